@@ -53,6 +53,22 @@ bool check_acs(const std::string& expression, acs_debug_t debug) {
   return result;
 }
 
+bool check_acs(const CompiledAcs& acs, acs_debug_t debug) {
+  if (acs.empty()) {
+    return true;
+  }
+  auto [result, debug_info] = sdk::acs::check_acs(*a()->config(), a()->user(),
+                                                  a()->sess().effective_sl(), acs, debug);
+  for (const auto& l : debug_info) {
+    if (debug == acs_debug_t::local) {
+      LOG(INFO) << l;
+    } else if (debug == acs_debug_t::remote) {
+      bout << l << endl;
+    }
+  }
+  return result;
+}
+
 bool validate_acs(const std::string& expression, acs_debug_t debug) {
   auto [result, ex_what, debug_info] =
       sdk::acs::validate_acs(*a()->config(), a()->user(), a()->sess().effective_sl(), expression);
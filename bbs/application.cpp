@@ -54,6 +54,7 @@
 #include "common/workspace.h"
 #include "core/command_line.h"
 #include "core/eventbus.h"
+#include "core/metrics.h"
 #include "core/os.h"
 #include "core/strings-ng.h"
 #include "core/strings.h"
@@ -71,6 +72,7 @@
 #include "local_io/wconstants.h"
 #include "sdk/chains.h"
 #include "sdk/gfiles.h"
+#include "sdk/latest_qscan.h"
 #include "sdk/names.h"
 #include "sdk/status.h"
 #include "sdk/subxtr.h"
@@ -890,10 +892,15 @@ int Application::Run(int argc, char* argv[]) {
     // HACK for now, pass arg into InitializeBBS
     user_already_on_ = true;
   }
+  Metrics::Init(config()->datadir());
   CreateComm(hSockOrComm, type);
+  const auto init_start = std::chrono::steady_clock::now();
   if (!InitializeBBS(!user_already_on_ && sysop_cmd.empty() && fsed.empty() && run_basic.empty())) {
     return exitLevelNotOK;
   }
+  Metrics::instance()
+      .histogram("bbs_startup_seconds", "Time taken to initialize the BBS")
+      .observe(std::chrono::steady_clock::now() - init_start);
   localIO()->UpdateNativeTitleBar(config()->system_name(), instance_number());
 
   auto remote_opened = true;
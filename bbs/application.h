@@ -71,6 +71,7 @@ class Config;
 class Conferences;
 class Chains;
 class GFiles;
+class LatestQScan;
 class Names;
 class StatusMgr;
 class Subs;
@@ -219,6 +220,8 @@ public:
   void set_net_num(int n) { network_num_ = n; }
 
   [[nodiscard]] wwiv::sdk::StatusMgr* status_manager() const { return statusMgr.get(); }
+  /** The shared newest post on each sub, or nullptr before the BBS is initialized. */
+  [[nodiscard]] wwiv::sdk::LatestQScan* latest_qscan() const { return latest_qscan_.get(); }
   [[nodiscard]] wwiv::sdk::UserManager* users() const { return user_manager_.get(); }
 
   [[nodiscard]] uint8_t primary_port() const { return primary_port_; }
@@ -430,6 +433,7 @@ private:
   bool at_wfc_{false};
 
   std::unique_ptr<wwiv::sdk::StatusMgr> statusMgr;
+  std::unique_ptr<wwiv::sdk::LatestQScan> latest_qscan_;
   std::unique_ptr<wwiv::sdk::UserManager> user_manager_;
   std::string attach_dir_;
   std::filesystem::path netfoss_dir_;
@@ -35,7 +35,6 @@
 #include "deps/my_basic/core/my_basic.h"
 #include "sdk/config.h"
 #include <cstdarg>
-#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -171,7 +170,17 @@ Basic::Basic(common::Input& i, common::Output& o, const sdk::Config& config, com
   bas_ = SetupBasicInterpreter();
   RegisterDefaultNamespaces();
 
-   mb_debug_set_stepped_handler(bas_, _on_stepped);
+  // The stepped handler runs for every statement, so only install it when
+  // it will log something.
+  if (VLOG_IS_ON(2)) {
+    mb_debug_set_stepped_handler(bas_, _on_stepped);
+  }
+}
+
+Basic::~Basic() {
+  if (bas_) {
+    mb_close(&bas_);
+  }
 }
 
 static std::string ScriptBaseName(const std::string& script_name) {
@@ -231,12 +240,13 @@ bool Basic::RunScript(const std::string& module, const std::string& text) {
     return false;
   }
 
-  static std::mutex script_mutex;
-  std::lock_guard<std::mutex> guard(script_mutex);
+  // script_in and script_out are per thread, so scripts running on other
+  // threads are not affected.
   set_script_out(&bout_);
   set_script_in(&bin_);
   const auto ret = mb_run(bas_, false);
   mb_close(&bas_);
+  bas_ = nullptr;
 
   // We don't call mb_dispose since we only call mb_init once per execution.
   if (ret != MB_FUNC_OK) {
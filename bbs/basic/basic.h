@@ -37,6 +37,9 @@ class Basic {
 public:
   Basic(common::Input& i, common::Output& o, const sdk::Config& config,
         common::Context* ctx);
+  ~Basic();
+  Basic(const Basic&) = delete;
+  Basic& operator=(const Basic&) = delete;
 
   bool RunScript(const std::string& script_name);
   bool RunScript(const std::string& module, const std::string& text);
@@ -52,7 +55,7 @@ private:
   const common::Context* ctx_;
   std::unique_ptr<BasicScriptState> script_userdata_;
 
-  mb_interpreter_t* bas_;
+  mb_interpreter_t* bas_{nullptr};
 };
 
 bool RunBasicScript(const std::string& script_name);
@@ -28,7 +28,8 @@ namespace wwiv::bbs::basic {
 
 using namespace wwiv::common;
 
-static Output* script_out_{nullptr};
+// Per thread so that scripts on different threads do not share their I/O.
+static thread_local Output* script_out_{nullptr};
 
 Output& script_out() { 
   CHECK_NOTNULL(script_out_);
@@ -43,7 +44,7 @@ void set_script_out(Output* o) {
   script_out_ = o; 
 }
 
-static Input* script_in_{nullptr};
+static thread_local Input* script_in_{nullptr};
 
 Input& script_in() {
   CHECK_NOTNULL(script_in_);
@@ -390,7 +390,7 @@ void zmbatchdl(bool bHangupAfterDl) {
   }
 }
 
-char end_ymodem_batch1() {
+char end_ymodem_batch1(bool streaming) {
   char b[128];
 
   memset(b, 0, 128);
@@ -404,6 +404,9 @@ char end_ymodem_batch1() {
     ch = gettimeout(5, &bAbort);
     if (ch == CF || ch == CX) {
       done = true;
+    } else if (streaming) {
+      // YModem-G receivers need not ACK the empty header ending the batch.
+      return CF;
     } else {
       ++nerr;
       if (nerr >= 9) {
@@ -426,11 +429,12 @@ static void end_ymodem_batch() {
   int oldx = a()->localIO()->WhereX();
   int oldy = a()->localIO()->WhereY();
   bool ucrc = false;
-  if (!okstart(&ucrc, &abort)) {
+  bool streaming = false;
+  if (!okstart(&ucrc, &abort, &streaming)) {
     abort = true;
   }
   if (!abort && !a()->sess().hangup()) {
-    const char ch = end_ymodem_batch1();
+    const char ch = end_ymodem_batch1(streaming);
     if (ch == CX) {
       abort = true;
     }
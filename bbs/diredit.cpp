@@ -32,6 +32,7 @@
 #include "core/strings.h"
 #include "fmt/printf.h"
 #include "sdk/files/dirs.h"
+#include "sdk/files/files.h"
 #include "sdk/usermanager.h"
 #include <string>
 
@@ -542,6 +543,7 @@ void dlboardedit() {
             const auto& fn = a()->dirs()[i].filename;
             File::Remove(FilePath(a()->config()->datadir(), StrCat(fn, ".dir")));
             File::Remove(FilePath(a()->config()->datadir(), StrCat(fn, ".ext")));
+            a()->fileapi()->catalog().ReplaceArea(fn, {});
           }
         }
       }
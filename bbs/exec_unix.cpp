@@ -27,7 +27,11 @@
 #include <sys/ttydefaults.h>
 #undef TTYDEFCHARS
 
+#include <poll.h>
 #include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
 
 #if defined(__APPLE__)
 #include <util.h>
@@ -42,76 +46,171 @@
 
 #include "core/log.h"
 #include "core/os.h"
+#include <cerrno>
+#include <string>
+#include <vector>
 
 static const char SHELL[] = "/bin/bash";
 
-static int ReadWriteNonBinary(int sock, int pty_fd, fd_set& rfd) {
-  if (FD_ISSET(sock, &rfd)) {
-    char input{};
-    if (read(sock, &input, 1) == 0) { 
-      return -1;
+// Size of the chunks moved between the socket and the door.
+static constexpr int kBridgeBufferSize = 16 * 1024;
+
+/** Writes all of data to fd, waiting for it to be writable if needed. */
+static bool WriteFully(int fd, const char* data, size_t len) {
+  while (len > 0) {
+    const auto w = write(fd, data, len);
+    if (w < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        pollfd pfd{fd, POLLOUT, 0};
+        poll(&pfd, 1, 1000);
+        continue;
+      }
+      VLOG(1) << "write failed; errno: " << errno;
+      return false;
+    }
+    data += w;
+    len -= static_cast<size_t>(w);
+  }
+  return true;
+}
+
+/**
+ * Removes telnet commands and control-C from the len bytes of user input
+ * in buf, returning the number of bytes left.  iac_skip carries the
+ * number of bytes of a telnet command still to be skipped into the next
+ * buffer.
+ */
+static ssize_t FilterFromSocket(char* buf, ssize_t len, int& iac_skip) {
+  ssize_t out = 0;
+  for (ssize_t i = 0; i < len; i++) {
+    const auto c = buf[i];
+    if (iac_skip > 0) {
+      --iac_skip;
+      continue;
     }
-    if (static_cast<uint8_t>(input) == 0xff) {
+    if (static_cast<uint8_t>(c) == 0xff) {
       // IAC, skip over them so we ignore them for now
       // This was causing the do suppress GA (255, 253, 3)
       // to get interpreted as a SIGINT by dosemu on startup.
-      LOG(INFO) << "IAC";
-      if (read(sock, &input, 1) == 0) { 
-        return -1;
-      }
-      if (read(sock, &input, 1) == 0) { 
-        return -1;
-      }
-      return 0;
+      VLOG(1) << "IAC";
+      iac_skip = 2;
+      continue;
     }
-    if (input == 3) {
+    if (c == 3) {
       VLOG(1) << "control-c from user, skipping.";
-      return 0;
-    }
-    VLOG(4) << "Read from Socket: input: " << input << " [" << static_cast<unsigned int>(input)
-	    << "]";
-    write(pty_fd, &input, 1);
-    VLOG(4) << "read from socket, write to term: '" << input << "'";
-  }
-  if (FD_ISSET(pty_fd, &rfd)) {
-    char input{};
-    read(pty_fd, &input, 1);
-    if (input == '\n') {
-      VLOG(1) << "Performed LF -> CRLF translation.";
-      write(sock, "\r\n", 2);
-    } else {
-      VLOG(4) << "Read From Terminal: '" << input << "'; [" << static_cast<unsigned>(input) << "]";
-      write(sock, &input, 1);
+      continue;
     }
+    buf[out++] = c;
   }
-  return 0;
+  return out;
 }
 
-static constexpr int READ_SIZE = 1024;
-static int ReadWriteBinary(int sock, int pty_fd, fd_set& rfd) {
-  VLOG(1) << "ReadWriteBinary Loop: << sock: " << sock
-	    << "; pty_fd: " << pty_fd;
-  if (FD_ISSET(sock, &rfd)) {
-    char input[READ_SIZE + 10];
-    const int num_read = read(sock, &input, READ_SIZE);
-    if (num_read > 0) {
-      const auto w = write(pty_fd, &input, num_read);
-      VLOG(1) << "wrote[pty_fd]: " << num_read << ";w:" << w;
-    } else {
-      VLOG(1) << "num_read[sock] <= 0; " << num_read;
+/** Copies the len bytes of door output in buf to out, translating LF to CRLF. */
+static void TranslateToSocket(const char* buf, ssize_t len, std::string& out) {
+  out.clear();
+  for (ssize_t i = 0; i < len; i++) {
+    if (buf[i] == '\n') {
+      out.push_back('\r');
     }
+    out.push_back(buf[i]);
   }
-  if (FD_ISSET(pty_fd, &rfd)) {
-    char input[READ_SIZE + 10];
-    const int num_read = read(pty_fd, &input, READ_SIZE);
-    if (num_read > 0) {
-      const auto w = write(sock, &input, num_read);
-      VLOG(1) << "wrote[sock]: " << num_read << ";w:" << w;
-    } else {
+}
+
+/** Returns a descriptor that becomes readable when pid exits, or -1. */
+static int OpenPidFd(pid_t pid) {
+#if defined(__linux__) && defined(SYS_pidfd_open)
+  return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+  (void)pid;
+  return -1;
+#endif
+}
+
+/** Returns true if pid has exited, without reaping it. */
+static bool ChildExited(pid_t pid) {
+  siginfo_t info{};
+  if (waitid(P_PID, static_cast<id_t>(pid), &info, WEXITED | WNOHANG | WNOWAIT) == -1) {
+    return errno != EINTR;
+  }
+  return info.si_pid == pid;
+}
+
+/**
+ * Moves data between the user's socket and the door's terminal until the
+ * door exits or the user hangs up.  Data is moved a buffer at a time, with
+ * the telnet and newline translations applied to the whole buffer unless
+ * binary is set.
+ */
+static void BridgeDoorIO(pid_t pid, int sock, int pty_fd, bool binary) {
+  const auto pidfd = OpenPidFd(pid);
+  std::vector<char> buf(kBridgeBufferSize);
+  std::string out;
+  out.reserve(kBridgeBufferSize * 2);
+  auto iac_skip = 0;
+
+  auto forward_from_pty = [&]() -> bool {
+    const auto num_read = read(pty_fd, buf.data(), buf.size());
+    if (num_read < 0 && errno == EINTR) {
+      return true;
+    }
+    if (num_read <= 0) {
+      // EOF or EIO once the door has closed the terminal.
       VLOG(1) << "num_read[pty_fd] <= 0; " << num_read;
+      return false;
+    }
+    if (binary) {
+      return WriteFully(sock, buf.data(), num_read);
+    }
+    TranslateToSocket(buf.data(), num_read, out);
+    return WriteFully(sock, out.data(), out.size());
+  };
+
+  for (;;) {
+    pollfd fds[3]{{sock, POLLIN, 0}, {pty_fd, POLLIN, 0}, {pidfd, POLLIN, 0}};
+    // Without a pidfd, wake up every second to see if the door has exited.
+    const auto ret = poll(fds, pidfd >= 0 ? 3 : 2, pidfd >= 0 ? -1 : 1000);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(INFO) << "poll returned <0; errno: " << errno;
+      break;
+    }
+    if (fds[1].revents & (POLLIN | POLLHUP | POLLERR)) {
+      if (!forward_from_pty()) {
+        break;
+      }
+    }
+    if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+      auto num_read = read(sock, buf.data(), buf.size());
+      if (num_read <= 0 && !(num_read < 0 && errno == EINTR)) {
+        VLOG(1) << "Socket closed; num_read[sock]: " << num_read;
+        break;
+      }
+      if (!binary) {
+        num_read = FilterFromSocket(buf.data(), num_read, iac_skip);
+      }
+      if (num_read > 0 && !WriteFully(pty_fd, buf.data(), num_read)) {
+        break;
+      }
+    }
+    const auto exited =
+        pidfd >= 0 ? (fds[2].revents & POLLIN) != 0 : (ret == 0 && ChildExited(pid));
+    if (exited) {
+      // Send whatever the door wrote before it exited.
+      pollfd pfd{pty_fd, POLLIN, 0};
+      while (poll(&pfd, 1, 0) > 0 && forward_from_pty()) {
+      }
+      break;
     }
   }
-  return 0;
+  if (pidfd >= 0) {
+    close(pidfd);
+  }
+  close(pty_fd);
 }
 
 static int UnixSpawn(const std::string& cmd, int flags, int sock) {
@@ -158,48 +257,9 @@ static int UnixSpawn(const std::string& cmd, int flags, int sock) {
 
   // In the parent now.
   VLOG(1) << "In parent, pid " << pid << "; errno: " << errno;
-  for (;;) {
-    fd_set rfd;
-    FD_ZERO(&rfd);
-
-    FD_SET(pty_fd, &rfd);
-    FD_SET(sock, &rfd);
-
-    struct timeval tv = {1, 0};
-    auto ret = select(std::max<int>(sock, pty_fd) + 1, &rfd, nullptr, nullptr, &tv);
-    if (ret < 0) {
-      LOG(INFO) << "select returned <0";
-      break;
-    }
-    int status_code = 0;
-    pid_t wp = waitpid(pid, &status_code, WNOHANG);
-    if (wp == -1 || wp > 0) {
-      // -1 means error and >0 is the pid
-      VLOG(2) << "waitpid returned: " << wp << "; errno: " << errno;
-      if (WIFEXITED(status_code)) {
-        VLOG(1) << "child exited with code: " << WEXITSTATUS(status_code);
-        break;
-      }
-      if (WIFSIGNALED(status_code)) {
-        VLOG(1) << "child caught signal: " << WTERMSIG(status_code);
-      } else {
-        LOG(INFO) << "Raw status_code: " << status_code;
-      }
-      LOG(INFO) << "core dump? : " << WCOREDUMP(status_code);
-      break;
-    }
-
-    if (pty_fd != -1) {
-      // Only do this in STDIO mode.
-      if (binary) {
-        ReadWriteBinary(sock, pty_fd, rfd);
-      } else {
-        if (ReadWriteNonBinary(sock, pty_fd, rfd) == -1) {
-          close(pty_fd);
-          break;
-        }
-      }
-    }
+  if (pty_fd != -1) {
+    // Only do this in STDIO mode.
+    BridgeDoorIO(pid, sock, pty_fd, binary);
   }
   // Wait for child to exit.
   for (;;) {
@@ -24,6 +24,7 @@
 #include "bbs/instmsg.h"
 #include "bbs/wqscn.h"
 #include "bbs/basic/basic.h"
+#include "core/async_log.h"
 #include "core/log.h"
 
 using namespace wwiv::core;
@@ -67,6 +68,9 @@ static int ExecuteExternalProgramNoScript(const std::string& commandLine, int nF
   // Some LocalIO implementations (Curses) needs to disable itself before
   // we fork some other process.
   a()->localIO()->DisableLocalIO();
+  // The program may append to the instance log named in chain.txt.
+  AsyncLogWriter::instance().flush();
+  AsyncLogWriter::instance().close_files();
   const auto return_code = exec_cmdline(commandLine, nFlags);
 
   // Re-engage the local IO engine if needed.
@@ -59,6 +59,7 @@
 #include "sdk/config.h"
 #include "sdk/filenames.h"
 #include "sdk/names.h"
+#include "sdk/ssm.h"
 #include "sdk/status.h"
 #include <chrono>
 #include <limits>
@@ -997,29 +998,10 @@ void logoff() {
     }
   }
   if (received_short_message()) {
-    File smwFile(FilePath(a()->config()->datadir(), SMW_DAT));
-    if (smwFile.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
-      const auto num_records = static_cast<int>(smwFile.length() / sizeof(shortmsgrec));
-      auto r = 0;
-      auto w = 0;
-      while (r < num_records) {
-        shortmsgrec sm;
-        smwFile.Seek(r * sizeof(shortmsgrec), File::Whence::begin);
-        smwFile.Read(&sm, sizeof(shortmsgrec));
-        if (sm.tosys != 0 || sm.touser != 0) {
-          if (sm.tosys == 0 && sm.touser == a()->sess().user_num()) {
-            a()->user()->SetStatusFlag(User::SMW);
-          }
-          if (r != w) {
-            smwFile.Seek(w * sizeof(shortmsgrec), File::Whence::begin);
-            smwFile.Write(&sm, sizeof(shortmsgrec));
-          }
-          ++w;
-        }
-        ++r;
-      }
-      smwFile.set_length(w * sizeof(shortmsgrec));
-      smwFile.Close();
+    SSM ssm(*a()->config(), *a()->users());
+    ssm.compact();
+    if (!ssm.messages_for(a()->sess().user_num()).empty()) {
+      a()->user()->SetStatusFlag(User::SMW);
     }
   }
   a()->WriteCurrentUser();
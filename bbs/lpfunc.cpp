@@ -31,6 +31,7 @@
 #include "fmt/printf.h"
 #include "local_io/keycodes.h"
 #include "sdk/filenames.h"
+#include "sdk/files/file_catalog.h"
 #include "sdk/files/files.h"
 #include <string>
 #include <vector>
@@ -97,6 +98,33 @@ static void load_listing() {
   }
 }
 
+// Returns false when the file catalog shows that nothing in dir can match sr,
+// so that the directory does not need to be opened at all.
+static bool catalog_may_match(const wwiv::sdk::files::FileCatalog& catalog,
+                              const wwiv::sdk::files::directory_t& dir, const search_record& sr) {
+  if (!catalog.has_area(dir.filename)) {
+    return true;
+  }
+  for (const auto& e : catalog.area_files(dir.filename)) {
+    const auto& u = e.u;
+    if (sr.filemask != "        .   " &&
+        !wwiv::sdk::files::aligned_wildcard_match(sr.filemask, u.filename)) {
+      continue;
+    }
+    if (sr.nscandate && u.daten < sr.nscandate) {
+      continue;
+    }
+    if (sr.search.empty() || (sr.search_extended && (u.mask & mask_extended))) {
+      return true;
+    }
+    const auto text = StrCat(u.filename, " ", u.description);
+    if (lp_compare_strings(text.c_str(), sr.search.c_str())) {
+      return true;
+    }
+  }
+  return false;
+}
+
 int listfiles_plus_function(int type) {
   int file_handle[51];
   char vert_pos[51];
@@ -125,6 +153,7 @@ int listfiles_plus_function(int type) {
 
   auto max_lines = calc_max_lines();
   auto all_done = false;
+  const auto* catalog = search_rec.alldirs == THIS_DIR ? nullptr : &file_catalog();
 
   for (uint16_t this_dir = 0; this_dir < a()->udir.size() && !a()->sess().hangup() && !all_done;
        this_dir++) {
@@ -144,6 +173,10 @@ int listfiles_plus_function(int type) {
       if (search_rec.alldirs == ALL_DIRS && (type != LP_NSCAN_NSCAN)) {
         scan_dir = true;
       }
+      if (scan_dir && catalog &&
+          !catalog_may_match(*catalog, a()->dirs()[also_this_dir], search_rec)) {
+        scan_dir = false;
+      }
     }
 
     int save_first_file = 0;
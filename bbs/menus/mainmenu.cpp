@@ -133,25 +133,9 @@ void mainmenu() {
 
 Menu::Menu(const std::filesystem::path& menu_path, const std::string& menu_set,
            const std::string& menu_name)
-    : menu_set_(menu_set), menu_name_(menu_name), menu_(menu_path, menu_set, menu_name) {
-
+    : menu_set_(menu_set), menu_name_(menu_name),
+      menu_(menu_cache().Get(menu_path, menu_set, menu_name)) {
   menu_set_path_ = FilePath(menu_path, menu_set_);
-  prompt_ = "|09Command? ";
-
-  // Load Prompt;
-  const auto prompt_filename = StrCat(menu_name, ".pro");
-  const auto prompt_path = FilePath(menu_set_path_, prompt_filename);
-
-  TextFile prompt_file(prompt_path, "rb");
-  if (prompt_file.IsOpen()) {
-    const auto tmp = prompt_file.ReadFileIntoString();
-    const auto end = tmp.find(".end.");
-    if (end != std::string::npos) {
-      prompt_ = tmp.substr(0, end);
-    } else {
-      prompt_ = tmp;
-    }
-  }
 }
 
 void Menu::DisplayMenu() {
@@ -199,49 +183,41 @@ static bool IsNumber(const std::string& command) {
   return true;
 }
 
-std::optional<menu_item_56_t> Menu::GetMenuItemForCommand(const std::string& cmd) const {
+const compiled_menu_item_t* Menu::GetMenuItemForCommand(const std::string& cmd) {
   const auto nums = menu().num_action;
   if (IsNumber(cmd) && nums != menu_numflag_t::none) {
-    if (nums == menu_numflag_t::subs) {
-      menu_item_56_t i{};
-      menu_action_56_t a{"SetSubNumber", cmd, ""};
-      i.actions.emplace_back(a);
-      return {i};
-    }
-    if (nums == menu_numflag_t::dirs) {
-      menu_item_56_t i{};
-      menu_action_56_t a{"SetDirNumber", cmd, ""};
-      i.actions.emplace_back(a);
-      return {i};
-    }
-  }
-
-  for (const auto& mi : menu().items) {
-    if (cmd == mi.item_key) {
-      return {mi};
+    if (nums == menu_numflag_t::subs || nums == menu_numflag_t::dirs) {
+      const menu_action_56_t a{nums == menu_numflag_t::subs ? "SetSubNumber" : "SetDirNumber",
+                               cmd, ""};
+      number_item_ = compiled_menu_item_t{};
+      number_item_.actions = CompileActions({a});
+      return &number_item_;
     }
   }
-  return std::nullopt;
+  return menu_->item(cmd);
 }
 
-std::tuple<menu_command_action_t, std::string> Menu::ExecuteAction(const menu_action_56_t& a) {
-  if (auto o = InterpretCommand(this, a.cmd, a.data)) {
+std::tuple<menu_command_action_t, std::string> Menu::ExecuteAction(const compiled_action_t& a) {
+  if (!a.command) {
+    return std::make_tuple(menu_command_action_t::none, "");
+  }
+  if (auto o = InterpretCommand(this, *a.command, a.action.data)) {
     auto& ctx = o.value();
     if (ctx.menu_action == menu_command_action_t::return_from_menu) {
       return std::make_tuple(menu_command_action_t::return_from_menu, "");
     }
     if (ctx.menu_action == menu_command_action_t::push_menu) {
-      return std::make_tuple(menu_command_action_t::push_menu, a.data);
+      return std::make_tuple(menu_command_action_t::push_menu, a.action.data);
     }
   }
   return std::make_tuple(menu_command_action_t::none, "");
 }
 
 std::tuple<menu_command_action_t, std::string>
-Menu::ExecuteActions(const std::vector<menu_action_56_t>& actions) {
+Menu::ExecuteActions(const std::vector<compiled_action_t>& actions) {
   for (const auto& action : actions) {
     auto [a, d] = ExecuteAction(action);
-    VLOG(1) << "Action: " << action.cmd << "; " << action.data << endl;
+    VLOG(1) << "Action: " << action.action.cmd << "; " << action.action.data << endl;
     if (a == menu_command_action_t::push_menu) {
       return std::make_tuple(menu_command_action_t::push_menu, d);
     }
@@ -254,10 +230,10 @@ Menu::ExecuteActions(const std::vector<menu_action_56_t>& actions) {
 
 std::tuple<menu_run_result_t, std::string> Menu::Run() {
   const auto menu_set = a()->user()->menu_set();
-  if (!menu_.initialized()) {
+  if (!menu_->initialized()) {
     return std::make_tuple(menu_run_result_t::error, "");
   }
-  if (!check_acs(menu().acs)) {
+  if (!check_acs(menu_->acs())) {
     sysoplog() << "Insufficient ACS for menu.";
     bout << "|#6Insufficient ACS for menu: " << menu().title << endl;
     return std::make_tuple(menu_run_result_t::error, "");
@@ -269,7 +245,7 @@ std::tuple<menu_run_result_t, std::string> Menu::Run() {
 
   {
     // Process entrance actions.
-    auto [a, d] = ExecuteActions(menu().enter_actions);
+    auto [a, d] = ExecuteActions(menu_->enter_actions());
     if (a == menu_command_action_t::push_menu) {
       return std::make_tuple(menu_run_result_t::push_menu, d);
     }
@@ -293,31 +269,31 @@ std::tuple<menu_run_result_t, std::string> Menu::Run() {
     }
     const auto save_mci = bout.mci_enabled();
     bout.enable_mci();
-    bout << prompt_;
+    bout << menu_->prompt();
     bout.set_mci_enabled(save_mci);
     // Do actions on enter.
 
     auto cmd = GetCommandFromUser();
     // Reset menu displayed
     menu_displayed_ = false;
-    if (auto omi = GetMenuItemForCommand(cmd)) {
-      const auto& mi = omi.value();
-      if (!check_acs(mi.acs)) {
+    if (const auto* cmi = GetMenuItemForCommand(cmd)) {
+      const auto& mi = cmi->item;
+      if (!check_acs(cmi->acs)) {
         sysoplog() << "Insufficient ACS for menu item: " << mi.item_key;
         bout << "|#6Insufficient ACS for menu item: " << mi.item_key << endl;
         continue;
       }
       VLOG(1) << "Command is: " << cmd << "; " << mi.item_key << endl;
       log_command(menu().logging_action, mi);
-      auto [action, d] = ExecuteActions(mi.actions);
+      auto [action, d] = ExecuteActions(cmi->actions);
       if (action == menu_command_action_t::push_menu) {
         // No push or pop allowed in exit actions
-        ExecuteActions(menu().exit_actions);
+        ExecuteActions(menu_->exit_actions());
         return std::make_tuple(menu_run_result_t::push_menu, d);
       }
       if (action == menu_command_action_t::return_from_menu) {
         // No push or pop allowed in exit actions
-        ExecuteActions(menu().exit_actions);
+        ExecuteActions(menu_->exit_actions());
         return std::make_tuple(menu_run_result_t::return_from_menu, "");
       }
       if (reload || !iequals(menu_set, a()->user()->menu_set())) {
@@ -347,7 +323,11 @@ void Menu::GenerateMenu(menu_type_t typ) {
 
 
 std::vector<std::string> Menu::GenerateMenuAsLines(menu_type_t typ) {
-  return GenerateMenuLines(*a()->config(), a()->sess().effective_sl(), menu(), *a()->user(), typ);
+  std::vector<bool> allowed;
+  for (const auto& mi : menu_->items()) {
+    allowed.push_back(check_acs(mi.acs));
+  }
+  return menu_->GenerateMenuLines(typ, a()->user()->GetScreenChars(), allowed);
 }
 
 
@@ -20,9 +20,11 @@
 #define INCLUDED_MENUS_MAINMENU_H
 
 #include "menucommands.h"
+#include "bbs/menus/menu_cache.h"
 #include "sdk/menus/menu.h"
 #include <filesystem>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -49,21 +51,21 @@ public:
   Menu(const std::filesystem::path& menu_path, const std::string& menu_set,
                const std::string& menu_name);
   ~Menu() = default;
-  [[nodiscard]] bool initalized() const { return menu_.initialized(); }
+  [[nodiscard]] bool initalized() const { return menu_->initialized(); }
   // Gets the command string from the user for this menu.
   [[nodiscard]] std::string GetCommandFromUser() const;
-  [[nodiscard]] std::optional<wwiv::sdk::menus::menu_item_56_t>
-  GetMenuItemForCommand(const std::string& cmd) const;
+  // Returns the item for cmd, or nullptr.  Valid until the next call.
+  [[nodiscard]] const compiled_menu_item_t* GetMenuItemForCommand(const std::string& cmd);
   void DisplayMenu();
   // Generates the short form (multi-column) or long form (single col, help text) menu.
   std::vector<std::string> GenerateMenuAsLines(sdk::menus::menu_type_t typ);
   // Generates the short form (multi-column) or long form (single col, help text) menu.
   void GenerateMenu(sdk::menus::menu_type_t typ);
-  [[nodiscard]] const sdk::menus::menu_56_t& menu() const noexcept { return menu_.menu; }
+  [[nodiscard]] const sdk::menus::menu_56_t& menu() const noexcept { return menu_->menu(); }
   std::tuple<menu_command_action_t, std::string>
-  ExecuteAction(const sdk::menus::menu_action_56_t& a);
+  ExecuteAction(const compiled_action_t& a);
   std::tuple<menu_command_action_t, std::string>
-  ExecuteActions(const std::vector<wwiv::sdk::menus::menu_action_56_t>& actions);
+  ExecuteActions(const std::vector<compiled_action_t>& actions);
   std::tuple<menu_run_result_t, std::string> Run();
 
   bool reload{false}; /* true if we are going to reload the menus */
@@ -72,9 +74,11 @@ public:
 private:
   const std::string menu_set_;
   const std::string menu_name_;
-  sdk::menus::Menu56 menu_;
+  // Shared with every other Menu for the same menu set and name.
+  std::shared_ptr<CompiledMenu> menu_;
   std::filesystem::path menu_set_path_;
-  std::string prompt_;
+  // Item created for a number when num_action is set.
+  compiled_menu_item_t number_item_;
 };
 
 class MainMenu {
@@ -0,0 +1,136 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2020, WWIV Software Services             */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "bbs/menus/menu_cache.h"
+
+#include "core/file.h"
+#include "core/log.h"
+#include "core/strings.h"
+#include "core/textfile.h"
+#include <string>
+#include <vector>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk::acs;
+using namespace wwiv::sdk::menus;
+using namespace wwiv::strings;
+
+namespace wwiv::bbs::menus {
+
+static std::filesystem::path menu_json_path(const std::filesystem::path& menu_dir,
+                                            const std::string& menu_set,
+                                            const std::string& menu_name) {
+  return FilePath(FilePath(menu_dir, menu_set), StrCat(menu_name, ".mnu.json"));
+}
+
+static std::filesystem::path menu_prompt_path(const std::filesystem::path& menu_dir,
+                                              const std::string& menu_set,
+                                              const std::string& menu_name) {
+  return FilePath(FilePath(menu_dir, menu_set), StrCat(menu_name, ".pro"));
+}
+
+static time_t mtime(const std::filesystem::path& path) {
+  return File::Exists(path) ? File::last_write_time(path) : 0;
+}
+
+std::vector<compiled_action_t> CompileActions(const std::vector<menu_action_56_t>& actions) {
+  std::vector<compiled_action_t> out;
+  for (const auto& a : actions) {
+    out.push_back(compiled_action_t{a, FindMenuCommand(a.cmd)});
+  }
+  return out;
+}
+
+CompiledMenu::CompiledMenu(const std::filesystem::path& menu_dir, const std::string& menu_set,
+                           const std::string& menu_name)
+    : prompt_("|09Command? ") {
+  const auto json_path = menu_json_path(menu_dir, menu_set, menu_name);
+  const auto prompt_path = menu_prompt_path(menu_dir, menu_set, menu_name);
+  // Read the times first so a change while loading is seen next time.
+  menu_time_ = mtime(json_path);
+  prompt_time_ = mtime(prompt_path);
+
+  Menu56 m(menu_dir, menu_set, menu_name);
+  initialized_ = m.initialized();
+  if (!initialized_) {
+    return;
+  }
+  menu_ = std::move(m.menu);
+
+  TextFile prompt_file(prompt_path, "rb");
+  if (prompt_file.IsOpen()) {
+    const auto tmp = prompt_file.ReadFileIntoString();
+    const auto end = tmp.find(".end.");
+    if (end != std::string::npos) {
+      prompt_ = tmp.substr(0, end);
+    } else {
+      prompt_ = tmp;
+    }
+  }
+
+  acs_ = CompiledAcs(menu_.acs);
+  enter_actions_ = CompileActions(menu_.enter_actions);
+  exit_actions_ = CompileActions(menu_.exit_actions);
+  for (const auto& mi : menu_.items) {
+    // The first item wins when keys are duplicated.
+    item_index_.emplace(mi.item_key, static_cast<int>(items_.size()));
+    items_.push_back(compiled_menu_item_t{mi, CompiledAcs(mi.acs), CompileActions(mi.actions)});
+  }
+}
+
+const compiled_menu_item_t* CompiledMenu::item(const std::string& key) const {
+  const auto it = item_index_.find(key);
+  return it == std::end(item_index_) ? nullptr : &items_.at(it->second);
+}
+
+const std::vector<std::string>& CompiledMenu::GenerateMenuLines(menu_type_t typ, int screen_chars,
+                                                                const std::vector<bool>& allowed) {
+  auto key = std::make_tuple(typ, screen_chars, allowed);
+  if (auto it = generated_.find(key); it != std::end(generated_)) {
+    return it->second;
+  }
+  auto lines = sdk::menus::GenerateMenuLines(menu_, screen_chars, allowed, typ);
+  return generated_.emplace(std::move(key), std::move(lines)).first->second;
+}
+
+std::shared_ptr<CompiledMenu> MenuCache::Get(const std::filesystem::path& menu_dir,
+                                             const std::string& menu_set,
+                                             const std::string& menu_name) {
+  auto key = std::make_tuple(menu_dir.string(), menu_set, menu_name);
+  if (auto it = menus_.find(key); it != std::end(menus_)) {
+    const auto& m = it->second;
+    if (m->menu_time() == mtime(menu_json_path(menu_dir, menu_set, menu_name)) &&
+        m->prompt_time() == mtime(menu_prompt_path(menu_dir, menu_set, menu_name))) {
+      return m;
+    }
+    VLOG(1) << "Reloading changed menu: " << menu_set << "/" << menu_name;
+    menus_.erase(it);
+  }
+  auto m = std::make_shared<CompiledMenu>(menu_dir, menu_set, menu_name);
+  if (m->initialized()) {
+    menus_.emplace(std::move(key), m);
+  }
+  return m;
+}
+
+MenuCache& menu_cache() {
+  static MenuCache cache; // NOLINT(clang-diagnostic-exit-time-destructors)
+  return cache;
+}
+
+} // namespace wwiv::bbs::menus
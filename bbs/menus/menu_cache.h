@@ -0,0 +1,125 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)1998-2020, WWIV Software Services             */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#ifndef INCLUDED_BBS_MENUS_MENU_CACHE_H
+#define INCLUDED_BBS_MENUS_MENU_CACHE_H
+
+#include "bbs/menus/menucommands.h"
+#include "sdk/acs/acs.h"
+#include "sdk/menus/menu.h"
+#include <ctime>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace wwiv::bbs::menus {
+
+/** A menu action with its command already looked up. */
+struct compiled_action_t {
+  sdk::menus::menu_action_56_t action;
+  // nullptr if no command with this name exists.
+  const MenuItem* command{nullptr};
+};
+
+/** A menu item with its ACS parsed and its actions bound to commands. */
+struct compiled_menu_item_t {
+  sdk::menus::menu_item_56_t item;
+  sdk::acs::CompiledAcs acs;
+  std::vector<compiled_action_t> actions;
+};
+
+std::vector<compiled_action_t> CompileActions(const std::vector<sdk::menus::menu_action_56_t>& actions);
+
+/**
+ * A menu and its prompt loaded from a menu set, ready to run: the ACS
+ * expressions are parsed, the actions are bound to their commands and the
+ * items are indexed by key.  The generated (novice) menus are memoized too.
+ */
+class CompiledMenu {
+public:
+  CompiledMenu(const std::filesystem::path& menu_dir, const std::string& menu_set,
+               const std::string& menu_name);
+
+  [[nodiscard]] bool initialized() const noexcept { return initialized_; }
+  [[nodiscard]] const sdk::menus::menu_56_t& menu() const noexcept { return menu_; }
+  [[nodiscard]] const std::string& prompt() const noexcept { return prompt_; }
+  [[nodiscard]] const sdk::acs::CompiledAcs& acs() const noexcept { return acs_; }
+  [[nodiscard]] const std::vector<compiled_menu_item_t>& items() const noexcept { return items_; }
+  [[nodiscard]] const std::vector<compiled_action_t>& enter_actions() const noexcept {
+    return enter_actions_;
+  }
+  [[nodiscard]] const std::vector<compiled_action_t>& exit_actions() const noexcept {
+    return exit_actions_;
+  }
+  /** Returns the item for key, or nullptr if there is none. */
+  [[nodiscard]] const compiled_menu_item_t* item(const std::string& key) const;
+
+  /**
+   * Returns the generated menu for a screen screen_chars wide where allowed[i]
+   * is the result of the ACS check of items()[i].
+   */
+  const std::vector<std::string>& GenerateMenuLines(sdk::menus::menu_type_t typ, int screen_chars,
+                                                    const std::vector<bool>& allowed);
+
+  // Modification times of the files this was loaded from.
+  [[nodiscard]] time_t menu_time() const noexcept { return menu_time_; }
+  [[nodiscard]] time_t prompt_time() const noexcept { return prompt_time_; }
+
+private:
+  bool initialized_{false};
+  sdk::menus::menu_56_t menu_{};
+  std::string prompt_;
+  sdk::acs::CompiledAcs acs_;
+  std::vector<compiled_menu_item_t> items_;
+  std::unordered_map<std::string, int> item_index_;
+  std::vector<compiled_action_t> enter_actions_;
+  std::vector<compiled_action_t> exit_actions_;
+  std::map<std::tuple<sdk::menus::menu_type_t, int, std::vector<bool>>, std::vector<std::string>>
+      generated_;
+  time_t menu_time_{0};
+  time_t prompt_time_{0};
+};
+
+/**
+ * Compiled menus for this process, keyed by menu set and name.  A menu is
+ * compiled again when its .mnu.json or .pro file has changed on disk.
+ */
+class MenuCache {
+public:
+  MenuCache() = default;
+
+  /** Returns the menu, which may not be initialized if it could not be loaded. */
+  std::shared_ptr<CompiledMenu> Get(const std::filesystem::path& menu_dir,
+                                    const std::string& menu_set, const std::string& menu_name);
+  void Clear() { menus_.clear(); }
+  [[nodiscard]] int size() const { return static_cast<int>(menus_.size()); }
+
+private:
+  std::map<std::tuple<std::string, std::string, std::string>, std::shared_ptr<CompiledMenu>> menus_;
+};
+
+/** The menu cache used by the BBS. */
+MenuCache& menu_cache();
+
+} // namespace wwiv::bbs::menus
+
+#endif
@@ -70,20 +70,29 @@ static const std::string MENU_CAT_SYS = "System";
 static const std::string MENU_CAT_CONF = "Conference";
 static const std::string MENU_CAT_USER = "User";
 
-std::optional<MenuContext> InterpretCommand(Menu* menu, const std::string& cmd,
-                                            const std::string& data) {
+const MenuItem* FindMenuCommand(const std::string& cmd) {
   if (cmd.empty()) {
-    return std::nullopt;
+    return nullptr;
+  }
+  static const auto functions = CreateCommandMap(); // NOLINT(clang-diagnostic-exit-time-destructors)
+  const auto it = functions.find(cmd);
+  return it == std::end(functions) ? nullptr : &it->second;
+}
+
+std::optional<MenuContext> InterpretCommand(Menu* menu, const MenuItem& command,
+                                            const std::string& data) {
+  MenuContext context(menu, data);
+  command.f_(context);
+  if (menu) {
+    menu->reload = context.need_reload;
   }
-  static auto functions = CreateCommandMap(); // NOLINT(clang-diagnostic-exit-time-destructors)
-
-  if (contains(functions, cmd)) {
-    MenuContext context(menu, data);
-    at(functions, cmd).f_(context);
-    if (menu) {
-      menu->reload = context.need_reload;
-    }
-    return {context};
+  return {context};
+}
+
+std::optional<MenuContext> InterpretCommand(Menu* menu, const std::string& cmd,
+                                            const std::string& data) {
+  if (const auto* command = FindMenuCommand(cmd)) {
+    return InterpretCommand(menu, *command, data);
   }
   return std::nullopt;
 }
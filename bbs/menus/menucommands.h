@@ -46,12 +46,22 @@ struct MenuItem {
 
 std::map<std::string, MenuItem, wwiv::stl::ci_less> CreateCommandMap();
 
+/**
+ * Returns the command named cmd (case insensitive), or nullptr if it does not
+ * exist.  The pointer remains valid for the life of the process.
+ */
+const MenuItem* FindMenuCommand(const std::string& cmd);
+
 /**
  * Executes a menu command ```script``` using the menu data for the context of
  * the MENU, or nullptr if not invoked from an actual menu.
  */
 std::optional<MenuContext> InterpretCommand(Menu* menu, const std::string& cmd, const std::string& data);
 
+/** Executes a command that was already found using FindMenuCommand. */
+std::optional<MenuContext> InterpretCommand(Menu* menu, const MenuItem& command,
+                                            const std::string& data);
+
 }  // namespace
 
 #endif
@@ -39,6 +39,7 @@
 #include "core/stl.h"
 #include "core/strings.h"
 #include "fmt/printf.h"
+#include "sdk/latest_qscan.h"
 #include "sdk/names.h"
 #include "sdk/status.h"
 #include "sdk/subxtr.h"
@@ -386,7 +387,14 @@ std::string grab_user_name(messagerec* msg, const std::string& file_name, int ne
   return {};
 }
 
-void qscan(uint16_t start_subnum, bool& nextsub) {
+// True when the shared table of the newest post on each sub is missing
+// nothing, so that subs it shows as read need not be opened.
+static bool latest_qscan_complete() {
+  const auto* latest = a()->latest_qscan();
+  return latest && latest->complete(a()->status_manager()->GetStatus()->GetQScanPointer());
+}
+
+static void qscan(uint16_t start_subnum, bool& nextsub, bool use_latest_qscan) {
   const int sub_number = a()->usub[start_subnum].subnum;
 
   if (a()->sess().hangup() || sub_number < 0) {
@@ -395,10 +403,17 @@ void qscan(uint16_t start_subnum, bool& nextsub) {
   bout.nl();
   auto memory_last_read = a()->sess().qsc_p[sub_number];
 
-  iscan1(sub_number);
   auto num_lines = 3;
-  const auto on_disk_last_post = WWIVReadLastRead(sub_number);
-  if (!on_disk_last_post || on_disk_last_post > memory_last_read) {
+  auto has_new = false;
+  const auto latest =
+      use_latest_qscan ? a()->latest_qscan()->latest(a()->subs().sub(sub_number).filename) : 0;
+  // Only open the sub when the shared table does not already show it as read.
+  if (latest == 0 || latest > memory_last_read) {
+    iscan1(sub_number);
+    const auto on_disk_last_post = WWIVReadLastRead(sub_number);
+    has_new = !on_disk_last_post || on_disk_last_post > memory_last_read;
+  }
+  if (has_new) {
     const auto old_subnum = a()->current_user_sub_num();
     a()->set_current_user_sub_num(start_subnum);
 
@@ -442,14 +457,19 @@ void qscan(uint16_t start_subnum, bool& nextsub) {
   bout.nl();
 }
 
+void qscan(uint16_t start_subnum, bool& nextsub) {
+  qscan(start_subnum, nextsub, latest_qscan_complete());
+}
+
 void nscan(uint16_t start_subnum) {
   bool nextsub = true;
+  const auto use_latest_qscan = latest_qscan_complete();
 
   bout << "\r\n|#3-=< Q-Scan All >=-\r\n";
   for (auto i = start_subnum; i < a()->usub.size() && nextsub && !a()->sess().hangup();
        i++) {
     if (a()->sess().qsc_q[a()->usub[i].subnum / 32] & (1L << (a()->usub[i].subnum % 32))) {
-      qscan(i, nextsub);
+      qscan(i, nextsub, use_latest_qscan);
     }
     bool abort = false;
     bin.checka(&abort);
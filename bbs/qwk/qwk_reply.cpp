@@ -50,6 +50,7 @@
 #include "fmt/printf.h"
 #include "local_io/keycodes.h"
 #include "local_io/wconstants.h"
+#include "sdk/files/arc.h"
 #include "sdk/names.h"
 #include "sdk/qwk_config.h"
 #include "sdk/status.h"
@@ -103,6 +104,10 @@ static void qwk_receive_file(const std::string& fn, bool* received, int prot_num
 }
 
 static std::filesystem::path ready_reply_packet(const std::string& packet_name, const std::string& msg_name) {
+  const auto qwk_dir = a()->sess().dirs().qwk_directory();
+  if (files::extract_archive(packet_name, qwk_dir, {msg_name})) {
+    return FilePath(qwk_dir, msg_name);
+  }
   const auto archiver = match_archiver(a()->arcs, packet_name).value_or(a()->arcs[0]);
   const auto command = stuff_in(archiver.arce, packet_name, msg_name, "", "", "");
 
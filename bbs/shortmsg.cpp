@@ -23,12 +23,12 @@
 #include "common/com.h"
 #include "common/input.h"
 #include "common/output.h"
-#include "core/datafile.h"
 #include "core/datetime.h"
 #include "core/file.h"
 #include "core/log.h"
 #include "core/strings.h"
 #include "sdk/filenames.h"
+#include "sdk/ssm.h"
 #include "sdk/user.h"
 #include "sdk/usermanager.h"
 #include <cstdarg>
@@ -47,45 +47,32 @@ void rsm(int nUserNum, User *pUser, bool bAskToSaveMsgs) {
   if (!pUser->HasShortMessage()) {
     return;
   }
-  DataFile<shortmsgrec> file(FilePath(a()->config()->datadir(), SMW_DAT),
-                             File::modeReadWrite | File::modeBinary | File::modeCreateFile);
-  if (!file) {
-    return;
-  }
+  SSM ssm(*a()->config(), *a()->users());
   auto bShownAnyMessage = false;
   auto bShownAllMessages = true;
-  const auto number_of_records = file.number_of_records();
-  shortmsgrec sm{};
-  for (auto cur = 0; cur < number_of_records; cur++) {
-    file.Read(cur, &sm);
-    if (sm.touser == nUserNum && sm.tosys == 0) {
-      bout << "|#9" << sm.message << "\r\n";
-      bool bHandledMessage = false;
-      bShownAnyMessage = true;
-      if (!so() || !bAskToSaveMsgs) {
-        bHandledMessage = true;
-      } else {
-        if (a()->HasConfigFlag(OP_FLAGS_CAN_SAVE_SSM)) {
-          if (!bHandledMessage && bAskToSaveMsgs) {
-            bout << "|#5Would you like to save this notification? ";
-            bHandledMessage = !bin.yesno();
-          }
-        } else {
-          bHandledMessage = true;
+  for (const auto& sm : ssm.messages_for(nUserNum)) {
+    bout << "|#9" << sm.text << "\r\n";
+    bool bHandledMessage = false;
+    bShownAnyMessage = true;
+    if (!so() || !bAskToSaveMsgs) {
+      bHandledMessage = true;
+    } else {
+      if (a()->HasConfigFlag(OP_FLAGS_CAN_SAVE_SSM)) {
+        if (!bHandledMessage && bAskToSaveMsgs) {
+          bout << "|#5Would you like to save this notification? ";
+          bHandledMessage = !bin.yesno();
         }
-
-      }
-      if (bHandledMessage) {
-        sm.touser = 0;
-        sm.tosys = 0;
-        memset(&sm.message, 0, sizeof(sm.message));
-        file.Write(cur, &sm);
       } else {
-        bShownAllMessages = false;
+        bHandledMessage = true;
       }
+
+    }
+    if (bHandledMessage) {
+      ssm.delete_message(sm.slot);
+    } else {
+      bShownAllMessages = false;
     }
   }
-  file.Close();
   received_short_message(true);
   if (bShownAnyMessage) {
     bout.nl();
@@ -96,40 +83,8 @@ void rsm(int nUserNum, User *pUser, bool bAskToSaveMsgs) {
 }
 
 static void SendLocalShortMessage(int usernum, const std::string& messageText) {
-  User user;
-  a()->users()->readuser(&user, usernum);
-  if (!user.IsUserDeleted()) {
-    File file(FilePath(a()->config()->datadir(), SMW_DAT));
-    if (!file.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
-      return;
-    }
-    auto total_msgs_in_file = static_cast<int>(file.length() / sizeof(shortmsgrec));
-    auto new_msg_pos = total_msgs_in_file - 1;
-    shortmsgrec sm{};
-    if (new_msg_pos >= 0) {
-      file.Seek(new_msg_pos * sizeof(shortmsgrec), File::Whence::begin);
-      file.Read(&sm, sizeof(shortmsgrec));
-      while (sm.tosys == 0 && sm.touser == 0 && new_msg_pos > 0) {
-        --new_msg_pos;
-        file.Seek(new_msg_pos * sizeof(shortmsgrec), File::Whence::begin);
-        file.Read(&sm, sizeof(shortmsgrec));
-      }
-      if (sm.tosys != 0 || sm.touser != 0) {
-        new_msg_pos++;
-      }
-    } else {
-      new_msg_pos = 0;
-    }
-    sm.tosys = 0;  // 0 means local
-    sm.touser = static_cast<uint16_t>(usernum);
-    to_char_array(sm.message, messageText);
-    sm.message[80] = '\0';
-    file.Seek(new_msg_pos * sizeof(shortmsgrec), File::Whence::begin);
-    file.Write(&sm, sizeof(shortmsgrec));
-    file.Close();
-    user.SetStatusFlag(User::SMW);
-    a()->users()->writeuser(&user, usernum);
-  }
+  SSM ssm(*a()->config(), *a()->users());
+  ssm.send_local(usernum, messageText);
 }
 
 static void SendRemoteShortMessage(int user_num, int system_num, const std::string& text,
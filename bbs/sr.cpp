@@ -21,6 +21,7 @@
 #include "bbs/bbs.h"
 #include "bbs/crc.h"
 #include "bbs/execexternal.h"
+#include "bbs/prot/crctab.h"
 #include "bbs/srrcv.h"
 #include "bbs/srsend.h"
 #include "bbs/stuffin.h"
@@ -53,18 +54,21 @@ using namespace wwiv::strings;
 
 unsigned char checksum = 0;
 
+// One step of the XModem CRC-16 using the table from crctab.cpp.
+static uint16_t crc16_update(uint16_t c, unsigned char b) {
+  return static_cast<uint16_t>((c << 8) ^ crctab[((c >> 8) ^ b) & 0xff]);
+}
+
 void calc_CRC(unsigned char b) {
   checksum = checksum + b;
+  crc = crc16_update(crc, b);
+}
 
-  crc ^= (static_cast<unsigned short>(b) << 8);
-  for (auto i = 0; i < 8; i++) {
-    if (crc & 0x8000) {
-      crc = crc << 1;
-      crc ^= 0x1021;
-    } else {
-      crc = crc << 1;
-    }
+uint16_t xmodem_crc16(const char* b, std::size_t len, uint16_t crc16) {
+  for (std::size_t i = 0; i < len; i++) {
+    crc16 = crc16_update(crc16, static_cast<unsigned char>(b[i]));
   }
+  return crc16;
 }
 
 
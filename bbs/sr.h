@@ -18,6 +18,8 @@
 #ifndef __INCLUDED_BBS_SR_H__
 #define __INCLUDED_BBS_SR_H__
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <string>
 
@@ -32,6 +34,8 @@ enum class xfertype {
 };
 
 void calc_CRC(unsigned char b);
+/** Returns the XModem CRC-16 of len bytes of b, continuing from crc16. */
+uint16_t xmodem_crc16(const char* b, std::size_t len, uint16_t crc16 = 0);
 char gettimeout(long d, bool *abort);
 int extern_prot(int nProtocolNum, const std::filesystem::path& path, bool bSending);
 bool ok_prot(int nProtocolNum, xfertype xt);
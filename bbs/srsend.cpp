@@ -20,6 +20,7 @@
 #include "common/com.h"
 #include "bbs/crc.h"
 #include "common/datetime.h"
+#include "common/input.h"
 #include "common/remote_io.h"
 #include "bbs/sr.h"
 #include "bbs/xfer.h"
@@ -29,6 +30,7 @@
 #include "fmt/printf.h"
 #include "local_io/keycodes.h"
 #include "sdk/files/file_record.h"
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <string>
@@ -46,57 +48,66 @@ bool NewZModemSendFile(const std::filesystem::path& path);
 // from sr.cpp
 extern unsigned char checksum;
 
-void send_block(char *b, int block_type, bool use_crc, char byBlockNumber) {
-  int nBlockSize = 0;
+// Largest run of blocks handed to the remote in a single write while streaming.
+static constexpr size_t kStreamingWriteSize = 16 * 1024;
+
+void xymodem_frame(std::string& out, const char* b, int block_size, char byBlockNumber,
+                   bool use_crc) {
+  out.push_back(block_size == 1024 ? '\x02' : '\x01');
+  out.push_back(byBlockNumber);
+  out.push_back(static_cast<char>(byBlockNumber ^ 0xff));
+  out.append(b, block_size);
+  if (use_crc) {
+    const auto c = xmodem_crc16(b, block_size);
+    out.push_back(static_cast<char>(c >> 8));
+    out.push_back(static_cast<char>(c & 0x00ff));
+  } else {
+    unsigned char sum = 0;
+    for (auto i = 0; i < block_size; i++) {
+      sum = static_cast<unsigned char>(sum + b[i]);
+    }
+    out.push_back(static_cast<char>(sum));
+  }
+}
 
+void send_block(char *b, int block_type, bool use_crc, char byBlockNumber) {
   a()->CheckForHangup();
   switch (block_type) {
-  case 5:
-    nBlockSize = 128;
-    bout.rputch(1);
-    break;
   case 4:
     bout.rputch('\x81');
     bout.rputch(byBlockNumber);
     bout.rputch(byBlockNumber ^ 0xff);
-    break;
+    return;
   case 3:
     bout.rputch(CX);
-    break;
+    return;
   case 2:
     bout.rputch(4);
-    break;
-  case 1:
-    nBlockSize = 1024;
-    bout.rputch(2);
-    break;
-  case 0:
-    nBlockSize = 128;
-    bout.rputch(1);
-  }
-  if (block_type > 1 && block_type < 5) {
     return;
   }
 
-  bout.rputch(byBlockNumber);
-  bout.rputch(byBlockNumber ^ 0xff);
-  crc = 0;
-  checksum = 0;
-  for (int i = 0; i < nBlockSize; i++) {
-    const char ch = b[i];
-    bout.rputch(ch);
-    calc_CRC(ch);
-  }
-
-  if (use_crc) {
-    bout.rputch(static_cast<char>(crc >> 8));
-    bout.rputch(static_cast<char>(crc & 0x00ff));
-  } else {
-    bout.rputch(checksum);
-  }
+  // Write the whole block at once rather than a byte at a time.
+  std::string frame;
+  frame.reserve(1029);
+  xymodem_frame(frame, b, block_type == 1 ? 1024 : 128, byBlockNumber, use_crc);
+  bout.flush();
+  bout.rputs(frame);
   bout.dump();
 }
 
+// Fills the 128 byte YModem header block for file, which is pos bytes long.
+static void ymodem_header_block(char* b, File& file, long pos,
+                                const wwiv::sdk::files::FileName& file_name) {
+  memset(b, 0, 128);
+  file_name.unaligned_filename().copy(b, 64);
+  // We needed this cast to (long) to compile with XCode 1.5 on OS X
+  const auto sb = fmt::sprintf("%ld %ld", pos, static_cast<long>(file.last_write_time()));
+
+  strcpy(&b[strlen(b) + 1], sb.c_str());
+  b[127] = static_cast<unsigned char>((static_cast<int>(pos + 127) / 128) >> 8);
+  b[126] = static_cast<unsigned char>((static_cast<int>(pos + 127) / 128) & 0x00ff);
+}
+
 char send_b(File &file, long pos, int block_type, char byBlockNumber, bool *use_crc, const wwiv::sdk::files::FileName& file_name,
             int *terr, bool *abort) {
   char b[1025];
@@ -115,15 +126,8 @@ char send_b(File &file, long pos, int block_type, char byBlockNumber, bool *use_
       b[i] = '\0';
     }
   } else if (block_type == 5) {
-    memset(b, 0, 128);
     nb = 128;
-    to_char_array(b, file_name.unaligned_filename());
-    // We needed this cast to (long) to compile with XCode 1.5 on OS X
-    const auto sb = fmt::sprintf("%ld %ld", pos, static_cast<long>(file.last_write_time()));
-
-    strcpy(&b[strlen(b) + 1], sb.c_str());
-    b[127] = static_cast<unsigned char>((static_cast<int>(pos + 127) / 128) >> 8);
-    b[126] = static_cast<unsigned char>((static_cast<int>(pos + 127) / 128) & 0x00ff);
+    ymodem_header_block(b, file, pos, file_name);
   }
   bool done = false;
   int nNumErrors = 0;
@@ -156,7 +160,7 @@ char send_b(File &file, long pos, int block_type, char byBlockNumber, bool *use_
   return CU;
 }
 
-bool okstart(bool *use_crc, bool *abort) {
+bool okstart(bool *use_crc, bool *abort, bool* streaming) {
   auto d = steady_clock::now();
   bool ok = false;
   bool done = false;
@@ -169,6 +173,12 @@ bool okstart(bool *use_crc, bool *abort) {
       ok = true;
       done = true;
     }
+    if (ch == 'G' && streaming != nullptr) {
+      *use_crc = true;
+      *streaming = true;
+      ok = true;
+      done = true;
+    }
     if (ch == CU) {
       *use_crc = false;
       ok = true;
@@ -182,6 +192,68 @@ bool okstart(bool *use_crc, bool *abort) {
   return ok;
 }
 
+/**
+ * Sends the YModem-G header block.  The receiver asks for the data with
+ * another 'G' (some ACK the header first) and never ACKs the data blocks.
+ */
+static char send_streaming_header(File& file, long file_size,
+                                  const wwiv::sdk::files::FileName& file_name, int* terr,
+                                  bool* abort) {
+  char b[128];
+  ymodem_header_block(b, file, file_size, file_name);
+  for (auto tries = 0; tries < 9 && !a()->sess().hangup() && !*abort; tries++) {
+    send_block(b, 5, true, 0);
+    auto ch = gettimeout(5, abort);
+    if (ch == CF) {
+      ch = gettimeout(5, abort);
+    }
+    if (ch == 'G') {
+      return CF;
+    }
+    if (ch == CX) {
+      return CX;
+    }
+    ++(*terr);
+    a()->localIO()->PutsXY(69, 5, std::to_string(*terr));
+  }
+  return CU;
+}
+
+/**
+ * Streams file from *cp to the end without waiting for any ACKs, batching
+ * blocks into large writes.  Since nothing is ever resent the receiver
+ * cancels the transfer with CAN when it sees a bad block.
+ */
+static void stream_blocks(File& file, long* cp, long file_size, char* byBlockNumber,
+                          double tpb, bool* abort) {
+  char b[1024];
+  std::string frames;
+  frames.reserve(kStreamingWriteSize + 1029);
+  file.Seek(*cp, File::Whence::begin);
+  while (*cp < file_size) {
+    a()->CheckForHangup();
+    if (a()->sess().hangup()) {
+      return;
+    }
+    if (bin.bkbhitraw() && bin.bgetchraw() == CX) {
+      *abort = true;
+      return;
+    }
+    frames.clear();
+    while (*cp < file_size && frames.size() < kStreamingWriteSize) {
+      const auto block_size = (file_size - *cp) < 128L ? 128 : 1024;
+      const auto num_read = std::max(0, static_cast<int>(file.Read(b, block_size)));
+      memset(b + num_read, 0, block_size - num_read);
+      xymodem_frame(frames, b, block_size, (*byBlockNumber)++, true);
+      *cp += block_size;
+    }
+    bout.rputs(frames);
+
+    a()->localIO()->PutsXY(65, 3, fmt::sprintf("%ld - %ldk", *cp / 128 + 1, *cp / 1024 + 1));
+    a()->localIO()->PutsXY(65, 1, ctim(std::lround(std::max(0L, file_size - *cp) * tpb)));
+  }
+}
+
 static int GetXYModemBlockSize(bool bBlockSize1K) {
   return bBlockSize1K ? 1024 : 128;
 }
@@ -229,11 +301,13 @@ void xymodem_send(const std::filesystem::path& path, bool *sent, double *percent
   a()->localIO()->PutsXY(65, 2,
                          fmt::format("{} - {}k", (file_size + 127) / 128, bytes_to_k(file_size)));
 
-  if (!okstart(&use_crc, &abort)) {
+  bool streaming = false;
+  if (!okstart(&use_crc, &abort, &streaming)) {
     abort = true;
   }
   if (use_ymodem && !abort && !a()->sess().hangup()) {
-    ch = send_b(file, file_size, 5, 0, &use_crc, fn, &terr, &abort);
+    ch = streaming ? send_streaming_header(file, file_size, fn, &terr, &abort)
+                   : send_b(file, file_size, 5, 0, &use_crc, fn, &terr, &abort);
     if (ch == CX) {
       abort = true;
     }
@@ -243,6 +317,9 @@ void xymodem_send(const std::filesystem::path& path, bool *sent, double *percent
     }
   }
   bool bUse1kBlocks = false;
+  if (streaming && !abort && !a()->sess().hangup()) {
+    stream_blocks(file, &cp, file_size, &byBlockNumber, tpb, &abort);
+  }
   while (!a()->sess().hangup() && !abort && cp < file_size) {
     bUse1kBlocks = (use_ymodem) ? true : false;
     if ((file_size - cp) < 128L) {
@@ -21,11 +21,22 @@
 #include "core/file.h"
 #include "sdk/files/file_record.h"
 #include <filesystem>
+#include <string>
 
+/**
+ * Appends an XModem data block of block_size (128 or 1024) bytes from b to out,
+ * with its header and CRC-16 or checksum.
+ */
+void xymodem_frame(std::string& out, const char* b, int block_size, char byBlockNumber,
+                   bool use_crc);
 void send_block(char *b, int block_type, bool use_crc, char byBlockNumber);
 char send_b(wwiv::core::File& file, long pos, int block_type, char byBlockNumber, bool* use_crc,
             const wwiv::sdk::files::FileName& file_name, int* terr, bool* abort);
-bool okstart(bool *use_crc, bool *abort);
+/**
+ * Waits for the receiver to start the transfer.  When streaming is not null a
+ * 'G' is accepted too, asking for YModem-G (or XModem-1K-G) with no ACKs.
+ */
+bool okstart(bool *use_crc, bool *abort, bool* streaming = nullptr);
 void xymodem_send(const std::filesystem::path& path, bool* sent, double* percent, bool use_crc,
                   bool use_ymodem, bool use_ymodemBatch);
 void zmodem_send(const std::filesystem::path& path, bool *sent, double *percent);
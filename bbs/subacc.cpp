@@ -31,6 +31,7 @@
 #include "core/version.h"
 #include "core/wwivport.h"
 #include "sdk/config.h"
+#include "sdk/latest_qscan.h"
 #include "sdk/status.h"
 #include "sdk/subxtr.h"
 #include "sdk/vardec.h"
@@ -242,6 +243,9 @@ void add_post(postrec* pp) {
   // add the new post
   fileSub->Seek(a()->GetNumMessagesInCurrentMessageArea() * sizeof(postrec), File::Whence::begin);
   fileSub->Write(pp, sizeof(postrec));
+  if (auto* latest = a()->latest_qscan()) {
+    latest->Update(std::filesystem::path(subdat_fn).stem().string(), pp->qscan);
+  }
 
   // we've modified the sub
   a()->subchg = 0;
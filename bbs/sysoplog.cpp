@@ -19,6 +19,7 @@
 #include "bbs/sysoplog.h"
 
 #include "bbs/bbs.h"
+#include "core/async_log.h"
 #include "core/datetime.h"
 #include "core/log.h"
 #include "core/strings.h"
@@ -60,6 +61,9 @@ void catsl() {
   auto temporary_log_filename = GetTemporaryInstanceLogFileName();
   auto instance_logfilename = FilePath(a()->config()->gfilesdir(), temporary_log_filename);
 
+  // Everything logged so far needs to be in the instance log before it moves.
+  AsyncLogWriter::instance().flush();
+  AsyncLogWriter::instance().close_files();
   if (File::Exists(instance_logfilename)) {
     auto basename = GetSysopLogFileName(date());
     File wholeLogFile(FilePath(a()->config()->gfilesdir(), basename));
@@ -102,13 +106,6 @@ void AddLineToSysopLogImpl(int cmd, const string& text) {
 
   switch (cmd) {
   case LOG_STRING: {  // Write line to sysop's log
-    File logFile(s_sysoplog_filename);
-    if (!logFile.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
-      return;
-    }
-    if (logFile.length()) {
-      logFile.Seek(0L, File::Whence::end);
-    }
     string logLine;
     if (midline > 0) {
       logLine = StrCat("\r\n", text);
@@ -117,19 +114,10 @@ void AddLineToSysopLogImpl(int cmd, const string& text) {
       logLine = text;
     }
     logLine += "\r\n";
-    logFile.Write(logLine);
-    logFile.Close();
+    AsyncLogWriter::instance().append(s_sysoplog_filename, logLine);
   }
   break;
   case LOG_CHAR: {
-    File logFile(s_sysoplog_filename);
-    if (!logFile.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
-      // sysop log ?
-      return;
-    }
-    if (logFile.length()) {
-      logFile.Seek(0L, File::Whence::end);
-    }
     string logLine;
     if (midline == 0 || (midline + 2 + text.length()) > 78) {
       logLine = (midline) ? "\r\n   " : "  ";
@@ -139,8 +127,7 @@ void AddLineToSysopLogImpl(int cmd, const string& text) {
       midline += 2 + text.length();
     }
     logLine += text;
-    logFile.Write(logLine);
-    logFile.Close();
+    AsyncLogWriter::instance().append(s_sysoplog_filename, logLine);
   }
   break;
   default: {
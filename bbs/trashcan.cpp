@@ -25,6 +25,10 @@
 #include "sdk/filenames.h"
 #include <algorithm>
 #include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <queue>
 #include <string>
 
 using std::string;
@@ -33,60 +37,175 @@ using namespace wwiv::sdk;
 using namespace wwiv::stl;
 using namespace wwiv::strings;
 
-Trashcan::Trashcan(wwiv::sdk::Config& config)
-    : file_(FilePath(config.gfilesdir(), TRASHCAN_TXT)) {}
+TrashcanMatcher::TrashcanMatcher(const std::vector<std::string>& patterns) {
+  for (const auto& pattern : patterns) {
+    if (pattern.empty()) {
+      continue;
+    }
+    if (!contains(pattern, '*')) {
+      exact_.insert(pattern);
+    } else if (pattern.length() == 1) {
+      // We have 1 char and it is a '*', which matches nothing.
+      continue;
+    } else if (pattern.length() > 2 && pattern.front() == '*' && pattern.back() == '*') {
+      // We have *foo*
+      add(contains_, pattern.substr(1, pattern.length() - 2));
+    } else if (pattern.front() == '*') {
+      auto s = pattern.substr(1);
+      std::reverse(std::begin(s), std::end(s));
+      add(suffix_, s);
+    } else if (pattern.back() == '*') {
+      add(prefix_, pattern.substr(0, pattern.length() - 1));
+    }
+    // Don't have a * at either end, so we don't support that pattern.
+  }
+  build_contains();
+}
 
-Trashcan::~Trashcan() = default;
+void TrashcanMatcher::add(trie_t& trie, const std::string& s) {
+  auto n = 0;
+  for (const auto c : s) {
+    const auto it = trie[n].next.find(c);
+    if (it != std::end(trie[n].next)) {
+      n = it->second;
+      continue;
+    }
+    const auto next = size_int(trie);
+    trie[n].next.emplace(c, next);
+    trie.emplace_back();
+    n = next;
+  }
+  trie[n].terminal = true;
+}
 
-static bool Matches(string whole, string pattern) {
-  if (!contains(pattern, '*')) {
-    return whole == pattern;
+void TrashcanMatcher::build_contains() {
+  // Breadth first so that the fail link of each node's parent is set
+  // before the node itself.
+  std::queue<int> q;
+  for (const auto& [c, child] : contains_[0].next) {
+    q.push(child);
   }
+  while (!q.empty()) {
+    const auto n = q.front();
+    q.pop();
+    for (const auto& [c, child] : contains_[n].next) {
+      auto f = contains_[n].fail;
+      while (f != 0 && !contains_[f].next.count(c)) {
+        f = contains_[f].fail;
+      }
+      const auto it = contains_[f].next.find(c);
+      contains_[child].fail = it != std::end(contains_[f].next) ? it->second : 0;
+      if (contains_[contains_[child].fail].terminal) {
+        contains_[child].terminal = true;
+      }
+      q.push(child);
+    }
+  }
+}
 
-  if (pattern.length() == 1) {
-    // We have 1 char and it is a '*'.
-    return false;
+bool TrashcanMatcher::matches_prefix(const trie_t& trie, const std::string& name) {
+  auto n = 0;
+  for (const auto c : name) {
+    const auto it = trie[n].next.find(c);
+    if (it == std::end(trie[n].next)) {
+      return false;
+    }
+    n = it->second;
+    if (trie[n].terminal) {
+      return true;
+    }
   }
-  StringUpperCase(&pattern);
-  if ((pattern.length() > 2) && pattern.front() == '*' && pattern.back() == '*') {
-    // We have *foo*
-    auto s = pattern.substr(1);
-    s.pop_back();
-    return whole.find(s) != string::npos;
-  } else if (pattern.front() == '*') {
-    return ends_with(whole, pattern.substr(1));
-  } else if (pattern.back() == '*') {
-    auto s = pattern;
-    s.pop_back();
-    return starts_with(whole, s);
-  } else {
-    // Don't have a * at either end, so we don't support that pattern.
-    return false;
+  return false;
+}
+
+bool TrashcanMatcher::matches_contains(const std::string& name) const {
+  auto n = 0;
+  for (const auto c : name) {
+    auto it = contains_[n].next.find(c);
+    while (n != 0 && it == std::end(contains_[n].next)) {
+      n = contains_[n].fail;
+      it = contains_[n].next.find(c);
+    }
+    n = it != std::end(contains_[n].next) ? it->second : 0;
+    if (contains_[n].terminal) {
+      return true;
+    }
   }
+  return false;
 }
 
-bool Trashcan::IsTrashName(const std::string& rawname) {
-  if (!File::Exists(file_.path())) {
-    return false;
+bool TrashcanMatcher::Matches(const std::string& name) const {
+  if (exact_.count(name)) {
+    return true;
   }
-  // Gotta have a name to be in the trashcan.
-  if (rawname.empty()) {
-    return false;
+  if (matches_prefix(prefix_, name)) {
+    return true;
   }
-  TextFile file(file_.path(), "rt");
-  if (!file.IsOpen()) {
-    return false;
+  if (matches_prefix(suffix_, std::string(name.rbegin(), name.rend()))) {
+    return true;
   }
+  return matches_contains(name);
+}
+
+namespace {
 
-  const auto name{ToStringUpperCase(rawname)};
+/** The compiled trashcan.txt, shared by every Trashcan in the process */
+struct trashcan_cache_t {
+  std::mutex mu;
+  std::filesystem::path path;
+  time_t mtime{0};
+  std::uintmax_t size{0};
+  std::shared_ptr<const TrashcanMatcher> matcher;
+};
+
+/**
+ * Returns the matcher for path, only reading the file again when it has
+ * been modified since the last time it was loaded.
+ */
+std::shared_ptr<const TrashcanMatcher> LoadMatcher(const std::filesystem::path& path) {
+  static trashcan_cache_t cache;
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return nullptr;
+  }
+  const auto mtime = File::last_write_time(path);
 
-  string line;
-  while (file.ReadLine(&line)) {
+  std::lock_guard<std::mutex> lock(cache.mu);
+  if (cache.matcher && cache.path == path && cache.mtime == mtime && cache.size == size) {
+    return cache.matcher;
+  }
+
+  TextFile file(path, "rt");
+  if (!file.IsOpen()) {
+    return nullptr;
+  }
+  auto lines = file.ReadFileIntoVector();
+  for (auto& line : lines) {
     StringUpperCase(&line);
-    if (Matches(name, line)) {
-      return true;
-    }
   }
+  cache.matcher = std::make_shared<const TrashcanMatcher>(lines);
+  cache.path = path;
+  cache.mtime = mtime;
+  cache.size = size;
+  return cache.matcher;
+}
 
-  return false;
+} // namespace
+
+Trashcan::Trashcan(wwiv::sdk::Config& config)
+    : file_(FilePath(config.gfilesdir(), TRASHCAN_TXT)) {}
+
+Trashcan::~Trashcan() = default;
+
+bool Trashcan::IsTrashName(const std::string& rawname) {
+  // Gotta have a name to be in the trashcan.
+  if (rawname.empty()) {
+    return false;
+  }
+  const auto matcher = LoadMatcher(file_.path());
+  if (!matcher) {
+    return false;
+  }
+  return matcher->Matches(ToStringUpperCase(rawname));
 }
@@ -18,9 +18,46 @@
 #ifndef __INCLUDED_BBS_TRASHCAN_H__
 #define __INCLUDED_BBS_TRASHCAN_H__
 
-#include <string>
 #include "core/file.h"
 #include "sdk/config.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * All of the patterns from trashcan.txt, compiled so that a name can be
+ * checked against every pattern in one pass over the name.
+ *
+ * Patterns are one of NAME, *NAME, NAME* or *NAME*, and must already be
+ * uppercase, as must the names passed to Matches.
+ */
+class TrashcanMatcher {
+public:
+  explicit TrashcanMatcher(const std::vector<std::string>& patterns);
+  [[nodiscard]] bool Matches(const std::string& name) const;
+
+private:
+  struct node_t {
+    std::unordered_map<char, int> next;
+    // Longest proper suffix of this node that is also in the trie (for *NAME*).
+    int fail{0};
+    // A pattern ends here (or, for *NAME*, at a node reachable via fail).
+    bool terminal{false};
+  };
+  using trie_t = std::vector<node_t>;
+
+  static void add(trie_t& trie, const std::string& s);
+  void build_contains();
+  [[nodiscard]] static bool matches_prefix(const trie_t& trie, const std::string& name);
+  [[nodiscard]] bool matches_contains(const std::string& name) const;
+
+  std::unordered_set<std::string> exact_;
+  trie_t prefix_{1};
+  // Holds the reversed suffixes, so that the name is walked backwards.
+  trie_t suffix_{1};
+  trie_t contains_{1};
+};
 
 class Trashcan {
 public:
@@ -40,6 +40,7 @@
 #include "local_io/wconstants.h"
 #include "sdk/config.h"
 #include "sdk/files/arc.h"
+#include "sdk/files/file_catalog.h"
 #include "sdk/files/files.h"
 #include <string>
 #include <vector>
@@ -455,6 +456,18 @@ void nscanall() {
   }
 }
 
+wwiv::sdk::files::FileCatalog& file_catalog() {
+  auto& catalog = a()->fileapi()->catalog();
+  catalog.Refresh();
+  for (const auto& ud : a()->udir) {
+    const auto& d = a()->dirs()[ud.subnum];
+    if (!catalog.has_area(d.filename)) {
+      a()->fileapi()->IndexArea(d);
+    }
+  }
+  return catalog;
+}
+
 void searchall() {
   if (okansi()) {
     listfiles_plus(LP_SEARCH_ALL);
@@ -479,10 +492,18 @@ void searchall() {
   bout.nl();
   bout << "|#2Searching ";
   bout.clear_lines_listed();
+  // Only open the directories the catalog says have a match.
+  const auto& catalog = file_catalog();
+  const auto matching_areas = catalog.AreasMatching(filemask);
   int count = 0;
   int color = 3;
   for (auto i = 0; i < size_int(a()->udir) && !abort && !a()->sess().hangup(); i++) {
     const int nDirNum = a()->udir[i].subnum;
+    const auto& dir = a()->dirs()[nDirNum];
+    if (catalog.has_area(dir.filename) &&
+        matching_areas.count(ToStringUpperCase(dir.filename)) == 0) {
+      continue;
+    }
     // ReSharper disable once CppInitializedValueIsAlwaysRewritten
     bool bIsDirMarked =  a()->sess().qsc_n[nDirNum / 32] & (1L << (nDirNum % 32));
     bIsDirMarked = true;
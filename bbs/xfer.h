@@ -26,6 +26,7 @@ namespace wwiv {
 namespace sdk {
 namespace files {
 struct directory_t;
+class FileCatalog;
 }
 }
 }
@@ -49,6 +50,11 @@ void listfiles();
 void nscandir(uint16_t nDirNum, bool& need_title, bool* abort);
 void nscanall();
 void searchall();
+/**
+ * Returns the up to date file catalog, first indexing any of the user's
+ * directories that are not in it yet.
+ */
+wwiv::sdk::files::FileCatalog& file_catalog();
 int recno(const std::string& file_mask);
 int nrecno(const std::string& file_mask, int start_recno);
 int printfileinfo(const uploadsrec* u, const wwiv::sdk::files::directory_t& dir);
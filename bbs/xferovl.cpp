@@ -697,7 +697,11 @@ void remove_from_file_database(const std::string& file_name) {
 
 bool is_uploadable(const std::string& file_name) {
   files::Allow allow(*a()->config());
-  return allow.IsAllowed(file_name);
+  if (!allow.IsAllowed(file_name)) {
+    return false;
+  }
+  // Reject files already in any of the directories.
+  return file_catalog().FindFile(files::align(file_name)).empty();
 }
 
 static void l_config_nscan() {
@@ -226,19 +226,31 @@ bool get_file_idz(FileRecord& fr, const directory_t& dir) {
     return false;
   }
 
-  fr.set_date(DateTime::from_time_t(File::last_write_time(FilePath(dir.path, fr))));
-  auto o = PathToTempdDiz(FilePath(dir.path, fr));
-  if (!o) {
-    return true;
+  const auto archive = FilePath(dir.path, fr);
+  fr.set_date(DateTime::from_time_t(File::last_write_time(archive)));
+  DizParser dp(a()->HasConfigFlag(OP_FLAGS_IDZ_DESC));
+  // Read it straight out of the archive when we can, otherwise use the archiver.
+  auto in_archive = dp.parse_archive(archive);
+  auto odiz = std::move(in_archive.diz);
+  auto diz_name = in_archive.filename;
+  if (in_archive.handled) {
+    if (diz_name.empty()) {
+      return true;
+    }
+  } else {
+    auto o = PathToTempdDiz(archive);
+    if (!o) {
+      return true;
+    }
+    diz_name = o.value().filename().string();
+    if (auto parsed = dp.parse(o.value())) {
+      odiz.emplace(parsed.value());
+    }
   }
-  const auto diz_fn = o.value();
   bout.nl();
-  bout << "|#9Reading in |#2" << diz_fn.filename() << "|#9 as extended description...";
+  bout << "|#9Reading in |#2" << diz_name << "|#9 as extended description...";
   const auto old_ext = a()->current_file_area()->ReadExtendedDescriptionAsString(fr).value_or("");
 
-  DizParser dp(a()->HasConfigFlag(OP_FLAGS_IDZ_DESC));
-  auto odiz = dp.parse(diz_fn);
-
   if (odiz.has_value()) {
     auto& diz = odiz.value();
     fr.set_description(diz.description());
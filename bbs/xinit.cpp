@@ -46,6 +46,7 @@
 #include "sdk/config.h"
 #include "sdk/filenames.h"
 #include "sdk/gfiles.h"
+#include "sdk/latest_qscan.h"
 #include "sdk/names.h"
 #include "sdk/status.h"
 #include "sdk/subxtr.h"
@@ -386,6 +387,7 @@ bool Application::ReadConfig() {
   // initialize the user manager
   user_manager_.reset(new UserManager(*config_));
   statusMgr.reset(new StatusMgr(config_->datadir(), StatusManagerCallback));
+  latest_qscan_ = std::make_unique<LatestQScan>(config_->datadir());
 
   IniFile ini(FilePath(bbspath(), WWIV_INI), {StrCat("WWIV-", instance_number()), INI_TAG});
   if (!ini.IsOpen()) {
@@ -24,6 +24,7 @@
 #include "bbs/basic/util.h"
 #include "bbs_test/bbs_helper.h"
 #include "core/log.h"
+#include "core/scope_exit.h"
 #include "core/strings.h"
 #include "core/version.h"
 #include "deps/fmt/test/gmock/gmock.h"
@@ -331,3 +332,33 @@ PrintList (lines)
   const auto actual = SplitString(helper.io()->captured(), "\r\n", true);
   EXPECT_THAT(actual, testing::ElementsAre("1", "2", "3"));
 }
+
+TEST_F(BasicTest, RunScript_ClosesInterpreter) {
+  Basic b(bin, bout, *a()->config(), ctx.get());
+  ASSERT_NE(nullptr, b.bas());
+  ASSERT_TRUE(b.RunScript("test", "print \"Hello World\""));
+  // RunScript closes the interpreter, so ~Basic must not close it again.
+  EXPECT_EQ(nullptr, b.bas());
+  EXPECT_EQ("Hello World", StringTrim(helper.io()->captured()));
+}
+
+TEST_F(BasicTest, Destructor_ClosesUnusedInterpreter) {
+  // ~Basic closes the interpreter when no script was run.
+  auto b = std::make_unique<Basic>(bin, bout, *a()->config(), ctx.get());
+  ASSERT_NE(nullptr, b->bas());
+  b.reset();
+}
+
+TEST_F(BasicTest, RunScript_SteppedHandler) {
+  // The stepped handler is only installed when VLOG(2) is on.
+  wwiv::core::Logger::set_cmdline_verbosity(2);
+  wwiv::core::ScopeExit at_exit([] { wwiv::core::Logger::set_cmdline_verbosity(0); });
+  basic.reset(new Basic(bin, bout, *a()->config(), ctx.get()));
+
+  ASSERT_TRUE(RunScript(R"(
+a = 1
+a = a + 1
+print a
+)"));
+  EXPECT_EQ("2", StringTrim(helper.io()->captured()));
+}
@@ -20,15 +20,19 @@
 
 #include "bbs/basic/util.h"
 #include "bbs_test/bbs_helper.h"
+#include "common/input.h"
+#include "common/output.h"
 #include "core/stl.h"
 #include "core/strings.h"
 #include "deps/my_basic/core/my_basic.h"
 #include <iostream>
 #include <string>
+#include <thread>
 
 using std::cout;
 using std::endl;
 using std::string;
+using namespace wwiv::common;
 using namespace wwiv::stl;
 using namespace wwiv::bbs::basic;
 
@@ -46,3 +50,26 @@ TEST(BasicUtilTest, MakeReal) {
   const auto s = wwiv_mb_make_real(1234);
   EXPECT_FLOAT_EQ(1234.0, s.value.float_point);
 }
+
+TEST(BasicUtilTest, ScriptIO_PerThread) {
+  Input in1;
+  Output out1;
+  set_script_in(&in1);
+  set_script_out(&out1);
+
+  std::thread t([] {
+    Input in2;
+    Output out2;
+    set_script_in(&in2);
+    set_script_out(&out2);
+    EXPECT_EQ(&in2, &script_in());
+    EXPECT_EQ(&out2, &script_out());
+  });
+  t.join();
+
+  // Setting the script I/O on the other thread does not change this one.
+  EXPECT_EQ(&in1, &script_in());
+  EXPECT_EQ(&out1, &script_out());
+  set_script_in(nullptr);
+  set_script_out(nullptr);
+}
@@ -0,0 +1,97 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "fsed/line.h"
+#include <string>
+
+using namespace wwiv::fsed;
+
+TEST(FsedLineTest, Construct_WithHeartCodes) {
+  const line_t l("a\x03" "1bc\x03" "2d");
+  EXPECT_EQ("abcd", l.text());
+  ASSERT_EQ(3u, l.colors().size());
+  EXPECT_EQ(0, l.color_at(0));
+  EXPECT_EQ(1, l.color_at(1));
+  EXPECT_EQ(1, l.color_at(2));
+  EXPECT_EQ(2, l.color_at(3));
+  EXPECT_EQ('c', l.cell(2).ch);
+  EXPECT_EQ(2, l.wwiv_color());
+}
+
+TEST(FsedLineTest, Add_InsertAndOverwrite) {
+  line_t l;
+  l.set_wwiv_color(1);
+  for (const auto c : std::string("abc")) {
+    l.add(static_cast<int>(l.size()), c, ins_ovr_mode_t::ins);
+  }
+  EXPECT_EQ(1u, l.colors().size());
+
+  l.set_wwiv_color(2);
+  EXPECT_EQ(line_add_result_t::needs_redraw, l.add(1, 'X', ins_ovr_mode_t::ins));
+  EXPECT_EQ("aXbc", l.text());
+  EXPECT_EQ(3u, l.colors().size());
+  EXPECT_EQ(1, l.color_at(2));
+
+  l.set_wwiv_color(1);
+  EXPECT_EQ(line_add_result_t::no_redraw, l.add(1, 'Y', ins_ovr_mode_t::ovr));
+  EXPECT_EQ("aYbc", l.text());
+  // The runs merge back together.
+  EXPECT_EQ(1u, l.colors().size());
+
+  l.add(6, 'Z', ins_ovr_mode_t::ins);
+  EXPECT_EQ("aYbc  Z", l.text());
+}
+
+TEST(FsedLineTest, Del) {
+  line_t l("a\x03" "1b\x03" "2c");
+  EXPECT_EQ(line_add_result_t::needs_redraw, l.del(1, ins_ovr_mode_t::ins));
+  EXPECT_EQ("ac", l.text());
+  EXPECT_EQ(2u, l.colors().size());
+  EXPECT_EQ(0, l.wwiv_color());
+  EXPECT_EQ(line_add_result_t::error, l.del(2, ins_ovr_mode_t::ins));
+  EXPECT_EQ(line_add_result_t::needs_redraw, l.bs(2, ins_ovr_mode_t::ins));
+  EXPECT_EQ("a", l.text());
+  EXPECT_EQ(1u, l.colors().size());
+}
+
+TEST(FsedLineTest, SubstrAndAppend) {
+  const line_t l("ab\x03" "1cd\x03" "2ef");
+  const auto mid = l.substr(1, 5);
+  EXPECT_EQ("bcde", mid.text());
+  EXPECT_EQ(0, mid.color_at(0));
+  EXPECT_EQ(1, mid.color_at(1));
+  EXPECT_EQ(2, mid.color_at(3));
+
+  line_t a = l.substr(0, 2);
+  a.append(l.substr(2));
+  EXPECT_EQ(l.text(), a.text());
+  EXPECT_EQ(l.to_colored_text(-1), a.to_colored_text(-1));
+  EXPECT_EQ(2, a.wwiv_color());
+
+  line_t b;
+  b.assign(l.substr(3));
+  EXPECT_EQ("def", b.text());
+  EXPECT_EQ(2, b.wwiv_color());
+}
+
+TEST(FsedLineTest, ToColoredText) {
+  const line_t l("\x03" "1ab\x03" "2c");
+  EXPECT_EQ("\x03" "1ab\x03" "2c\x03" "0", l.to_colored_text(-1));
+  EXPECT_EQ("abc", line_t("abc").to_colored_text(0));
+}
@@ -0,0 +1,68 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*           Copyright (C)2007-2020, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "bbs/crc.h"
+#include "bbs/sr.h"
+#include "bbs/srsend.h"
+#include <string>
+
+TEST(SrSendTest, XModemCrc16) {
+  const std::string s = "123456789";
+  EXPECT_EQ(0x31c3, xmodem_crc16(s.data(), s.size()));
+  // Continues from a previous crc.
+  EXPECT_EQ(0x31c3, xmodem_crc16(s.data() + 4, 5, xmodem_crc16(s.data(), 4)));
+
+  crc = 0;
+  for (const auto ch : s) {
+    calc_CRC(static_cast<unsigned char>(ch));
+  }
+  EXPECT_EQ(0x31c3, crc);
+}
+
+TEST(SrSendTest, XYModemFrame_Crc) {
+  const std::string data(1024, '\xff');
+  std::string frame;
+  xymodem_frame(frame, data.data(), 1024, 3, true);
+  ASSERT_EQ(1029u, frame.size());
+  EXPECT_EQ('\x02', frame[0]);
+  EXPECT_EQ('\x03', frame[1]);
+  EXPECT_EQ('\xfc', frame[2]);
+  EXPECT_EQ(data, frame.substr(3, 1024));
+  const auto c = xmodem_crc16(data.data(), data.size());
+  EXPECT_EQ(static_cast<char>(c >> 8), frame[1027]);
+  EXPECT_EQ(static_cast<char>(c & 0xff), frame[1028]);
+
+  // Frames are appended so several blocks can be written at once.
+  xymodem_frame(frame, data.data(), 128, 4, true);
+  ASSERT_EQ(1029u + 133u, frame.size());
+  EXPECT_EQ('\x01', frame[1029]);
+  EXPECT_EQ('\x04', frame[1030]);
+}
+
+TEST(SrSendTest, XYModemFrame_Checksum) {
+  std::string data(128, '\0');
+  data[0] = '\x80';
+  data[1] = '\x81';
+  std::string frame;
+  xymodem_frame(frame, data.data(), 128, 1, false);
+  ASSERT_EQ(132u, frame.size());
+  EXPECT_EQ('\x01', frame[0]);
+  EXPECT_EQ('\x01', frame[131]);
+}
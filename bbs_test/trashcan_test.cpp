@@ -20,6 +20,7 @@
 
 #include "bbs/trashcan.h"
 #include "bbs_test/bbs_helper.h"
+#include "core/file.h"
 #include "core/strings.h"
 #include "sdk/filenames.h"
 
@@ -28,6 +29,7 @@ using std::endl;
 using std::ostringstream;
 using std::string;
 
+using namespace wwiv::core;
 using namespace wwiv::strings;
 
 class TrashcanTest : public testing::Test {
@@ -63,3 +65,35 @@ TEST_F(TrashcanTest, SimpleCase) {
   EXPECT_FALSE(t.IsTrashName("dude"));
   EXPECT_FALSE(t.IsTrashName("a"));
 }
+
+TEST_F(TrashcanTest, ReloadsWhenChanged) {
+  Trashcan t(*a()->config());
+  EXPECT_FALSE(t.IsTrashName("dude"));
+
+  const auto path = helper.files().CreateTempFile(StrCat("gfiles/", TRASHCAN_TXT), "dude\n*ood*\n");
+  // Make sure the change is seen even within the same second.
+  File f(path);
+  f.set_last_write_time(File::last_write_time(path) + 10);
+  EXPECT_TRUE(t.IsTrashName("dude"));
+  EXPECT_TRUE(t.IsTrashName("goodies"));
+  EXPECT_FALSE(t.IsTrashName("all"));
+}
+
+TEST(TrashcanMatcherTest, Patterns) {
+  const TrashcanMatcher m({"SYSOP", "*", "**", "GUEST*", "*BOT", "*SHE*", "*HERS*", "*ABCD*", "*BC*X"});
+  EXPECT_TRUE(m.Matches("SYSOP"));
+  EXPECT_FALSE(m.Matches("SYSOPS"));
+  EXPECT_TRUE(m.Matches("GUEST"));
+  EXPECT_TRUE(m.Matches("GUESTS"));
+  EXPECT_FALSE(m.Matches("GUES"));
+  EXPECT_TRUE(m.Matches("ROBOT"));
+  EXPECT_FALSE(m.Matches("ROBOTS"));
+  EXPECT_TRUE(m.Matches("USHERS"));
+  EXPECT_TRUE(m.Matches("ASHE"));
+  // Needs the fail links to find BCD after ABC.
+  EXPECT_FALSE(m.Matches("ABCX"));
+  EXPECT_TRUE(m.Matches("ABABCD"));
+  EXPECT_TRUE(m.Matches("NAME*"));
+  EXPECT_FALSE(m.Matches("BOB"));
+  EXPECT_FALSE(m.Matches(""));
+}
@@ -0,0 +1,204 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+// XModem/YModem sender throughput over a loopback socket, see
+// core_test/benchmark_main.cpp.  Each op sends 1MiB to a receiver thread
+// that ACKs each block unless streaming.
+
+#include "bbs/srsend.h"
+#include "core/net.h"
+#include "core_test/benchmark.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+
+using namespace wwiv::core;
+using namespace wwiv::core::test;
+
+namespace {
+
+constexpr int kDataSize = 1024 * 1024;
+constexpr int kStreamingWriteSize = 16 * 1024;
+constexpr char ACK = 6;
+
+const std::string& data() {
+  static const std::string d = [] {
+    std::string s;
+    uint32_t seed = 1;
+    for (auto i = 0; i < kDataSize; i++) {
+      seed = seed * 1103515245 + 12345;
+      s.push_back(static_cast<char>(seed >> 16));
+    }
+    return s;
+  }();
+  return d;
+}
+
+void set_nodelay(SOCKET s) {
+  int one = 1;
+  setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char*>(&one), sizeof(one));
+}
+
+// A connected pair of blocking TCP sockets on 127.0.0.1.
+class Loopback {
+public:
+  Loopback() {
+    InitializeSockets();
+    const auto listener = CreateListenSocket(0);
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sender = socket(AF_INET, SOCK_STREAM, 0);
+    connect(sender, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    receiver = accept(listener, nullptr, nullptr);
+    closesocket(listener);
+    set_nodelay(sender);
+    set_nodelay(receiver);
+  }
+  ~Loopback() {
+    closesocket(sender);
+    closesocket(receiver);
+  }
+
+  SOCKET sender{INVALID_SOCKET};
+  SOCKET receiver{INVALID_SOCKET};
+};
+
+Loopback& loopback() {
+  static Loopback l;
+  return l;
+}
+
+void send_all(SOCKET s, const char* b, int size) {
+  while (size > 0) {
+    const auto n = send(s, b, size, 0);
+    if (n <= 0) {
+      return;
+    }
+    b += n;
+    size -= n;
+  }
+}
+
+void recv_all(SOCKET s, char* b, int size) {
+  while (size > 0) {
+    const auto n = recv(s, b, size, 0);
+    if (n <= 0) {
+      return;
+    }
+    b += n;
+    size -= n;
+  }
+}
+
+// Reads num_blocks frames of frame_size, ACKing each one when ack_each is set
+// and only the last one otherwise.
+void receive(int frame_size, int num_blocks, bool ack_each) {
+  std::string b(frame_size, '\0');
+  for (auto i = 0; i < num_blocks; i++) {
+    recv_all(loopback().receiver, &b[0], frame_size);
+    if (ack_each || i == num_blocks - 1) {
+      send_all(loopback().receiver, &ACK, 1);
+    }
+  }
+}
+
+char wait_for_ack() {
+  char ch = 0;
+  recv(loopback().sender, &ch, 1, 0);
+  return ch;
+}
+
+// The CRC as calc_CRC computed it, a bit at a time.
+unsigned short legacy_crc(unsigned short crc, unsigned char b) {
+  crc ^= static_cast<unsigned short>(b) << 8;
+  for (auto i = 0; i < 8; i++) {
+    crc = (crc & 0x8000) ? static_cast<unsigned short>((crc << 1) ^ 0x1021)
+                         : static_cast<unsigned short>(crc << 1);
+  }
+  return crc;
+}
+
+// XModem-CRC as sent before: 128 byte blocks written a byte at a time, waiting
+// for an ACK after each block.
+void legacy_xmodem() {
+  const auto& d = data();
+  std::thread r(receive, 133, kDataSize / 128, true);
+  char block_number = 1;
+  for (auto pos = 0; pos < kDataSize; pos += 128) {
+    const char header[] = {1, block_number, static_cast<char>(block_number ^ 0xff)};
+    for (const auto ch : header) {
+      send_all(loopback().sender, &ch, 1);
+    }
+    unsigned short crc = 0;
+    for (auto i = 0; i < 128; i++) {
+      const auto ch = d[pos + i];
+      send_all(loopback().sender, &ch, 1);
+      crc = legacy_crc(crc, static_cast<unsigned char>(ch));
+    }
+    const char trailer[] = {static_cast<char>(crc >> 8), static_cast<char>(crc & 0xff)};
+    for (const auto ch : trailer) {
+      send_all(loopback().sender, &ch, 1);
+    }
+    benchmark_sink = wait_for_ack();
+    ++block_number;
+  }
+  r.join();
+}
+
+// YModem with each 1K block written at once, still waiting for each ACK.
+void ymodem_1k() {
+  const auto& d = data();
+  std::thread r(receive, 1029, kDataSize / 1024, true);
+  std::string frame;
+  char block_number = 1;
+  for (auto pos = 0; pos < kDataSize; pos += 1024) {
+    frame.clear();
+    xymodem_frame(frame, d.data() + pos, 1024, block_number++, true);
+    send_all(loopback().sender, frame.data(), static_cast<int>(frame.size()));
+    benchmark_sink = wait_for_ack();
+  }
+  r.join();
+}
+
+// YModem-G, with 1K blocks batched into large writes and no ACKs.
+void ymodem_g() {
+  const auto& d = data();
+  std::thread r(receive, 1029, kDataSize / 1024, false);
+  std::string frames;
+  char block_number = 1;
+  for (auto pos = 0; pos < kDataSize;) {
+    frames.clear();
+    while (pos < kDataSize && static_cast<int>(frames.size()) < kStreamingWriteSize) {
+      xymodem_frame(frames, d.data() + pos, 1024, block_number++, true);
+      pos += 1024;
+    }
+    send_all(loopback().sender, frames.data(), static_cast<int>(frames.size()));
+  }
+  // Wait for the receiver as the EOT would.
+  benchmark_sink = wait_for_ack();
+  r.join();
+}
+
+const BenchmarkRegistrar registrar({
+    {"xmodem_crc_loopback/legacy (bytewise, ack per 128)", legacy_xmodem, kDataSize},
+    {"ymodem_loopback/1k (ack per block)", ymodem_1k, kDataSize},
+    {"ymodem_g_loopback/1k (streaming)", ymodem_g, kDataSize},
+});
+
+} // namespace
@@ -22,13 +22,15 @@
 #include "binkp/cram.h"
 #include "binkp/file_manager.h"
 #include "binkp/net_log.h"
+#include "binkp/partial_files.h"
 #include "binkp/transfer_file.h"
 #include "core/connection.h"
-#include "core/crc32.h"
 #include "core/datetime.h"
 #include "core/file.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/os.h"
+#include "core/scope_exit.h"
 #include "core/socket_exceptions.h"
 #include "core/stl.h"
 #include "core/strings.h"
@@ -38,6 +40,7 @@
 #include "sdk/net/callout.h"
 #include "sdk/net/contact.h"
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstring>
 #include <functional>
@@ -126,6 +129,18 @@ bool BinkP::process_opt(const std::string& opt) {
       } else {
         LOG(INFO) << "       Not enabling CRC support (disabled in net.ini).";
       }
+    } else if (s == "NR") {
+      LOG(INFO) << "       Remote side is in non-reliable (NR) mode.";
+      remote_nr_ = true;
+    } else if (s == "EXTCMD") {
+      remote_extcmd_ = true;
+    } else if (s == "GZ") {
+      if (config_->gz()) {
+        LOG(INFO) << "       Enabling GZ compression";
+        remote_gz_ = true;
+      } else {
+        LOG(INFO) << "       Not enabling GZ compression (disabled in net.ini).";
+      }
     } else {
       LOG(INFO) << "       Unknown OPT: '" << s << "'";
     }
@@ -220,11 +235,36 @@ bool BinkP::process_data(int16_t length, duration<double> d) {
       << "RECV:  DATA PACKET; ** unexpected size** len: " << s.size() << "; expected: " << length
       << " duration:" << wwiv::core::to_string(d);
   if (!current_receive_file_) {
+    if (skip_data_) {
+      // Data sent before the remote saw our M_GET.
+      VLOG(2) << "       skipping data packet while waiting for M_FILE";
+      return true;
+    }
     LOG(ERROR) << "ERROR: Received M_DATA with no current file.";
     return false;
   }
-  current_receive_file_->WriteChunk(s);
-  if (current_receive_file_->length() >= current_receive_file_->expected_length()) {
+  if (!current_receive_file_->WriteChunk(s)) {
+    LOG(ERROR) << "ERROR: Unable to write data for: " << current_receive_file_->filename();
+  }
+  if (current_receive_file_->wrong_length()) {
+    // Never accept a short or overlong file. Skip it so the remote sends it
+    // again in a later session.
+    LOG(ERROR) << "ERROR: Compressed data for: " << current_receive_file_->filename() << " is "
+               << current_receive_file_->length() << " bytes; expected: "
+               << current_receive_file_->expected_length();
+    const auto skip_line =
+        fmt::format("{} {} {}", current_receive_file_->filename(),
+                    current_receive_file_->expected_length(), current_receive_file_->timestamp());
+    PartialFiles partials(config_->partial_dir(remote_.network_name()));
+    partials.Remove(current_receive_file_->filename());
+    current_receive_file_->Delete();
+    current_receive_file_.reset();
+    // Ignore the rest of this file's data frames.
+    skip_data_ = true;
+    send_command_packet(BinkpCommands::M_SKIP, skip_line);
+    return true;
+  }
+  if (current_receive_file_->complete()) {
     LOG(INFO) << "       file finished; bytes_received: " << current_receive_file_->length();
 
     auto data_line =
@@ -245,24 +285,21 @@ bool BinkP::process_data(int16_t length, duration<double> d) {
       LOG(ERROR) << "Failed to close file: " << current_receive_file_->filename();
     }
 
-    // If we have a crc; check it.
+    // If we have a crc; check it.  It's computed as each chunk arrives.
     if (crc_ && crc != 0) {
-      const auto rdir = config_->receive_dir(remote_.network_name());
-      const auto dir = File::absolute(config_->config().root_directory(), rdir);
-      const File received_file(FilePath(dir, current_receive_file_->filename()));
-      const auto file_crc = crc32file(received_file.path());
-      if (file_crc == 0) {
-        LOG(ERROR) << "Error calculating CRC32 of: " << current_receive_file_->filename();
-      } else {
-        if (file_crc != current_receive_file_->crc()) {
-          // TODO(rushfan): Once we're sure this works, make it mark the file bad.
-          LOG(ERROR) << "Wrong CRC32 of: " << current_receive_file_->filename()
-                     << "; expected: " << std::hex << current_receive_file_->crc()
-                     << "; actual: " << std::hex << file_crc;
-        }
+      const auto file_crc = current_receive_file_->received_crc();
+      if (file_crc != current_receive_file_->crc()) {
+        // TODO(rushfan): Once we're sure this works, make it mark the file bad.
+        LOG(ERROR) << "Wrong CRC32 of: " << current_receive_file_->filename()
+                   << "; expected: " << std::hex << current_receive_file_->crc()
+                   << "; actual: " << std::hex << file_crc;
       }
     }
 
+    // Remove the descriptor left if this file was resumed.
+    PartialFiles partials(config_->partial_dir(remote_.network_name()));
+    partials.Remove(current_receive_file_->filename());
+
     file_manager_->ReceiveFile(current_receive_file_->filename());
 
     // Delete the reference to this file and signal the other side we received it.
@@ -359,6 +396,18 @@ bool BinkP::send_data_packet(const char* data, int packet_length) {
   return true;
 }
 
+bool BinkP::send_data_packets(const std::string& data) {
+  // Compressed data may be a little larger than the chunk it came from.
+  const auto max_frame_size = 16384;
+  for (auto start = 0; start < ssize(data); start += max_frame_size) {
+    const auto size = min<int>(max_frame_size, ssize(data) - start);
+    if (!send_data_packet(data.data() + start, size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 BinkState BinkP::ConnInit() {
   VLOG(1) << "STATE: ConnInit";
   process_frames(seconds(2));
@@ -391,6 +440,12 @@ BinkState BinkP::WaitConn() {
   if (config_->crc()) {
     send_command_packet(BinkpCommands::M_NUL, "OPT CRC");
   }
+  if (config_->nr()) {
+    send_command_packet(BinkpCommands::M_NUL, "OPT NR");
+  }
+  if (config_->gz()) {
+    send_command_packet(BinkpCommands::M_NUL, "OPT EXTCMD GZ");
+  }
 
   string network_addresses;
   if (side_ == BinkSide::ANSWERING) {
@@ -710,39 +765,111 @@ BinkState BinkP::WaitEob() {
   return BinkState::DONE;
 }
 
+binkp_compression_t BinkP::compression_for(TransferFile* file) const {
+  if (remote_extcmd_ && remote_gz_ && file->file_size() > 0 && should_compress(file->filename())) {
+    return binkp_compression_t::gz;
+  }
+  return binkp_compression_t::none;
+}
+
+std::string BinkP::file_packet_data(TransferFile* file, int offset) const {
+  auto data = file->as_packet_data(offset);
+  if (compression_for(file) == binkp_compression_t::gz) {
+    data += " GZ";
+  }
+  return data;
+}
+
 bool BinkP::SendFilePacket(TransferFile* file) {
   const auto filename(file->filename());
   LOG(INFO) << "       SendFilePacket: " << filename;
   files_to_send_[filename] = unique_ptr<TransferFile>(file);
-  send_command_packet(BinkpCommands::M_FILE, file->as_packet_data(0));
-  process_frames(seconds(2));
-
-  // file* may not be viable anymore if it was already send.
-  if (contains(files_to_send_, filename)) {
-    // We have the file still to send.
-    SendFileData(file);
+  sending_file_ = filename;
+  ScopeExit at_exit([this] { sending_file_.clear(); });
+
+  auto offset = 0;
+  if (remote_nr_) {
+    // In NR mode the remote answers with M_GET saying where to start.
+    send_command_packet(BinkpCommands::M_FILE, file_packet_data(file, -1));
+    auto answered = [&]() -> bool {
+      return contains(get_offsets_, filename) || !contains(files_to_send_, filename);
+    };
+    for (auto i = 0; i < 30 && !answered(); i++) {
+      process_frames(answered, seconds(1));
+    }
+    if (!contains(files_to_send_, filename)) {
+      // The remote already has it (M_GOT).
+      return true;
+    }
+    offset = TakeGetOffset(filename).value_or(0);
+    send_command_packet(BinkpCommands::M_FILE, file_packet_data(file, offset));
+  } else {
+    send_command_packet(BinkpCommands::M_FILE, file_packet_data(file, 0));
+    process_frames(seconds(2));
+    if (!contains(files_to_send_, filename)) {
+      // file* is no longer viable if the remote already has it.
+      return true;
+    }
+    if (const auto o = TakeGetOffset(filename)) {
+      offset = o.value();
+      send_command_packet(BinkpCommands::M_FILE, file_packet_data(file, offset));
+    }
   }
-  return true;
+  return SendFileData(file, offset);
 }
 
-bool BinkP::SendFileData(TransferFile* file) {
-  LOG(INFO) << "       SendFileData: " << file->filename();
+bool BinkP::SendFileData(TransferFile* file, int offset) {
+  const auto filename = file->filename();
+  LOG(INFO) << "       SendFileData: " << filename << "; offset: " << offset;
   const auto file_length = file->file_size();
   const auto chunk_size = 16384; // This is 1<<14.  The max per spec is (1 << 15) - 1
   const auto chunk = std::make_unique<char[]>(chunk_size);
-  for (long start = 0; start < file_length; start += chunk_size) {
+  // Each M_FILE starts a new compressed stream.
+  std::unique_ptr<GzCompressor> gz;
+  if (compression_for(file) == binkp_compression_t::gz) {
+    gz = std::make_unique<GzCompressor>();
+  }
+  for (auto start = offset; start < file_length;) {
     const auto size = min<int>(chunk_size, file_length - start);
     if (!file->GetChunk(chunk.get(), start, size)) {
       // Bad chunk. Abort
     }
-    send_data_packet(chunk.get(), size);
+    start += size;
+    if (gz) {
+      std::string compressed;
+      gz->Compress(chunk.get(), size, start >= file_length, compressed);
+      send_data_packets(compressed);
+    } else {
+      send_data_packet(chunk.get(), size);
+    }
     // sending multi-chunk files was not reliable.  check after each frame if we have
     // an inbound command.
     process_frames(seconds(1));
+    if (!contains(files_to_send_, filename)) {
+      // M_GOT was received, so file* is no longer viable.
+      return true;
+    }
+    if (const auto o = TakeGetOffset(filename)) {
+      start = o.value();
+      send_command_packet(BinkpCommands::M_FILE, file_packet_data(file, start));
+      if (gz) {
+        gz = std::make_unique<GzCompressor>();
+      }
+    }
   }
   return true;
 }
 
+std::optional<int> BinkP::TakeGetOffset(const std::string& filename) {
+  const auto it = get_offsets_.find(filename);
+  if (it == end(get_offsets_)) {
+    return std::nullopt;
+  }
+  const auto offset = it->second;
+  get_offsets_.erase(it);
+  return offset;
+}
+
 bool BinkP::HandlePassword(const string& password_line) {
   VLOG(1) << "        HandlePassword: ";
   VLOG(2) << "        password_line: " << password_line;
@@ -769,24 +896,74 @@ bool BinkP::HandlePassword(const string& password_line) {
 // M_FILE received.
 bool BinkP::HandleFileRequest(const string& request_line) {
   VLOG(1) << "       HandleFileRequest; request_line: " << request_line;
-  auto* old_file = current_receive_file_.release();
-  if (old_file != nullptr) {
-    LOG(ERROR) << "** ERROR: Got HandleFileRequest while still having an open receive file!";
-  }
   string filename;
   long expected_length;
   time_t timestamp;
   long starting_offset = 0;
   uint32_t crc = 0;
+  auto compression = binkp_compression_t::none;
   if (!ParseFileRequestLine(request_line, &filename, &expected_length, &timestamp, &starting_offset,
-                            &crc)) {
+                            &crc, &compression)) {
     return false;
   }
+  skip_data_ = false;
+  if (current_receive_file_) {
+    if (current_receive_file_->filename() == filename &&
+        current_receive_file_->length() == starting_offset) {
+      // The remote is continuing at the offset we asked for.
+      current_receive_file_->set_compression(compression);
+      return true;
+    }
+    LOG(ERROR) << "** ERROR: Got HandleFileRequest while still having an open receive file!";
+    SavePartialReceiveFile();
+  }
+
   const auto net = remote_.network_name();
-  auto* p = new ReceiveFile(received_transfer_file_factory_(net, filename), filename,
-                            expected_length, timestamp, crc);
-  current_receive_file_.reset(p);
-  return true;
+  PartialFiles partials(config_->partial_dir(net));
+  const auto partial = partials.Find(filename, expected_length, timestamp);
+  const auto get_line = [&](int offset) {
+    return fmt::format("{} {} {} {}", filename, expected_length, timestamp, offset);
+  };
+
+  // A remote that answers our M_GET with the file from the start again will
+  // not resume it, so only ask once.
+  const auto resume_asked = contains(resume_requested_, filename);
+  if (starting_offset == -1 || (starting_offset == 0 && partial && remote_nr_ && !resume_asked)) {
+    // NR mode always waits for M_GET. Otherwise we only ask a remote to resume
+    // if it is in NR mode too, since older mailers resend from the start.
+    const auto offset = partial && !resume_asked ? partial->offset : 0;
+    LOG(INFO) << "       Asking for: " << filename << " from offset: " << offset;
+    send_command_packet(BinkpCommands::M_GET, get_line(offset));
+    if (partial) {
+      resume_requested_.insert(filename);
+    }
+    skip_data_ = starting_offset == 0;
+    return true;
+  }
+
+  current_receive_file_ = std::make_unique<ReceiveFile>(
+      received_transfer_file_factory_(net, filename), filename, expected_length, timestamp, crc);
+  current_receive_file_->set_compression(compression);
+  if (starting_offset == 0) {
+    LOG_IF(partial && resume_asked, INFO)
+        << "       Remote would not resume: " << filename << "; receiving it from the start.";
+    // Anything kept is replaced by this copy.
+    partials.Remove(filename);
+    return true;
+  }
+  if (partial && partial->offset == starting_offset &&
+      current_receive_file_->Resume(partials.data_path(filename), partial->offset,
+                                    partial->offset_crc)) {
+    LOG(INFO) << "       Resuming: " << filename << " at offset: " << starting_offset;
+    return true;
+  }
+  LOG(ERROR) << "Unable to resume: " << filename << " at offset: " << starting_offset
+             << "; asking for the whole file.";
+  current_receive_file_.reset();
+  partials.Remove(filename);
+  send_command_packet(BinkpCommands::M_GET, get_line(0));
+  skip_data_ = true;
+  return false;
 }
 
 bool BinkP::HandleFileGetRequest(const string& request_line) {
@@ -795,12 +972,9 @@ bool BinkP::HandleFileGetRequest(const string& request_line) {
   const auto& filename = s.at(0);
   //const auto length = to_number<long>(s.at(1));
   //const auto timestamp = to_number<time_t>(s.at(2));
-  long offset = 0;
+  auto offset = 0;
   if (s.size() >= 4) {
-    offset = to_number<long>(s.at(3));
-  }
-  if (offset != 0) {
-    LOG(WARNING) << "offset specified in FileGetRequest.  We don't support offset != 0";
+    offset = to_number<int>(s.at(3));
   }
 
   const auto iter = files_to_send_.find(filename);
@@ -808,10 +982,48 @@ bool BinkP::HandleFileGetRequest(const string& request_line) {
     LOG(ERROR) << "File not found: " << filename;
     return false;
   }
-  return SendFileData(iter->second.get());
+  auto* file = iter->second.get();
+  if (offset < 0 || offset > file->file_size()) {
+    LOG(WARNING) << "Invalid offset: " << offset << " in M_GET; sending from the start.";
+    offset = 0;
+  }
+  if (filename == sending_file_) {
+    // SendFilePacket or SendFileData picks this up.
+    get_offsets_[filename] = offset;
+    return true;
+  }
+  send_command_packet(BinkpCommands::M_FILE, file_packet_data(file, offset));
+  return SendFileData(file, offset);
   // File was sent but wait until we receive M_GOT before we remove it from the list.
 }
 
+void BinkP::SavePartialReceiveFile() {
+  const auto f = std::move(current_receive_file_);
+  if (!f || f->length() <= 0 || f->length() >= f->expected_length()) {
+    return;
+  }
+  const auto dir = config_->partial_dir(remote_.network_name());
+  if (!File::Exists(dir) && !File::mkdirs(dir)) {
+    LOG(ERROR) << "Unable to create directory: " << dir;
+    return;
+  }
+  PartialFiles partials(dir);
+  if (!f->SavePartial(partials.data_path(f->filename()))) {
+    LOG(ERROR) << "Unable to keep partial file: " << f->filename();
+    return;
+  }
+  const partial_file_t p{f->filename(),
+                         static_cast<int>(f->expected_length()),
+                         f->timestamp(),
+                         f->crc(),
+                         static_cast<int>(f->length()),
+                         f->received_crc()};
+  if (partials.Save(p)) {
+    LOG(INFO) << "Kept " << p.offset << " of " << p.size << " bytes of: " << p.filename
+              << " to resume later.";
+  }
+}
+
 bool BinkP::HandleFileGotRequest(const string& request_line) {
   LOG(INFO) << "       HandleFileGotRequest: request_line: [" << request_line << "]";
   const auto s = SplitString(request_line, " ");
@@ -842,9 +1054,45 @@ bool BinkP::HandleFileGotRequest(const string& request_line) {
   return true;
 }
 
+static void record_callout_metrics(bool failed) {
+  auto& m = Metrics::instance();
+  m.counter("binkp_callouts_total", "Outbound BinkP sessions").inc();
+  if (failed) {
+    m.counter("binkp_callouts_failed_total", "Outbound BinkP sessions ending with an error").inc();
+  }
+}
+
+void record_failed_callout() { record_callout_metrics(true); }
+
+void BinkP::RecordSessionMetrics(std::chrono::duration<double> d) const {
+  auto& m = Metrics::instance();
+  m.counter("binkp_sessions_total", "BinkP sessions, inbound and outbound").inc();
+  m.histogram("binkp_session_duration_seconds", "Duration of BinkP sessions").observe(d);
+  m.counter("binkp_bytes_sent_total", "Bytes of files sent by BinkP").inc(bytes_sent_);
+  m.counter("binkp_bytes_received_total", "Bytes of files received by BinkP").inc(bytes_received_);
+  const auto failed = error_received_ || session_failed_;
+  if (failed) {
+    m.counter("binkp_session_errors_total", "BinkP sessions ending with an error").inc();
+  }
+  if (side_ == BinkSide::ORIGINATING) {
+    record_callout_metrics(failed);
+  }
+}
+
 void BinkP::Run(const wwiv::core::CommandLine& cmdline) {
+  if (!network_processor_) {
+    network_processor_ = [bindir = cmdline.bindir(), verbose = config_->verbose()](int net) {
+      System(bindir, StrCat("networkc .", net, " --v=", verbose));
+    };
+  }
+  Run();
+}
+
+void BinkP::Run() {
+  // Sessions may share a process (wwivd), so the time alone is not unique.
+  static std::atomic<int> session_number{0};
   const auto now = DateTime::now();
-  config_->session_identifier(fmt::format("in-{}", now.to_time_t()));
+  config_->session_identifier(fmt::format("in-{}-{}", now.to_time_t(), session_number++));
   LOG(INFO) << "session id:  " << config_->session_identifier();
 
   VLOG(1) << "STATE: Run(): side:" << static_cast<int>(side_);
@@ -911,16 +1159,22 @@ void BinkP::Run(const wwiv::core::CommandLine& cmdline) {
     LOG(INFO) << "       connection was closed by the other side. details: " << e.what();
   } catch (const socket_error& e) {
     LOG(ERROR) << "STATE: BinkP::RunOriginatingLoop() socket_error: " << e.what();
+    session_failed_ = true;
   }
 
+  // Keep anything we were in the middle of receiving so the next session
+  // can resume it.
+  SavePartialReceiveFile();
+
   const auto end_time = system_clock::now();
+  RecordSessionMetrics(end_time - start_time);
   if (remote_.network().type == network_type_t::wwivnet) {
     // Handle WWIVnet inbound files.
     if (file_manager_) {
       // file_manager_ is null in some tests (BinkpTest).
       file_manager_->rename_wwivnet_pending_files();
       if (!config_->skip_net()) {
-        process_network_files(cmdline);
+        process_network_files();
       }
     }
 
@@ -947,8 +1201,7 @@ void BinkP::Run(const wwiv::core::CommandLine& cmdline) {
       // file_manager_ is null in some tests (BinkpTest).
       file_manager_->rename_ftn_pending_files(remote_);
       if (!config_->skip_net()) {
-        const auto network_number = config_->networks().network_number(remote_.network_name());
-        System(cmdline.bindir(), StrCat("networkc .", network_number, " --v=", config_->verbose()));
+        process_network_files();
       }
     }
   }
@@ -963,18 +1216,19 @@ void BinkP::Run(const wwiv::core::CommandLine& cmdline) {
 
 }
 
-void BinkP::process_network_files(const wwiv::core::CommandLine& cmdline) const {
+void BinkP::process_network_files() const {
   const auto network_name = remote_.network_name();
   VLOG(1) << "STATE: process_network_files for network: " << network_name;
   const auto network_number = config_->networks().network_number(network_name);
-  if (network_number == wwiv::sdk::Networks::npos) {
+  if (network_number == wwiv::sdk::Networks::npos || !network_processor_) {
     return;
   }
-  System(cmdline.bindir(), StrCat("networkc .", network_number, " --v=", config_->verbose()));
+  network_processor_(network_number);
 }
 
 bool ParseFileRequestLine(const string& request_line, string* filename, long* length,
-                          time_t* timestamp, long* offset, uint32_t* crc) {
+                          time_t* timestamp, long* offset, uint32_t* crc,
+                          binkp_compression_t* compression) {
   auto s = SplitString(request_line, " ");
   if (s.size() < 3) {
     LOG(ERROR) << "ERROR: INVALID request_line: " << request_line
@@ -985,11 +1239,21 @@ bool ParseFileRequestLine(const string& request_line, string* filename, long* le
   *length = to_number<long>(s.at(1));
   *timestamp = to_number<time_t>(s.at(2));
   *offset = 0;
+  *compression = binkp_compression_t::none;
   if (s.size() >= 4) {
     *offset = to_number<long>(s.at(3));
   }
-  if (s.size() >= 5) {
-    *crc = to_number<uint32_t>(s.at(4), 16);
+  // Anything after the offset is either a CRC or an EXTCMD compression method.
+  for (auto i = 4; i < ssize(s); i++) {
+    const auto& p = s.at(i);
+    if (p == "GZ") {
+      *compression = binkp_compression_t::gz;
+    } else if (p == "BZ2") {
+      LOG(ERROR) << "ERROR: BZ2 compression is not supported: " << request_line;
+      return false;
+    } else {
+      *crc = to_number<uint32_t>(p, 16);
+    }
   }
   return true;
 }
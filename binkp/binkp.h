@@ -20,6 +20,7 @@
 
 #include "core/command_line.h"
 #include "core/connection.h"
+#include "binkp/compression.h"
 #include "binkp/cram.h"
 #include "binkp/file_manager.h"
 #include "binkp/receive_file.h"
@@ -30,6 +31,8 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
+#include <set>
 #include <string>
 
 namespace wwiv::net {
@@ -70,14 +73,23 @@ public:
   typedef std::function<TransferFile*(
       const std::string& network_name, const std::string& filename)>
       received_transfer_file_factory_t;
+  // Processes the network files received for network_number, i.e. by running networkc.
+  typedef std::function<void(int network_number)> network_processor_t;
   BinkP(wwiv::core::Connection* conn, BinkConfig* config, BinkSide side,
         const std::string& expected_remote_node,
         received_transfer_file_factory_t& received_transfer_file_factory);
   virtual ~BinkP();
 
+  // Runs the session, running networkc from cmdline.bindir() to process
+  // received files unless a network processor has been set.
   void Run(const wwiv::core::CommandLine& cmdline);
+  // Runs the session, handing received files to the network processor.
+  void Run();
+  void set_network_processor(network_processor_t p) { network_processor_ = std::move(p); }
 
 private:
+  // Adds this session to the shared metrics.
+  void RecordSessionMetrics(std::chrono::duration<double> d) const;
   // Process frames until we time out waiting for a new frame.
   bool process_frames(std::chrono::duration<double> d);
   // Process frames until predicate is satisfied (returns true) or we time out waiting
@@ -90,8 +102,10 @@ private:
 
   bool send_command_packet(uint8_t command_id, const std::string& data);
   bool send_data_packet(const char* data, int size);
+  // Sends data as one or more data frames.
+  bool send_data_packets(const std::string& data);
 
-  void process_network_files(const wwiv::core::CommandLine& cmdline) const;
+  void process_network_files() const;
 
   BinkState ConnInit();
   BinkState WaitConn();
@@ -106,8 +120,18 @@ private:
   BinkState WaitEob();
   BinkState Unknown();
   BinkState FatalError();
+  // Compression to use when sending file.
+  binkp_compression_t compression_for(TransferFile* file) const;
+  // M_FILE data line for file starting at offset.
+  std::string file_packet_data(TransferFile* file, int offset) const;
   bool SendFilePacket(TransferFile* file);
-  bool SendFileData(TransferFile* file);
+  // Sends the data for file starting at offset, restarting at a new offset
+  // whenever the remote asks for one with M_GET.
+  bool SendFileData(TransferFile* file, int offset);
+  // Returns and clears the offset requested by M_GET for filename, if any.
+  std::optional<int> TakeGetOffset(const std::string& filename);
+  // Keeps the file being received so that a later session may resume it.
+  void SavePartialReceiveFile();
   bool HandleFileGetRequest(const std::string& request_line);
   bool HandleFileGotRequest(const std::string& request_line);
   bool HandlePassword(const std::string& password_line);
@@ -122,7 +146,10 @@ private:
   const std::string expected_remote_node_;
   std::string remote_password_;
   bool error_received_ = false;
+  // Set when the session ends because of a socket error.
+  bool session_failed_ = false;
   received_transfer_file_factory_t received_transfer_file_factory_;
+  network_processor_t network_processor_;
   std::unique_ptr<ReceiveFile> current_receive_file_;
   unsigned int bytes_received_ = 0;
   unsigned int bytes_sent_ = 0;
@@ -132,20 +159,41 @@ private:
   // Auth type used.
   AuthType auth_type_ = AuthType::PLAIN_TEXT;
   bool crc_ = false;
+  // True if the remote is in non-reliable (NR) mode. Files sent to it start
+  // with an offset of -1 and wait for an M_GET saying where to begin.
+  bool remote_nr_ = false;
+  // True if the remote may be sent GZ compressed files (OPT EXTCMD GZ).
+  bool remote_extcmd_ = false;
+  bool remote_gz_ = false;
+  // Name of the file being sent by SendFilePacket.
+  std::string sending_file_;
+  // Offsets asked for by M_GET for sending_file_.
+  std::map<std::string, int> get_offsets_;
+  // Files we have asked the remote to resume with M_GET. If one comes back
+  // from offset 0 anyway, it is received from the start.
+  std::set<std::string> resume_requested_;
+  // Set after asking the remote to resume a file with M_GET; data frames are
+  // discarded until the M_FILE with the new offset arrives.
+  bool skip_data_ = false;
 
   std::unique_ptr<FileManager> file_manager_;
   Remote remote_;
 };
 
-// Parses a M_FILE request line into it's parts.
-// TODO(rushfan): Support the 5th CRC parameter in FRL-1022
-// See  http://www.filegate.net/ftsc/FRL-1022.001
+// Parses a M_FILE request line into it's parts.  After the offset may come
+// the CRC from FRL-1022 (http://www.filegate.net/ftsc/FRL-1022.001) and the
+// compression ("GZ") from the binkp GZ extension.
 bool ParseFileRequestLine(const std::string& request_line, 
 			  std::string* filename,
 			  long* length,
 			  time_t* timestamp,
 			  long* offset,
-        uint32_t* crc);
+        uint32_t* crc,
+        binkp_compression_t* compression);
+
+// Adds an outbound call that failed before a session could start (i.e. the
+// connect failed) to the shared metrics.
+void record_failed_callout();
 
 // Returns just the expected password for a node (node) contained in the
 // callout.net file used by the wwiv::sdk::Callout class.
@@ -103,6 +103,10 @@ std::string BinkConfig::receive_dir(const std::string& network_name) const {
   return dir;
 }
 
+std::filesystem::path BinkConfig::partial_dir(const std::string& network_name) const {
+  return wwiv::core::FilePath(network_dir(network_name), "partial");
+}
+
 static net_networks_rec test_net(const string& network_dir) {
   net_networks_rec net{};
   net.sysnum = 1;
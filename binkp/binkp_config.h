@@ -51,11 +51,17 @@ public:
   [[nodiscard]] std::filesystem::path network_dir(const std::string& network_name) const;
   /** Get the directory to receive files into for network named network_name */
   [[nodiscard]] std::string receive_dir(const std::string& network_name) const;
+  /**
+   * Get the directory where partially received files for network_name are
+   * kept between sessions.
+   */
+  [[nodiscard]] std::filesystem::path partial_dir(const std::string& network_name) const;
 
   [[nodiscard]] const net_networks_rec& network(const std::string& network_name) const;
   [[nodiscard]] const net_networks_rec& callout_network() const;
   [[nodiscard]] const wwiv::sdk::Networks& networks() { return networks_; }
-  std::map<const std::string, std::unique_ptr<wwiv::sdk::Callout>>& callouts() { return callouts_; }
+  // Callouts are shared so that sessions in one process may use the same ones.
+  std::map<const std::string, std::shared_ptr<wwiv::sdk::Callout>>& callouts() { return callouts_; }
 
   void set_skip_net(bool skip_net) { skip_net_ = skip_net; }
   [[nodiscard]] bool skip_net() const { return skip_net_; }
@@ -64,6 +70,15 @@ public:
   void set_network_version(int network_version) { network_version_ = network_version; }
   [[nodiscard]] int network_version() const { return network_version_; }
   [[nodiscard]] bool crc() const { return crc_; }
+  /**
+   * Whether to ask remotes to send in non-reliable (NR) mode, so that any
+   * interrupted file can be resumed.
+   */
+  [[nodiscard]] bool nr() const { return nr_; }
+  void set_nr(bool nr) { nr_ = nr; }
+  /** Whether to offer and accept GZ compressed files (the binkp GZ extension). */
+  [[nodiscard]] bool gz() const { return gz_; }
+  void set_gz(bool gz) { gz_ = gz; }
   [[nodiscard]] bool cram_md5() const { return cram_md5_; }
   [[nodiscard]] const wwiv::sdk::Config& config() const { return config_; }
 
@@ -81,13 +96,15 @@ private:
   std::string sysop_name_;
   std::string gfiles_directory_;
   const wwiv::sdk::Networks networks_;
-  std::map<const std::string, std::unique_ptr<wwiv::sdk::Callout>> callouts_;
+  std::map<const std::string, std::shared_ptr<wwiv::sdk::Callout>> callouts_;
   std::unique_ptr<wwiv::sdk::Binkp> binkp_;
 
   bool skip_net_ = false;
   int verbose_ = 0;
   int network_version_ = 38;
   bool crc_ = false;
+  bool nr_ = true;
+  bool gz_ = true;
   bool cram_md5_ = true;
   std::string session_identifier_;
 };
@@ -0,0 +1,126 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "binkp/compression.h"
+
+#include "core/log.h"
+#include "core/strings.h"
+#include <set>
+#include <string>
+#include <zlib.h>
+
+using namespace wwiv::strings;
+
+namespace wwiv::net {
+
+// Size of the buffer zlib writes into; the output is appended to a string.
+static constexpr int kOutBufferSize = 16384;
+
+bool should_compress(const std::string& filename) {
+  static const std::set<std::string> compressed_extensions{
+      "7z", "arc", "arj", "bz2", "gif", "gz", "jpg", "lha", "lzh",
+      "mp3", "png", "rar", "tgz", "xz",  "z",  "zip", "zoo"};
+  const auto dot = filename.find_last_of('.');
+  if (dot == std::string::npos) {
+    return true;
+  }
+  const auto ext = ToStringLowerCase(filename.substr(dot + 1));
+  if (compressed_extensions.find(ext) != compressed_extensions.end()) {
+    return false;
+  }
+  // FTN bundles are named *.su0 through *.sa9 (or with a letter).
+  static const std::set<std::string> bundle_days{"su", "mo", "tu", "we", "th", "fr", "sa"};
+  return !(ext.size() == 3 && bundle_days.find(ext.substr(0, 2)) != bundle_days.end());
+}
+
+GzCompressor::GzCompressor() : zs_(std::make_unique<z_stream>()) {
+  initialized_ = deflateInit(zs_.get(), Z_DEFAULT_COMPRESSION) == Z_OK;
+  LOG_IF(!initialized_, ERROR) << "Unable to initialize zlib compression.";
+}
+
+GzCompressor::~GzCompressor() {
+  if (initialized_) {
+    deflateEnd(zs_.get());
+  }
+}
+
+bool GzCompressor::Compress(const char* data, int size, bool finish, std::string& out) {
+  if (!initialized_) {
+    return false;
+  }
+  char buf[kOutBufferSize];
+  zs_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  zs_->avail_in = static_cast<uInt>(size);
+  const auto flush = finish ? Z_FINISH : Z_NO_FLUSH;
+  int ret;
+  do {
+    zs_->next_out = reinterpret_cast<Bytef*>(buf);
+    zs_->avail_out = sizeof(buf);
+    ret = deflate(zs_.get(), flush);
+    if (ret == Z_STREAM_ERROR) {
+      LOG(ERROR) << "zlib deflate error.";
+      return false;
+    }
+    out.append(buf, sizeof(buf) - zs_->avail_out);
+  } while (zs_->avail_out == 0 || (finish && ret != Z_STREAM_END));
+  return true;
+}
+
+GzDecompressor::GzDecompressor() : zs_(std::make_unique<z_stream>()) {
+  initialized_ = inflateInit(zs_.get()) == Z_OK;
+  LOG_IF(!initialized_, ERROR) << "Unable to initialize zlib decompression.";
+}
+
+GzDecompressor::~GzDecompressor() {
+  if (initialized_) {
+    inflateEnd(zs_.get());
+  }
+}
+
+bool GzDecompressor::Decompress(const char* data, int size, std::string& out) {
+  if (!initialized_) {
+    return false;
+  }
+  if (finished_) {
+    LOG(ERROR) << "Data received after the end of the compressed stream.";
+    return false;
+  }
+  char buf[kOutBufferSize];
+  zs_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  zs_->avail_in = static_cast<uInt>(size);
+  do {
+    zs_->next_out = reinterpret_cast<Bytef*>(buf);
+    zs_->avail_out = sizeof(buf);
+    const auto ret = inflate(zs_.get(), Z_NO_FLUSH);
+    if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+      LOG(ERROR) << "zlib inflate error: " << ret;
+      return false;
+    }
+    out.append(buf, sizeof(buf) - zs_->avail_out);
+    if (ret == Z_STREAM_END) {
+      finished_ = true;
+      break;
+    }
+    if (ret == Z_BUF_ERROR) {
+      // No progress possible until more input arrives.
+      break;
+    }
+  } while (zs_->avail_in > 0 || zs_->avail_out == 0);
+  return true;
+}
+
+} // namespace wwiv::net
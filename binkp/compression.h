@@ -0,0 +1,80 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_BINKP_COMPRESSION_H
+#define INCLUDED_BINKP_COMPRESSION_H
+
+#include <memory>
+#include <string>
+
+struct z_stream_s;
+
+namespace wwiv::net {
+
+/** Per-file compression from the binkp GZ/BZ2 extension (M_FILE's last field) */
+enum class binkp_compression_t { none, gz };
+
+/**
+ * Returns true if filename is worth compressing, i.e. it's not already an
+ * archive or an FTN bundle.
+ */
+bool should_compress(const std::string& filename);
+
+/**
+ * Streaming zlib compressor for the data frames of a file sent with GZ.
+ * A new compressor must be used each time the file is (re)started with M_FILE.
+ */
+class GzCompressor final {
+public:
+  GzCompressor();
+  ~GzCompressor();
+  GzCompressor(const GzCompressor&) = delete;
+  GzCompressor& operator=(const GzCompressor&) = delete;
+
+  /**
+   * Compresses size bytes from data, appending whatever is ready to out.  Set
+   * finish on the last call so that the end of the stream is written.
+   */
+  bool Compress(const char* data, int size, bool finish, std::string& out);
+
+private:
+  std::unique_ptr<z_stream_s> zs_;
+  bool initialized_{false};
+};
+
+/** Streaming zlib decompressor for data frames of a file received with GZ. */
+class GzDecompressor final {
+public:
+  GzDecompressor();
+  ~GzDecompressor();
+  GzDecompressor(const GzDecompressor&) = delete;
+  GzDecompressor& operator=(const GzDecompressor&) = delete;
+
+  /** Decompresses size bytes of data, appending the output to out. */
+  bool Decompress(const char* data, int size, std::string& out);
+  /** True once the end of the compressed stream has been seen. */
+  [[nodiscard]] bool finished() const noexcept { return finished_; }
+
+private:
+  std::unique_ptr<z_stream_s> zs_;
+  bool initialized_{false};
+  bool finished_{false};
+};
+
+} // namespace wwiv::net
+
+#endif
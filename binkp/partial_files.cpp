@@ -0,0 +1,97 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "binkp/partial_files.h"
+
+#include "core/file.h"
+#include "core/log.h"
+#include "core/strings.h"
+#include "core/textfile.h"
+#include "fmt/format.h"
+#include <string>
+#include <utility>
+
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+namespace wwiv::net {
+
+PartialFiles::PartialFiles(std::filesystem::path dir) : dir_(std::move(dir)) {}
+
+std::filesystem::path PartialFiles::data_path(const std::string& filename) const {
+  return FilePath(dir_, filename);
+}
+
+std::filesystem::path PartialFiles::descriptor_path(const std::string& filename) const {
+  return FilePath(dir_, StrCat(filename, ".partial"));
+}
+
+std::optional<partial_file_t> PartialFiles::Find(const std::string& filename, int size,
+                                                 time_t timestamp) const {
+  const auto dpath = descriptor_path(filename);
+  if (!File::Exists(dpath) || !File::Exists(data_path(filename))) {
+    return std::nullopt;
+  }
+  TextFile f(dpath, "rt");
+  std::string line;
+  if (!f.IsOpen() || !f.ReadLine(&line)) {
+    return std::nullopt;
+  }
+  // filename size timestamp crc offset offset_crc
+  const auto parts = SplitString(line, " ");
+  if (parts.size() != 6) {
+    LOG(ERROR) << "Invalid partial file descriptor: " << dpath << "; line: " << line;
+    return std::nullopt;
+  }
+  partial_file_t p{};
+  p.filename = parts.at(0);
+  p.size = to_number<int>(parts.at(1));
+  p.timestamp = to_number<time_t>(parts.at(2));
+  p.crc = to_number<uint32_t>(parts.at(3), 16);
+  p.offset = to_number<int>(parts.at(4));
+  p.offset_crc = to_number<uint32_t>(parts.at(5), 16);
+  if (p.filename != filename || p.size != size || p.timestamp != timestamp) {
+    VLOG(1) << "Partial file: " << filename << " is for a different version of the file.";
+    return std::nullopt;
+  }
+  if (p.offset <= 0 || p.offset >= p.size) {
+    return std::nullopt;
+  }
+  return p;
+}
+
+bool PartialFiles::Save(const partial_file_t& p) {
+  TextFile f(descriptor_path(p.filename), "wt");
+  if (!f.IsOpen()) {
+    LOG(ERROR) << "Unable to write partial file descriptor: " << descriptor_path(p.filename);
+    return false;
+  }
+  return f.WriteLine(fmt::format("{} {} {} {:08X} {} {:08X}", p.filename, p.size, p.timestamp,
+                                 p.crc, p.offset, p.offset_crc)) > 0;
+}
+
+bool PartialFiles::Remove(const std::string& filename) {
+  auto result = true;
+  for (const auto& path : {data_path(filename), descriptor_path(filename)}) {
+    if (File::Exists(path) && !File::Remove(path)) {
+      result = false;
+    }
+  }
+  return result;
+}
+
+} // namespace wwiv
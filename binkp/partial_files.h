@@ -0,0 +1,77 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_BINKP_PARTIAL_FILES_H
+#define INCLUDED_BINKP_PARTIAL_FILES_H
+
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace wwiv::net {
+
+/**
+ * Describes the part of a file received before a session ended.  The values
+ * match the M_FILE line the file was sent with, plus how much was received.
+ */
+struct partial_file_t {
+  std::string filename;
+  int size{0};
+  time_t timestamp{0};
+  // CRC of the whole file from the M_FILE line, or 0 if none was sent.
+  uint32_t crc{0};
+  // Number of bytes received so far.
+  int offset{0};
+  // CRC-32 of the first offset bytes, so that the received CRC can be
+  // continued without reading them again.
+  uint32_t offset_crc{0};
+};
+
+/**
+ * Keeps files whose receipt was interrupted so that a later session can
+ * resume them using M_GET.  Each file is stored as FILENAME with a one line
+ * descriptor named FILENAME.partial next to it.
+ */
+class PartialFiles final {
+public:
+  explicit PartialFiles(std::filesystem::path dir);
+  ~PartialFiles() = default;
+
+  /** Path of the kept data for filename. */
+  [[nodiscard]] std::filesystem::path data_path(const std::string& filename) const;
+  /**
+   * Returns the partial file for this exact version of filename (same size
+   * and timestamp) if one was kept.
+   */
+  [[nodiscard]] std::optional<partial_file_t> Find(const std::string& filename, int size,
+                                                   time_t timestamp) const;
+  /** Writes the descriptor for data already moved to data_path(p.filename). */
+  bool Save(const partial_file_t& p);
+  /** Removes the data and descriptor kept for filename. */
+  bool Remove(const std::string& filename);
+
+private:
+  [[nodiscard]] std::filesystem::path descriptor_path(const std::string& filename) const;
+
+  const std::filesystem::path dir_;
+};
+
+}  // namespace
+
+#endif
@@ -18,11 +18,14 @@
 #ifndef INCLUDED_NETORKB_RECEIVE_FILE_H
 #define INCLUDED_NETORKB_RECEIVE_FILE_H
 
+#include "core/crc32.h"
 #include "core/log.h"
 #include "core/strings.h"
+#include "binkp/compression.h"
 #include "binkp/transfer_file.h"
 #include <cstdint>
 #include <ctime>
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <utility>
@@ -39,29 +42,77 @@ public:
   }
   ~ReceiveFile() = default;
 
+  /** Writes a data frame, decompressing it first if the file was sent with GZ. */
   bool WriteChunk(const char* chunk, int size) {
-    const auto ok = file_->WriteChunk(chunk, size);
-    if (ok) {
-      length_ += size;
+    if (!decompressor_) {
+      return WriteData(chunk, size);
     }
-    return ok;
+    std::string data;
+    if (!decompressor_->Decompress(chunk, size, data)) {
+      return false;
+    }
+    return WriteData(data.data(), wwiv::strings::ssize(data));
   }
 
   bool WriteChunk(const std::string& chunk) {
-    const auto cs = wwiv::strings::ssize(chunk);
-    if (!file_->WriteChunk(chunk.data(), cs)) {
+    return WriteChunk(chunk.data(), wwiv::strings::ssize(chunk));
+  }
+
+  /**
+   * Continues receiving at offset using the partial file at path, whose first
+   * offset bytes have a CRC-32 of offset_crc.
+   */
+  bool Resume(const std::filesystem::path& path, int offset, uint32_t offset_crc) {
+    if (!file_->ResumePartial(path, offset)) {
       return false;
     }
-    length_ += cs;
+    length_ = offset;
+    received_crc_ = wwiv::core::Crc32(offset_crc);
     return true;
   }
 
+  /**
+   * Sets the compression used for the data frames that follow, starting a new
+   * compressed stream each time the file is (re)started by M_FILE.
+   */
+  void set_compression(binkp_compression_t c) {
+    if (c == binkp_compression_t::gz) {
+      decompressor_ = std::make_unique<GzDecompressor>();
+    } else {
+      decompressor_.reset();
+    }
+  }
+
+  /** True once all of the file has been received. */
+  [[nodiscard]] bool complete() const {
+    // The end of a compressed stream may arrive after the last of the data.
+    return decompressor_ ? decompressor_->finished() && length_ == expected_length_
+                         : length_ >= expected_length_;
+  }
+
+  /**
+   * True when the compressed stream inflated past the expected length, or
+   * ended before reaching it.  The file can never complete.
+   */
+  [[nodiscard]] bool wrong_length() const {
+    return decompressor_ && (length_ > expected_length_ ||
+                             (decompressor_->finished() && length_ != expected_length_));
+  }
+
+  /** Discards the data received so far. */
+  bool Delete() { return file_->Delete(); }
+
+  /** Moves the data received so far to path. */
+  bool SavePartial(const std::filesystem::path& path) { return file_->SavePartial(path); }
+
   [[nodiscard]] std::string filename() const { return filename_; }
   [[nodiscard]] long expected_length() const { return expected_length_; }
   [[nodiscard]] long length() const { return length_; }
   [[nodiscard]] time_t timestamp() const { return timestamp_; }
   [[nodiscard]] bool Close() { return file_->Close(); }
   [[nodiscard]] uint32_t crc() const { return crc_; }
+  /** CRC-32 of the data received so far. */
+  [[nodiscard]] uint32_t received_crc() const { return received_crc_.value(); }
 
   std::unique_ptr<TransferFile> file_;
   std::string filename_;
@@ -69,6 +120,21 @@ public:
   time_t timestamp_{0};
   long length_{0};
   uint32_t crc_{0};
+  wwiv::core::Crc32 received_crc_;
+  std::unique_ptr<GzDecompressor> decompressor_;
+
+private:
+  bool WriteData(const char* data, int size) {
+    if (size == 0) {
+      return true;
+    }
+    if (!file_->WriteChunk(data, size)) {
+      return false;
+    }
+    length_ += size;
+    received_crc_.update(data, size);
+    return true;
+  }
 };
 
 } // namespace
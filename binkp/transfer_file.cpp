@@ -18,6 +18,7 @@
 #include "binkp/transfer_file.h"
 
 #include "core/crc32.h"
+#include "core/file.h"
 #include "core/log.h"
 #include "core/strings.h"
 #include "fmt/printf.h"
@@ -75,5 +76,23 @@ bool InMemoryTransferFile::Close() {
   return true;
 }
 
+bool InMemoryTransferFile::SavePartial(const std::filesystem::path& path) {
+  wwiv::core::File f(path);
+  if (!f.Open(wwiv::core::File::modeBinary | wwiv::core::File::modeCreateFile |
+              wwiv::core::File::modeReadWrite | wwiv::core::File::modeTruncate)) {
+    return false;
+  }
+  return f.Write(contents_) == ssize(contents_);
+}
+
+bool InMemoryTransferFile::ResumePartial(const std::filesystem::path& path, int offset) {
+  wwiv::core::File f(path);
+  if (!f.Open(wwiv::core::File::modeBinary | wwiv::core::File::modeReadOnly)) {
+    return false;
+  }
+  contents_.resize(offset);
+  return offset == 0 || f.Read(&contents_[0], offset) == offset;
+}
+
 
 } // namespace wwiv
@@ -21,6 +21,7 @@
 #include "core/stl.h"
 #include <chrono>
 #include <cstdint>
+#include <filesystem>
 #include <string>
 
 namespace wwiv::net {
@@ -40,6 +41,16 @@ public:
   virtual bool GetChunk(char* chunk, int start, int size) = 0;
   virtual bool WriteChunk(const char* chunk, int size) = 0;
   virtual bool Close() = 0;
+  /**
+   * Moves everything written so far to path so that a later session can
+   * resume receiving this file.  Nothing may be written afterwards.
+   */
+  virtual bool SavePartial(const std::filesystem::path& path) = 0;
+  /**
+   * Starts this file with the first offset bytes of the partial file at path,
+   * so that the next WriteChunk continues at offset.
+   */
+  virtual bool ResumePartial(const std::filesystem::path& path, int offset) = 0;
 
  protected:
   [[nodiscard]] std::string as_packet_data(int size, int offset) const;
@@ -64,6 +75,8 @@ public:
   bool GetChunk(char* chunk, int start, int size) override final;
   bool WriteChunk(const char* chunk, int size) override final;
   bool Close() override final;
+  bool SavePartial(const std::filesystem::path& path) override final;
+  bool ResumePartial(const std::filesystem::path& path, int offset) override final;
 
 private:
   std::string contents_;
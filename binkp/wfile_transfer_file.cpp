@@ -97,15 +97,19 @@ bool WFileTransferFile::GetChunk(char* chunk, int start, int size) {
   return file_->Read(chunk, size) == size;
 }
 
+static void rename_existing_file(const File& file) {
+  if (file.Exists()) {
+    // Don't overwrite an existing file.  Rename it away to: FILENAME.timestamp
+    auto newpath = file.path();
+    newpath += StrCat(".", system_clock::to_time_t(system_clock::now()));
+    File::Rename(file.path(), newpath);
+  }
+}
+
 bool WFileTransferFile::WriteChunk(const char* chunk, int size) {
   VLOG(3) << "WFileTransferFile::WriteChunk";
   if (!file_->IsOpen()) {
-    if (file_->Exists()) {
-      // Don't overwrite an existing file.  Rename it away to: FILENAME.timestamp
-      auto newpath = file_->path();
-      newpath += StrCat(".", system_clock::to_time_t(system_clock::now()));
-      File::Rename(file_->path(), newpath);
-    }
+    rename_existing_file(*file_);
     if (!file_->Open(File::modeBinary | File::modeReadWrite | File::modeCreateFile)) {
       return false;
     }
@@ -113,6 +117,37 @@ bool WFileTransferFile::WriteChunk(const char* chunk, int size) {
   return file_->Write(chunk, size) == size;
 }
 
+bool WFileTransferFile::SavePartial(const std::filesystem::path& path) {
+  VLOG(1) << "WFileTransferFile::SavePartial " << file_->path().string() << " to " << path.string();
+  file_->Close();
+  if (!File::Exists(file_->path())) {
+    return false;
+  }
+  if (File::Exists(path)) {
+    File::Remove(path);
+  }
+  return File::Move(file_->path(), path);
+}
+
+bool WFileTransferFile::ResumePartial(const std::filesystem::path& path, int offset) {
+  VLOG(1) << "WFileTransferFile::ResumePartial " << path.string() << " at " << offset;
+  file_->Close();
+  rename_existing_file(*file_);
+  if (!File::Move(path, file_->path())) {
+    return false;
+  }
+  if (!file_->Open(File::modeBinary | File::modeReadWrite)) {
+    return false;
+  }
+  if (file_->length() < offset) {
+    LOG(ERROR) << "Partial file: " << file_->path() << " is shorter than: " << offset;
+    file_->Close();
+    return false;
+  }
+  file_->set_length(offset);
+  return file_->Seek(offset, File::Whence::begin) == offset;
+}
+
 bool WFileTransferFile::Close() {
   VLOG(1) << "WFileTransferFile::Close " << file_->path().string();
   file_->Close();
@@ -38,6 +38,8 @@ public:
   bool GetChunk(char* chunk, int start, int size) override final;
   bool WriteChunk(const char* chunk, int size) override final;
   bool Close() override final;
+  bool SavePartial(const std::filesystem::path& path) override final;
+  bool ResumePartial(const std::filesystem::path& path, int offset) override final;
   void set_flo_file(std::unique_ptr<wwiv::sdk::fido::FloFile>&& f) { flo_file_ = std::move(f); }
 
  private:
@@ -0,0 +1,99 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+// Loopback throughput of binkp GZ compression, see core_test/benchmark_main.cpp.
+// The compression ratio of each sample is part of the benchmark name.
+
+#include "binkp/compression.h"
+#include "binkp/receive_file.h"
+#include "binkp/transfer_file.h"
+#include "core_test/benchmark.h"
+#include "fmt/format.h"
+#include <algorithm>
+#include <string>
+
+using namespace wwiv::core::test;
+using namespace wwiv::net;
+
+namespace {
+
+constexpr int kChunkSize = 16384;
+
+// Text shaped like the messages inside a .pkt or a nodelist.
+std::string sample_text(int size) {
+  std::string s;
+  for (auto i = 0; static_cast<int>(s.size()) < size; i++) {
+    s += fmt::format(",{},WWIV_Node_{},Somewhere_USA,Sysop_{},-Unpublished-,300,XA,V34,IBN\r\n",
+                     i % 9999, i % 313, i % 71);
+  }
+  s.resize(size);
+  return s;
+}
+
+// Data that does not compress, like an archive sent without should_compress.
+std::string sample_random(int size) {
+  std::string s;
+  uint32_t seed = 1;
+  for (auto i = 0; i < size; i++) {
+    seed = seed * 1103515245 + 12345;
+    s.push_back(static_cast<char>(seed >> 16));
+  }
+  return s;
+}
+
+std::string compress(const std::string& data) {
+  GzCompressor gz;
+  std::string out;
+  const auto length = static_cast<int>(data.size());
+  for (auto start = 0; start < length; start += kChunkSize) {
+    const auto size = std::min(kChunkSize, length - start);
+    gz.Compress(data.data() + start, size, start + size >= length, out);
+  }
+  return out;
+}
+
+// Compresses data as SendFileData does and receives it as ReceiveFile does.
+void loopback(const std::string& data) {
+  ReceiveFile r(new InMemoryTransferFile("bench.pkt", ""), "bench.pkt",
+                static_cast<long>(data.size()), 0, 0);
+  r.set_compression(binkp_compression_t::gz);
+  r.WriteChunk(compress(data));
+  benchmark_sink = static_cast<std::size_t>(r.length());
+}
+
+std::string name(const std::string& label, const std::string& data) {
+  const auto ratio =
+      static_cast<double>(data.size()) / static_cast<double>(std::max<size_t>(1, compress(data).size()));
+  return fmt::format("binkp_gz_loopback/{} ({:.1f}:1)", label, ratio);
+}
+
+const std::string& text() {
+  static const auto s = sample_text(1024 * 1024);
+  return s;
+}
+
+const std::string& random_data() {
+  static const auto s = sample_random(1024 * 1024);
+  return s;
+}
+
+const BenchmarkRegistrar registrar({
+    {name("text_1m", text()), [] { loopback(text()); }, text().size()},
+    {name("random_1m", random_data()), [] { loopback(random_data()); }, random_data().size()},
+});
+
+} // namespace
@@ -17,19 +17,24 @@
 /**************************************************************************/
 #include "gtest/gtest.h"
 
+#include "core/crc32.h"
 #include "core/file.h"
+#include "core/metrics.h"
 #include "core/strings.h"
 #include "core_test/file_helper.h"
 #include "binkp/binkp.h"
 #include "binkp/binkp_commands.h"
 #include "binkp/binkp_config.h"
+#include "binkp/partial_files.h"
 #include "sdk/net/callout.h"
 #include "binkp/transfer_file.h"
 #include "binkp_test/fake_connection.h"
 #include "core/file.h"
 
+#include <map>
 #include <string>
 #include <thread>
+#include <vector>
 
 using std::clog;
 using std::endl;
@@ -66,7 +71,9 @@ protected:
     net.type = network_type_t::wwivnet;
     net.sysnum = 0;
     binkp_config_ = std::make_unique<BinkConfig>(ORIGINATING_ADDRESS, config, network_dir);
-    auto dummy_callout = std::make_unique<Callout>(net, 0);
+    binkp_config_->set_skip_net(true);
+    const net_call_out_rec n{"20000:20000/2", 2, 1, unused_options_sendback, 2, 3, 4, "pass", 5, 6};
+    auto dummy_callout = std::make_unique<Callout>(std::initializer_list<net_call_out_rec>{n});
     BinkP::received_transfer_file_factory_t null_factory = [](const string&, const string& filename) { 
       return new InMemoryTransferFile(filename, "");
     };
@@ -80,6 +87,25 @@ protected:
     thread_.join();
   }
 
+  // Queues the frames a caller at node 2 in NR mode sends to log in.
+  void ReplyLogin() {
+    conn_.ReplyCommand(BinkpCommands::M_NUL, "OPT NR");
+    conn_.ReplyCommand(BinkpCommands::M_ADR, "20000:20000/2@wwivnet");
+    conn_.ReplyCommand(BinkpCommands::M_PWD, "pass");
+  }
+
+  // Returns the data of the commands sent by the BinkP, by command id.
+  std::map<uint8_t, std::vector<string>> SentCommands() {
+    std::map<uint8_t, std::vector<string>> result;
+    while (conn_.has_sent_packets()) {
+      auto packet = conn_.GetNextPacket();
+      if (packet.is_command()) {
+        result[packet.command()].push_back(packet.data().substr(1));
+      }
+    }
+    return result;
+  }
+
   unique_ptr<BinkP> binkp_;
   std::unique_ptr<BinkConfig> binkp_config_;
   FakeConnection conn_;
@@ -98,6 +124,46 @@ TEST_F(BinkTest, ErrorAbortsSession) {
   }
 }
 
+TEST_F(BinkTest, ResumeRefused_ReceivesFromStart) {
+  files_.Mkdir("network");
+  files_.Mkdir("network/partial");
+  PartialFiles partials(files_.Dir("network/partial"));
+  files_.CreateTempFile("network/partial/s1.net", "abc");
+  ASSERT_TRUE(partials.Save({"s1.net", 6, 1000, 0, 3, crc32string("abc")}));
+
+  ReplyLogin();
+  // We ask for the rest of the file, the remote sends it from the start again.
+  conn_.ReplyCommand(BinkpCommands::M_FILE, "s1.net 6 1000 0");
+  conn_.ReplyCommand(BinkpCommands::M_FILE, "s1.net 6 1000 0");
+  conn_.ReplyData("abcdef");
+  conn_.ReplyCommand(BinkpCommands::M_EOB, "done");
+  StartBinkpReceiver();
+  Stop();
+
+  EXPECT_FALSE(partials.Find("s1.net", 6, 1000));
+  auto sent = SentCommands();
+  EXPECT_EQ(std::vector<string>{"s1.net 6 1000 3"}, sent[BinkpCommands::M_GET]);
+  EXPECT_EQ(std::vector<string>{"s1.net 6 1000"}, sent[BinkpCommands::M_GOT]);
+}
+
+TEST_F(BinkTest, SocketErrorCountsAsSessionError) {
+  auto errors = Metrics::instance().counter("binkp_session_errors_total", "");
+  const auto before = errors.value();
+  conn_.Reset();
+  StartBinkpReceiver();
+  Stop();
+  EXPECT_EQ(before + 1, errors.value());
+}
+
+TEST(BinkpMetricsTest, RecordFailedCallout) {
+  auto& m = Metrics::instance();
+  const auto callouts = m.counter("binkp_callouts_total", "").value();
+  const auto failed = m.counter("binkp_callouts_failed_total", "").value();
+  record_failed_callout();
+  EXPECT_EQ(callouts + 1, m.counter("binkp_callouts_total", "").value());
+  EXPECT_EQ(failed + 1, m.counter("binkp_callouts_failed_total", "").value());
+}
+
 static int node_number_from_address_list(const std::string& addresses, const string& network_name) {
   const auto a = ftn_address_from_address_list(addresses, network_name);
   return wwivnet_node_number_from_ftn_address(a);
@@ -0,0 +1,145 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "binkp/binkp.h"
+#include "binkp/compression.h"
+#include "binkp/receive_file.h"
+#include "binkp/transfer_file.h"
+#include "core/crc32.h"
+#include <algorithm>
+#include <string>
+
+using namespace wwiv::core;
+using namespace wwiv::net;
+
+namespace {
+
+std::string text(int size) {
+  std::string s;
+  for (auto i = 0; static_cast<int>(s.size()) < size; i++) {
+    s += "AREA:WWIVNET This is line " + std::to_string(i % 97) + " of a message.\r\n";
+  }
+  s.resize(size);
+  return s;
+}
+
+std::string compress(const std::string& data, int chunk_size) {
+  GzCompressor gz;
+  std::string out;
+  for (auto start = 0; start < static_cast<int>(data.size()); start += chunk_size) {
+    const auto size = std::min<int>(chunk_size, static_cast<int>(data.size()) - start);
+    EXPECT_TRUE(gz.Compress(data.data() + start, size, start + size >= static_cast<int>(data.size()), out));
+  }
+  return out;
+}
+
+} // namespace
+
+TEST(CompressionTest, RoundTrip) {
+  const auto data = text(100000);
+  const auto compressed = compress(data, 16384);
+  EXPECT_LT(compressed.size(), data.size() / 4);
+
+  GzDecompressor gz;
+  std::string out;
+  // Feed it back in odd sized pieces.
+  for (size_t start = 0; start < compressed.size(); start += 1000) {
+    ASSERT_TRUE(gz.Decompress(compressed.data() + start,
+                              static_cast<int>(std::min<size_t>(1000, compressed.size() - start)), out));
+  }
+  EXPECT_TRUE(gz.finished());
+  EXPECT_EQ(data, out);
+}
+
+TEST(CompressionTest, Decompress_Garbage) {
+  GzDecompressor gz;
+  std::string out;
+  EXPECT_FALSE(gz.Decompress("not compressed", 14, out));
+}
+
+TEST(CompressionTest, ShouldCompress) {
+  EXPECT_TRUE(should_compress("s1234.net"));
+  EXPECT_TRUE(should_compress("00000001.pkt"));
+  EXPECT_TRUE(should_compress("NODELIST.123"));
+  EXPECT_TRUE(should_compress("README"));
+  EXPECT_FALSE(should_compress("files.ZIP"));
+  EXPECT_FALSE(should_compress("00010002.we0"));
+  EXPECT_FALSE(should_compress("00010002.SUA"));
+}
+
+TEST(CompressionTest, ReceiveFile_Gz) {
+  const auto data = text(50000);
+  const auto compressed = compress(data, 16384);
+  ReceiveFile r(new InMemoryTransferFile("foo.pkt", ""), "foo.pkt", static_cast<long>(data.size()),
+                0, 0);
+  r.set_compression(binkp_compression_t::gz);
+  const auto half = compressed.size() / 2;
+  ASSERT_TRUE(r.WriteChunk(compressed.substr(0, half)));
+  EXPECT_FALSE(r.complete());
+  ASSERT_TRUE(r.WriteChunk(compressed.substr(half)));
+  EXPECT_TRUE(r.complete());
+  EXPECT_EQ(static_cast<long>(data.size()), r.length());
+  EXPECT_EQ(crc32string(data), r.received_crc());
+  EXPECT_EQ(data, dynamic_cast<InMemoryTransferFile*>(r.file_.get())->contents());
+}
+
+TEST(CompressionTest, ReceiveFile_Gz_Truncated) {
+  const auto data = text(50000);
+  const auto compressed = compress(data.substr(0, 40000), 16384);
+  ReceiveFile r(new InMemoryTransferFile("foo.pkt", ""), "foo.pkt", static_cast<long>(data.size()),
+                0, 0);
+  r.set_compression(binkp_compression_t::gz);
+  ASSERT_TRUE(r.WriteChunk(compressed));
+  EXPECT_EQ(40000, r.length());
+  EXPECT_FALSE(r.complete());
+  EXPECT_TRUE(r.wrong_length());
+}
+
+TEST(CompressionTest, ReceiveFile_Gz_TooLong) {
+  const auto data = text(50000);
+  const auto compressed = compress(data, 16384);
+  ReceiveFile r(new InMemoryTransferFile("foo.pkt", ""), "foo.pkt", 40000, 0, 0);
+  r.set_compression(binkp_compression_t::gz);
+  const auto half = compressed.size() / 2;
+  ASSERT_TRUE(r.WriteChunk(compressed.substr(0, half)));
+  ASSERT_TRUE(r.WriteChunk(compressed.substr(half)));
+  EXPECT_FALSE(r.complete());
+  EXPECT_TRUE(r.wrong_length());
+}
+
+TEST(CompressionTest, ParseFileRequestLine_Gz) {
+  std::string filename;
+  long length = 0;
+  time_t timestamp = 0;
+  long offset = 0;
+  uint32_t crc = 0;
+  auto compression = binkp_compression_t::none;
+  ASSERT_TRUE(ParseFileRequestLine("foo.pkt 100 200 0 1234abcd GZ", &filename, &length, &timestamp,
+                                   &offset, &crc, &compression));
+  EXPECT_EQ("foo.pkt", filename);
+  EXPECT_EQ(0x1234abcdu, crc);
+  EXPECT_EQ(binkp_compression_t::gz, compression);
+
+  ASSERT_TRUE(ParseFileRequestLine("foo.pkt 100 200 0 GZ", &filename, &length, &timestamp, &offset,
+                                   &crc, &compression));
+  EXPECT_EQ(binkp_compression_t::gz, compression);
+
+  EXPECT_FALSE(ParseFileRequestLine("foo.pkt 100 200 0 BZ2", &filename, &length, &timestamp,
+                                    &offset, &crc, &compression));
+}
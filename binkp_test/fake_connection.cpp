@@ -39,9 +39,9 @@ using namespace wwiv::net;
 
 FakeBinkpPacket::FakeBinkpPacket(const void* data, int size) {
   auto p = static_cast<const char*>(data);
-  header_ = (*p++) << 8;
-  header_ = header_ | *p++;
-  is_command_ = (header_ | 0x8000) != 0;
+  header_ = static_cast<uint8_t>(*p++) << 8;
+  header_ = header_ | static_cast<uint8_t>(*p++);
+  is_command_ = (header_ & 0x8000) != 0;
   header_ &= 0x7fff;
 
   if (is_command_) {
@@ -75,12 +75,15 @@ FakeConnection::~FakeConnection() = default;
 uint16_t FakeConnection::read_uint16(std::chrono::duration<double> d) {
   auto predicate = [&]() { 
     std::lock_guard<std::mutex> lock(mu_);
-    return !receive_queue_.empty();
+    return !receive_queue_.empty() || reset_;
   };
   if (!wait_for(predicate, d)) {
     throw timeout_error("timedout on read_uint16");
   }
   std::lock_guard<std::mutex> lock(mu_);
+  if (receive_queue_.empty()) {
+    throw socket_error("connection reset on read_uint16");
+  }
   const auto& packet = receive_queue_.front();
   auto header = packet.header();
   if (packet.is_command()) {
@@ -124,7 +127,8 @@ string FakeConnection::receive(int, duration<double> d) {
   std::lock_guard<std::mutex> lock(mu_);
   wwiv::core::ScopeExit on_exit([=] { receive_queue_.pop(); });
   const FakeBinkpPacket& front = receive_queue_.front();
-  return front.data();
+  // The command id was already read by read_uint8.
+  return front.is_command() ? front.data().substr(1) : front.data();
 }
 
 int FakeConnection::send(const void* data, int size, std::chrono::duration<double>) {
@@ -173,5 +177,24 @@ void FakeConnection::ReplyCommand(int8_t command_id, const string& data) {
   receive_queue_.push(FakeBinkpPacket(packet.get(), size));
 }
 
+// Reply to the BinkP with a data frame.
+void FakeConnection::ReplyData(const string& data) {
+  const int size = 2 + static_cast<int>(data.size());
+  unique_ptr<char[]> packet(new char[size]);
+  const auto packet_length = static_cast<uint16_t>(data.size());
+  auto* p = packet.get();
+  *p++ = static_cast<char>((packet_length & 0x7f00) >> 8);
+  *p++ = static_cast<char>(packet_length & 0x00ff);
+  memcpy(p, data.data(), data.size());  // NOLINT(bugprone-not-null-terminated-result)
+
+  std::lock_guard<std::mutex> lock(mu_);
+  receive_queue_.push(FakeBinkpPacket(packet.get(), size));
+}
+
+void FakeConnection::Reset() {
+  std::lock_guard<std::mutex> lock(mu_);
+  reset_ = true;
+}
+
 bool FakeConnection::is_open() const { return open_; }
-bool FakeConnection::close() { open_ = false; return true; }
\ No newline at end of file
+bool FakeConnection::close() { open_ = false; return true; }
@@ -65,6 +65,9 @@ public:
   bool has_sent_packets() const;
   FakeBinkpPacket GetNextPacket();
   void ReplyCommand(int8_t command_id, const std::string& data);
+  void ReplyData(const std::string& data);
+  // Once the queued replies are read, reading fails with a socket_error.
+  void Reset();
 
   // GUARDED_BY(mu_)
   std::queue<FakeBinkpPacket> receive_queue_;
@@ -72,7 +75,8 @@ public:
   std::queue<FakeBinkpPacket> send_queue_;
 private:
   mutable std::mutex mu_;
-  bool open_{};
+  bool open_{true};
+  bool reset_{false};
 };
 
 #endif
\ No newline at end of file
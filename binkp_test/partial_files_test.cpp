@@ -0,0 +1,99 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "binkp/partial_files.h"
+#include "binkp/receive_file.h"
+#include "binkp/transfer_file.h"
+#include "core/crc32.h"
+#include "core/file.h"
+#include "core_test/file_helper.h"
+#include <string>
+
+using namespace wwiv::core;
+using namespace wwiv::net;
+
+class PartialFilesTest : public testing::Test {
+public:
+  PartialFilesTest() : partials_(helper_.TempDir()) {}
+
+  FileHelper helper_;
+  PartialFiles partials_;
+};
+
+TEST_F(PartialFilesTest, SaveAndFind) {
+  helper_.CreateTempFile("s1234.net", "ASDF");
+  const partial_file_t p{"s1234.net", 10, 1234567, 0xDEADBEEF, 4, 0x12345678};
+  ASSERT_TRUE(partials_.Save(p));
+
+  const auto o = partials_.Find("s1234.net", 10, 1234567);
+  ASSERT_TRUE(o);
+  EXPECT_EQ(p.filename, o->filename);
+  EXPECT_EQ(p.size, o->size);
+  EXPECT_EQ(p.timestamp, o->timestamp);
+  EXPECT_EQ(p.crc, o->crc);
+  EXPECT_EQ(p.offset, o->offset);
+  EXPECT_EQ(p.offset_crc, o->offset_crc);
+}
+
+TEST_F(PartialFilesTest, Find_DifferentFile) {
+  helper_.CreateTempFile("s1234.net", "ASDF");
+  ASSERT_TRUE(partials_.Save({"s1234.net", 10, 1234567, 0, 4, 0}));
+
+  EXPECT_FALSE(partials_.Find("s1234.net", 11, 1234567));
+  EXPECT_FALSE(partials_.Find("s1234.net", 10, 1234568));
+  EXPECT_FALSE(partials_.Find("s5678.net", 10, 1234567));
+}
+
+TEST_F(PartialFilesTest, Find_NoData) {
+  ASSERT_TRUE(partials_.Save({"s1234.net", 10, 1234567, 0, 4, 0}));
+  EXPECT_FALSE(partials_.Find("s1234.net", 10, 1234567));
+}
+
+TEST_F(PartialFilesTest, Remove) {
+  helper_.CreateTempFile("s1234.net", "ASDF");
+  ASSERT_TRUE(partials_.Save({"s1234.net", 10, 1234567, 0, 4, 0}));
+  ASSERT_TRUE(partials_.Remove("s1234.net"));
+  EXPECT_FALSE(partials_.Find("s1234.net", 10, 1234567));
+  EXPECT_FALSE(File::Exists(partials_.data_path("s1234.net")));
+}
+
+TEST_F(PartialFilesTest, ReceiveFile_ResumeContinuesCrc) {
+  const std::string contents = "Hello World, this is a partial file.";
+  const auto expected_crc = crc32string(contents);
+  const auto half = static_cast<int>(contents.size() / 2);
+  partial_file_t p{};
+  {
+    ReceiveFile r(new InMemoryTransferFile("test.dat", ""), "test.dat",
+                  static_cast<long>(contents.size()), 1234, expected_crc);
+    ASSERT_TRUE(r.WriteChunk(contents.substr(0, half)));
+    ASSERT_TRUE(r.SavePartial(partials_.data_path("test.dat")));
+    p = {"test.dat", static_cast<int>(contents.size()), 1234, expected_crc, half, r.received_crc()};
+    ASSERT_TRUE(partials_.Save(p));
+  }
+
+  const auto o = partials_.Find("test.dat", static_cast<int>(contents.size()), 1234);
+  ASSERT_TRUE(o);
+  auto* file = new InMemoryTransferFile("test.dat", "");
+  ReceiveFile r(file, "test.dat", static_cast<long>(contents.size()), 1234, expected_crc);
+  ASSERT_TRUE(r.Resume(partials_.data_path("test.dat"), o->offset, o->offset_crc));
+  EXPECT_EQ(half, r.length());
+  ASSERT_TRUE(r.WriteChunk(contents.substr(half)));
+  EXPECT_EQ(contents, file->contents());
+  EXPECT_EQ(expected_crc, r.received_crc());
+}
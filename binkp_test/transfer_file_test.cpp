@@ -141,3 +141,34 @@ TEST_F(TransferFileTest, WFileTest_Write) {
   // Needed wfile_file to go out of scope before the file can be read.
   EXPECT_EQ(contents, file_helper_.ReadFile(empty_file_fullpath));
 }
+
+TEST_F(TransferFileTest, WFileTest_SaveAndResumePartial) {
+  const auto partial = file_helper_.CreateTempFilePath("partial.dat");
+  {
+    WFileTransferFile wfile_file("part", std::make_unique<File>(FilePath(file_helper_.TempDir(), "part")));
+    ASSERT_TRUE(wfile_file.WriteChunk(contents.c_str(), contents.size()));
+    ASSERT_TRUE(wfile_file.SavePartial(partial));
+  }
+  EXPECT_FALSE(File::Exists(FilePath(file_helper_.TempDir(), "part")));
+  EXPECT_EQ(contents, file_helper_.ReadFile(partial));
+
+  const auto resumed_path = FilePath(file_helper_.TempDir(), "resumed");
+  {
+    WFileTransferFile wfile_file("resumed", std::make_unique<File>(resumed_path));
+    ASSERT_TRUE(wfile_file.ResumePartial(partial, 2));
+    ASSERT_TRUE(wfile_file.WriteChunk("XY", 2));
+    wfile_file.Close();
+  }
+  EXPECT_FALSE(File::Exists(partial));
+  EXPECT_EQ("ASXY", file_helper_.ReadFile(resumed_path));
+}
+
+TEST_F(TransferFileTest, InMemory_SaveAndResumePartial) {
+  const auto partial = file_helper_.CreateTempFilePath("partial.dat");
+  ASSERT_TRUE(file.SavePartial(partial));
+
+  InMemoryTransferFile resumed("resumed", "");
+  ASSERT_TRUE(resumed.ResumePartial(partial, 3));
+  ASSERT_TRUE(resumed.WriteChunk("X", 1));
+  EXPECT_EQ("ASDX", resumed.contents());
+}
@@ -115,6 +115,9 @@ void Output::rputs(const std::string& text) {
   }
 }
 
+// Largest amount of buffered output held back before writing it to the remote.
+static constexpr size_t kMaxRemoteBufferSize = 8192;
+
 void Output::flush() {
   if (!bputch_buffer_.empty()) {
     remoteIO()->write(bputch_buffer_.c_str(), stl::size_int(bputch_buffer_));
@@ -127,7 +130,7 @@ void Output::rputch(char ch, bool use_buffer_) {
     return;
   }
   if (use_buffer_) {
-    if (bputch_buffer_.size() > 1024) {
+    if (bputch_buffer_.size() >= kMaxRemoteBufferSize) {
       flush();
     }
     bputch_buffer_.push_back(ch);
@@ -22,6 +22,7 @@
 #include "common/input.h"
 #include "common/macro_context.h"
 #include "core/eventbus.h"
+#include "core/scope_exit.h"
 #include "core/strings.h"
 #include "fmt/printf.h"
 #include "local_io/keycodes.h"
@@ -321,6 +322,14 @@ int Output::bputs(const string& text) {
   core::bus().invoke<CheckForHangupEvent>();
   if (text.empty() || sess().hangup()) { return 0; }
   auto& ctx = macro_context_provider_();
+  // Pipe codes and macros expand into nested calls to bputs, so only the
+  // outermost one sends the buffer to the remote side.
+  ++bputs_depth_;
+  core::ScopeExit at_exit([this] {
+    if (--bputs_depth_ == 0) {
+      flush();
+    }
+  });
 
   auto it = std::cbegin(text);
   const auto fin = std::cend(text);
@@ -395,7 +404,6 @@ int Output::bputs(const string& text) {
     }
   }
 
-  flush();
   return ssize(stripcolors(text));
 }
 
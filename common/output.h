@@ -245,6 +245,8 @@ private:
   char GetKeyForPause();
 
   std::string bputch_buffer_;
+  // Number of calls to bputs currently in progress.
+  int bputs_depth_{0};
   std::vector<std::pair<char, uint8_t>> current_line_;
   int x_{0};
   // Means we need to reset the color before displaying our
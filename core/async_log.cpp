@@ -0,0 +1,171 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "core/async_log.h"
+
+#include "core/os.h"
+#include "core/stl.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace wwiv::core {
+
+static const int kLogFileMode =
+    File::modeReadWrite | File::modeAppend | File::modeBinary | File::modeCreateFile;
+
+AsyncLogWriter::AsyncLogWriter(std::size_t max_pending_bytes)
+    : max_pending_bytes_(max_pending_bytes) {}
+
+AsyncLogWriter::~AsyncLogWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    if (os::get_pid() == pid_) {
+      thread_.join();
+    } else {
+      // The writer thread does not exist in a forked child.
+      thread_.detach();
+    }
+  }
+  drain();
+}
+
+// static
+AsyncLogWriter& AsyncLogWriter::instance() {
+  // Never destroyed, so that anything logged while other statics are
+  // being destroyed still has somewhere to go.
+  static auto* writer = [] {
+    auto* w = new AsyncLogWriter();
+    std::atexit([] { instance().flush(); });
+    return w;
+  }();
+  return *writer;
+}
+
+void AsyncLogWriter::start() {
+  pid_ = os::get_pid();
+  thread_ = std::thread([this] { run(); });
+}
+
+bool AsyncLogWriter::append(const std::filesystem::path& path, std::string text) {
+  if (text.empty()) {
+    return true;
+  }
+  std::call_once(started_, [this] { start(); });
+  if (os::get_pid() != pid_) {
+    File file(path);
+    return file.Open(kLogFileMode) && file.Write(text) == stl::ssize(text);
+  }
+
+  const auto size = text.size();
+  if (pending_bytes_.fetch_add(size) + size > max_pending_bytes_) {
+    pending_bytes_.fetch_sub(size);
+    ++dropped_;
+    return false;
+  }
+
+  auto* e = new entry_t{path, std::move(text), head_.load(std::memory_order_relaxed)};
+  while (!head_.compare_exchange_weak(e->next, e, std::memory_order_release,
+                                      std::memory_order_relaxed)) {
+  }
+  cv_.notify_one();
+  return true;
+}
+
+void AsyncLogWriter::flush() {
+  if (os::get_pid() != pid_) {
+    // Either nothing was ever queued, or we are a forked child and
+    // everything was written directly.
+    return;
+  }
+  drain();
+}
+
+void AsyncLogWriter::close_files() {
+  std::lock_guard<std::mutex> lock(drain_mu_);
+  files_.clear();
+}
+
+void AsyncLogWriter::run() {
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      // The timeout covers a notify that lands between the check and the wait.
+      cv_.wait_for(lock, std::chrono::milliseconds(250),
+                   [this] { return stop_ || head_.load() != nullptr; });
+      if (stop_ && head_.load() == nullptr) {
+        return;
+      }
+    }
+    drain();
+  }
+}
+
+void AsyncLogWriter::drain() {
+  std::lock_guard<std::mutex> lock(drain_mu_);
+  auto* list = head_.exchange(nullptr, std::memory_order_acquire);
+  if (list == nullptr) {
+    return;
+  }
+
+  // The queue is newest first, so reverse it to write in order.
+  entry_t* e = nullptr;
+  while (list != nullptr) {
+    auto* next = list->next;
+    list->next = e;
+    e = list;
+    list = next;
+  }
+
+  // Combine everything for each file into one write.
+  std::vector<std::pair<std::filesystem::path, std::string>> batches;
+  std::size_t bytes = 0;
+  while (e != nullptr) {
+    std::unique_ptr<entry_t> current(e);
+    e = e->next;
+    bytes += current->text.size();
+    auto it = std::find_if(std::begin(batches), std::end(batches),
+                           [&](const auto& b) { return b.first == current->path; });
+    if (it == std::end(batches)) {
+      batches.emplace_back(std::move(current->path), std::move(current->text));
+    } else {
+      it->second.append(current->text);
+    }
+  }
+
+  for (const auto& [path, text] : batches) {
+    auto& file = files_[path];
+    if (!file) {
+      file = std::make_unique<File>(path);
+    }
+    if (!file->IsOpen() && !file->Open(kLogFileMode)) {
+      // We don't want to crash if we can't log, so drop it.
+      files_.erase(path);
+      continue;
+    }
+    file->Write(text);
+  }
+  pending_bytes_.fetch_sub(bytes);
+}
+
+} // namespace wwiv::core
@@ -0,0 +1,108 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_CORE_ASYNC_LOG_H
+#define INCLUDED_CORE_ASYNC_LOG_H
+
+#include "core/file.h"
+#include "core/wwivport.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace wwiv::core {
+
+/**
+ * Appends text to log files from a background thread.
+ *
+ * Any thread may call append, which only links the text onto a lock-free
+ * queue.  The writer thread takes everything queued at once, keeps the
+ * files open between batches and writes all of the text for a file with
+ * a single write.
+ *
+ * At most max_pending_bytes may be waiting to be written; anything past
+ * that is dropped (and counted in dropped()) rather than letting a stalled
+ * disk grow memory without bound.
+ *
+ * Text appended from a process other than the one that started the
+ * writer (i.e. after fork) is written directly.
+ */
+class AsyncLogWriter final {
+public:
+  static constexpr std::size_t kDefaultMaxPendingBytes = 4 * 1024 * 1024;
+
+  explicit AsyncLogWriter(std::size_t max_pending_bytes = kDefaultMaxPendingBytes);
+  /** Writes everything that has been queued and stops the writer thread. */
+  ~AsyncLogWriter();
+  AsyncLogWriter(const AsyncLogWriter&) = delete;
+  AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+  /** The writer shared by the Logger and the sysop log. */
+  static AsyncLogWriter& instance();
+
+  /**
+   * Queues text (which should include any line ending) to be appended to
+   * path.  Returns false if it was dropped.
+   */
+  bool append(const std::filesystem::path& path, std::string text);
+
+  /** Blocks until everything appended before this call has been written. */
+  void flush();
+
+  /** Closes all of the open files, i.e. before they are renamed or removed. */
+  void close_files();
+
+  [[nodiscard]] int64_t dropped() const noexcept { return dropped_.load(); }
+
+private:
+  struct entry_t {
+    std::filesystem::path path;
+    std::string text;
+    entry_t* next{nullptr};
+  };
+
+  void start();
+  void run();
+  // Writes everything currently queued. Only called by one thread at a time.
+  void drain();
+
+  const std::size_t max_pending_bytes_;
+  std::atomic<entry_t*> head_{nullptr};
+  std::atomic<std::size_t> pending_bytes_{0};
+  std::atomic<int64_t> dropped_{0};
+
+  std::once_flag started_;
+  pid_t pid_{0};
+  std::thread thread_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool stop_{false};
+
+  // Held while writing, so that flush can drain from any thread.
+  std::mutex drain_mu_;
+  std::map<std::filesystem::path, std::unique_ptr<File>> files_;
+};
+
+} // namespace wwiv::core
+
+#endif
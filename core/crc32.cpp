@@ -1,10 +1,23 @@
 /*
 *  Crc - 32 BIT ANSI X3.66 CRC checksum files
 */
+#include "core/crc32.h"
+
 #include "core/file.h"
+#include <array>
 #include <memory>
 #include <string>
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define WWIV_CRC32_PCLMUL
+#include <emmintrin.h>
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
 namespace wwiv::core {
 
 /**********************************************************************\
@@ -68,7 +81,7 @@ namespace wwiv::core {
 /*     hardware you could probably optimize the shift in assembler by  */
 /*     using byte-swap instructions.                                   */
 
-static uint32_t crc_32_tab[] = { /* CRC polynomial 0xedb88320 */
+static constexpr uint32_t crc_32_tab[256] = { /* CRC polynomial 0xedb88320 */
     0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3,
     0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988, 0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91,
     0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
@@ -105,29 +118,203 @@ static uint32_t crc_32_tab[] = { /* CRC polynomial 0xedb88320 */
 
 #define UPDC32(octet, crc) (crc_32_tab[((crc) ^ (octet)) & 0xff] ^ ((crc) >> 8))
 
+// Size of the chunks read from files.
+static constexpr int kFileChunkSize = 64 * 1024;
+
+/*
+ * Tables for slicing-by-8, which runs the CRC over eight bytes at a time.
+ * Table n gives the CRC of a byte followed by n zero bytes; table 0 is
+ * crc_32_tab.
+ */
+static constexpr std::array<std::array<uint32_t, 256>, 8> make_slice_tables() {
+  std::array<std::array<uint32_t, 256>, 8> t{};
+  for (auto i = 0; i < 256; i++) {
+    t[0][i] = crc_32_tab[i];
+  }
+  for (auto n = 1; n < 8; n++) {
+    for (auto i = 0; i < 256; i++) {
+      t[n][i] = (t[n - 1][i] >> 8) ^ crc_32_tab[t[n - 1][i] & 0xff];
+    }
+  }
+  return t;
+}
+
+static constexpr auto slice_tab = make_slice_tables();
+
+static inline uint32_t load32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+         static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+}
+
+namespace internal {
+
+uint32_t crc32_bytewise(uint32_t crc, const uint8_t* p, std::size_t size) noexcept {
+  for (std::size_t i = 0; i < size; i++) {
+    crc = UPDC32(p[i], crc);
+  }
+  return crc;
+}
+
+uint32_t crc32_slice8(uint32_t crc, const uint8_t* p, std::size_t size) noexcept {
+  for (; size >= 8; size -= 8, p += 8) {
+    const auto one = crc ^ load32(p);
+    const auto two = load32(p + 4);
+    crc = slice_tab[7][one & 0xff] ^ slice_tab[6][(one >> 8) & 0xff] ^
+          slice_tab[5][(one >> 16) & 0xff] ^ slice_tab[4][one >> 24] ^
+          slice_tab[3][two & 0xff] ^ slice_tab[2][(two >> 8) & 0xff] ^
+          slice_tab[1][(two >> 16) & 0xff] ^ slice_tab[0][two >> 24];
+  }
+  return crc32_bytewise(crc, p, size);
+}
+
+#ifdef WWIV_CRC32_PCLMUL
+
+bool crc32_has_pclmul() noexcept {
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 1);
+  // ECX bit 1 is PCLMULQDQ and bit 19 is SSE4.1
+  return (info[2] & (1 << 1)) && (info[2] & (1 << 19));
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+/*
+ * Folds 64 bytes at a time using carry-less multiplication, then Barrett
+ * reduces to 32 bits.  See "Fast CRC Computation for Generic Polynomials
+ * Using PCLMULQDQ Instruction", Intel, 2009; the constants are the
+ * bit-reflected ones for polynomial 0xedb88320 from the end of that paper.
+ * size must be at least 64 and a multiple of 16.
+ */
+#ifndef _MSC_VER
+__attribute__((target("pclmul,sse4.1")))
+#endif
+static uint32_t crc32_fold(uint32_t crc, const uint8_t* p, std::size_t size) noexcept {
+  alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+  alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+  alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+  alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+  auto x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 0x00));
+  auto x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 0x10));
+  auto x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 0x20));
+  auto x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 0x30));
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+  auto k = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+  p += 64;
+  size -= 64;
+
+  // Fold four 128 bit lanes in parallel.
+  for (; size >= 64; p += 64, size -= 64) {
+    const auto x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+    const auto x6 = _mm_clmulepi64_si128(x2, k, 0x00);
+    const auto x7 = _mm_clmulepi64_si128(x3, k, 0x00);
+    const auto x8 = _mm_clmulepi64_si128(x4, k, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, k, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, k, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, k, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 0x00)));
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 0x10)));
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 0x20)));
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 0x30)));
+  }
+
+  // Fold the four lanes into one.
+  k = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+  for (const auto& x : {x2, x3, x4}) {
+    const auto x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x), x5);
+  }
+
+  // Fold in any remaining 16 byte blocks.
+  for (; size >= 16; p += 16, size -= 16) {
+    const auto x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))), x5);
+  }
+
+  // Fold 128 bits down to 64.
+  x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+  const auto mask = _mm_setr_epi32(~0, 0, ~0, 0);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduction to 32 bits.
+  k = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), k, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+uint32_t crc32_pclmul(uint32_t crc, const uint8_t* p, std::size_t size) noexcept {
+  if (size >= 64) {
+    const auto folded = size & ~static_cast<std::size_t>(15);
+    crc = crc32_fold(crc, p, folded);
+    p += folded;
+    size -= folded;
+  }
+  return crc32_slice8(crc, p, size);
+}
+
+#else
+
+bool crc32_has_pclmul() noexcept { return false; }
+
+uint32_t crc32_pclmul(uint32_t crc, const uint8_t* p, std::size_t size) noexcept {
+  return crc32_slice8(crc, p, size);
+}
+
+#endif // WWIV_CRC32_PCLMUL
+
+} // namespace internal
+
+using crc32_kernel_t = uint32_t (*)(uint32_t, const uint8_t*, std::size_t) noexcept;
+
+static crc32_kernel_t crc32_kernel() {
+  static const crc32_kernel_t kernel =
+      internal::crc32_has_pclmul() ? internal::crc32_pclmul : internal::crc32_slice8;
+  return kernel;
+}
+
+const char* crc32_implementation() {
+  return crc32_kernel() == internal::crc32_pclmul ? "pclmul" : "slice8";
+}
+
+Crc32& Crc32::update(const void* data, std::size_t size) noexcept {
+  crc_ = crc32_kernel()(crc_, static_cast<const uint8_t*>(data), size);
+  return *this;
+}
+
 uint32_t crc32file(const std::filesystem::path& path) {
-  uint32_t crc = 0xFFFFFFFF;
   File file(path);
   if (!file.Open(File::modeReadOnly | File::modeBinary, File::shareDenyWrite)) {
-    return false;
-  }
-  const auto size = file.length();
-  const auto buffer = std::make_unique<uint8_t[]>(size);
-  if (!file.Read(buffer.get(), size)) {
-    return false;
+    return 0;
   }
-  for (auto i = 0; i < size; i++) {
-    crc = UPDC32(buffer[i], crc);
+  const auto buffer = std::make_unique<uint8_t[]>(kFileChunkSize);
+  Crc32 crc;
+  for (;;) {
+    const auto num_read = file.Read(buffer.get(), kFileChunkSize);
+    if (num_read < 0) {
+      return 0;
+    }
+    if (num_read == 0) {
+      break;
+    }
+    crc.update(buffer.get(), static_cast<std::size_t>(num_read));
   }
-  return ~crc;
+  return crc.value();
 }
 
 uint32_t crc32string(const std::string& contents) {
-  uint32_t crc = 0xFFFFFFFF;
-  for (const auto& c : contents) {
-    crc = UPDC32(c, crc);
-  }
-  return ~crc;
+  return Crc32().update(contents).value();
 }
 
 }
@@ -18,14 +18,56 @@
 #ifndef INCLUDED_CORE_CRC32_H
 #define INCLUDED_CORE_CRC32_H
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <string>
+#include <string_view>
 
 namespace wwiv::core {
 
+/**
+ * Incremental CRC-32 (the polynomial used by zip, binkp and TIC files).
+ *
+ * Data may be added in as many pieces as needed:
+ *   Crc32 crc;
+ *   crc.update(header, sizeof(header)).update(body);
+ *   return crc.value();
+ *
+ * The fastest kernel supported by the CPU is picked the first time it is used.
+ */
+class Crc32 final {
+public:
+  Crc32() = default;
+  /** Continues a CRC from an earlier value(), i.e. one saved with a partial file. */
+  explicit Crc32(uint32_t value) noexcept : crc_(~value) {}
+
+  Crc32& update(const void* data, std::size_t size) noexcept;
+  Crc32& update(std::string_view s) noexcept { return update(s.data(), s.size()); }
+  [[nodiscard]] uint32_t value() const noexcept { return ~crc_; }
+  void reset() noexcept { crc_ = 0xFFFFFFFF; }
+
+private:
+  uint32_t crc_{0xFFFFFFFF};
+};
+
+/** Returns the CRC-32 of the file at path, or 0 if it can not be read. */
 [[nodiscard]] uint32_t crc32file(const std::filesystem::path& path);
 [[nodiscard]] uint32_t crc32string(const std::string& contents);
 
+/** Returns the name of the CRC-32 kernel in use, i.e. "pclmul" or "slice8". */
+[[nodiscard]] const char* crc32_implementation();
+
+namespace internal {
+// The individual kernels, exposed for tests and benchmarks.  They take and
+// return the uninverted CRC register.
+uint32_t crc32_bytewise(uint32_t crc, const uint8_t* p, std::size_t size) noexcept;
+uint32_t crc32_slice8(uint32_t crc, const uint8_t* p, std::size_t size) noexcept;
+// Returns true if crc32_pclmul may be called on this CPU.
+bool crc32_has_pclmul() noexcept;
+uint32_t crc32_pclmul(uint32_t crc, const uint8_t* p, std::size_t size) noexcept;
+} // namespace internal
+
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -3,16 +3,14 @@
 #include "core/graphs.h"
 
 #include <cmath>
-#include <iostream>
-#include <vector>
-#include <string>
-#include <list>
+#include <functional>
 #include <limits>
-#include <set>
-#include <utility>
-#include <algorithm>
-#include <iterator>
+#include <list>
+#include <queue>
 #include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace wwiv::graphs {
 
@@ -23,55 +21,96 @@ static constexpr uint16_t NO_NODE = 0;
 static constexpr float max_cost = numeric_limits<float>::infinity();
 
 Graph::Graph(uint16_t node, uint16_t max_size)
-  : node_(node), adjacency_list_(max_size) {
-  cost_.clear();
+  : node_(node), max_size_(max_size) {
   cost_.resize(max_size, max_cost);
   cost_[node] = 0;
-  previous_.clear();
   previous_.resize(max_size, NO_NODE);
 }
 
 Graph::~Graph() = default;
 
 bool Graph::add_edge(uint16_t source, uint16_t dest, float cost) {
-  if (computed_) {
+  if (computed_ || source >= max_size_ || dest >= max_size_) {
     return false;
   }
 
-  //VLOG(3) << "adding edge: " << source << " " << dest << " " << cost << " " << std::boolalpha << computed_ << std::endl;
-  adjacency_list_[source].emplace_back(dest, cost);
+  pending_.push_back({source, dest, cost});
   return true;
 }
 
 bool Graph::has_node(uint16_t source) {
-  return !adjacency_list_[source].empty();
+  if (!computed_) {
+    Compute();
+  }
+  return source < max_size_ && offsets_[source + 1] != offsets_[source];
 }
 
+bool Graph::reachable(uint16_t destination) {
+  if (!computed_) {
+    Compute();
+  }
+  return destination < max_size_ && std::isfinite(cost_[destination]);
+}
 
 void Graph::Compute() {
   computed_ = true;
-  std::set<std::pair<float, uint16_t>> queue;
-  queue.insert(std::make_pair(cost_[node_], node_));
+
+  // Pack the edges by source node, keeping them in the order they were added.
+  offsets_.assign(max_size_ + 1, 0);
+  for (const auto& e : pending_) {
+    ++offsets_[e.source + 1];
+  }
+  for (auto i = 0; i < max_size_; i++) {
+    offsets_[i + 1] += offsets_[i];
+  }
+  edges_.resize(pending_.size(), edge(NO_NODE, 0));
+  auto pos = offsets_;
+  for (const auto& e : pending_) {
+    edges_[pos[e.source]++] = edge(e.dest, e.cost);
+  }
+  pending_.clear();
+  pending_.shrink_to_fit();
+
+  using entry_t = std::pair<float, uint16_t>;
+  std::priority_queue<entry_t, std::vector<entry_t>, std::greater<>> queue;
+  queue.emplace(cost_[node_], node_);
+  // Nodes in the order their shortest path was found, so every node comes
+  // after the node before it on that path.
+  std::vector<uint16_t> order;
 
   while (!queue.empty()) {
-    const auto dist = queue.begin()->first;
-    const auto u = queue.begin()->second;
-    queue.erase(queue.begin());
+    const auto [dist, u] = queue.top();
+    queue.pop();
+    if (dist > cost_[u]) {
+      // A shorter path to u was already found.
+      continue;
+    }
+    order.push_back(u);
 
     // Visit each edge exiting u
-    const auto& edges = adjacency_list_[u];
-    for (const auto& e : edges) {
-      auto v = e.node_;
+    for (auto i = offsets_[u]; i < offsets_[u + 1]; i++) {
+      const auto& e = edges_[i];
+      const auto v = e.node_;
       const auto cost_through_u = dist + e.cost_;
       if (cost_through_u < cost_[v]) {
-        queue.erase(std::make_pair(cost_[v], v));
         cost_[v] = cost_through_u;
         previous_[v] = u;
-        queue.insert(std::make_pair(cost_[v], v));
+        queue.emplace(cost_through_u, v);
       }
     }
   }
-  //DumpCosts();
+
+  next_hop_.resize(max_size_, NO_NODE);
+  hops_.resize(max_size_, 0);
+  next_hop_[node_] = node_;
+  for (const auto v : order) {
+    if (v == node_) {
+      continue;
+    }
+    const auto p = previous_[v];
+    next_hop_[v] = p == node_ ? v : next_hop_[p];
+    hops_[v] = static_cast<uint16_t>(hops_[p] + 1);
+  }
 }
 
 float Graph::cost_to(uint16_t destination) {
@@ -81,11 +120,24 @@ float Graph::cost_to(uint16_t destination) {
   return cost_[destination];
 }
 
+uint16_t Graph::next_hop_to(uint16_t destination) {
+  if (!computed_) {
+    Compute();
+  }
+  return destination < max_size_ ? next_hop_[destination] : NO_NODE;
+}
+
+int Graph::num_hops_to(uint16_t destination) {
+  if (!computed_) {
+    Compute();
+  }
+  return destination < max_size_ ? hops_[destination] : 0;
+}
 
 std::string Graph::DumpCosts() const {
   std::ostringstream ss;
   ss << "costs_: ";
-  for (auto i = 0; i < std::numeric_limits<uint16_t>::max(); i++) {
+  for (auto i = 0; i < max_size_; i++) {
     const auto cost = cost_[i];
     if (std::isfinite(cost)) {
       ss << i << "[" << cost_[i] << "] ";
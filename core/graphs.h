@@ -19,7 +19,6 @@
 #ifndef INCLUDED_WWIV_GRAPHS_OS_H
 #define INCLUDED_WWIV_GRAPHS_OS_H
 
-#include "core/stl.h"
 #include <cstdint>
 #include <list>
 #include <string>
@@ -38,8 +37,6 @@ struct edge {
   }
 };
 
-typedef std::vector<std::vector<edge>> adjacency_list_t;
-
 /*
  Use:
  Graph net(1, 200);
@@ -49,6 +46,12 @@ typedef std::vector<std::vector<edge>> adjacency_list_t;
  net.add_edge(3, 2, 0);
 
  list<uint16_t> path = net.shortest_path_to(3);
+ uint16_t next = net.next_hop_to(3);
+
+ The edges are packed into a compressed sparse row adjacency list and the
+ shortest path to every node is computed the first time a path, cost or hop
+ is requested.  After that no more edges may be added, and the next hop, number
+ of hops and cost to any node are single array lookups.
  */
 class Graph final {
 public:
@@ -56,25 +59,40 @@ public:
   ~Graph();
 
   bool add_edge(uint16_t source, uint16_t dest, float cost);
+  /** Does source have any edges leaving it. */
   [[nodiscard]] bool has_node(uint16_t source);
+  /** Is there any path from node to destination. */
+  [[nodiscard]] bool reachable(uint16_t destination);
   [[nodiscard]] std::list<uint16_t> shortest_path_to(uint16_t destination);
   [[nodiscard]] float cost_to(uint16_t destination);
+  /**
+   * Returns the first node after node on the shortest path to destination, node
+   * itself if destination is node, or 0 if there is no path.
+   */
+  [[nodiscard]] uint16_t next_hop_to(uint16_t destination);
+  /** Returns the number of hops to destination, or 0 if there is no path. */
+  [[nodiscard]] int num_hops_to(uint16_t destination);
   [[nodiscard]] std::string DumpCosts() const;
 
-  [[nodiscard]] int num_hops_to(uint16_t destination) {
-    const auto path = shortest_path_to(destination);
-    if (path.empty()) {
-      return 0;
-    }
-    return stl::size_int(path) - 1;
-  }
-
 private:
+  struct pending_edge_t {
+    uint16_t source;
+    uint16_t dest;
+    float cost;
+  };
+
   uint16_t node_;
-  adjacency_list_t adjacency_list_;
+  uint16_t max_size_;
   bool computed_{false};
+  // Edges added before Compute packs them into offsets_ and edges_.
+  std::vector<pending_edge_t> pending_;
+  // Edges leaving node n are edges_[offsets_[n]] .. edges_[offsets_[n + 1] - 1].
+  std::vector<uint32_t> offsets_;
+  std::vector<edge> edges_;
   std::vector<float> cost_;
   std::vector<uint16_t> previous_;
+  std::vector<uint16_t> next_hop_;
+  std::vector<uint16_t> hops_;
 
   void Compute();
 };
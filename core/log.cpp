@@ -17,11 +17,11 @@
 /**************************************************************************/
 #include "core/log.h"
 
+#include "core/async_log.h"
 #include "core/command_line.h"
 #include "core/datetime.h"
 #include "core/file.h"
 #include "core/strings.h"
-#include "core/textfile.h"
 #include "core/version.h"
 #include "fmt/core.h"
 #include "fmt/printf.h"
@@ -61,18 +61,15 @@ public:
   }
 
   bool append(const std::string& message) override {
-    // Not super performant, but we'll start here and see how far this
-    // gets us.
     if (message.empty()) {
       return true;
     }
-    TextFile out(filename_, "a");
-    if (!out.IsOpen()) {
-      // We don't want to crash if we can't log, but what
-      // should we do instead?
-      return false;
-    }
-    return out.WriteLine(message) > 0;
+    // The file is opened in binary mode, so add the line ending for the platform.
+#ifdef _WIN32
+    return AsyncLogWriter::instance().append(filename_, StrCat(message, "\r\n"));
+#else
+    return AsyncLogWriter::instance().append(filename_, StrCat(message, "\n"));
+#endif
   }
 
 private:
@@ -132,6 +129,8 @@ Logger::~Logger() noexcept {
       a->append(msg);
     }
     if (level_ == LoggerLevel::fatal) {
+      // Make sure the reason we are aborting makes it to the log file.
+      AsyncLogWriter::instance().flush();
       abort();
     }
   } catch (...) {
@@ -167,6 +166,7 @@ void Logger::StartupLog(int argc, char* argv[]) {
 void Logger::ExitLogger() {
   const auto dt = DateTime::now();
   LOG(STARTUP) << config_.exit_filename << " exiting at " << dt.to_string();
+  AsyncLogWriter::instance().flush();
 }
 
 // static
@@ -0,0 +1,123 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "core/mapped_file.h"
+
+#include "core/log.h"
+#include <utility>
+
+#ifdef _WIN32
+#include "core/wwiv_windows.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace wwiv::core {
+
+MappedFile::MappedFile(std::filesystem::path path) : path_(std::move(path)) {}
+
+MappedFile::~MappedFile() { Close(); }
+
+bool MappedFile::Open() {
+  Close();
+#ifdef _WIN32
+  const auto h = CreateFileW(path_.wstring().c_str(), GENERIC_READ,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (h == INVALID_HANDLE_VALUE) {
+    VLOG(1) << "Unable to open file: " << path_.string();
+    return false;
+  }
+  LARGE_INTEGER size{};
+  if (!GetFileSizeEx(h, &size)) {
+    CloseHandle(h);
+    LOG(ERROR) << "Unable to get the size of file: " << path_.string();
+    return false;
+  }
+  if (size.QuadPart == 0) {
+    // Empty files can not be mapped.
+    CloseHandle(h);
+    open_ = true;
+    return true;
+  }
+  mapping_handle_ = CreateFileMappingW(h, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(h);
+  if (mapping_handle_ == nullptr) {
+    LOG(ERROR) << "Unable to map file: " << path_.string();
+    return false;
+  }
+  auto* p = MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0);
+  if (p == nullptr) {
+    CloseHandle(mapping_handle_);
+    mapping_handle_ = nullptr;
+    LOG(ERROR) << "Unable to map file: " << path_.string();
+    return false;
+  }
+  size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+  const auto fd = open(path_.string().c_str(), O_RDONLY);
+  if (fd < 0) {
+    VLOG(1) << "Unable to open file: " << path_.string();
+    return false;
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    LOG(ERROR) << "Unable to get the size of file: " << path_.string();
+    return false;
+  }
+  if (st.st_size == 0) {
+    // Empty files can not be mapped.
+    close(fd);
+    open_ = true;
+    return true;
+  }
+  const auto size = static_cast<std::size_t>(st.st_size);
+  auto* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    LOG(ERROR) << "Unable to map file: " << path_.string();
+    return false;
+  }
+  // Files are almost always read front to back.
+  madvise(p, size, MADV_SEQUENTIAL);
+  size_ = size;
+#endif
+  data_ = static_cast<const char*>(p);
+  open_ = true;
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data_ != nullptr) {
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_handle_);
+    mapping_handle_ = nullptr;
+#else
+    munmap(const_cast<char*>(data_), size_);
+#endif
+  }
+  data_ = nullptr;
+  size_ = 0;
+  open_ = false;
+}
+
+} // namespace wwiv::core
@@ -0,0 +1,62 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_CORE_MAPPED_FILE_H
+#define INCLUDED_CORE_MAPPED_FILE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace wwiv::core {
+
+/**
+ * A whole file mapped read only into memory, for reading large files without
+ * a read call (and a copy) for every record.
+ */
+class MappedFile final {
+public:
+  explicit MappedFile(std::filesystem::path path);
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  /** Maps the file. Returns false if it can not be opened or mapped. */
+  bool Open();
+  /** Unmaps the file, invalidating any views of it. */
+  void Close();
+
+  [[nodiscard]] bool is_open() const noexcept { return open_; }
+  [[nodiscard]] const std::filesystem::path& path() const noexcept { return path_; }
+  [[nodiscard]] const char* data() const noexcept { return data_; }
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+  /** The contents of the file, valid until the file is closed. */
+  [[nodiscard]] std::string_view view() const noexcept { return {data_, size_}; }
+
+private:
+  const std::filesystem::path path_;
+  bool open_{false};
+  const char* data_{nullptr};
+  std::size_t size_{0};
+#ifdef _WIN32
+  void* mapping_handle_{nullptr};
+#endif
+};
+
+} // namespace wwiv::core
+
+#endif
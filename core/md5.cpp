@@ -40,10 +40,12 @@
 #include <cstdint>
 #include <cstring>
 #include <iomanip>
+#include <memory>
 #include <string>
 #include <sstream>
 
 #include "md5.h"
+#include "core/file.h"
 
 /*
 * The basic MD5 functions.
@@ -294,6 +296,14 @@ void MD5_Final(unsigned char* result, MD5_CTX* ctx) {
   memset(ctx, 0, sizeof(*ctx));
 }
 
+static std::string to_hex(const unsigned char* hash) {
+  std::ostringstream ss;
+  for (int i = 0; i < 16; i++) {
+    ss << std::setw(2) << std::setfill('0') << std::hex << static_cast<int>(hash[i]);
+  }
+  return ss.str();
+}
+
 std::string md5(const std::string& text) {
   MD5_CTX ctx;
   MD5_Init(&ctx);
@@ -301,12 +311,32 @@ std::string md5(const std::string& text) {
   unsigned char hash[16];
   MD5_Update(&ctx, (void*)text.c_str(), text.size());
   MD5_Final(hash, &ctx);
+  return to_hex(hash);
+}
 
-  std::ostringstream ss;
-  for (int i = 0; i < 16; i++) {
-    ss << std::setw(2) << std::setfill('0') << std::hex << static_cast<int>(hash[i]);
+std::string md5file(const std::filesystem::path& path) {
+  wwiv::core::File file(path);
+  if (!file.Open(wwiv::core::File::modeReadOnly | wwiv::core::File::modeBinary,
+                 wwiv::core::File::shareDenyWrite)) {
+    return {};
   }
-  return ss.str();
+  MD5_CTX ctx;
+  MD5_Init(&ctx);
+  // Hash the file in chunks rather than reading it all into memory.
+  const auto buffer = std::make_unique<unsigned char[]>(64 * 1024);
+  for (;;) {
+    const auto num_read = file.Read(buffer.get(), 64 * 1024);
+    if (num_read < 0) {
+      return {};
+    }
+    if (num_read == 0) {
+      break;
+    }
+    MD5_Update(&ctx, buffer.get(), static_cast<unsigned long>(num_read));
+  }
+  unsigned char hash[16];
+  MD5_Final(hash, &ctx);
+  return to_hex(hash);
 }
 
 #endif
@@ -28,6 +28,7 @@
 #elif !defined(_MD5_H)
 #define _MD5_H
 
+#include <filesystem>
 #include <string>
 
 /* Any 32-bit or wider unsigned integer data type will do */
@@ -46,4 +47,7 @@ extern void MD5_Final(unsigned char* result, MD5_CTX* ctx);
 
 [[nodiscard]] std::string md5(const std::string& text);
 
+/* Returns the hex MD5 of the file at path, or an empty string if it can't be read. */
+[[nodiscard]] std::string md5file(const std::filesystem::path& path);
+
 #endif
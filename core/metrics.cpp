@@ -0,0 +1,245 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "core/metrics.h"
+
+#include "core/file.h"
+#include "core/log.h"
+#include "fmt/format.h"
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#ifdef _WIN32
+#include "core/wwiv_windows.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace wwiv::core {
+
+static constexpr char kMetricsSignature[4] = {'W', 'M', 'E', 'T'};
+static constexpr uint32_t kMetricsVersion = 1;
+static constexpr std::size_t kMetricsFileSize =
+    sizeof(metrics_header_t) + sizeof(metric_slot_t) * kMetricsMaxSlots;
+
+void Histogram::observe(std::chrono::duration<double> d) noexcept {
+  const auto ms = static_cast<uint64_t>(
+      std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::milliseconds>(d).count()));
+  auto bucket = 0;
+  while (bucket < kMetricsHistogramBuckets - 1 && ms > kMetricsBucketBoundsMillis[bucket]) {
+    ++bucket;
+  }
+  slot_->buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  slot_->sum_millis.fetch_add(ms, std::memory_order_relaxed);
+  slot_->count.fetch_add(1, std::memory_order_relaxed);
+}
+
+Metrics::Metrics() : local_(new metric_slot_t[kMetricsMaxSlots]()), slots_(local_.get()) {}
+
+Metrics::Metrics(const std::filesystem::path& path) : Metrics() {
+#ifdef _WIN32
+  const auto h = CreateFileW(path.wstring().c_str(), GENERIC_READ | GENERIC_WRITE,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (h == INVALID_HANDLE_VALUE) {
+    LOG(ERROR) << "Unable to open metrics file: " << path.string();
+    return;
+  }
+  // Creating the mapping grows the file to the full size if needed.
+  mapping_handle_ = CreateFileMappingW(h, nullptr, PAGE_READWRITE, 0,
+                                       static_cast<DWORD>(kMetricsFileSize), nullptr);
+  CloseHandle(h);
+  if (mapping_handle_ == nullptr) {
+    LOG(ERROR) << "Unable to map metrics file: " << path.string();
+    return;
+  }
+  auto* p = MapViewOfFile(mapping_handle_, FILE_MAP_ALL_ACCESS, 0, 0, kMetricsFileSize);
+  if (p == nullptr) {
+    CloseHandle(mapping_handle_);
+    mapping_handle_ = nullptr;
+    LOG(ERROR) << "Unable to map metrics file: " << path.string();
+    return;
+  }
+#else
+  const auto fd = open(path.string().c_str(), O_RDWR | O_CREAT, 0660);
+  if (fd < 0) {
+    LOG(ERROR) << "Unable to open metrics file: " << path.string();
+    return;
+  }
+  struct stat st {};
+  // Growing the file fills it with zeros, which is an empty set of metrics.
+  if (fstat(fd, &st) != 0 ||
+      (static_cast<std::size_t>(st.st_size) < kMetricsFileSize &&
+       ftruncate(fd, static_cast<off_t>(kMetricsFileSize)) != 0)) {
+    close(fd);
+    LOG(ERROR) << "Unable to size metrics file: " << path.string();
+    return;
+  }
+  auto* p = mmap(nullptr, kMetricsFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    LOG(ERROR) << "Unable to map metrics file: " << path.string();
+    return;
+  }
+#endif
+  auto* header = static_cast<metrics_header_t*>(p);
+  if (memcmp(header->signature, "\0\0\0\0", 4) == 0) {
+    // A new file. Two processes doing this at once write the same values.
+    header->version = kMetricsVersion;
+    header->num_slots = kMetricsMaxSlots;
+    header->slot_size = sizeof(metric_slot_t);
+    memcpy(header->signature, kMetricsSignature, sizeof(kMetricsSignature));
+  }
+  if (memcmp(header->signature, kMetricsSignature, 4) != 0 ||
+      header->version != kMetricsVersion || header->num_slots != kMetricsMaxSlots ||
+      header->slot_size != sizeof(metric_slot_t)) {
+    LOG(ERROR) << "Metrics file is not compatible, delete it to recreate it: " << path.string();
+#ifdef _WIN32
+    UnmapViewOfFile(p);
+    CloseHandle(mapping_handle_);
+    mapping_handle_ = nullptr;
+#else
+    munmap(p, kMetricsFileSize);
+#endif
+    return;
+  }
+  mapped_ = p;
+  mapped_size_ = kMetricsFileSize;
+  slots_ = reinterpret_cast<metric_slot_t*>(static_cast<char*>(p) + sizeof(metrics_header_t));
+  local_.reset();
+}
+
+Metrics::~Metrics() {
+  if (mapped_ == nullptr) {
+    return;
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(mapped_);
+  CloseHandle(mapping_handle_);
+#else
+  munmap(mapped_, mapped_size_);
+#endif
+}
+
+static std::mutex metrics_mu;
+static Metrics* metrics_instance = nullptr;
+
+// static
+bool Metrics::Init(const std::filesystem::path& datadir) {
+  std::lock_guard<std::mutex> lock(metrics_mu);
+  // Any previous instance is left alone since counters may still point
+  // into it.
+  metrics_instance = new Metrics(FilePath(datadir, "metrics.dat"));
+  return metrics_instance->shared();
+}
+
+// static
+Metrics& Metrics::instance() {
+  std::lock_guard<std::mutex> lock(metrics_mu);
+  if (metrics_instance == nullptr) {
+    metrics_instance = new Metrics();
+  }
+  return *metrics_instance;
+}
+
+metric_slot_t* Metrics::find_or_add(const std::string& name, const std::string& help,
+                                    metric_type_t type) {
+  const auto n = name.substr(0, sizeof(metric_slot_t::name) - 1);
+  for (auto i = 0; i < kMetricsMaxSlots; i++) {
+    auto& s = slots_[i];
+    auto t = s.type.load(std::memory_order_acquire);
+    if (t == metric_type_t::unused) {
+      if (!s.type.compare_exchange_strong(t, metric_type_t::claimed)) {
+        // Someone else took it first, look at what they put there.
+        --i;
+        continue;
+      }
+      strncpy(s.name, n.c_str(), sizeof(s.name) - 1);
+      strncpy(s.help, help.c_str(), sizeof(s.help) - 1);
+      s.type.store(type, std::memory_order_release);
+      return &s;
+    }
+    // Slots still being claimed by another process are skipped.  If that was
+    // the same name, both slots are used and summed by ToPrometheusText.
+    if (t == type && n == s.name) {
+      return &s;
+    }
+  }
+  LOG(ERROR) << "Too many metrics, unable to add: " << name;
+  return &overflow_;
+}
+
+Counter Metrics::counter(const std::string& name, const std::string& help) {
+  return Counter(find_or_add(name, help, metric_type_t::counter));
+}
+
+Histogram Metrics::histogram(const std::string& name, const std::string& help) {
+  return Histogram(find_or_add(name, help, metric_type_t::histogram));
+}
+
+std::string Metrics::ToPrometheusText() const {
+  struct totals_t {
+    metric_type_t type;
+    std::string help;
+    uint64_t count{0};
+    uint64_t sum_millis{0};
+    std::array<uint64_t, kMetricsHistogramBuckets> buckets{};
+  };
+  std::map<std::string, totals_t> metrics;
+  for (auto i = 0; i < kMetricsMaxSlots; i++) {
+    const auto& s = slots_[i];
+    const auto type = s.type.load(std::memory_order_acquire);
+    if (type != metric_type_t::counter && type != metric_type_t::histogram) {
+      continue;
+    }
+    auto& m = metrics[s.name];
+    m.type = type;
+    m.help = s.help;
+    m.count += s.count.load();
+    m.sum_millis += s.sum_millis.load();
+    for (auto b = 0; b < kMetricsHistogramBuckets; b++) {
+      m.buckets[b] += s.buckets[b].load();
+    }
+  }
+
+  std::string out;
+  for (const auto& [name, m] : metrics) {
+    out += fmt::format("# HELP {} {}\n", name, m.help);
+    if (m.type == metric_type_t::counter) {
+      out += fmt::format("# TYPE {} counter\n{} {}\n", name, name, m.count);
+      continue;
+    }
+    out += fmt::format("# TYPE {} histogram\n", name);
+    uint64_t cumulative = 0;
+    for (auto b = 0; b < kMetricsHistogramBuckets - 1; b++) {
+      cumulative += m.buckets[b];
+      out += fmt::format("{}_bucket{{le=\"{}\"}} {}\n", name,
+                         static_cast<double>(kMetricsBucketBoundsMillis[b]) / 1000.0, cumulative);
+    }
+    cumulative += m.buckets[kMetricsHistogramBuckets - 1];
+    out += fmt::format("{}_bucket{{le=\"+Inf\"}} {}\n", name, cumulative);
+    out += fmt::format("{}_sum {}\n", name, static_cast<double>(m.sum_millis) / 1000.0);
+    out += fmt::format("{}_count {}\n", name, m.count);
+  }
+  return out;
+}
+
+} // namespace wwiv::core
@@ -0,0 +1,141 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_CORE_METRICS_H
+#define INCLUDED_CORE_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace wwiv::core {
+
+enum class metric_type_t : uint32_t { unused = 0, claimed = 1, counter = 2, histogram = 3 };
+
+static constexpr int kMetricsMaxSlots = 128;
+static constexpr int kMetricsHistogramBuckets = 15;
+
+/**
+ * Upper bounds of the histogram buckets in milliseconds.  The last bucket
+ * holds everything larger.
+ */
+static constexpr std::array<uint64_t, kMetricsHistogramBuckets - 1> kMetricsBucketBoundsMillis{
+    5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000, 60000, 300000};
+
+/** One counter or histogram in the stats file. */
+struct metric_slot_t {
+  std::atomic<metric_type_t> type;
+  char name[60];
+  char help[128];
+  // Counter value, or the number of observations for a histogram.
+  std::atomic<uint64_t> count;
+  // Sum of the observations in milliseconds.
+  std::atomic<uint64_t> sum_millis;
+  std::atomic<uint64_t> buckets[kMetricsHistogramBuckets];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "metrics are shared between processes so must be lock free.");
+
+/** Header of the stats file, followed by kMetricsMaxSlots metric_slot_t */
+struct metrics_header_t {
+  char signature[4];
+  uint32_t version;
+  uint32_t num_slots;
+  uint32_t slot_size;
+};
+
+class Counter {
+public:
+  explicit Counter(metric_slot_t* slot) noexcept : slot_(slot) {}
+  void inc(uint64_t n = 1) noexcept { slot_->count.fetch_add(n, std::memory_order_relaxed); }
+  [[nodiscard]] uint64_t value() const noexcept { return slot_->count.load(); }
+
+private:
+  metric_slot_t* slot_;
+};
+
+class Histogram {
+public:
+  explicit Histogram(metric_slot_t* slot) noexcept : slot_(slot) {}
+  void observe(std::chrono::duration<double> d) noexcept;
+  [[nodiscard]] uint64_t count() const noexcept { return slot_->count.load(); }
+
+private:
+  metric_slot_t* slot_;
+};
+
+/**
+ * Counters and latency histograms shared by all of the WWIV processes.
+ *
+ * The metrics live in a small memory mapped file (metrics.dat in the data
+ * directory) so that short lived processes like bbs, networkb and
+ * network1/2 add to the same totals that wwivd serves from /metrics.
+ * Updating a metric is a single relaxed atomic add on the mapped memory.
+ *
+ * Example:
+ *   Metrics::instance().counter("wwivd_connections_total", "Connections accepted").inc();
+ */
+class Metrics final {
+public:
+  /** Maps the stats file at path, creating it if needed. */
+  explicit Metrics(const std::filesystem::path& path);
+  /** Keeps the metrics in memory only. */
+  Metrics();
+  ~Metrics();
+  Metrics(const Metrics&) = delete;
+  Metrics& operator=(const Metrics&) = delete;
+
+  /**
+   * Uses the stats file in datadir for Metrics::instance. Call this at
+   * startup, before any metrics are used.
+   */
+  static bool Init(const std::filesystem::path& datadir);
+  /** The metrics for this process; in memory only until Init is called. */
+  static Metrics& instance();
+
+  [[nodiscard]] bool shared() const noexcept { return mapped_ != nullptr; }
+  /** Finds or registers the counter named name. */
+  Counter counter(const std::string& name, const std::string& help);
+  /** Finds or registers the histogram named name. */
+  Histogram histogram(const std::string& name, const std::string& help);
+
+  /** All of the metrics in the Prometheus text exposition format. */
+  [[nodiscard]] std::string ToPrometheusText() const;
+
+private:
+  metric_slot_t* find_or_add(const std::string& name, const std::string& help,
+                             metric_type_t type);
+
+  void* mapped_{nullptr};
+  std::size_t mapped_size_{0};
+#ifdef _WIN32
+  void* mapping_handle_{nullptr};
+#endif
+  std::unique_ptr<metric_slot_t[]> local_;
+  metric_slot_t* slots_{nullptr};
+  // Used when every slot has been taken.
+  metric_slot_t overflow_{};
+};
+
+} // namespace wwiv::core
+
+#endif
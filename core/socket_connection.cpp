@@ -186,7 +186,9 @@ SocketConnection::~SocketConnection() {
   if (exit_mode_ == ExitMode::RESET_TO_BLOCKING && sock_ != INVALID_SOCKET) {
     SetBlockingMode(sock_, true);
     SetNoDelayMode(sock_, false);
-  } else if (exit_mode_ == ExitMode::CLOSE_SOCKET && sock_ != INVALID_SOCKET) {
+  } else if (exit_mode_ == ExitMode::CLOSE_SOCKET && open_) {
+    // Once close() has been called the descriptor may already belong to
+    // another connection in this process.
     closesocket(sock_);
     sock_ = INVALID_SOCKET;
   }
@@ -32,6 +32,14 @@
 #include <string>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define WWIV_STRINGS_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
 using std::numeric_limits;
 using std::stoi;
 using std::string;
@@ -50,6 +58,115 @@ using std::string;
 using std::stringstream;
 using std::vector;
 
+// ASCII is folded inline, only the high characters go through the C library
+// so that the result still follows the current locale.
+static char fold_upper(char c) {
+  if (c >= 'a' && c <= 'z') {
+    return static_cast<char>(c - ('a' - 'A'));
+  }
+  return static_cast<unsigned char>(c) < 0x80 ? c : static_cast<char>(toupper(c));
+}
+
+static char fold_lower(char c) {
+  if (c >= 'A' && c <= 'Z') {
+    return static_cast<char>(c + ('a' - 'A'));
+  }
+  return static_cast<unsigned char>(c) < 0x80 ? c : static_cast<char>(tolower(c));
+}
+
+/**
+ * Is the character c a possible color code. (is it #, B, or a digit)
+ * @param c The Character to test.
+ */
+static bool IsColorCode(char c) {
+  if (!c) {
+    return false;
+  }
+  return c == '#' || isdigit(static_cast<unsigned char>(c));
+}
+
+/**
+ * Returns the number of characters at the start of p that can not begin a
+ * color code, pipe code or ANSI sequence.
+ */
+static std::string::size_type plain_prefix_length(const char* p, std::string::size_type n) {
+  std::string::size_type i = 0;
+#if defined(WWIV_STRINGS_SSE2)
+  const auto pipe = _mm_set1_epi8('|');
+  const auto ctrl_c = _mm_set1_epi8(3);
+  const auto esc = _mm_set1_epi8(27);
+  for (; i + 16 <= n; i += 16) {
+    const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+    const auto m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, pipe), _mm_cmpeq_epi8(v, ctrl_c)),
+                                _mm_cmpeq_epi8(v, esc));
+    const auto mask = static_cast<unsigned>(_mm_movemask_epi8(m));
+    if (mask != 0) {
+#ifdef _MSC_VER
+      unsigned long bit;
+      _BitScanForward(&bit, mask);
+      return i + bit;
+#else
+      return i + static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+  }
+#endif
+  for (; i < n; i++) {
+    if (p[i] == '|' || p[i] == 3 || p[i] == 27) {
+      return i;
+    }
+  }
+  return n;
+}
+
+/**
+ * Calls sink(const char* p, size n) for each run of s that is not part of a
+ * color code, pipe code or ANSI sequence.
+ */
+template <typename Sink>
+static void strip_colors(std::string_view s, Sink sink) {
+  const auto n = s.size();
+  const auto* p = s.data();
+  // ANSI sequences need an 'm' somewhere after the escape.
+  const auto last_m = s.rfind('m');
+  std::string::size_type i = 0;
+  while (i < n) {
+    if (const auto run = plain_prefix_length(p + i, n - i); run > 0) {
+      sink(p + i, run);
+      i += run;
+      if (i == n) {
+        break;
+      }
+    }
+    if (p[i] == 27 && i + 1 < n) {
+      const auto ansi = n - i >= 3 && p[i + 1] == '[' && last_m != std::string_view::npos && last_m > i;
+      if (!ansi) {
+        sink(p + i, 1);
+        ++i;
+        continue;
+      }
+      // skip everything until we have the end of the ansi sequence.
+      while (i < n && !std::isalpha(static_cast<unsigned char>(p[i]))) {
+        ++i;
+      }
+      if (i < n) {
+        ++i;
+      }
+      if (i == n) {
+        break;
+      }
+    }
+    if (i + 2 < n && p[i] == '|' && IsColorCode(p[i + 1]) && IsColorCode(p[i + 2])) {
+      i += 3;
+    } else if (i + 1 < n && p[i] == 3 && isdigit(static_cast<unsigned char>(p[i + 1]))) {
+      i += 2;
+    } else {
+      sink(p + i, 1);
+      ++i;
+    }
+  }
+}
+
 namespace wwiv::strings {
 
 /**
@@ -75,13 +192,10 @@ bool iequals(const char* str1, const char* str2) {
   return StringCompareIgnoreCase(str1, str2) == 0;
 }
 
-bool iequals(const std::string& s1, const std::string& s2) {
+bool iequals(std::string_view s1, std::string_view s2) noexcept {
   return s1.size() == s2.size() &&
          std::equal(s1.begin(), s1.end(), s2.begin(),
-                    [](const char& c1, const char& c2)
-                    {
-                      return (std::tolower(c1) == std::tolower(c2));
-                    });
+                    [](char c1, char c2) { return fold_lower(c1) == fold_lower(c2); });
 }
 
 int StringCompareIgnoreCase(const char* str1, const char* str2) {
@@ -123,29 +237,61 @@ void SplitString(const string& original_string, const string& delims, vector<str
 
 void SplitString(const string& original_string, const string& delims, bool skip_empty,
                  vector<string>* out) {
-  auto s(original_string);
-  for (auto found = s.find_first_of(delims); found != string::npos;
-       s = s.substr(found + 1), found = s.find_first_of(delims)) {
-    if (found > 0) {
-      out->push_back(s.substr(0, found));
-    } else if (!skip_empty && found == 0) {
-      // Add empty lines.
-      out->push_back({});
-    }
+  for (const auto part : SplitStringView(original_string, delims, skip_empty)) {
+    out->emplace_back(part);
   }
-  if (!s.empty()) {
-    out->push_back(s);
+}
+
+StringSplitter SplitStringView(std::string_view s, std::string_view delims,
+                               bool skip_empty) noexcept {
+  return StringSplitter(s, delims, skip_empty);
+}
+
+StringSplitter::iterator::iterator(const StringSplitter* splitter) noexcept
+    : splitter_(splitter), pos_(0) {
+  ++*this;
+}
+
+StringSplitter::iterator& StringSplitter::iterator::operator++() noexcept {
+  const auto& s = splitter_->s_;
+  const auto& delims = splitter_->delims_;
+  while (pos_ != std::string_view::npos) {
+    auto found = pos_;
+    while (found < s.size() && !delims.test(static_cast<unsigned char>(s[found]))) {
+      ++found;
+    }
+    if (found == s.size()) {
+      // Unlike the parts between delimiters, an empty last part is never returned.
+      part_ = s.substr(pos_);
+      pos_ = std::string_view::npos;
+      if (!part_.empty()) {
+        return *this;
+      }
+      break;
+    }
+    part_ = s.substr(pos_, found - pos_);
+    pos_ = found + 1;
+    if (!part_.empty() || !splitter_->skip_empty_) {
+      return *this;
+    }
   }
+  *this = iterator();
+  return *this;
+}
+
+StringSplitter::iterator StringSplitter::iterator::operator++(int) noexcept {
+  auto i = *this;
+  ++*this;
+  return i;
 }
 
-bool starts_with(const std::string& input, const std::string& match) {
-  return input.size() >= match.size()
-         && std::equal(std::begin(match), std::end(match), std::begin(input));
+bool starts_with(std::string_view input, std::string_view match) noexcept {
+  return input.size() >= match.size() && input.compare(0, match.size(), match) == 0;
 }
 
-bool ends_with(const std::string& input, const std::string& match) {
-  return input.size() >= match.size()
-         && std::equal(match.rbegin(), match.rend(), input.rbegin());
+bool ends_with(std::string_view input, std::string_view match) noexcept {
+  return input.size() >= match.size() &&
+         input.compare(input.size() - match.size(), match.size(), match) == 0;
 }
 
 /**
@@ -237,6 +383,15 @@ string StringTrim(const string& orig) {
   return s;
 }
 
+std::string_view StringTrimView(std::string_view s) noexcept {
+  const auto first = s.find_first_not_of(DELIMS_WHITE);
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  const auto last = s.find_last_not_of(DELIMS_WHITE);
+  return s.substr(first, last - first + 1);
+}
+
 void StringTrimBegin(string* s) {
   const auto pos = s->find_first_not_of(DELIMS_WHITE);
   s->erase(0, pos);
@@ -258,26 +413,36 @@ void StringTrimEnd(char* str) {
 }
 
 void StringUpperCase(string* s) {
-  std::transform(std::begin(*s), std::end(*s), std::begin(*s), to_upper_case<char>);
+  std::transform(std::begin(*s), std::end(*s), std::begin(*s), fold_upper);
 }
 
-string ToStringUpperCase(const string& orig) {
-  auto s(orig);
-  StringUpperCase(&s);
-  return s;
+void StringUpperCase(char* s) {
+  for (; *s; ++s) {
+    *s = fold_upper(*s);
+  }
 }
 
-static char tolower_char(int c) {
-  return static_cast<char>(tolower(c));
+string ToStringUpperCase(std::string_view orig) {
+  string s;
+  s.resize(orig.size());
+  std::transform(std::begin(orig), std::end(orig), std::begin(s), fold_upper);
+  return s;
 }
 
 void StringLowerCase(string* s) {
-  std::transform(std::begin(*s), std::end(*s), std::begin(*s), tolower_char);
+  std::transform(std::begin(*s), std::end(*s), std::begin(*s), fold_lower);
 }
 
-string ToStringLowerCase(const string& orig) {
-  string s(orig);
-  StringLowerCase(&s);
+void StringLowerCase(char* s) {
+  for (; *s; ++s) {
+    *s = fold_lower(*s);
+  }
+}
+
+string ToStringLowerCase(std::string_view orig) {
+  string s;
+  s.resize(orig.size());
+  std::transform(std::begin(orig), std::end(orig), std::begin(s), fold_lower);
   return s;
 }
 
@@ -315,9 +480,10 @@ std::string JoinStrings(const std::vector<std::string>& lines, const std::string
   return out;
 }
 
-int size_without_colors(const std::string& s) {
-  const auto stripped = stripcolors(s);
-  return stl::size_int(stripped);
+int size_without_colors(std::string_view s) noexcept {
+  std::string::size_type len = 0;
+  strip_colors(s, [&len](const char*, std::string::size_type n) { len += n; });
+  return static_cast<int>(len);
 }
 
 std::string trim_to_size_ignore_colors(const std::string& orig, int size) {
@@ -371,17 +537,6 @@ std::string trim_to_size(const std::string& orig, int max_size) {
 
 } // namespace wwiv
 
-/**
- * Is the character c a possible color code. (is it #, B, or a digit)
- * @param c The Character to test.
- */
-static bool IsColorCode(char c) {
-  if (!c) {
-    return false;
-  }
-  return c == '#' || isdigit(c);
-}
-
 bool wwiv::strings::contains(const std::string& haystack, const std::string_view& needle) noexcept {
   try {
     return haystack.find(needle) != std::string::npos;
@@ -400,18 +555,6 @@ char* stripcolors(const char* str) {
   return s;
 }
 
-template <typename I>
-static bool is_ansi_seq_start(I& i, const std::string& orig) {
-  auto left = string(i, end(orig));
-  if (left.size() < 3) {
-    return false;
-  }
-  if (left.at(1) != '[') {
-    return false;
-  }
-  return left.find('m') != std::string::npos;
-}
-
 /**
  * Removes the WWIV color codes and pipe codes from the string
  *
@@ -420,42 +563,15 @@ static bool is_ansi_seq_start(I& i, const std::string& orig) {
  */
 string stripcolors(const string& orig) {
   string out;
-  for (auto i = begin(orig); i != end(orig); ++i) {
-    if (*i == 27 && (i + 1) != end(orig)) {
-      auto left = string(i, end(orig));
-      if (!is_ansi_seq_start(i, orig)) {
-        out.push_back(*i);
-        continue;
-      }
-      // skip everything until we have the end of the ansi sequence.
-      while (i != end(orig) && !std::isalpha(*i)) {
-        ++i;
-      }
-      if (i != end(orig)) {
-        ++i;
-      }
-    }
-    if (i == end(orig)) {
-      break;
-    }
-    if ((i + 1) != end(orig)
-        && (i + 2) != end(orig)
-        && *i == '|'
-        && IsColorCode(*(i + 1))
-        && IsColorCode(*(i + 2))) {
-      ++i;
-      ++i;
-    } else if ((i + 1) != end(orig)
-               && *i == 3
-               && isdigit(*(i + 1))) {
-      ++i;
-    } else {
-      out.push_back(*i);
-    }
-  }
+  stripcolors(orig, &out);
   return out;
 }
 
+void stripcolors(std::string_view orig, std::string* out) {
+  out->clear();
+  strip_colors(orig, [out](const char* p, std::string::size_type n) { out->append(p, n); });
+}
+
 /**
  * Translates the character ch into uppercase using WWIV's translation tables
  * @param ch The character to translate
@@ -20,13 +20,17 @@
 #define INCLUDED_CORE_STRINGS_H
 
 // ReSharper disable once CppUnusedIncludeDirective
+#include <bitset>
 #include <cstring> // strncpy
 // ReSharper disable once CppUnusedIncludeDirective
 #include <ctime>   // struct tm
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <limits>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -38,21 +42,36 @@ namespace wwiv::strings {
 
 enum class JustificationType { LEFT, RIGHT };
 
-template <typename A> std::string StrCat(const A& a) noexcept {
-  try {
-    std::ostringstream ss;
-    ss << a;
-    return ss.str();
-  } catch (...) {
-    return {};
-  }
-}
+namespace internal {
+template <typename T> std::string_view to_string_view(const T& t) noexcept { return t; }
+inline std::string_view to_string_view(const char* s) noexcept { return s ? s : ""; }
+inline std::string_view to_string_view(char* s) noexcept { return s ? s : ""; }
+} // namespace internal
 
-template <typename A, typename... Args> std::string StrCat(const A& a, const Args&... args) noexcept {
+template <typename A, typename... Args>
+std::string StrCat(const A& a, const Args&... args) noexcept {
   try {
-    std::ostringstream ss;
-    ss << a << StrCat(args...);
-    return ss.str();
+    if constexpr (std::is_convertible_v<const A&, std::string_view> &&
+                  (std::is_convertible_v<const Args&, std::string_view> && ...)) {
+      // Only strings, so append them directly without a stream.
+      const std::string_view parts[] = {internal::to_string_view(a),
+                                        internal::to_string_view(args)...};
+      std::string::size_type len = 0;
+      for (const auto& p : parts) {
+        len += p.size();
+      }
+      std::string out;
+      out.reserve(len);
+      for (const auto& p : parts) {
+        out.append(p);
+      }
+      return out;
+    } else {
+      std::ostringstream ss;
+      ss << a;
+      (ss << ... << args);
+      return ss.str();
+    }
   } catch (...) {
     return {};
   }
@@ -87,7 +106,7 @@ template <typename A, typename... Args> std::string StrCat(const A& a, const Arg
   // Comparisons
   [[nodiscard]] bool IsEquals(const char* str1, const char* str2);
   [[nodiscard]] bool iequals(const char* str1, const char* str2);
-  [[nodiscard]] bool iequals(const std::string& s1, const std::string& s2);
+  [[nodiscard]] bool iequals(std::string_view s1, std::string_view s2) noexcept;
   [[nodiscard]] int StringCompareIgnoreCase(const char* str1, const char* str2);
   [[nodiscard]] int StringCompare(const char* str1, const char* str2);
 
@@ -102,23 +121,80 @@ template <typename A, typename... Args> std::string StrCat(const A& a, const Arg
   void SplitString(const std::string& original_string, const std::string& delims, bool skip_empty,
                    std::vector<std::string>* out);
 
-  [[nodiscard]] bool starts_with(const std::string& input, const std::string& match);
-  [[nodiscard]] bool ends_with(const std::string& input, const std::string& match);
+  /**
+   * Splits a string on any of the characters in delims without copying it.
+   * Used in a range based for loop:
+   *   for (const auto part : SplitStringView(line, " ")) { ... }
+   * The parts are views into s, so s must outlive them.  Yields the same parts
+   * as SplitString.
+   */
+  class StringSplitter {
+  public:
+    class iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = std::string_view;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const std::string_view*;
+      using reference = const std::string_view&;
+
+      iterator() noexcept = default;
+      explicit iterator(const StringSplitter* splitter) noexcept;
+      reference operator*() const noexcept { return part_; }
+      pointer operator->() const noexcept { return &part_; }
+      iterator& operator++() noexcept;
+      iterator operator++(int) noexcept;
+      bool operator==(const iterator& o) const noexcept {
+        return splitter_ == o.splitter_ && pos_ == o.pos_;
+      }
+      bool operator!=(const iterator& o) const noexcept { return !(*this == o); }
+
+    private:
+      const StringSplitter* splitter_{nullptr};
+      // Start of the rest of the string, or npos once it has all been used.
+      std::string_view::size_type pos_{std::string_view::npos};
+      std::string_view part_;
+    };
+
+    StringSplitter(std::string_view s, std::string_view delims, bool skip_empty) noexcept
+        : s_(s), skip_empty_(skip_empty) {
+      for (const auto c : delims) {
+        delims_.set(static_cast<unsigned char>(c));
+      }
+    }
+    [[nodiscard]] iterator begin() const noexcept { return iterator(this); }
+    [[nodiscard]] iterator end() const noexcept { return iterator(); }
+
+  private:
+    const std::string_view s_;
+    std::bitset<256> delims_;
+    const bool skip_empty_;
+  };
+
+  [[nodiscard]] StringSplitter SplitStringView(std::string_view s, std::string_view delims,
+                                               bool skip_empty = true) noexcept;
+
+  [[nodiscard]] bool starts_with(std::string_view input, std::string_view match) noexcept;
+  [[nodiscard]] bool ends_with(std::string_view input, std::string_view match) noexcept;
 
   void StringJustify(std::string* s, int length, char bg,
                      JustificationType just_type);
   void StringTrim(char* str);
   void StringTrim(std::string* s);
   [[nodiscard]] std::string StringTrim(const std::string& orig);
+  /** Returns the part of s without leading and trailing whitespace. */
+  [[nodiscard]] std::string_view StringTrimView(std::string_view s) noexcept;
 
   void StringTrimCRLF(std::string* s);
   void StringTrimEnd(std::string* s);
   void StringTrimEnd(char* str);
   void StringTrimBegin(std::string* s);
   void StringUpperCase(std::string* s);
-  [[nodiscard]] std::string ToStringUpperCase(const std::string& s);
+  void StringUpperCase(char* s);
+  [[nodiscard]] std::string ToStringUpperCase(std::string_view s);
   void StringLowerCase(std::string* s);
-  [[nodiscard]] std::string ToStringLowerCase(const std::string& s);
+  void StringLowerCase(char* s);
+  [[nodiscard]] std::string ToStringLowerCase(std::string_view s);
 
 // Strips the string from the first occurrence of ch
   // Doesn't seem to be used anywhere. Maybe it should be removed.
@@ -130,7 +206,7 @@ template <typename A, typename... Args> std::string StrCat(const A& a, const Arg
   [[nodiscard]] std::string JoinStrings(const std::vector<std::string>& lines, const std::string& end_of_line);
 
   // String length without colors
-  [[nodiscard]] int size_without_colors(const std::string& s);
+  [[nodiscard]] int size_without_colors(std::string_view s) noexcept;
 
   /** returns a copy of orig trimmed to size, excluding colors. */
   [[nodiscard]] std::string trim_to_size_ignore_colors(const std::string& orig, int size);
@@ -220,6 +296,11 @@ template <typename A, typename... Args> std::string StrCat(const A& a, const Arg
   // Function Prototypes
   [[nodiscard]] char* stripcolors(const char* str);
   [[nodiscard]] std::string stripcolors(const std::string& orig);
+  /**
+   * Writes orig without the WWIV color codes, pipe codes and ANSI sequences to
+   * out, reusing the memory already held by out.
+   */
+  void stripcolors(std::string_view orig, std::string* out);
   [[nodiscard]] unsigned char upcase(unsigned char ch);
   [[nodiscard]] unsigned char locase(unsigned char ch);
 
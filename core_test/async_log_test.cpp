@@ -0,0 +1,104 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/async_log.h"
+#include "core/file.h"
+#include "core/strings.h"
+#include "core_test/file_helper.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+TEST(AsyncLogWriterTest, WritesInOrder) {
+  FileHelper helper;
+  const auto one = helper.CreateTempFilePath("one.log");
+  const auto two = helper.CreateTempFilePath("two.log");
+
+  AsyncLogWriter w;
+  std::string expected;
+  for (auto i = 0; i < 100; i++) {
+    const auto line = StrCat("line ", i, "\n");
+    ASSERT_TRUE(w.append(i % 2 ? one : two, line));
+    if (i % 2) {
+      expected.append(line);
+    }
+  }
+  w.flush();
+  EXPECT_EQ(expected, helper.ReadFile(one));
+  EXPECT_EQ(50u, SplitString(helper.ReadFile(two), "\n").size());
+}
+
+TEST(AsyncLogWriterTest, ManyThreads) {
+  FileHelper helper;
+  const auto path = helper.CreateTempFilePath("threads.log");
+  {
+    AsyncLogWriter w;
+    std::vector<std::thread> threads;
+    for (auto t = 0; t < 4; t++) {
+      threads.emplace_back([&w, &path, t] {
+        for (auto i = 0; i < 250; i++) {
+          w.append(path, StrCat(t, ":", i, "\n"));
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
+  // Everything is written when the writer is destroyed.
+  const auto lines = SplitString(helper.ReadFile(path), "\n");
+  ASSERT_EQ(1000u, lines.size());
+  // Each thread's lines are still in the order it appended them.
+  std::vector<int> last(4, -1);
+  for (const auto& l : lines) {
+    const auto parts = SplitString(l, ":");
+    ASSERT_EQ(2u, parts.size());
+    const auto t = to_number<int>(parts[0]);
+    const auto i = to_number<int>(parts[1]);
+    EXPECT_EQ(last[t] + 1, i);
+    last[t] = i;
+  }
+}
+
+TEST(AsyncLogWriterTest, DropsWhenFull) {
+  FileHelper helper;
+  const auto path = helper.CreateTempFilePath("full.log");
+  AsyncLogWriter w(8);
+  EXPECT_TRUE(w.append(path, "1234"));
+  EXPECT_FALSE(w.append(path, "123456789"));
+  EXPECT_EQ(1, w.dropped());
+  w.flush();
+  EXPECT_EQ("1234", helper.ReadFile(path));
+}
+
+TEST(AsyncLogWriterTest, CloseFiles) {
+  FileHelper helper;
+  const auto path = helper.CreateTempFilePath("close.log");
+  AsyncLogWriter w;
+  w.append(path, "a");
+  w.flush();
+  w.close_files();
+  ASSERT_TRUE(File::Remove(path));
+  w.append(path, "b");
+  w.flush();
+  EXPECT_EQ("b", helper.ReadFile(path));
+}
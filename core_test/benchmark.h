@@ -0,0 +1,51 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_CORE_TEST_BENCHMARK_H
+#define INCLUDED_CORE_TEST_BENCHMARK_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace wwiv::core::test {
+
+/**
+ * A micro benchmark for core_benchmarks.  When bytes_per_op is set the
+ * throughput is reported too.
+ */
+struct benchmark_t {
+  std::string name;
+  std::function<void()> fn;
+  std::size_t bytes_per_op{0};
+};
+
+/** All registered benchmarks, in registration order. */
+std::vector<benchmark_t>& benchmarks();
+
+/** Registers benchmarks from a static initializer in each benchmark file. */
+struct BenchmarkRegistrar {
+  explicit BenchmarkRegistrar(std::vector<benchmark_t> b);
+};
+
+// Assign results here so the work being measured is not optimized away.
+extern volatile std::size_t benchmark_sink;
+
+} // namespace wwiv::core::test
+
+#endif
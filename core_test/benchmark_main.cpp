@@ -0,0 +1,83 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+// Runs the registered micro benchmarks for core_benchmarks, binkp_benchmarks
+// and bbs_benchmarks.  Not run by ctest; build them in a release build and run
+// them directly, optionally with a filter:
+//   core_benchmarks [substring]
+
+#include "core_test/benchmark.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace wwiv::core::test {
+
+volatile std::size_t benchmark_sink;
+
+std::vector<benchmark_t>& benchmarks() {
+  static std::vector<benchmark_t> b;
+  return b;
+}
+
+BenchmarkRegistrar::BenchmarkRegistrar(std::vector<benchmark_t> b) {
+  for (auto& e : b) {
+    benchmarks().push_back(std::move(e));
+  }
+}
+
+static void run(const benchmark_t& b) {
+  // Calibrate to roughly 0.2s per benchmark.
+  std::size_t iterations = 1;
+  nanoseconds elapsed{};
+  for (;;) {
+    const auto start = steady_clock::now();
+    for (std::size_t i = 0; i < iterations; i++) {
+      b.fn();
+    }
+    elapsed = duration_cast<nanoseconds>(steady_clock::now() - start);
+    if (elapsed >= milliseconds(200) || iterations >= (1u << 30)) {
+      break;
+    }
+    iterations *= elapsed < milliseconds(20) ? 10 : 2;
+  }
+  const auto ns_per_op = static_cast<double>(elapsed.count()) / static_cast<double>(iterations);
+  if (b.bytes_per_op == 0) {
+    std::printf("%-40s %14.1f ns/op %12zu iterations\n", b.name.c_str(), ns_per_op, iterations);
+    return;
+  }
+  const auto mb_per_sec = static_cast<double>(b.bytes_per_op) / ns_per_op * 1e9 / (1024 * 1024);
+  std::printf("%-40s %14.1f ns/op %12zu iterations %10.1f MB/s\n", b.name.c_str(), ns_per_op,
+              iterations, mb_per_sec);
+}
+
+} // namespace wwiv::core::test
+
+int main(int argc, char* argv[]) {
+  using namespace wwiv::core::test;
+  const std::string filter = argc > 1 ? argv[1] : "";
+  for (const auto& b : benchmarks()) {
+    if (filter.empty() || b.name.find(filter) != std::string::npos) {
+      run(b);
+    }
+  }
+  return 0;
+}
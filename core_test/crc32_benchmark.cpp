@@ -0,0 +1,104 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+// Throughput of the CRC-32 kernels and of hashing files, see benchmark_main.cpp.
+
+#include "core/crc32.h"
+#include "core/file.h"
+#include "core/md5.h"
+#include "core_test/benchmark.h"
+#include <filesystem>
+#include <memory>
+#include <string>
+
+using namespace wwiv::core;
+using namespace wwiv::core::test;
+
+namespace {
+
+constexpr std::size_t kDataSize = 8 * 1024 * 1024;
+
+const std::string& data() {
+  static const std::string d = [] {
+    std::string s;
+    s.reserve(kDataSize);
+    uint32_t seed = 1;
+    for (std::size_t i = 0; i < kDataSize; i++) {
+      seed = seed * 1103515245 + 12345;
+      s.push_back(static_cast<char>(seed >> 16));
+    }
+    return s;
+  }();
+  return d;
+}
+
+const uint8_t* bytes() { return reinterpret_cast<const uint8_t*>(data().data()); }
+
+// An 8MiB file on disk, removed when the benchmarks exit.
+class DataFile {
+public:
+  DataFile() : path_(std::filesystem::temp_directory_path() / "wwiv_crc32_benchmark.bin") {
+    File f(path_);
+    f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite | File::modeTruncate);
+    f.Write(data());
+  }
+  ~DataFile() {
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+  }
+  [[nodiscard]] const std::filesystem::path& path() const { return path_; }
+
+private:
+  const std::filesystem::path path_;
+};
+
+const std::filesystem::path& data_file() {
+  static const DataFile file;
+  return file.path();
+}
+
+// The whole file read into memory and hashed a byte at a time, as crc32file
+// used to.
+uint32_t legacy_crc32file(const std::filesystem::path& path) {
+  File file(path);
+  if (!file.Open(File::modeReadOnly | File::modeBinary)) {
+    return 0;
+  }
+  const auto size = file.length();
+  const auto buffer = std::make_unique<uint8_t[]>(size);
+  file.Read(buffer.get(), size);
+  return ~internal::crc32_bytewise(0xFFFFFFFF, buffer.get(), size);
+}
+
+BenchmarkRegistrar crc32_benchmarks({
+    {"crc32 bytewise", [] { benchmark_sink = internal::crc32_bytewise(~0u, bytes(), kDataSize); },
+     kDataSize},
+    {"crc32 slice8", [] { benchmark_sink = internal::crc32_slice8(~0u, bytes(), kDataSize); },
+     kDataSize},
+    {"crc32 pclmul",
+     [] {
+       // Falls back to slice8 when the CPU lacks PCLMULQDQ.
+       benchmark_sink = internal::crc32_pclmul(~0u, bytes(), kDataSize);
+     },
+     kDataSize},
+    {"crc32file/legacy", [] { benchmark_sink = legacy_crc32file(data_file()); }, kDataSize},
+    {"crc32file", [] { benchmark_sink = crc32file(data_file()); }, kDataSize},
+    {"md5", [] { benchmark_sink = md5(data()).size(); }, kDataSize},
+    {"md5file", [] { benchmark_sink = md5file(data_file()).size(); }, kDataSize},
+});
+
+} // namespace
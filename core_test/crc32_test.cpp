@@ -42,3 +42,56 @@ TEST(Crc32Test, Simple) {
   // use wwiv/scripts/crc32.py to generate golden values as needed.
   EXPECT_EQ(expected, crc) << " was " << std::hex << crc;
 }
+
+TEST(Crc32Test, String) {
+  EXPECT_EQ(0xcbf43926u, crc32string("123456789"));
+  EXPECT_EQ(0u, crc32string(""));
+}
+
+TEST(Crc32Test, Kernels) {
+  string data;
+  uint32_t seed = 12345;
+  for (auto i = 0; i < 5000; i++) {
+    seed = seed * 1103515245 + 12345;
+    data.push_back(static_cast<char>(seed >> 16));
+  }
+  const auto* p = reinterpret_cast<const uint8_t*>(data.data());
+  // Cover the short, unaligned and leftover cases of each kernel.
+  for (const auto offset : {0, 1, 3, 7}) {
+    for (const auto size : {0, 1, 15, 16, 63, 64, 65, 127, 128, 200, 4096, 4993}) {
+      const auto expected = internal::crc32_bytewise(0xFFFFFFFF, p + offset, size);
+      EXPECT_EQ(expected, internal::crc32_slice8(0xFFFFFFFF, p + offset, size)) << size;
+      if (internal::crc32_has_pclmul()) {
+        EXPECT_EQ(expected, internal::crc32_pclmul(0xFFFFFFFF, p + offset, size)) << size;
+      }
+    }
+  }
+}
+
+TEST(Crc32Test, Streaming) {
+  const string data(100000, 'x');
+  const auto expected = crc32string(data);
+  Crc32 crc;
+  for (std::size_t i = 0; i < data.size(); i += 999) {
+    crc.update(std::string_view(data).substr(i, 999));
+  }
+  EXPECT_EQ(expected, crc.value());
+
+  crc.reset();
+  EXPECT_EQ(expected, crc.update(data.data(), 10).update(data.data() + 10, data.size() - 10).value());
+
+  // Continue from a saved value.
+  const auto saved = Crc32().update(data.data(), 5000).value();
+  EXPECT_EQ(expected, Crc32(saved).update(data.data() + 5000, data.size() - 5000).value());
+}
+
+TEST(Crc32Test, File_LargerThanChunk) {
+  FileHelper file;
+  string data;
+  for (auto i = 0; i < 200000; i++) {
+    data.push_back(static_cast<char>('a' + i % 26));
+  }
+  const auto path = file.CreateTempFile("big.bin", data);
+  EXPECT_EQ(crc32string(data), crc32file(path));
+  EXPECT_EQ(0u, crc32file(FilePath(file.TempDir(), "missing.bin")));
+}
@@ -0,0 +1,73 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+#include "core/graphs.h"
+
+#include <cmath>
+#include <list>
+
+using namespace wwiv::graphs;
+
+class GraphTest : public testing::Test {
+public:
+  GraphTest() : g(1, 100) {
+    g.add_edge(1, 2, 1);
+    g.add_edge(2, 3, 1);
+    g.add_edge(1, 3, 5);
+    g.add_edge(3, 4, 0);
+    g.add_edge(4, 3, 0);
+    g.add_edge(5, 1, 1);
+  }
+
+  Graph g;
+};
+
+TEST_F(GraphTest, ShortestPath) {
+  EXPECT_EQ((std::list<uint16_t>{1, 2, 3, 4}), g.shortest_path_to(4));
+  EXPECT_FLOAT_EQ(2.0f, g.cost_to(4));
+  EXPECT_EQ(3, g.num_hops_to(4));
+}
+
+TEST_F(GraphTest, NextHop) {
+  EXPECT_EQ(1, g.next_hop_to(1));
+  EXPECT_EQ(2, g.next_hop_to(2));
+  EXPECT_EQ(2, g.next_hop_to(3));
+  EXPECT_EQ(2, g.next_hop_to(4));
+}
+
+TEST_F(GraphTest, Unreachable) {
+  EXPECT_TRUE(g.has_node(5));
+  EXPECT_FALSE(g.reachable(5));
+  EXPECT_EQ(0, g.next_hop_to(5));
+  EXPECT_EQ(0, g.num_hops_to(5));
+  EXPECT_FALSE(std::isfinite(g.cost_to(5)));
+  EXPECT_FALSE(g.has_node(99));
+}
+
+TEST_F(GraphTest, AddEdge_AfterCompute) {
+  EXPECT_TRUE(g.reachable(4));
+  EXPECT_FALSE(g.add_edge(4, 5, 1));
+  EXPECT_FALSE(g.reachable(5));
+}
+
+TEST(GraphsTest, AddEdge_OutOfRange) {
+  Graph g(1, 10);
+  EXPECT_FALSE(g.add_edge(1, 10, 1));
+  EXPECT_TRUE(g.add_edge(1, 9, 1));
+  EXPECT_EQ(9, g.next_hop_to(9));
+}
@@ -0,0 +1,54 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/mapped_file.h"
+#include "core_test/file_helper.h"
+#include <string>
+
+using namespace wwiv::core;
+
+TEST(MappedFileTest, Open) {
+  FileHelper helper;
+  const std::string contents("Hello\r\nWorld");
+  const auto path = helper.CreateTempFile("hello.dat", contents);
+  MappedFile f(path);
+  ASSERT_TRUE(f.Open());
+  EXPECT_TRUE(f.is_open());
+  EXPECT_EQ(contents, f.view());
+
+  f.Close();
+  EXPECT_FALSE(f.is_open());
+  EXPECT_TRUE(f.view().empty());
+}
+
+TEST(MappedFileTest, Empty) {
+  FileHelper helper;
+  const auto path = helper.CreateTempFile("empty.dat", "");
+  MappedFile f(path);
+  ASSERT_TRUE(f.Open());
+  EXPECT_EQ(0u, f.size());
+  EXPECT_TRUE(f.view().empty());
+}
+
+TEST(MappedFileTest, Missing) {
+  FileHelper helper;
+  MappedFile f(helper.CreateTempFilePath("missing.dat"));
+  EXPECT_FALSE(f.Open());
+  EXPECT_FALSE(f.is_open());
+}
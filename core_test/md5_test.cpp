@@ -19,6 +19,7 @@
 #include "gtest/gtest.h"
 
 #include "core/md5.h"
+#include "core_test/file_helper.h"
 #include <map>
 #include <string>
 #include <vector>
@@ -30,3 +31,12 @@ using std::vector;
 TEST(Md5Test, Welcome) {
   EXPECT_EQ("f851256dff2a8825ad4af615111b6a4f", md5("WELCOME"));
 }
+
+TEST(Md5Test, File) {
+  FileHelper helper;
+  const std::string data(200000, 'w');
+  const auto path = helper.CreateTempFile("md5.bin", data);
+  EXPECT_EQ(md5(data), md5file(path));
+  EXPECT_EQ("f851256dff2a8825ad4af615111b6a4f", md5file(helper.CreateTempFile("w.txt", "WELCOME")));
+  EXPECT_EQ("", md5file(helper.CreateTempFilePath("missing.txt")));
+}
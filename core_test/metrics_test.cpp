@@ -0,0 +1,73 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/metrics.h"
+#include "core/strings.h"
+#include "core_test/file_helper.h"
+#include <chrono>
+#include <string>
+
+using namespace std::chrono_literals;
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+TEST(MetricsTest, Counter_InMemory) {
+  Metrics m;
+  EXPECT_FALSE(m.shared());
+  m.counter("foo_total", "Foo").inc();
+  m.counter("foo_total", "Foo").inc(2);
+  EXPECT_EQ(3u, m.counter("foo_total", "Foo").value());
+  EXPECT_EQ(0u, m.counter("bar_total", "Bar").value());
+}
+
+TEST(MetricsTest, SharedBetweenInstances) {
+  FileHelper helper;
+  const auto path = helper.CreateTempFilePath("metrics.dat");
+  Metrics one(path);
+  ASSERT_TRUE(one.shared());
+  one.counter("foo_total", "Foo").inc(5);
+
+  Metrics two(path);
+  ASSERT_TRUE(two.shared());
+  auto c = two.counter("foo_total", "Foo");
+  EXPECT_EQ(5u, c.value());
+  c.inc();
+  EXPECT_EQ(6u, one.counter("foo_total", "Foo").value());
+}
+
+TEST(MetricsTest, ToPrometheusText) {
+  Metrics m;
+  m.counter("foo_total", "Number of foos").inc(2);
+  auto h = m.histogram("bar_seconds", "Bar latency");
+  h.observe(3ms);
+  h.observe(700ms);
+  h.observe(1h);
+
+  const auto text = m.ToPrometheusText();
+  EXPECT_TRUE(contains(text, "# HELP foo_total Number of foos\n# TYPE foo_total counter\nfoo_total 2\n"))
+      << text;
+  EXPECT_TRUE(contains(text, "# TYPE bar_seconds histogram\n")) << text;
+  EXPECT_TRUE(contains(text, "bar_seconds_bucket{le=\"0.005\"} 1\n")) << text;
+  EXPECT_TRUE(contains(text, "bar_seconds_bucket{le=\"0.5\"} 1\n")) << text;
+  EXPECT_TRUE(contains(text, "bar_seconds_bucket{le=\"1\"} 2\n")) << text;
+  EXPECT_TRUE(contains(text, "bar_seconds_bucket{le=\"300\"} 2\n")) << text;
+  EXPECT_TRUE(contains(text, "bar_seconds_bucket{le=\"+Inf\"} 3\n")) << text;
+  EXPECT_TRUE(contains(text, "bar_seconds_sum 3600.703\n")) << text;
+  EXPECT_TRUE(contains(text, "bar_seconds_count 3\n")) << text;
+}
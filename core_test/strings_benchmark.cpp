@@ -0,0 +1,188 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+// Micro benchmarks for core/strings, see benchmark_main.cpp.
+
+#include "core/strings.h"
+#include "core_test/benchmark.h"
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace wwiv::core::test;
+using namespace wwiv::strings;
+
+namespace {
+
+volatile std::size_t& sink = benchmark_sink;
+
+// The implementations these replaced, kept to measure against.
+namespace legacy {
+
+template <typename A> std::string StrCat(const A& a) {
+  std::ostringstream ss;
+  ss << a;
+  return ss.str();
+}
+
+template <typename A, typename... Args> std::string StrCat(const A& a, const Args&... args) {
+  std::ostringstream ss;
+  ss << a << StrCat(args...);
+  return ss.str();
+}
+
+void SplitString(const std::string& original_string, const std::string& delims, bool skip_empty,
+                 std::vector<std::string>* out) {
+  auto s(original_string);
+  for (auto found = s.find_first_of(delims); found != std::string::npos;
+       s = s.substr(found + 1), found = s.find_first_of(delims)) {
+    if (found > 0) {
+      out->push_back(s.substr(0, found));
+    } else if (!skip_empty && found == 0) {
+      out->push_back({});
+    }
+  }
+  if (!s.empty()) {
+    out->push_back(s);
+  }
+}
+
+bool IsColorCode(char c) { return c && (c == '#' || isdigit(c)); }
+
+bool is_ansi_seq_start(std::string::const_iterator i, const std::string& orig) {
+  const auto left = std::string(i, end(orig));
+  return left.size() >= 3 && left.at(1) == '[' && left.find('m') != std::string::npos;
+}
+
+std::string stripcolors(const std::string& orig) {
+  std::string out;
+  for (auto i = begin(orig); i != end(orig); ++i) {
+    if (*i == 27 && (i + 1) != end(orig)) {
+      if (!is_ansi_seq_start(i, orig)) {
+        out.push_back(*i);
+        continue;
+      }
+      while (i != end(orig) && !std::isalpha(*i)) {
+        ++i;
+      }
+      if (i != end(orig)) {
+        ++i;
+      }
+    }
+    if (i == end(orig)) {
+      break;
+    }
+    if ((i + 1) != end(orig) && (i + 2) != end(orig) && *i == '|' && IsColorCode(*(i + 1)) &&
+        IsColorCode(*(i + 2))) {
+      i += 2;
+    } else if ((i + 1) != end(orig) && *i == 3 && isdigit(*(i + 1))) {
+      ++i;
+    } else {
+      out.push_back(*i);
+    }
+  }
+  return out;
+}
+
+bool iequals(const std::string& s1, const std::string& s2) {
+  return s1.size() == s2.size() &&
+         std::equal(s1.begin(), s1.end(), s2.begin(),
+                    [](char c1, char c2) { return std::tolower(c1) == std::tolower(c2); });
+}
+
+std::string ToStringUpperCase(const std::string& orig) {
+  auto s(orig);
+  std::transform(std::begin(s), std::end(s), std::begin(s),
+                 [](char c) { return static_cast<char>(::toupper(c)); });
+  return s;
+}
+
+std::string StringTrim(const std::string& orig) {
+  auto s(orig);
+  s.erase(0, s.find_first_not_of(" \t\r\n"));
+  s.erase(s.find_last_not_of(" \t\r\n") + 1);
+  return s;
+}
+
+} // namespace legacy
+
+// A nodelist line, a colorized menu line and a user name.
+const std::string kNodelistLine =
+    "Host,123,Some_Fidonet_Network,Somewhere_USA,Joe_Sysop,1-555-555-1212,9600,CM,XA,V34,IBN,INA:bbs.example.com";
+const std::string kMenuLine =
+    "|#7[|#1R|#7] |#2Read Messages     |#7[|#1P|#7] |#2Post a Message    \x1b[0;1;33m|10Press Enter";
+const std::string kPlainLine(80, 'x');
+const std::string kUserName = "Joe Sysop";
+
+BenchmarkRegistrar strings_benchmarks({
+    {"SplitString/legacy",
+     [] {
+       std::vector<std::string> v;
+       legacy::SplitString(kNodelistLine, ",", true, &v);
+       sink = v.size();
+     }},
+    {"SplitString",
+     [] {
+       std::vector<std::string> v;
+       SplitString(kNodelistLine, ",", true, &v);
+       sink = v.size();
+     }},
+    {"SplitStringView",
+     [] {
+       std::size_t n = 0;
+       for (const auto part : SplitStringView(kNodelistLine, ",")) {
+         n += part.size();
+       }
+       sink = n;
+     }},
+    {"stripcolors/legacy", [] { sink = legacy::stripcolors(kMenuLine).size(); }},
+    {"stripcolors", [] { sink = stripcolors(kMenuLine).size(); }},
+    {"stripcolors(view, out)",
+     [] {
+       static std::string out;
+       stripcolors(kMenuLine, &out);
+       sink = out.size();
+     }},
+    {"stripcolors/legacy plain", [] { sink = legacy::stripcolors(kPlainLine).size(); }},
+    {"stripcolors(view, out) plain",
+     [] {
+       static std::string out;
+       stripcolors(kPlainLine, &out);
+       sink = out.size();
+     }},
+    {"size_without_colors", [] { sink = size_without_colors(kMenuLine); }},
+    {"iequals/legacy", [] { sink = legacy::iequals(kUserName, "JOE SYSOP"); }},
+    {"iequals", [] { sink = iequals(kUserName, "JOE SYSOP"); }},
+    {"ToStringUpperCase/legacy", [] { sink = legacy::ToStringUpperCase(kUserName).size(); }},
+    {"ToStringUpperCase", [] { sink = ToStringUpperCase(kUserName).size(); }},
+    {"StringUpperCase(char*)",
+     [] {
+       char s[81];
+       to_char_array(s, kUserName);
+       StringUpperCase(s);
+       sink = s[0];
+     }},
+    {"StringTrim/legacy", [] { sink = legacy::StringTrim("  Joe Sysop \r\n").size(); }},
+    {"StringTrimView", [] { sink = StringTrimView("  Joe Sysop \r\n").size(); }},
+    {"StrCat/legacy", [] { sink = legacy::StrCat("p", 0, ".net", kUserName).size(); }},
+    {"StrCat", [] { sink = StrCat("p", 0, ".net", kUserName).size(); }},
+    {"StrCat strings", [] { sink = StrCat("p0", ".net", kUserName).size(); }},
+});
+
+} // namespace
@@ -53,6 +53,16 @@ TEST(StringsTest, StripColors_AnsiSeq) {
             stripcolors(string("\x1b[0m|15\x1b[0;33;46;1ma\x1b[0mb\x1b[0mc\x1b[0m")));
 }
 
+TEST(StringsTest, StripColors_ReusesOutput) {
+  std::string out("leftover");
+  stripcolors(std::string_view("|15a|#1b\x1b[0mc"), &out);
+  EXPECT_EQ("abc", out);
+  // A long run of plain text followed by codes.
+  const std::string plain(40, 'x');
+  stripcolors(plain + "|09" + plain + "\x1b[1;33m|", &out);
+  EXPECT_EQ(plain + plain + "|", out);
+}
+
 TEST(StringsTest, StringColors_CharStarVersion) {
   EXPECT_STREQ("", stripcolors(""));
   EXPECT_STREQ("|", stripcolors("|"));
@@ -157,6 +167,28 @@ TEST(StringsTest, SplitString_TwoDelimsBackToBack) {
   EXPECT_EQ(expected, actual);
 }
 
+TEST(StringsTest, SplitStringView) {
+  vector<std::string_view> actual;
+  for (const auto part : SplitStringView("Hello\t\tWorld  Everyone ", " \t")) {
+    actual.push_back(part);
+  }
+  EXPECT_EQ((vector<std::string_view>{"Hello", "World", "Everyone"}), actual);
+}
+
+TEST(StringsTest, SplitStringView_NoSkipEmpty) {
+  const std::string s = ",Hello,,World,";
+  const auto splitter = SplitStringView(s, ",", false);
+  const vector<std::string_view> actual(splitter.begin(), splitter.end());
+  EXPECT_EQ((vector<std::string_view>{"", "Hello", "", "World"}), actual);
+}
+
+TEST(StringsTest, SplitStringView_Empty) {
+  const auto splitter = SplitStringView("", ",");
+  EXPECT_EQ(splitter.begin(), splitter.end());
+  const auto delims_only = SplitStringView(",,", ",");
+  EXPECT_EQ(delims_only.begin(), delims_only.end());
+}
+
 TEST(StringsTest, String_int16_t) {
   EXPECT_EQ(1234, to_number<int16_t>("1234"));
   EXPECT_EQ(0, to_number<int16_t>("0"));
@@ -322,6 +354,14 @@ TEST(StringsTest, StringUpperCase) {
   EXPECT_EQ("AB", a);
 }
 
+TEST(StringsTest, StringUpperCase_CharStar) {
+  char s[] = "Hello World 123";
+  StringUpperCase(s);
+  EXPECT_STREQ("HELLO WORLD 123", s);
+  StringLowerCase(s);
+  EXPECT_STREQ("hello world 123", s);
+}
+
 TEST(StringsTest, StringLowerCase) {
   string a = "aB";
   StringLowerCase(&a);
@@ -348,6 +388,27 @@ TEST(StringsTest, IEQuals) {
   EXPECT_FALSE(iequals(string("foo"), string("")));
 }
 
+TEST(StringsTest, IEQuals_StringView) {
+  const std::string_view foo{"FOObar"};
+  EXPECT_TRUE(iequals(foo.substr(0, 3), "foo"));
+  EXPECT_TRUE(iequals(string("fOo"), foo.substr(0, 3)));
+  EXPECT_FALSE(iequals(foo, "foo"));
+}
+
+TEST(StringsTest, StringTrimView) {
+  EXPECT_EQ("abc", StringTrimView("  abc \r\n"));
+  EXPECT_EQ("a b", StringTrimView("a b"));
+  EXPECT_EQ("", StringTrimView(" \t "));
+  EXPECT_EQ("", StringTrimView(""));
+}
+
+TEST(StringsTest, StrCat_Strings) {
+  const std::string foo{"foo"};
+  const char* null_str = nullptr;
+  EXPECT_EQ("foobar baz", StrCat(foo, "bar", std::string_view(" baz"), null_str));
+  EXPECT_EQ("foo1", StrCat(foo, 1));
+}
+
 TEST(StringsTest, SizeWithoutColors) {
   EXPECT_EQ(1, size_without_colors("a"));
   EXPECT_EQ(1, size_without_colors("|#1a"));
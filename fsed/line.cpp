@@ -21,6 +21,8 @@
 #include "core/strings.h"
 #include "core/textfile.h"
 #include "fmt/format.h"
+#include <algorithm>
+#include <iterator>
 
 namespace wwiv::fsed {
 
@@ -31,6 +33,7 @@ enum class add_cell_state_t { text, heart_color };
 
 line_t::line_t(bool wrapped, std::string text) : wrapped_(wrapped) {
   auto state = add_cell_state_t::text;
+  text_.reserve(text.size());
   for (const auto c : text) {
     if (state == add_cell_state_t::heart_color) {
       state = add_cell_state_t::text;
@@ -44,30 +47,76 @@ line_t::line_t(bool wrapped, std::string text) : wrapped_(wrapped) {
       state = add_cell_state_t::heart_color;
       continue;
     }
-    cell_.emplace_back(wwiv_color_, c);
-    ++size_;
+    push_back(c);
   }
 }
 
 void line_t::push_back(char c) {
-  cell_.emplace_back(wwiv_color_, c);
-  ++size_;
+  if (colors_.empty() || colors_.back().wwiv_color != wwiv_color_) {
+    colors_.push_back(color_run_t{size_int(text_), wwiv_color_});
+  }
+  text_.push_back(c);
+}
+
+void line_t::splice(int x, int count, const std::string& text,
+                    const std::vector<color_run_t>& runs) {
+  const auto old_size = size_int(text_);
+  const auto end = x + count;
+  const auto delta = size_int(text) - count;
+
+  // Rebuild the runs so that they stay sorted with no two adjacent runs
+  // of the same color.
+  std::vector<color_run_t> out;
+  out.reserve(colors_.size() + runs.size() + 1);
+  auto add_run = [&out](int start, int color) {
+    if (!out.empty() && out.back().start == start) {
+      out.pop_back();
+    }
+    if (!out.empty() && out.back().wwiv_color == color) {
+      return;
+    }
+    out.push_back(color_run_t{start, color});
+  };
+
+  for (const auto& r : colors_) {
+    if (r.start >= x) {
+      break;
+    }
+    add_run(r.start, r.wwiv_color);
+  }
+  for (const auto& r : runs) {
+    add_run(x + r.start, r.wwiv_color);
+  }
+  if (end < old_size) {
+    add_run(x + size_int(text), color_at(end));
+    for (const auto& r : colors_) {
+      if (r.start > end) {
+        add_run(r.start + delta, r.wwiv_color);
+      }
+    }
+  }
+
+  text_.replace(x, count, text);
+  const auto new_size = size_int(text_);
+  while (!out.empty() && out.back().start >= new_size) {
+    out.pop_back();
+  }
+  colors_ = std::move(out);
 }
 
 line_add_result_t line_t::add(int x, char c, ins_ovr_mode_t mode) {
-  while (size_ < x) {
+  while (size_int(text_) < x) {
     push_back(' ');
   }
-  if (x == size_) {
+  if (x == size_int(text_)) {
     push_back(c);
     return line_add_result_t::no_redraw;
   }
   if (mode == ins_ovr_mode_t::ins) {
-    wwiv::stl::insert_at(cell_, x, cell_t{wwiv_color_, c});
-    ++size_;
+    splice(x, 0, std::string(1, c), {color_run_t{0, wwiv_color_}});
     return line_add_result_t::needs_redraw;
   }
-  cell_[x] = cell_t{wwiv_color_, c};
+  splice(x, 1, std::string(1, c), {color_run_t{0, wwiv_color_}});
   return line_add_result_t::no_redraw;
 }
 
@@ -75,16 +124,17 @@ line_add_result_t line_t::del(int x, ins_ovr_mode_t) {
   if (x < 0) {
     return line_add_result_t::error;
   }
-  const auto result = x == size_ ? line_add_result_t::no_redraw : line_add_result_t::needs_redraw;
-  if (!wwiv::stl::erase_at(cell_, x)) {
+  const auto size = size_int(text_);
+  const auto result = x == size ? line_add_result_t::no_redraw : line_add_result_t::needs_redraw;
+  if (x >= size) {
     return line_add_result_t ::error;
   }
-  --size_;
+  splice(x, 1, {}, {});
 
   const auto new_x = x - 1;
-  if (new_x >= 0 && new_x < size_) {
+  if (new_x >= 0 && new_x < size_int(text_)) {
     // adopt new color
-    wwiv_color_ = cell_.at(new_x).wwiv_color;
+    wwiv_color_ = color_at(new_x);
   }
   return result;
 }
@@ -96,17 +146,17 @@ line_add_result_t line_t::bs(int x, ins_ovr_mode_t mode) {
   return del(x - 1, mode);
 }
 
-std::size_t line_t::size() const { return size_; }
+std::size_t line_t::size() const { return text_.size(); }
 
 int line_t::last_space_before(int maxlen) { 
-  if (size_ < maxlen) {
-    return size_;
+  if (size_int(text_) < maxlen) {
+    return size_int(text_);
   }
-  if (cell_.empty()) {
+  if (text_.empty()) {
     return 0;
   }
   for (int i = maxlen - 1; i > 0; i--) {
-    char c = cell_.at(i).ch;
+    const auto c = text_.at(i);
     if (c == '\t' || c == ' ') {
       return i;
     }
@@ -122,42 +172,57 @@ int line_t::wwiv_color() const noexcept {
   return wwiv_color_; 
 }
 
-line_t& line_t::operator=(const line_t& o) {
-  wrapped_ = o.wrapped_;
-  cell_ = o.cell_;
-  size_ = o.size_;
-  wwiv_color_ = o.wwiv_color_;
-  return *this;
-}
-
-void line_t::assign(const std::vector<cell_t>& cells) {
-  if (cells.empty()) {
-    cell_.clear();
-    size_ = 0;
+void line_t::assign(const line_t& o) {
+  if (o.text_.empty()) {
+    text_.clear();
+    colors_.clear();
     return;
   }
-  cell_ = cells;
-  size_ = size_int(cells);
-  wwiv_color_ = cells.back().wwiv_color;
+  text_ = o.text_;
+  colors_ = o.colors_;
+  wwiv_color_ = o.colors_.back().wwiv_color;
 }
 
-void line_t::append(const std::vector<cell_t>& cells) {
-  if (cells.empty()) {
+void line_t::append(const line_t& o) {
+  if (o.text_.empty()) {
     return;
   }
-  for (const auto& c : cells) {
-    cell_.emplace_back(c);
+  splice(size_int(text_), 0, o.text_, o.colors_);
+  wwiv_color_ = o.colors_.back().wwiv_color;
+}
+
+int line_t::color_at(int x) const {
+  const auto it = std::upper_bound(
+      std::begin(colors_), std::end(colors_), x,
+      [](int pos, const color_run_t& r) { return pos < r.start; });
+  if (it == std::begin(colors_)) {
+    return wwiv_color_;
   }
-  size_ += size_int(cells);
-  wwiv_color_ = cells.back().wwiv_color;
+  return std::prev(it)->wwiv_color;
 }
 
-std::vector<cell_t> line_t::substr(int start, int end) {
-  return std::vector<cell_t>(cell_.begin() + start, cell_.begin() + end);
+cell_t line_t::cell(int x) const {
+  return cell_t{color_at(x), text_.at(x)};
+}
+
+line_t line_t::substr(int start, int end) const {
+  line_t out;
+  out.wwiv_color_ = wwiv_color_;
+  out.text_ = text_.substr(start, end - start);
+  if (out.text_.empty()) {
+    return out;
+  }
+  out.colors_.push_back(color_run_t{0, color_at(start)});
+  for (const auto& r : colors_) {
+    if (r.start > start && r.start < end) {
+      out.colors_.push_back(color_run_t{r.start - start, r.wwiv_color});
+    }
+  }
+  return out;
 }
 
-std::vector<cell_t> line_t::substr(int start) {
-  return std::vector<cell_t>(cell_.begin() + start, cell_.end());
+line_t line_t::substr(int start) const {
+  return substr(start, size_int(text_));
 }
 
 static void append_wwiv_color(std::string& out, int wwiv_color, line_color_code_format_t format) {
@@ -175,13 +240,16 @@ std::string line_t::to_colored_text(int default_last_color) const {
   // This used to be 0, try -1 so we always set the color explicitly.
   auto last_color = default_last_color;
   std::string out;
-  for (const auto& c : cell_) {
-    if (c.wwiv_color != last_color) {
-      append_wwiv_color(out, c.wwiv_color, line_color_code_format_t::heart);
-      last_color = c.wwiv_color;
+  out.reserve(text_.size() + colors_.size() * 2 + 2);
+  for (auto i = 0; i < size_int(colors_); i++) {
+    const auto& r = colors_[i];
+    if (r.wwiv_color != last_color) {
+      append_wwiv_color(out, r.wwiv_color, line_color_code_format_t::heart);
+      last_color = r.wwiv_color;
       changed_color = true;
     }
-    out.push_back(c.ch);
+    const auto end = i + 1 < size_int(colors_) ? colors_[i + 1].start : size_int(text_);
+    out.append(text_, r.start, end - r.start);
   }
   if (changed_color) {
     append_wwiv_color(out, 0, line_color_code_format_t::heart);
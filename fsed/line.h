@@ -33,8 +33,21 @@ public:
   char ch{0};
 };
 
+/** All of the characters from start up to the start of the next run are wwiv_color */
+struct color_run_t {
+  int start;
+  int wwiv_color;
+};
+
 enum class line_color_code_format_t { heart, pipe };
 
+/**
+ * A line of text in the editor.
+ *
+ * The text is kept as a string, with the colors kept as runs of the same
+ * color, so a line costs about a byte per character.  Lines are cheap to
+ * move, which is what happens when lines are inserted or removed.
+ */
 class line_t {
 public:
   line_t() : line_t(false, "") {}
@@ -56,21 +69,28 @@ public:
   void set_wwiv_color(int c);
   [[nodiscard]] int wwiv_color() const noexcept;
 
-  // operators
-  line_t& operator=(const line_t& o);
-
-  void assign(const std::vector<cell_t>& cells);
-  void append(const std::vector<cell_t>& cells);
-  [[nodiscard]] const std::vector<cell_t>& cells() const { return cell_; }
-  std::vector<cell_t> substr(int start, int end);
-  std::vector<cell_t> substr(int start);
+  // Replaces the text and colors with those of o.
+  void assign(const line_t& o);
+  // Appends the text and colors of o.
+  void append(const line_t& o);
+  [[nodiscard]] const std::string& text() const noexcept { return text_; }
+  [[nodiscard]] const std::vector<color_run_t>& colors() const noexcept { return colors_; }
+  // Gets the color of the character at x.
+  [[nodiscard]] int color_at(int x) const;
+  // Gets the character and color at x.
+  [[nodiscard]] cell_t cell(int x) const;
+  [[nodiscard]] line_t substr(int start, int end) const;
+  [[nodiscard]] line_t substr(int start) const;
   // Gets a line of text that can be displayed using bputs
   [[nodiscard]] std::string to_colored_text(int default_last_color) const;
 
 private:
+  // Replaces count characters at x with text, colored using runs (relative to text).
+  void splice(int x, int count, const std::string& text, const std::vector<color_run_t>& runs);
+
   bool wrapped_{false};
-  std::vector<cell_t> cell_;
-  int size_{0};
+  std::string text_;
+  std::vector<color_run_t> colors_;
   int wwiv_color_{0};
 };
 
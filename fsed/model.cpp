@@ -73,11 +73,11 @@ line_t& FsedModel::line(int n) const {
 }
 
 bool FsedModel::set_lines(std::vector<line_t>&& n) {
-  lines_ = n;
+  lines_ = std::move(n);
   return true;
 }
 
-void FsedModel::emplace_back(line_t&& n) { lines_.emplace_back(n); }
+void FsedModel::emplace_back(line_t&& n) { lines_.emplace_back(std::move(n)); }
 
 bool FsedModel::insert_line() {
   if (ssize(lines_) >= maxli()) {
@@ -157,7 +157,7 @@ cell_t FsedModel::current_cell() const {
     return cell_t(0, ' ');
   }
   try {
-    return line.cells().at(cx);
+    return line.cell(cx);
   } catch (const std::exception& e) {
     LOG(ERROR) << "Exception trying to get cx: " << cx << "; what: " << e.what();
     LOG(ERROR) << wwiv::os::stacktrace();
@@ -379,7 +379,7 @@ bool FsedModel::bs() {
     const auto last_pos = std::max<int>(0, max_line_len() - size_int(prev) - 1);
     const auto new_cx = size_int(prev);
     if (ssize(cur) < last_pos) {
-      prev.append(cur.cells());
+      prev.append(cur);
       remove_line();
     } else if (const int space = cur.last_space_before(last_pos) > 0) {
       prev.append(cur.substr(0, space));
@@ -45,6 +45,8 @@ FullScreenView& FsedView::fs() { return fs_; }
 
 void FsedView::gotoxy(const FsedModel& ed) {
   bout_.GotoXY(ed.cx + 1, ed.cy + fs_.lines_start()); // - top_line() 
+  cursor_x_ = ed.cx;
+  cursor_row_ = ed.cy;
 }
 
 void FsedView::ClearCommandLine() { 
@@ -66,35 +68,83 @@ void FsedView::macro(Context& ctx, int cc) {
 
 }
 
+FsedView::screen_row_t& FsedView::screen_row(int y) {
+  const auto row = y - fs_.lines_start();
+  if (row >= ssize(rows_)) {
+    rows_.resize(row + 1);
+  }
+  return rows_.at(row);
+}
+
+void FsedView::draw_line(int y, const line_t& line, bool current) {
+  auto& row = screen_row(y);
+  if (!current && line.text().find('|') != std::string::npos) {
+    // Pipe codes are interpreted by bputs, so we can't tell what will be
+    // on the screen.  Draw it all and start over next time.
+    bout_.GotoXY(0, y);
+    bout_.bputs(line.to_colored_text(-1));
+    bout_.clreol();
+    row.valid = false;
+    return;
+  }
+
+  const auto size = size_int(line);
+  const auto old_size = row.valid ? size_int(row.line) : 0;
+  auto first = 0;
+  auto last = size;
+  if (row.valid) {
+    const auto& ot = row.line.text();
+    const auto& nt = line.text();
+    const auto common = std::min<int>(size, old_size);
+    while (first < common && ot[first] == nt[first] &&
+           row.line.color_at(first) == line.color_at(first)) {
+      ++first;
+    }
+    if (size == old_size) {
+      while (last > first && ot[last - 1] == nt[last - 1] &&
+             row.line.color_at(last - 1) == line.color_at(last - 1)) {
+        --last;
+      }
+    }
+  }
+  const auto needs_clear = !row.valid || old_size > size;
+  if (first == last && !needs_clear) {
+    return;
+  }
+
+  bout_.GotoXY(first + 1, y);
+  auto last_color = -1;
+  for (auto x = first; x < last; x++) {
+    // Draw char by char so we don't display color codes on the
+    // line being edited.
+    const auto c = line.cell(x);
+    if (c.wwiv_color != last_color) {
+      last_color = c.wwiv_color;
+      bout_.Color(c.wwiv_color);
+    }
+    bout_.bputch(c.ch);
+  }
+  if (needs_clear) {
+    bout_.clreol();
+  }
+  row.line = line;
+  row.valid = true;
+}
+
 void FsedView::draw_current_line(FsedModel& ed, int previous_line) { 
   if (previous_line != ed.curli) {
     const auto py = previous_line - top_line() + fs_.lines_start();
-    bout_.GotoXY(0, py);
-    if (previous_line < ssize(ed)) {
-      bout_.bputs(ed.line(previous_line).to_colored_text(-1));
-    }
-    bout_.clreol();
+    draw_line(py, previous_line < ssize(ed) ? ed.line(previous_line) : line_t(), false);
   }
 
   const auto y = ed.curli - top_line() + fs_.lines_start(); 
-  bout_.GotoXY(0, y);
-  bout_.Color(0);
-  for (const auto& c : ed.curline().cells()) {
-    // Draw char by char for the current line so we don't display
-    // color codes where we are editing.
-    bout_.Color(c.wwiv_color);
-    bout_.bputch(c.ch);
-  }
-  bout_.clreol();
+  draw_line(y, ed.curline(), true);
   gotoxy(ed);
 }
 
 void FsedView::handle_editor_invalidate(FsedModel& e, editor_range_t t) {
-  // TODO: optimize for first line
-
   // Never go below top line.
   const auto start_line = std::max<int>(t.start.line, top_line());
-  auto last_color = -1;
 
   for (auto i = start_line; i <= t.end.line; i++) {
     auto y = i - top_line() + fs_.lines_start();
@@ -104,30 +154,15 @@ void FsedView::handle_editor_invalidate(FsedModel& e, editor_range_t t) {
     if (i >= ssize(e)) {
       break;
     }
-    bout_.GotoXY(0, y);
-    auto& rl = e.line(i);
-    if (i == e.curli) {
-      for (const auto& c : rl.cells()) {
-        // Draw char by char for the current line so we don't display
-        // color codes where we are editing.
-        if (c.wwiv_color != last_color) {
-          last_color = c.wwiv_color;
-          bout_.Color(c.wwiv_color);
-        }
-        bout_.bputch(c.ch);
-      }
-    } else {
-      bout_.bputs(rl.to_colored_text(-1));
-    }
-    bout_.clreol();
+    draw_line(y, e.line(i), i == e.curli);
   }
 
   // Clean up the bottom.
   // clear the current and then remaining
   if (size_int(e) == t.end.line + 1) {
+    const line_t empty;
     for (auto z = size_int(e) - top_line() + fs_.lines_start(); z < fs_.lines_end(); z++) {
-      bout_.GotoXY(0, z);
-      bout_.clreol();
+      draw_line(z, empty, false);
     }
   }
 
@@ -137,6 +172,7 @@ void FsedView::handle_editor_invalidate(FsedModel& e, editor_range_t t) {
 void FsedView::draw_header() {
   const auto oldcuratr = bout_.curatr();
   bout_.cls();
+  invalidate_screen();
   const auto to = data_.to_name.empty() ? "All" : data_.to_name;
   bout_ << "|#7From: |#2" << data_.from_name << wwiv::endl;
   bout_ << "|#7To:   |#2" << to << wwiv::endl;
@@ -215,9 +251,20 @@ int FsedView::bgetch(FsedModel& ed) {
 void FsedView::bputch(int color, char ch) {
   bout_.Color(color);
   bout_.bputch(ch);
+  if (cursor_row_ >= 0 && cursor_row_ < ssize(rows_) && rows_[cursor_row_].valid) {
+    auto& l = rows_[cursor_row_].line;
+    l.set_wwiv_color(color);
+    l.add(cursor_x_, ch, ins_ovr_mode_t::ovr);
+  }
+  ++cursor_x_;
+}
+
+void FsedView::cls() {
+  bout_.cls();
+  invalidate_screen();
 }
 
-void FsedView::cls() { bout_.cls(); }
+void FsedView::invalidate_screen() { rows_.clear(); }
 
 void FsedView::Color(int c) { bout_.Color(c); }
 
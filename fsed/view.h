@@ -20,7 +20,9 @@
 
 #include "common/full_screen.h"
 #include "common/message_editor_data.h"
+#include "fsed/line.h"
 #include "fsed/model.h"
+#include <vector>
 
 namespace wwiv {
 namespace common {
@@ -49,8 +51,11 @@ public:
   void redraw(const FsedModel& ed);
   void draw_bottom_bar(const FsedModel& ed);
   [[nodiscard]] int bgetch(FsedModel& ed);
+  // Writes ch at the cursor, keeping track of it on the screen.
   void bputch(int color, char ch);
   void cls();
+  // Forgets what is on the screen, so the next draw of each line is complete.
+  void invalidate_screen();
   void Color(int c);
   [[nodiscard]] int top_line() const override { return top_line_; }
   void set_top_line(int l) override { top_line_ = l; }
@@ -70,6 +75,22 @@ private:
   int max_view_columns_;
   common::MessageEditorData& data_;
   bool file_{false};
+  // What is currently displayed on an editor row on the screen.
+  struct screen_row_t {
+    bool valid{false};
+    line_t line;
+  };
+
+  // Draws line on screen row y, only sending the cells that differ from
+  // what is already displayed there.
+  void draw_line(int y, const line_t& line, bool current);
+  screen_row_t& screen_row(int y);
+
+  // Editor rows on the screen, indexed from fs_.lines_start().
+  std::vector<screen_row_t> rows_;
+  // Cursor position in the editor from the last gotoxy.
+  int cursor_x_{0};
+  int cursor_row_{0};
   //  Saved positions for the bottom bar caching.
   int sx{-1};
   int sy{-1};
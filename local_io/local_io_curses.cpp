@@ -30,6 +30,7 @@
 #include "localui/wwiv_curses.h"
 #include "local_io/keycodes.h"
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <string>
 
@@ -41,6 +42,9 @@ using std::string;
 using namespace wwiv::strings;
 
 static const int default_screen_bottom = 20;
+// How often output is drawn to the local screen. Anything written since the
+// last refresh is also drawn whenever the keyboard is polled.
+static constexpr auto local_refresh_interval = std::chrono::milliseconds(33);
 
 static void InitPairs() {
   std::vector<short> lowbit_colors = {COLOR_BLACK, COLOR_BLUE,    COLOR_GREEN,  COLOR_CYAN,
@@ -60,6 +64,7 @@ CursesLocalIO::CursesLocalIO(int num_lines) {
   window_.reset(new CursesWindow(nullptr, curses_out->color_scheme(), num_lines, 80, 0, 0));
   auto* w = std::any_cast<WINDOW*>(window_->window());
   scrollok(w, true);
+  window_->set_refresh_interval(local_refresh_interval);
   window_->Clear();
 }
 
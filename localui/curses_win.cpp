@@ -107,7 +107,17 @@ void CursesWindow::SetTitle(const std::string& title) {
 void CursesWindow::Bkgd(uint32_t ch) { wbkgd(std::any_cast<WINDOW*>(window_), ch); }
 int CursesWindow::RedrawWin() { return redrawwin(std::any_cast<WINDOW*>(window_)); }
 int CursesWindow::TouchWin() { return touchwin(std::any_cast<WINDOW*>(window_)); }
-int CursesWindow::Refresh() { return wrefresh(std::any_cast<WINDOW*>(window_)); }
+int CursesWindow::Refresh() {
+  last_refresh_ = steady_clock::now();
+  return wrefresh(std::any_cast<WINDOW*>(window_));
+}
+
+void CursesWindow::RefreshIfDue() {
+  if (refresh_interval_.count() == 0 || steady_clock::now() - last_refresh_ >= refresh_interval_) {
+    Refresh();
+  }
+}
+
 int CursesWindow::Move(int y, int x) { return wmove(std::any_cast<WINDOW*>(window_), y, x); }
 int CursesWindow::GetcurX() const { return getcurx(std::any_cast<WINDOW*>(window_)); }
 int CursesWindow::GetcurY() const { return getcury(std::any_cast<WINDOW*>(window_)); }
@@ -205,22 +215,22 @@ void CursesWindow::GotoXY(int x, int y) {
   y = std::min<int>(y, GetMaxY());
 
   Move(y, x);
-  Refresh();
+  RefreshIfDue();
 }
 
 void CursesWindow::Putch(uint32_t ch) {
   waddch(std::any_cast<WINDOW*>(window_), ch);
-  Refresh();
+  RefreshIfDue();
 }
 
 void CursesWindow::Puts(const std::string& text) {
   waddstr(std::any_cast<WINDOW*>(window_), text.c_str());
-  Refresh();
+  RefreshIfDue();
 }
 
 void CursesWindow::PutsXY(int x, int y, const std::string& text) {
   mvwaddstr(std::any_cast<WINDOW*>(window_), y, x, text.c_str());
-  Refresh();
+  RefreshIfDue();
 }
 
 void CursesWindow::PutchW(wchar_t ch) {
@@ -228,17 +238,17 @@ void CursesWindow::PutchW(wchar_t ch) {
   wchar_t c[2] = {ch, 0};
   waddwstr(std::any_cast<WINDOW*>(window_), c);
 
-  Refresh();
+  RefreshIfDue();
 }
 
 void CursesWindow::PutsW(const std::wstring& text) {
   waddwstr(std::any_cast<WINDOW*>(window_), text.c_str());
-  Refresh();
+  RefreshIfDue();
 }
 
 void CursesWindow::PutsXYW(int x, int y, const std::wstring& text) {
   mvwaddwstr(std::any_cast<WINDOW*>(window_), y, x, text.c_str());
-  Refresh();
+  RefreshIfDue();
 }
 
 void CursesWindow::SetColor(SchemeId id) {
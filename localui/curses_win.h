@@ -74,10 +74,21 @@ public:
 
   [[nodiscard]] bool IsGUI() const override;
 
+  /**
+   * Limits how often writing to the window refreshes the screen.  Anything
+   * written in between is drawn by the next Refresh or GetChar.  The default
+   * of 0 refreshes on every write.
+   */
+  void set_refresh_interval(std::chrono::milliseconds i) { refresh_interval_ = i; }
+
 private:
+  void RefreshIfDue();
+
   std::any window_;
   CursesWindow* parent_;
   ColorScheme* color_scheme_;
+  std::chrono::milliseconds refresh_interval_{0};
+  std::chrono::steady_clock::time_point last_refresh_{};
 };
 
 #endif
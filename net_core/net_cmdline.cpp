@@ -22,6 +22,7 @@
 #include "core/file.h"
 #include "core/inifile.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/stl.h"
 #include "core/strings.h"
 #include "core/version.h"
@@ -76,6 +77,8 @@ NetworkCommandLine::NetworkCommandLine(wwiv::core::CommandLine& cmdline, char ne
   if (!config_->IsInitialized()) {
     LOG(ERROR) << "Unable to load CONFIG.DAT.";
     initialized_ = false;
+  } else {
+    Metrics::Init(config_->datadir());
   }
   if (!networks_->IsInitialized()) {
     LOG(ERROR) << "Unable to load networks.";
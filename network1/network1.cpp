@@ -24,6 +24,7 @@
 #include "core/file.h"
 #include "core/findfiles.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/os.h"
 #include "core/scope_exit.h"
 #include "core/semaphore_file.h"
@@ -128,23 +129,45 @@ bool Network1::handle_packet(Packet& p) {
   return write_multiple_wwivnet_packets(p.nh, p.list, p.text());
 }
 
+bool Network1::handle_packet(const PacketView& v) {
+  if (need_to_update_routing(v.nh().main_type) || v.list_size() > 0) {
+    // The routing information changes the text, and packets to multiple
+    // systems are split up, so these need a copy.
+    auto p = v.ToPacket();
+    return handle_packet(p);
+  }
+
+  // Everything else is forwarded as is.
+  if (v.nh().tosys == net_.sysnum) {
+    // Local Packet.
+    netdat_.add_file_bytes(net_.sysnum, v.length());
+    return write_wwivnet_packet(LOCAL_NET, net_, v);
+  }
+  // Network packet, single destination
+  const auto forsys = get_forsys(bbslist_, v.nh().tosys);
+  netdat_.add_file_bytes(forsys, v.length());
+  return write_wwivnet_packet(Packet::wwivnet_packet_name(net_, forsys), net_, v);
+}
+
 bool Network1::handle_file(const string& name) {
-  File f(FilePath(net_.dir, name));
-  if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+  PacketReader reader(FilePath(net_.dir, name), false);
+  if (!reader.Open()) {
     LOG(INFO) << "Unable to open file: " << net_.dir << name;
     return false;
   }
 
+  auto packets = Metrics::instance().counter("network1_packets_total", "Packets routed by network1");
   for (;;) {
-    auto [packet, response] = read_packet(f, false);
+    auto [packet, response] = reader.Next();
     if (response == ReadPacketResponse::END_OF_FILE) {
       return true;
     }
     if (response == ReadPacketResponse::ERROR) {
       return false;
     }
+    packets.inc();
     if (!handle_packet(packet)) {
-      LOG(INFO) << "error handing packet: type: " << packet.nh.main_type;
+      LOG(INFO) << "error handing packet: type: " << packet.nh().main_type;
     }
   }
 }
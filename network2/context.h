@@ -22,9 +22,13 @@
 #include "sdk/config.h"
 #include "sdk/msgapi/message_api_wwiv.h"
 #include "sdk/net/net.h"
+#include "sdk/net/packets.h"
+#include "sdk/net/subscribers.h"
 #include "sdk/subxtr.h"
 #include "sdk/usermanager.h"
 #include <map>
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace wwiv::net::network2 {
@@ -61,6 +65,13 @@ public:
   NetDat& netdat_;
   bool verbose{false};
   bool subs_initialized{false};
+  // Message areas that posts have been imported into, keyed by sub filename.
+  // These stay open for the rest of the run.
+  std::map<std::string, std::unique_ptr<sdk::msgapi::MessageArea>> areas;
+  // Subscriber lists used when sending posts out to subscribers.
+  sdk::SubscriberCache subscribers;
+  // Posts sent out to subscribers, written once local.net has been processed.
+  sdk::net::PendingPacketWriter outbound{'2'};
 };
 
 } // namespace wwiv::net::network2
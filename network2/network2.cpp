@@ -21,6 +21,7 @@
 #include "core/datafile.h"
 #include "core/file.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/os.h"
 #include "core/scope_exit.h"
 #include "core/semaphore_file.h"
@@ -243,14 +244,15 @@ static bool handle_packet(Context& context, Packet& p) {
 }
 
 static bool handle_file(Context& context, const string& name) {
-  File f(FilePath(context.net.dir, name));
-  if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+  PacketReader reader(FilePath(context.net.dir, name), true);
+  if (!reader.Open()) {
     LOG(ERROR) << "Unable to open file: " << context.net.dir << name;
     return false;
   }
 
+  auto packets = Metrics::instance().counter("network2_packets_total", "Packets imported by network2");
   for (;;) {
-    auto [packet, response] = read_packet(f, true);
+    auto [view, response] = reader.Next();
     if (response == ReadPacketResponse::END_OF_FILE) {
       return true;
     }
@@ -258,6 +260,8 @@ static bool handle_file(Context& context, const string& name) {
       return false;
     }
 
+    packets.inc();
+    auto packet = view.ToPacket();
     if (!handle_packet(context, packet)) {
       LOG(ERROR) << "Error handing packet: type: " << packet.nh.main_type;
     }
@@ -292,7 +296,12 @@ int network2_main(const NetworkCommandLine& net_cmdline) {
                                                    new NullLastReadImpl()));
 
     LOG(INFO) << "Processing: " << net.dir << LOCAL_NET;
-    if (handle_file(context, LOCAL_NET)) {
+    const auto handled = handle_file(context, LOCAL_NET);
+    // Anything that was processed has been sent out, even if the rest failed.
+    if (!context.outbound.Flush()) {
+      LOG(ERROR) << "ERROR: Unable to write the posts sent to subscribers.";
+    }
+    if (handled) {
       if (net_cmdline.skip_delete()) {
         backup_file(FilePath(net.dir, LOCAL_NET));
       }
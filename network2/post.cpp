@@ -105,30 +105,35 @@ bool handle_inbound_post(Context& context, Packet& p) {
     return write_wwivnet_packet(DEAD_NET, context.net, p);
   }
 
-  if (!context.api(sub.storage_type).Exist(sub)) {
-    LOG(INFO) << "WARNING Message area: '" << sub.filename << "' does not exist.";
-    LOG(INFO) << "WARNING Attempting to create it.";
-    // Since the area does not exist, let's create it automatically
-    // like WWIV always does.
-    auto created = context.api(sub.storage_type).Create(sub, -1);
-    if (!created) {
-      const auto msg = fmt::format("Failed to create message area: '{}'; writing to dead.net", sub.filename);
+  // Areas stay open for the run, since a batch usually has many posts for
+  // the same sub.
+  auto& area = context.areas[sub.filename];
+  if (!area) {
+    if (!context.api(sub.storage_type).Exist(sub)) {
+      LOG(INFO) << "WARNING Message area: '" << sub.filename << "' does not exist.";
+      LOG(INFO) << "WARNING Attempting to create it.";
+      // Since the area does not exist, let's create it automatically
+      // like WWIV always does.
+      auto created = context.api(sub.storage_type).Create(sub, -1);
+      if (!created) {
+        const auto msg = fmt::format("Failed to create message area: '{}'; writing to dead.net", sub.filename);
+        context.netdat().add_message(NetDat::netdat_msgtype_t::error, msg);
+        LOG(INFO) << "    ! ERROR: Failed to create message area: '" << sub.filename
+                  << "'; writing to dead.net.";
+        return write_wwivnet_packet(DEAD_NET, context.net, p);
+      }
+    }
+
+    area.reset(context.api(sub.storage_type).Open(sub, -1));
+    if (!area) {
+      const auto msg = fmt::format("Failed to open message area: '{}'; writing to dead.net", sub.filename);
       context.netdat().add_message(NetDat::netdat_msgtype_t::error, msg);
-      LOG(INFO) << "    ! ERROR: Failed to create message area: '" << sub.filename
+      LOG(INFO) << "    ! ERROR Unable to open message area: '" << sub.filename
                 << "'; writing to dead.net.";
       return write_wwivnet_packet(DEAD_NET, context.net, p);
     }
   }
 
-  unique_ptr<MessageArea> area(context.api(sub.storage_type).Open(sub, -1));
-  if (!area) {
-    const auto msg = fmt::format("Failed to open message area: '{}'; writing to dead.net", sub.filename);
-    context.netdat().add_message(NetDat::netdat_msgtype_t::error, msg);
-    LOG(INFO) << "    ! ERROR Unable to open message area: '" << sub.filename
-              << "'; writing to dead.net.";
-    return write_wwivnet_packet(DEAD_NET, context.net, p);
-  }
-
   if (area->Exists(p.nh.daten, ppt.title(), p.nh.fromsys, p.nh.fromuser)) {
     const auto msg = fmt::format("Discarding Duplicate Message on sub: {}; daten: {}; title: {}", ppt.subtype(),  p.nh.daten, ppt.title());
     context.netdat().add_message(NetDat::netdat_msgtype_t::normal, msg);
@@ -202,7 +207,8 @@ bool send_post_to_subscribers(Context& context, Packet& template_packet,
 
   return send_post_to_subscribers(context.networks(), context.network_number, original_subtype, sub,
                                   template_packet, subscribers_to_skip,
-                                  subscribers_send_to_t::hosted_and_gated_only);
+                                  subscribers_send_to_t::hosted_and_gated_only,
+                                  context.subscribers, context.outbound);
 }
 
 } // namespace wwiv
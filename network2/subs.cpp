@@ -208,6 +208,7 @@ bool handle_sub_add_req(Context& context, Packet& p) {
     LOG(INFO) << "Unable to write subscribers file.";
     return resp(sub_adddrop_error);
   }
+  context.subscribers.Invalidate(FilePath(context.net.dir, filename));
 
   // success!
   LOG(INFO) << "Added system @" << p.nh.fromsys << " to subtype: " << subtype;
@@ -239,6 +240,7 @@ bool handle_sub_drop_req(Context& context, Packet& p) {
     LOG(INFO) << "Unable to write subscribers file.";
     return resp(sub_adddrop_error);
   }
+  context.subscribers.Invalidate(FilePath(context.net.dir, filename));
 
   // success!
   LOG(INFO) << "Dropped system @" << p.nh.fromsys << " to subtype: " << subtype;
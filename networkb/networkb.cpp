@@ -140,6 +140,7 @@ static bool Send(const CommandLine& cmdline, BinkConfig& bink_config, const stri
     c = Connect(node_config->host, node_config->port);
   } catch (const connection_error& e) {
     LOG(ERROR) << "Recording failure: '" << e.what() << "'";
+    record_failed_callout();
     const net_networks_rec& net = bink_config.networks()[network_name];
     Contact contact(net, true);
 
@@ -44,6 +44,8 @@
 #include "sdk/net/ftn_msgdupe.h"
 #include "sdk/net/packets.h"
 #include "sdk/net/subscribers.h"
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
@@ -52,12 +54,9 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
-#ifndef _WIN32
-#include <signal.h>
-#endif // _WIN32
-
 using namespace wwiv::core;
 using namespace wwiv::net;
 using namespace wwiv::os;
@@ -120,7 +119,7 @@ static std::string arc_stuff_in(const std::string& command_line, const std::stri
   return os.str();
 }
 
-static void ShowHelp(const NetworkCommandLine& cmdline) {
+void ShowHelp(const NetworkCommandLine& cmdline) {
   cout << cmdline.GetHelp() << endl
        << "commands: " << endl
        << endl
@@ -161,6 +160,97 @@ NetworkF::NetworkF(const wwiv::net::NetworkCommandLine& net_cmdline,
 
 NetworkF::~NetworkF() = default;
 
+bool NetworkF::check_packet_password(const packet_header_2p_t& header) const {
+  const FidoAddress address(header.orig_zone, header.orig_net, header.orig_node,
+                            header.orig_point, "");
+  const auto expected = fido_callout_.packet_config_for(address).packet_password;
+  // Do this dance to ensure that if there's no trailing null
+  // on header.password, we add one.
+  char temp[9];
+  memset(temp, 0, sizeof(temp));
+  strncpy(temp, header.password, 8);
+  temp[8] = '\0';
+  const std::string actual = temp;
+  if (!iequals(expected, actual)) {
+    LOG(ERROR) << "Unexpected packet password from node: " << address << "; actual: '" << actual
+               << "'; expected: '" << expected << "'";
+    return false;
+  }
+  return true;
+}
+
+void NetworkF::move_to_bad_packets(const std::filesystem::path& path) const {
+  const FtnDirectories dirs(net_cmdline_.config().root_directory(), net_);
+  const auto dest = FilePath(dirs.bad_packets_dir(), path.filename().string());
+
+  if (!File::Move(path, dest)) {
+    LOG(ERROR) << "Error moving file to BADMSGS; file: " << path.string();
+  }
+}
+
+/**
+ * Creates the WWIVnet packet for network2 to import from the FTN message.
+ * wwiv_text is the message text already converted by FidoToWWIVText and
+ * area_or_to is set to the echomail area name or the netmail recipient.
+ */
+static Packet ftn_message_to_wwivnet_packet(const FidoPackedMessage& msg,
+                                            const FidoAddress& from_address,
+                                            const std::string& wwiv_text,
+                                            std::string& area_or_to) {
+  const bool is_email = (msg.nh.attribute & MSGPRIVATE);
+  net_header_rec nh{};
+  nh.daten = static_cast<uint32_t>(fido_to_daten(msg.vh.date_time));
+  nh.fromsys = FTN_FAKE_OUTBOUND_NODE;
+  nh.fromuser = 0;
+  nh.list_len = 0;
+  if (is_email) {
+    nh.main_type = main_type_email_name;
+  } else {
+    nh.main_type = main_type_new_post;
+  }
+
+  nh.method = 0;
+  nh.minor_type = 0;
+  nh.tosys = 1; // always 1 in new fido
+  nh.touser = 0;
+
+  std::string text;
+  if (is_email) {
+    // TO_USER<nul>TITLE<nul>SENDER_NAME<cr/lf>DATE_STRING<cr/lf>MESSAGE_TEXT.
+    area_or_to = msg.vh.to_user_name;
+  } else {
+    // SUBTYPE<nul>TITLE<nul>SENDER_NAME<cr/lf>DATE_STRING<cr/lf>MESSAGE_TEXT.
+    area_or_to = get_echomail_areaname(msg.vh.text);
+  }
+  text.append(area_or_to);
+
+  text.push_back(0);
+  text.append(msg.vh.subject);
+  text.push_back(0);
+  text.append(StrCat(msg.vh.from_user_name, "(", from_address, ")\r\n"));
+  const auto dt = fido_to_daten(msg.vh.date_time);
+  text.append(daten_to_wwivnet_time(dt));
+  text.append("\r\n");
+
+  if (!is_email) {
+    // Add ^D0FidoAddr for the "To:" name of the post.
+    static const char kFidoAddr[] = "\x04"
+                                    "0FidoAddr: ";
+    auto to_name = msg.vh.to_user_name;
+    if (to_name.empty()) {
+      // If for some screwy reason we don't have a to name, address
+      // it to 'All'.
+      LOG(WARNING) << "Somehow have empty msg.vh.to_user_name";
+      to_name = "All";
+    }
+    text.append(kFidoAddr).append(msg.vh.to_user_name).append("\r\n");
+  }
+  text.append(wwiv_text);
+
+  nh.length = size_uint32(text);
+  return Packet(nh, {}, text);
+}
+
 bool NetworkF::import_packet_file(const std::string& dir, const std::string& name) {
   LOG(INFO) << "Importing Packet: " << FilePath(dir, name).string();
   File f(FilePath(dir, name));
@@ -177,26 +267,10 @@ bool NetworkF::import_packet_file(const std::string& dir, const std::string& nam
     return false;
   }
 
-  FidoAddress address(header.orig_zone, header.orig_net, header.orig_node, header.orig_point, "");
-  auto expected = fido_callout_.packet_config_for(address).packet_password;
-  // Do this dance to ensure that if there's no trailing null
-  // on header.password, we add one.
-  char temp[9];
-  memset(temp, 0, sizeof(temp));
-  strncpy(temp, header.password, 8);
-  temp[8] = '\0';
-  std::string actual = temp;
-  if (!iequals(expected, actual)) {
-    LOG(ERROR) << "Unexpected packet password from node: " << address << "; actual: '" << actual
-               << "'; expected: '" << expected << "'";
+  if (!check_packet_password(header)) {
     // Move to BADMSGS
     f.Close();
-    FtnDirectories dirs(net_cmdline_.config().root_directory(), net_);
-    const auto dest = FilePath(dirs.bad_packets_dir(), f.path().filename().string());
-
-    if (!File::Move(f.path(), dest)) {
-      LOG(ERROR) << "Error moving file to BADMSGS; file: " << f;
-    }
+    move_to_bad_packets(f.path());
     return false;
   }
 
@@ -220,62 +294,12 @@ bool NetworkF::import_packet_file(const std::string& dir, const std::string& nam
     }
     dupe().add(msg);
 
-    bool is_email = (msg.nh.attribute & MSGPRIVATE);
-    net_header_rec nh{};
-    nh.daten = static_cast<uint32_t>(fido_to_daten(msg.vh.date_time));
-    nh.fromsys = FTN_FAKE_OUTBOUND_NODE;
-    nh.fromuser = 0;
-    nh.list_len = 0;
-    if (is_email) {
-      nh.main_type = main_type_email_name;
-    } else {
-      nh.main_type = main_type_new_post;
-    }
-
-    nh.method = 0;
-    nh.minor_type = 0;
-    nh.tosys = 1; // always 1 in new fido
-    nh.touser = 0;
-
-    auto from_address = get_address_from_packet(msg, header);
-
-    std::string text;
+    const bool is_email = (msg.nh.attribute & MSGPRIVATE);
+    const auto from_address = get_address_from_packet(msg, header);
     std::string s1;
-    if (is_email) {
-      // TO_USER<nul>TITLE<nul>SENDER_NAME<cr/lf>DATE_STRING<cr/lf>MESSAGE_TEXT.
-      s1 = msg.vh.to_user_name;
-    } else {
-      // SUBTYPE<nul>TITLE<nul>SENDER_NAME<cr/lf>DATE_STRING<cr/lf>MESSAGE_TEXT.
-      s1 = get_echomail_areaname(msg.vh.text);
-    }
-    text.append(s1);
-
-    text.push_back(0);
-    text.append(msg.vh.subject);
-    text.push_back(0);
-    text.append(StrCat(msg.vh.from_user_name, "(", from_address, ")\r\n"));
-    auto dt = fido_to_daten(msg.vh.date_time);
-    text.append(daten_to_wwivnet_time(dt));
-    text.append("\r\n");
-
-    if (!is_email) {
-      // Add ^D0FidoAddr for the "To:" name of the post.
-      static const char kFidoAddr[] = "\x04"
-                                      "0FidoAddr: ";
-      auto to_name = msg.vh.to_user_name;
-      if (to_name.empty()) {
-        // If for some screwy reason we don't have a to name, address
-        // it to 'All'.
-        LOG(WARNING) << "Somehow have empty msg.vh.to_user_name";
-        to_name = "All";
-      }
-      text.append(kFidoAddr).append(msg.vh.to_user_name).append("\r\n");
-    }
-    text.append(FidoToWWIVText(msg.vh.text));
-
-    nh.length = size_uint32(text);
     // Create file, write to local.net_ for network2 to import.
-    Packet packet(nh, {}, text);
+    auto packet =
+        ftn_message_to_wwivnet_packet(msg, from_address, FidoToWWIVText(msg.vh.text), s1);
     if (!write_wwivnet_packet(LOCAL_NET, net_, packet)) {
       LOG(ERROR) << "ERROR Writing WWIV packet for message: " << packet.nh.main_type << "/"
                  << packet.nh.minor_type;
@@ -310,22 +334,30 @@ bool NetworkF::import_packets(const std::string& dir, const std::string& mask) {
   return true;
 }
 
-bool NetworkF::import_bundle_file(const std::string& dir, const std::string& name) {
-  VLOG(1) << "import_bundle_file: name: " << name;
-
+/**
+ * Extracts the bundle into dest_dir, in-process when the archive type is
+ * supported and otherwise using the archiver configured for it.
+ * The archivers extract into the current directory, so this changes into
+ * dest_dir for the duration of the command.
+ */
+bool NetworkF::extract_bundle(const std::filesystem::path& bundle,
+                              const std::filesystem::path& dest_dir) {
   {
     // Check to make sure the file is readable.
-    File f(FilePath(dir, name));
+    File f(bundle);
     if (!f.Open(File::modeBinary | File::modeReadOnly)) {
-      LOG(INFO) << "Unable to open file: " << dir << name;
+      LOG(INFO) << "Unable to open file: " << bundle.string();
       return false;
     }
   }
+  if (files::extract_archive(bundle, dest_dir)) {
+    VLOG(1) << "Extracted bundle: " << bundle.string();
+    return true;
+  }
 
   const auto saved_dir = File::current_directory();
   ScopeExit at_exit([=] { File::set_current_directory(saved_dir); });
-  const FtnDirectories dirs(net_cmdline_.config().root_directory(), net_);
-  File::set_current_directory(dirs.temp_inbound_dir());
+  File::set_current_directory(dest_dir);
 
   // were in the temp dir now.
   const auto arcs = read_arcs(net_cmdline_.config().datadir());
@@ -334,22 +366,29 @@ bool NetworkF::import_bundle_file(const std::string& dir, const std::string& nam
     return false;
   }
 
-  const auto path = FilePath(dir, name);
-  const auto& arc = files::find_arcrec(arcs, path, "ZIP");
+  const auto& arc = files::find_arcrec(arcs, bundle, "ZIP");
   if (!arc) {
-    LOG(ERROR) << "Unable to find archiver for file: " << path;
+    LOG(ERROR) << "Unable to find archiver for file: " << bundle.string();
     return false;
   }
   // We have no parameter 2 since we're extracting everything.
-  const auto unzip_cmd = arc_stuff_in(arc.value().arce, path.string(), "");
+  const auto unzip_cmd = arc_stuff_in(arc.value().arce, bundle.string(), "");
   // Execute the command
   LOG(INFO) << "Command: " << unzip_cmd;
   if (system(unzip_cmd.c_str()) != 0) {
     LOG(ERROR) << "Failed executing: " << unzip_cmd;
     return false;
   }
-  // Need to be back home.
-  File::set_current_directory(saved_dir);
+  return true;
+}
+
+bool NetworkF::import_bundle_file(const std::string& dir, const std::string& name) {
+  VLOG(1) << "import_bundle_file: name: " << name;
+
+  const FtnDirectories dirs(net_cmdline_.config().root_directory(), net_);
+  if (!extract_bundle(FilePath(dir, name), dirs.temp_inbound_dir())) {
+    return false;
+  }
 
   import_packets(dirs.temp_inbound_dir(), "*.pkt");
   return true;
@@ -395,6 +434,242 @@ int NetworkF::import_bundles(const std::string& dir, const std::string& mask) {
   return num_bundles_processed;
 }
 
+/** An FTN message decoded from a packet by a batch import worker. */
+struct batch_message_t {
+  FidoPackedMessage msg;
+  FidoAddress from_address;
+  uint32_t header_crc32{0};
+  uint32_t msgid_crc32{0};
+  std::string wwiv_text;
+};
+
+/** A FTN packet file decoded by a batch import worker. */
+struct batch_packet_t {
+  std::filesystem::path path;
+  // Index of the inbound bundle or packet file that this packet came from.
+  int source{0};
+  // Set once the packet header has been read.
+  bool has_header{false};
+  // Set once all of the messages have been read.
+  bool decoded{false};
+  packet_header_2p_t header{};
+  std::vector<batch_message_t> messages;
+};
+
+/**
+ * Reads all of the messages in the packet, along with the work that doesn't
+ * depend on other packets (the dupe crcs, origin address and text conversion).
+ * This runs on the batch worker threads so it must not touch NetworkF state.
+ */
+static void decode_batch_packet(batch_packet_t& p) {
+  File f(p.path);
+  if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+    return;
+  }
+  const auto num_header_read = f.Read(&p.header, sizeof(packet_header_2p_t));
+  if (num_header_read < static_cast<int>(sizeof(packet_header_2p_t))) {
+    return;
+  }
+  p.has_header = true;
+  for (;;) {
+    batch_message_t m;
+    const auto response = read_packed_message(f, m.msg);
+    if (response == ReadPacketResponse::END_OF_FILE) {
+      p.decoded = true;
+      return;
+    }
+    if (response == ReadPacketResponse::ERROR) {
+      // Keep the messages read before the error, the same as import_packet_file.
+      return;
+    }
+    FtnMessageDupe::GetMessageCrc32s(m.msg, m.header_crc32, m.msgid_crc32);
+    m.from_address = get_address_from_packet(m.msg, p.header);
+    m.wwiv_text = FidoToWWIVText(m.msg.vh.text);
+    p.messages.emplace_back(std::move(m));
+  }
+}
+
+static void decode_batch_packets(std::vector<batch_packet_t>& packets) {
+  const auto num_threads = std::max<size_t>(
+      1, std::min<size_t>(std::thread::hardware_concurrency(), packets.size()));
+  VLOG(1) << "Decoding " << packets.size() << " packets using " << num_threads << " threads.";
+  std::atomic<size_t> next{0};
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&packets, &next] {
+      for (auto n = next++; n < packets.size(); n = next++) {
+        decode_batch_packet(packets[n]);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+int NetworkF::import_batch(const std::string& dir, const std::vector<std::string>& extensions) {
+  struct inbound_file_t {
+    std::filesystem::path path;
+    bool is_bundle{false};
+    bool ok{true};
+  };
+
+  std::vector<inbound_file_t> inbound;
+  std::set<std::string> seen;
+  for (const auto& ext : extensions) {
+    std::vector<std::string> masks{StrCat("*.", ext)};
+#ifndef _WIN32
+    masks.emplace_back(StrCat("*.", ToStringUpperCase(ext)));
+#endif
+    for (const auto& mask : masks) {
+      FindFiles files(FilePath(dir, mask), FindFiles::FindFilesType::files);
+      for (const auto& f : files) {
+        if (f.size == 0) {
+          // skip zero byte files.
+          LOG(INFO) << "Skipping zero byte bundle or packet: " << f.name;
+          continue;
+        }
+        if (!seen.insert(f.name).second) {
+          continue;
+        }
+        const auto is_bundle = !ends_with(ToStringLowerCase(f.name), ".pkt");
+        inbound.push_back({FilePath(dir, f.name), is_bundle, true});
+      }
+    }
+  }
+  if (inbound.empty()) {
+    LOG(INFO) << "No bundles or packets to import in: '" << dir << "'";
+    return 0;
+  }
+
+  // Extract each bundle into its own directory so that packets with the same
+  // name in different bundles don't collide.
+  const FtnDirectories dirs(net_cmdline_.config().root_directory(), net_);
+  std::vector<batch_packet_t> packets;
+  for (auto i = 0; i < ssize(inbound); i++) {
+    auto& in = inbound[i];
+    if (!in.is_bundle) {
+      batch_packet_t p{};
+      p.path = in.path;
+      p.source = i;
+      packets.emplace_back(std::move(p));
+      continue;
+    }
+    const auto bundle_dir = FilePath(dirs.temp_inbound_dir(), in.path.filename().string());
+    if (!File::Exists(bundle_dir) && !File::mkdirs(bundle_dir)) {
+      LOG(ERROR) << "Unable to create directory: " << bundle_dir.string();
+      in.ok = false;
+      continue;
+    }
+    LOG(INFO) << "Extracting bundle: " << in.path.string();
+    if (!extract_bundle(in.path, bundle_dir)) {
+      in.ok = false;
+      continue;
+    }
+    FindFiles files(FilePath(bundle_dir, "*"), FindFiles::FindFilesType::files);
+    for (const auto& f : files) {
+      if (!ends_with(ToStringLowerCase(f.name), ".pkt")) {
+        continue;
+      }
+      batch_packet_t p{};
+      p.path = FilePath(bundle_dir, f.name);
+      p.source = i;
+      packets.emplace_back(std::move(p));
+    }
+  }
+
+  decode_batch_packets(packets);
+
+  // Check passwords and dupes in one pass, in the order the packets were found.
+  std::vector<Packet> wwivnet_packets;
+  std::vector<bool> imported(packets.size(), false);
+  // Packets moved to the bad packets directory, which are never retried.
+  std::vector<bool> rejected(packets.size(), false);
+  for (auto i = 0; i < ssize(packets); i++) {
+    auto& p = packets[i];
+    LOG(INFO) << "Importing Packet: " << p.path.string();
+    if (!p.has_header) {
+      LOG(ERROR) << "Unable to read packet header from: " << p.path.string();
+      continue;
+    }
+    if (!check_packet_password(p.header)) {
+      move_to_bad_packets(p.path);
+      rejected[i] = true;
+      continue;
+    }
+    if (!p.decoded) {
+      LOG(ERROR) << "Error reading packet: " << p.path.string();
+    }
+    for (const auto& m : p.messages) {
+      if (dupe().is_dupe(m.header_crc32, m.msgid_crc32)) {
+        const auto msgid = FtnMessageDupe::GetMessageIDFromText(m.msg.vh.text);
+        LOG(ERROR) << "Skipping duplicate FTN message: '" << m.msg.vh.subject << "' msgid: ("
+                   << msgid << ")";
+        continue;
+      }
+      dupe().add_deferred(m.header_crc32, m.msgid_crc32);
+      std::string s1;
+      wwivnet_packets.emplace_back(
+          ftn_message_to_wwivnet_packet(m.msg, m.from_address, m.wwiv_text, s1));
+      const bool is_email = (m.msg.nh.attribute & MSGPRIVATE);
+      LOG(INFO) << fmt::format("Imported FTN {} '{}' to '{}'", is_email ? "Email" : "Post",
+                               m.msg.vh.subject, s1);
+    }
+    imported[i] = p.decoded;
+  }
+
+  // Create file, write to local.net_ for network2 to import.
+  if (!write_wwivnet_packets(LOCAL_NET, net_, wwivnet_packets)) {
+    // Leave everything in the inbound directory, nothing was imported and
+    // the dupes were not saved, so the next run will retry all of it.
+    LOG(ERROR) << "ERROR Writing " << wwivnet_packets.size() << " WWIV packets to: " << LOCAL_NET;
+    return 0;
+  }
+  if (!dupe().Save()) {
+    LOG(ERROR) << "Error saving the FTN message dupe list.";
+  }
+
+  for (auto i = 0; i < ssize(packets); i++) {
+    const auto& p = packets[i];
+    auto& in = inbound[p.source];
+    if (!imported[i]) {
+      if (!in.is_bundle) {
+        in.ok = false;
+      } else if (!rejected[i]) {
+        // Keep the bundle so the next run extracts and retries this packet.
+        // Messages already imported from it are skipped as dupes then.
+        in.ok = false;
+        File::Remove(p.path);
+      }
+      continue;
+    }
+    LOG(INFO) << "Successfully imported packet: " << p.path.string();
+    if (in.is_bundle) {
+      // Packets from bundles live in the temp dir, just like import_bundle_file.
+      File::Remove(p.path);
+    }
+  }
+
+  auto num_processed = 0;
+  for (const auto& in : inbound) {
+    if (in.is_bundle) {
+      // Only removes the directory if nothing besides packets was extracted.
+      File::Remove(FilePath(dirs.temp_inbound_dir(), in.path.filename().string()));
+    }
+    if (!in.ok) {
+      continue;
+    }
+    LOG(INFO) << "Successfully imported " << (in.is_bundle ? "bundle: " : "packet: ")
+              << in.path.string();
+    ++num_processed;
+    if (net_cmdline_.skip_delete()) {
+      backup_file(in.path);
+    }
+    File::Remove(in.path);
+  }
+  return num_processed;
+}
+
 static std::string rename_fido_packet(const std::string& dir, const std::string& origname) {
   if (!ends_with(origname, ".pkt") || origname.size() != 12) {
     LOG(ERROR) << "rename_fido_packet: not allowed on name: '" << origname << "'";
@@ -600,183 +875,191 @@ static std::string remove_fido_addr(string to_user) {
   return to_user_new;
 }
 
-bool NetworkF::create_ftn_packet(const FidoAddress& dest, const FidoAddress& route_to,
-                                 const Packet& wwivnet_packet, std::string& fido_packet_name) {
-
-  VLOG(1) << "create_ftn_packet: dest: " << dest << "; route: " << route_to;
-
-  FtnDirectories dirs(net_cmdline_.config().root_directory(), net_);
-
-  FidoAddress from_address(net_.fido.fido_address);
-  for (auto tries = 0; tries < 10; tries++) {
-    auto now = DateTime::now();
-    File file(FilePath(dirs.temp_outbound_dir(), packet_name(now)));
-    if (!file.Open(File::modeCreateFile | File::modeExclusive | File::modeReadWrite |
-                       File::modeBinary,
-                   File::shareDenyReadWrite)) {
-      LOG(INFO) << "Will try again: Unable to create packet file: " << file;
-      sleep_for(std::chrono::seconds(1));
+std::unique_ptr<File> NetworkF::open_ftn_packet(const FidoAddress& route_to) {
+  const FtnDirectories dirs(net_cmdline_.config().root_directory(), net_);
+  const FidoAddress from_address(net_.fido.fido_address);
+  const auto start = DateTime::now().to_time_t();
+  // Packet names are based on the time, and many packets may be opened within
+  // the same second, so step forward in time rather than waiting for a free name.
+  for (auto tries = 0; tries < 600; tries++) {
+    auto now = DateTime::from_time_t(start + tries);
+    auto file = std::make_unique<File>(FilePath(dirs.temp_outbound_dir(), packet_name(now)));
+    if (!file->Open(File::modeCreateFile | File::modeExclusive | File::modeReadWrite |
+                        File::modeBinary,
+                    File::shareDenyReadWrite)) {
+      VLOG(1) << "Will try again: Unable to create packet file: " << *file;
       continue;
     }
 
-    auto pw = fido_callout_.packet_config_for(route_to).packet_password;
+    const auto pw = fido_callout_.packet_config_for(route_to).packet_password;
     auto header = CreateType2PlusPacketHeader(from_address, route_to, now, pw);
-
-    if (!write_fido_packet_header(file, header)) {
+    if (!write_fido_packet_header(*file, header)) {
       LOG(ERROR) << "Error writing packet header.";
-      return false;
+      file->Close();
+      File::Remove(file->path());
+      return {};
     }
+    return file;
+  }
+  LOG(ERROR) << "Unable to create packet file for route: " << route_to;
+  return {};
+}
 
-    auto is_email = wwivnet_packet.nh.main_type == main_type_email ||
-                    wwivnet_packet.nh.main_type == main_type_email_name;
-    const auto raw_text = wwivnet_packet.text();
-    auto iter = raw_text.cbegin();
+FidoPackedMessage NetworkF::create_ftn_message(const FidoAddress& dest,
+                                               const Packet& wwivnet_packet) {
+  const FidoAddress from_address(net_.fido.fido_address);
+  auto is_email = wwivnet_packet.nh.main_type == main_type_email ||
+                  wwivnet_packet.nh.main_type == main_type_email_name;
+  const auto raw_text = wwivnet_packet.text();
+  auto iter = raw_text.cbegin();
+
+  std::string subtype;
+  std::string to_user_name;
+  // or we can put code in for email here??
+
+  if (is_email) {
+    to_user_name = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+    CleanupWWIVName(to_user_name);
+  } else {
+    subtype = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+  }
+  auto title = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+  auto sender_name = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+  auto date_string = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
+
+  // TODO(rushfan: These next 2 here should be done differently. We should
+  // split the message here and look for these in all lines.  For the By:
+  // line we just want to remove it since it's useless.
+  if (!is_email) {
+    to_user_name = get_fido_addr(raw_text, iter, {'\0', '\r', '\n'}, 80);
+  }
 
-    std::string subtype;
-    std::string to_user_name;
-    // or we can put code in for email here??
+  if (!is_email && iter_starts_with(raw_text, iter, "BY: ")) {
+    // Skip BY line.
+    get_message_field(raw_text, iter, {'\r', '\n'}, 80);
+  }
 
-    if (is_email) {
-      to_user_name = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
-      CleanupWWIVName(to_user_name);
-    } else {
-      subtype = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
-    }
-    auto title = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
-    auto sender_name = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
-    auto date_string = get_message_field(raw_text, iter, {'\0', '\r', '\n'}, 80);
-
-    // TODO(rushfan: These next 2 here should be done differently. We should
-    // split the message here and look for these in all lines.  For the By:
-    // line we just want to remove it since it's useless.
-    if (!is_email) {
-      to_user_name = get_fido_addr(raw_text, iter, {'\0', '\r', '\n'}, 80);
-    }
+  fido_variable_length_header_t vh{};
+  vh.date_time = daten_to_fido(wwivnet_packet.nh.daten);
+  // Clean up sender name.
+  CleanupWWIVName(sender_name);
+  vh.from_user_name = sender_name;
+  vh.subject = title;
+  if (!to_user_name.empty()) {
+    auto username_only = remove_fido_addr(to_user_name);
+    vh.to_user_name = properize(username_only);
+  } else {
+    vh.to_user_name = "All";
+  }
 
-    if (!is_email && iter_starts_with(raw_text, iter, "BY: ")) {
-      // Skip BY line.
-      get_message_field(raw_text, iter, {'\r', '\n'}, 80);
-    }
+  auto msgid = FtnMessageDupe::GetMessageIDFromWWIVText(raw_text);
+  auto needs_msgid = false;
+  if (msgid.empty()) {
+    // Create a new MSGID if the BBS didn't put one in there already.
+    // We'll do this for emails too since Mystic needs this for a proper
+    // reply to address. Otherwise we'd just do it for conference mail.
+    msgid = dupe().CreateMessageID(from_address);
+    needs_msgid = true;
+  }
 
-    fido_variable_length_header_t vh{};
-    vh.date_time = daten_to_fido(wwivnet_packet.nh.daten);
-    // Clean up sender name.
-    CleanupWWIVName(sender_name);
-    vh.from_user_name = sender_name;
-    vh.subject = title;
-    if (!to_user_name.empty()) {
-      auto username_only = remove_fido_addr(to_user_name);
-      vh.to_user_name = properize(username_only);
-    } else {
-      vh.to_user_name = "All";
+  // TODO(rushfan): need to add in INTL for netmails, and all that nonsense.
+  // We probably have other stuff we need to add for echomail too.
+  std::ostringstream text;
+  if (is_email) {
+    text << "\001"
+         << "INTL " << dest.as_string(false, false) << " "
+         << from_address.as_string(false, false) << "\r";
+    if (from_address.point()) {
+      // FMPT (FROM POINT) just has the point address
+      text << "\001" << "FMPT " << from_address.point() << "\r";
     }
-
-    FtnMessageDupe dupe(net_cmdline_.config());
-    auto msgid = FtnMessageDupe::GetMessageIDFromWWIVText(raw_text);
-    auto needs_msgid = false;
-    if (msgid.empty()) {
-      // Create a new MSGID if the BBS didn't put one in there already.
-      // We'll do this for emails too since Mystic needs this for a proper
-      // reply to address. Otherwise we'd just do it for conference mail.
-      msgid = dupe.CreateMessageID(from_address);
-      needs_msgid = true;
+    if (dest.point()) {
+      // TOPT (TO POINT) just has the point address
+      text << "\001" << "TOPT " << dest.point() << "\r";
     }
+  } else {
+    text << "AREA:" << subtype << "\r";
+  }
+  // As of 5.3, the PID is added by the BBS software.
+  // text << "\001PID: WWIV " << full_version() << "\r";
+  text << "\001TID: WWIV NET" << full_version() << "\r";
+  if (needs_msgid && !is_email) {
+    text << "\001MSGID: " << msgid << "\r";
+  }
+  // Implement FTS-5003. [http://ftsc.org/docs/fts-5003.001]
+  // All outbound WWIV messages are always CP437.
+  text << "\001CHRS: CP437 2\r";
+
+  // Implement FRL-1004. [http://ftsc.org/docs/frl-1004.002]
+  text << "\001TZUTC: " << tz_offset_from_utc(clock_.Now()) << "\r";
+
+  // TODO(rushfan): We should rip through the bbs_text here.
+  // and add in any special kludges like ^AREPLY here.
+  // Add the text from the message (as entered from the BBS).
+  wwiv_to_fido_options opts{};
+  opts.colors = colors_;
+  opts.wwiv_heart_color_codes = net_.fido.wwiv_heart_color_codes;
+  opts.wwiv_pipe_color_codes = net_.fido.wwiv_pipe_color_codes;
+  auto bbs_text = WWIVToFidoText(string(iter, raw_text.end()), opts);
+  text << bbs_text;
+
+  // Now we need tear + origin lines
+  auto origin_line = net_.fido.origin_line;
+  if (origin_line.empty()) {
+    // default origin line to system name if it doesn't exist.
+    origin_line = net_cmdline_.config().system_name();
+  }
 
-    // TODO(rushfan): need to add in INTL for netmails, and all that nonsense.
-    // We probably have other stuff we need to add for echomail too.
-    std::ostringstream text;
-    if (is_email) {
-      text << "\001"
-           << "INTL " << dest.as_string(false, false) << " "
-           << from_address.as_string(false, false) << "\r";
-      if (from_address.point()) {
-        // FMPT (FROM POINT) just has the point address
-        text << "\001" << "FMPT " << from_address.point() << "\r";
-      }
-      if (dest.point()) {
-        // TOPT (TO POINT) just has the point address
-        text << "\001" << "TOPT " << dest.point() << "\r";
-      }
-    } else {
-      text << "AREA:" << subtype << "\r";
-    }
-    // As of 5.3, the PID is added by the BBS software.
-    // text << "\001PID: WWIV " << full_version() << "\r";
-    text << "\001TID: WWIV NET" << full_version() << "\r";
-    if (needs_msgid && !is_email) {
-      text << "\001MSGID: " << msgid << "\r";
-    }
-    // Implement FTS-5003. [http://ftsc.org/docs/fts-5003.001]
-    // All outbound WWIV messages are always CP437.
-    text << "\001CHRS: CP437 2\r";
-
-    // Implement FRL-1004. [http://ftsc.org/docs/frl-1004.002]
-    text << "\001TZUTC: " << tz_offset_from_utc(clock_.Now()) << "\r";
-
-    // TODO(rushfan): We should rip through the bbs_text here.
-    // and add in any special kludges like ^AREPLY here.
-    // Add the text from the message (as entered from the BBS).
-    wwiv_to_fido_options opts{};
-    opts.colors = colors_;
-    opts.wwiv_heart_color_codes = net_.fido.wwiv_heart_color_codes;
-    opts.wwiv_pipe_color_codes = net_.fido.wwiv_pipe_color_codes;
-    auto bbs_text = WWIVToFidoText(string(iter, raw_text.end()), opts);
-    text << bbs_text;
-
-    // Now we need tear + origin lines
-    auto origin_line = net_.fido.origin_line;
-    if (origin_line.empty()) {
-      // default origin line to system name if it doesn't exist.
-      origin_line = net_cmdline_.config().system_name();
-    }
+  if (from_address.point() == 0) {
+    text << "\r"
+         << "--- WWIV " << full_version() << "\r"
+         << " * Origin: " << origin_line << " (" << to_zone_net_node(from_address) << ")\r";
+  } else {
+    text << "\r"
+         << "--- WWIV " << full_version() << "\r"
+         << " * Origin: " << origin_line << " (" << to_zone_net_node_point(from_address) << ")\r";
+  }
+  // Finally we need SEEN-BY and PATH lines for routing.
+  if (!is_email) {
+    // TODO(rushfan): Add the nodes we are exporting this to.
+    text << "SEEN-BY: " << to_net_node(from_address) << "\r\r";
+    // Also we need to add a ^APATH: line here, starting with us.
+  }
 
-    if (from_address.point() == 0) {
-      text << "\r"
-           << "--- WWIV " << full_version() << "\r"
-           << " * Origin: " << origin_line << " (" << to_zone_net_node(from_address) << ")\r";
-    } else {
-      text << "\r"
-           << "--- WWIV " << full_version() << "\r"
-           << " * Origin: " << origin_line << " (" << to_zone_net_node_point(from_address) << ")\r";
-    }
-    // Finally we need SEEN-BY and PATH lines for routing.
-    if (!is_email) {
-      // TODO(rushfan): Add the nodes we are exporting this to.
-      text << "SEEN-BY: " << to_net_node(from_address) << "\r\r";
-      // Also we need to add a ^APATH: line here, starting with us.
-    }
+  vh.text = text.str();
 
-    vh.text = text.str();
+  fido_packed_message_t nh{};
+  nh.message_type = 2;
+  nh.attribute = 0;
+  nh.cost = 0;
+  nh.orig_net = from_address.net();
+  nh.orig_node = from_address.node();
+  nh.dest_net = dest.net();
+  nh.dest_node = dest.node();
+  nh.attribute = MSGLOCAL;
 
-    fido_packed_message_t nh{};
-    nh.message_type = 2;
-    nh.attribute = 0;
-    nh.cost = 0;
-    nh.orig_net = from_address.net();
-    nh.orig_node = from_address.node();
-    nh.dest_net = dest.net();
-    nh.dest_node = dest.node();
-    nh.attribute = MSGLOCAL;
+  if (wwivnet_packet.nh.main_type == main_type_email_name) {
+    nh.attribute |= MSGPRIVATE;
+  }
 
-    if (wwivnet_packet.nh.main_type == main_type_email_name) {
-      nh.attribute |= MSGPRIVATE;
-    }
+  return FidoPackedMessage(nh, vh);
+}
 
-    FidoPackedMessage p(nh, vh);
-    if (!write_packed_message(file, p)) {
-      LOG(ERROR) << "Error writing packed message.";
-      return false;
-    }
+bool NetworkF::create_ftn_packet(const FidoAddress& dest, const FidoAddress& route_to,
+                                 const Packet& wwivnet_packet, std::string& fido_packet_name) {
+  VLOG(1) << "create_ftn_packet: dest: " << dest << "; route: " << route_to;
 
-    // Since we wrote the packed message, let's add it to the
-    // duplicate message database if it's a post.
-    if (!is_email) {
-      dupe.add(p);
-    }
-    fido_packet_name = file.path().filename().string();
-    return true;
+  auto msg = create_ftn_message(dest, wwivnet_packet);
+  auto file = open_ftn_packet(route_to);
+  if (!file) {
+    return false;
   }
-  return false;
+  if (!write_packed_message(*file, msg)) {
+    LOG(ERROR) << "Error writing packed message.";
+    return false;
+  }
+  fido_packet_name = file->path().filename().string();
+  return true;
 }
 
 bool NetworkF::create_ftn_packet_and_bundle(const FidoAddress& dest, const FidoAddress& route_to,
@@ -960,28 +1243,132 @@ static FidoAddress find_route_to(const FidoAddress& dest, const FidoCallout& cal
   return a;
 }
 
-bool NetworkF::export_main_type_new_post(std::set<std::string>& bundles, Packet& p) {
-  // Lame implementation that creates 1 file per message.
+bool NetworkF::append_to_outbound_packet(const FidoAddress& route_to, FidoPackedMessage& msg,
+                                         const std::shared_ptr<const Packet>& source) {
+  auto max_size = fido_callout_.packet_config_for(route_to).max_packet_size;
+  if (max_size <= 0) {
+    max_size = 1024 * 1024;
+  }
+  auto it = open_packets_.find(route_to);
+  if (it != open_packets_.end() && it->second.size >= max_size) {
+    close_outbound_packet(route_to);
+    it = open_packets_.end();
+  }
+  if (it == open_packets_.end()) {
+    auto file = open_ftn_packet(route_to);
+    if (!file) {
+      LOG(ERROR) << "    ! ERROR Failed to create FTN packet; writing to dead.net";
+      write_wwivnet_packet(DEAD_NET, net_, *source);
+      return false;
+    }
+    LOG(INFO) << "Created packet: " << file->path() << " for route_to: " << route_to;
+    outbound_packet_t packet{route_to, std::move(file), sizeof(packet_header_2p_t), {}};
+    it = open_packets_.emplace(route_to, std::move(packet)).first;
+  }
+
+  auto& packet = it->second;
+  // Posts to more than one subscriber behind the same route_to are written
+  // to the packet one after another, so only the last source can match.
+  if (packet.sources.empty() || packet.sources.back() != source) {
+    packet.sources.push_back(source);
+  }
+  if (!append_packed_message(*packet.file, msg)) {
+    LOG(ERROR) << "Error writing packed message to: " << packet.file->path();
+    discard_outbound_packet(route_to);
+    return false;
+  }
+  packet.size = static_cast<int>(packet.file->current_position());
+  return true;
+}
+
+void NetworkF::close_outbound_packet(const FidoAddress& route_to) {
+  const auto it = open_packets_.find(route_to);
+  if (it == open_packets_.end()) {
+    return;
+  }
+  if (!write_fido_packet_end(*it->second.file)) {
+    LOG(ERROR) << "Error writing end of packet to: " << it->second.file->path();
+    discard_outbound_packet(route_to);
+    return;
+  }
+  auto packet = std::move(it->second);
+  open_packets_.erase(it);
+  packet.file->Close();
+  closed_packets_.emplace_back(std::move(packet));
+}
+
+void NetworkF::discard_outbound_packet(const FidoAddress& route_to) {
+  const auto it = open_packets_.find(route_to);
+  if (it == open_packets_.end()) {
+    return;
+  }
+  auto packet = std::move(it->second);
+  open_packets_.erase(it);
+  LOG(ERROR) << "    ! ERROR Discarding FTN packet: " << packet.file->path() << "; writing "
+             << packet.sources.size() << " packets to dead.net";
+  packet.file->Close();
+  File::Remove(packet.file->path());
+  for (const auto& p : packet.sources) {
+    write_wwivnet_packet(DEAD_NET, net_, *p);
+  }
+}
+
+bool NetworkF::bundle_outbound_packets(std::set<std::string>& bundles) {
+  while (!open_packets_.empty()) {
+    close_outbound_packet(open_packets_.begin()->first);
+  }
+
+  auto result = true;
+  for (const auto& packet : closed_packets_) {
+    const auto fido_packet_name = packet.file->path().filename().string();
+    std::string bundlename;
+    if (!create_ftn_bundle(packet.route_to, fido_packet_name, bundlename)) {
+      LOG(ERROR) << "    ! ERROR Failed to create FTN bundle for: " << fido_packet_name
+                 << "; writing " << packet.sources.size() << " packets to dead.net";
+      for (const auto& p : packet.sources) {
+        write_wwivnet_packet(DEAD_NET, net_, *p);
+      }
+      result = false;
+      continue;
+    }
+    if (!contains(bundles, bundlename)) {
+      // We only want to attach the bundle (or add it to the flo file)
+      // one time, so skip ones that have already been done.
+      bundles.insert(bundlename);
+      const auto route_packet_config = fido_callout_.packet_config_for(packet.route_to);
+      CreateNetmailAttachOrFloFile(packet.route_to, bundlename, route_packet_config);
+    }
+  }
+  closed_packets_.clear();
+  return result;
+}
+
+bool NetworkF::export_main_type_new_post(Packet p) {
+  // Messages are appended to one open packet per route_to address, which are
+  // bundled once all of the messages have been exported.
   auto subtype = get_subtype_from_packet_text(p.text());
-  LOG(INFO) << "Creating packet for subtype: " << subtype;
+  LOG(INFO) << "Exporting post for subtype: " << subtype;
 
   auto subscribers = ReadFidoSubcriberFile(FilePath(net_.dir, StrCat("n", subtype, ".net")));
   if (subscribers.empty()) {
     LOG(INFO) << "There are no subscribers on echo: '" << subtype << "'. Nothing to do!";
+    return true;
   }
+  const auto source = std::make_shared<const Packet>(std::move(p));
   for (const auto& sub : subscribers) {
-    std::string bundlename;
     auto packet_config = fido_callout_.packet_config_for(sub);
     auto route_to = find_route_to(sub, fido_callout_, packet_config);
-    if (!create_ftn_packet_and_bundle(sub, route_to, p, bundlename)) {
+    VLOG(1) << "Adding message for subscriber: " << sub << "; route_to: " << route_to;
+    auto msg = create_ftn_message(sub, *source);
+    if (!append_to_outbound_packet(route_to, msg, source)) {
+      // The post has been written to dead.net.
+      LOG(ERROR) << "    ! ERROR Failed to add message to FTN packet for: " << sub;
       continue;
     }
-    if (!contains(bundles, bundlename)) {
-      // We only want to attach the bundle (or add it to the flo file)
-      // one time, so skip ones that have already been done.
-      bundles.insert(bundlename);
-      auto route_packet_config = fido_callout_.packet_config_for(route_to);
-      CreateNetmailAttachOrFloFile(route_to, bundlename, route_packet_config);
+    uint32_t header_crc32 = 0;
+    uint32_t msgid_crc32 = 0;
+    if (FtnMessageDupe::GetMessageCrc32s(msg, header_crc32, msgid_crc32)) {
+      dupe().add_deferred(header_crc32, msgid_crc32);
     }
   }
   return true;
@@ -1047,9 +1434,11 @@ bool NetworkF::Run() {
 
   FtnDirectories dirs(net_cmdline_.config().root_directory(), net_);
   if (cmd == "import") {
-    std::unique_ptr<FtnMessageDupe> dupe;
     const std::vector<std::string> extensions{"su?", "mo?", "tu?", "we?",
                                               "th?", "fr?", "sa?", "pkt"};
+    if (net_cmdline_.cmdline().barg("batch")) {
+      return import_batch(dirs.inbound_dir(), extensions) > 0;
+    }
     for (const auto& ext : extensions) {
       num_packets_processed += import_bundles(dirs.inbound_dir(), StrCat("*.", ext));
 #ifndef _WIN32
@@ -1076,6 +1465,10 @@ bool NetworkF::Run() {
     while (!done) {
       auto [p, response] = read_packet(f, true);
       if (response == ReadPacketResponse::END_OF_FILE) {
+        if (!bundle_outbound_packets(bundles)) {
+          LOG(ERROR) << "Error bundling exported posts.";
+        }
+        dupe().Save();
         // Delete the packet.
         f.Close();
         if (net_cmdline_.skip_delete()) {
@@ -1085,13 +1478,16 @@ bool NetworkF::Run() {
         break;
       }
       if (response == ReadPacketResponse::ERROR) {
+        // Still send everything exported before the bad packet.
+        bundle_outbound_packets(bundles);
+        dupe().Save();
         return false;
       }
       // If we got here, we had a packet to process.
       ++num_packets_processed;
 
       if (p.nh.main_type == main_type_new_post) {
-        if (!export_main_type_new_post(bundles, p)) {
+        if (!export_main_type_new_post(std::move(p))) {
           LOG(ERROR) << "Error exporting post.";
         }
       } else if (p.nh.main_type == main_type_email_name) {
@@ -1117,60 +1513,3 @@ bool NetworkF::Run() {
 }
 
 } // namespace wwiv::net::networkf
-
-using namespace wwiv::net::networkf;
-
-int main(int argc, char** argv) {
-
-#ifndef _WIN32
-  // Set this to the default handling, since when wwivd invokes
-  // this (and wwivd ignores SIGCHLD).
-  signal(SIGCHLD, SIG_DFL);
-#endif // !_WIN32
-
-  LoggerConfig config(LogDirFromConfig);
-  Logger::Init(argc, argv, config);
-
-  CommandLine cmdline(argc, argv, "net");
-  const NetworkCommandLine net_cmdline_(cmdline, 'f');
-  try {
-    ScopeExit at_exit(Logger::ExitLogger);
-    if (!net_cmdline_.IsInitialized() || net_cmdline_.cmdline().help_requested()) {
-      ShowHelp(net_cmdline_);
-      return 1;
-    }
-    const auto& net = net_cmdline_.network();
-    if (net.type != network_type_t::ftn) {
-      LOG(ERROR) << "NETWORKF is only for use on FTN type networks.";
-      ShowHelp(net_cmdline_);
-      return 1;
-    }
-
-    VLOG(3) << "Reading bbsdata.net_..";
-    auto b = BbsListNet::ReadBbsDataNet(net.dir);
-    if (b.empty()) {
-      LOG(ERROR) << "ERROR: Unable to read bbsdata.net_.";
-      LOG(ERROR) << "       Do you need to run network3?";
-      return 3;
-    }
-
-    const auto fake_ftn_node = b.node_config_for(FTN_FAKE_OUTBOUND_NODE);
-    if (!fake_ftn_node) {
-      LOG(ERROR) << "Can not find node for outbound FTN address.";
-      LOG(ERROR) << "       Do you need to run network3?";
-      return 2;
-    }
-
-    auto semaphore =
-        SemaphoreFile::try_acquire(net_cmdline_.semaphore_path(), net_cmdline_.semaphore_timeout());
-    SystemClock clock{};
-    NetworkF nf(net_cmdline_, b, clock);
-    return nf.Run() ? 0 : 2;
-  } catch (const semaphore_not_acquired& e) {
-    LOG(ERROR) << "ERROR: [network" << net_cmdline_.net_cmd()
-               << "]: Unable to Acquire Network Semaphore: " << e.what();
-  } catch (const std::exception& e) {
-    LOG(ERROR) << "ERROR: [networkf]: " << e.what();
-  }
-  return 2;
-}
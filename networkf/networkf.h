@@ -19,16 +19,40 @@
 #define INCLUDED_NETWORKF_NETWORKF_H
 
 #include "core/clock.h"
+#include "core/file.h"
 #include "net_core/net_cmdline.h"
 #include "net_core/netdat.h"
 #include "sdk/bbslist.h"
 #include "sdk/fido/fido_callout.h"
+#include "sdk/fido/fido_packets.h"
 #include "sdk/net/ftn_msgdupe.h"
 #include "sdk/net/packets.h"
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 namespace wwiv::net::networkf {
 
+/**
+ * A Type-2+ packet in the temp outbound directory that echomail for one
+ * route-to address is being appended to.
+ */
+struct outbound_packet_t {
+  sdk::fido::FidoAddress route_to;
+  std::unique_ptr<core::File> file;
+  // Number of bytes written to file so far.
+  int size{0};
+  // WWIVnet packets with a message in this packet; written to dead.net if
+  // the packet can not be bundled.
+  std::vector<std::shared_ptr<const sdk::net::Packet>> sources;
+};
+
+/** Prints the networkf usage and exits. */
+void ShowHelp(const NetworkCommandLine& cmdline);
+
 class NetworkF final {
 public:
   NetworkF(const NetworkCommandLine& cmdline, const sdk::BbsListNet& bbslist,
@@ -38,6 +62,10 @@ public:
   bool Run();
 
 private:
+  bool check_packet_password(const sdk::fido::packet_header_2p_t& header) const;
+
+  void move_to_bad_packets(const std::filesystem::path& path) const;
+
   bool import_packet_file(const std::string& dir, const std::string& name);
 
   bool import_packets(const std::string& dir, const std::string& mask);
@@ -46,10 +74,27 @@ private:
 
   int import_bundles(const std::string& dir, const std::string& mask);
 
+  bool extract_bundle(const std::filesystem::path& bundle, const std::filesystem::path& dest_dir);
+
+  /**
+   * Imports all bundles and packets in dir matching any of the extensions in one
+   * batch.  Packets are decoded in parallel, duplicates are checked in one pass and
+   * all of the imported messages are written to local.net with a single write.
+   *
+   * Returns the # of bundles and packets processed.
+   */
+  int import_batch(const std::string& dir, const std::vector<std::string>& extensions);
+
   bool create_ftn_bundle(const sdk::fido::FidoAddress& route_to, 
                          const std::string& fido_packet_name, std::string& out_bundle_name);
 
-  // ReSharper disable once CppMemberFunctionMayBeConst
+  /** Creates a new Type-2+ packet in the temp outbound directory for route_to. */
+  std::unique_ptr<core::File> open_ftn_packet(const sdk::fido::FidoAddress& route_to);
+
+  /** Converts wwivnet_packet into an FTN message addressed to dest. */
+  sdk::fido::FidoPackedMessage create_ftn_message(const sdk::fido::FidoAddress& dest,
+                                                  const sdk::net::Packet& wwivnet_packet);
+
   bool create_ftn_packet(const sdk::fido::FidoAddress& dest, const sdk::fido::FidoAddress& route_to,
                          const sdk::net::Packet& wwivnet_packet,
                          std::string& fido_packet_name);
@@ -70,7 +115,29 @@ private:
                                     const std::string& bundlename,
                                     const fido_packet_config_t& packet_config);
 
-  bool export_main_type_new_post(std::set<std::string>& bundles, sdk::net::Packet& p);
+  /**
+   * Appends msg to the open packet for route_to, starting a new packet once
+   * the current one reaches the max packet size for route_to.  On failure the
+   * packet is discarded and source, along with the rest of its sources, is
+   * written to dead.net.
+   */
+  bool append_to_outbound_packet(const sdk::fido::FidoAddress& route_to,
+                                 sdk::fido::FidoPackedMessage& msg,
+                                 const std::shared_ptr<const sdk::net::Packet>& source);
+
+  /** Ends the open packet for route_to and queues it to be bundled. */
+  void close_outbound_packet(const sdk::fido::FidoAddress& route_to);
+
+  /** Deletes the open packet for route_to, writing its sources to dead.net. */
+  void discard_outbound_packet(const sdk::fido::FidoAddress& route_to);
+
+  /**
+   * Closes all of the open packets and bundles each of them, attaching each
+   * bundle (or adding it to the flo file) one time.
+   */
+  bool bundle_outbound_packets(std::set<std::string>& bundles);
+
+  bool export_main_type_new_post(sdk::net::Packet p);
 
   bool export_main_type_email_name(std::set<std::string>& bundles, sdk::net::Packet& p);
 
@@ -84,6 +151,10 @@ private:
   NetDat netdat_;
 
   std::unique_ptr<sdk::FtnMessageDupe> dupe_;
+  // Echomail packets being written, one per route-to address.
+  std::map<sdk::fido::FidoAddress, outbound_packet_t> open_packets_;
+  // Echomail packets that are complete and waiting to be bundled.
+  std::vector<outbound_packet_t> closed_packets_;
   std::vector<int> colors_{7, 11, 14, 5, 31, 2, 12, 9, 6, 3};
 };
 
@@ -0,0 +1,418 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/command_line.h"
+#include "core/crc32.h"
+#include "core/datafile.h"
+#include "core/datetime.h"
+#include "core/fake_clock.h"
+#include "core/file.h"
+#include "core/findfiles.h"
+#include "core/strings.h"
+#include "core/version.h"
+#include "core_test/file_helper.h"
+#include "net_core/net_cmdline.h"
+#include "networkf/networkf.h"
+#include "sdk/bbslist.h"
+#include "sdk/config.h"
+#include "sdk/fido/fido_callout.h"
+#include "sdk/fido/fido_packets.h"
+#include "sdk/filenames.h"
+#include "sdk/net/networks.h"
+#include "sdk/net/packets.h"
+#include "sdk/vardec.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using std::string;
+using std::vector;
+using namespace wwiv::core;
+using namespace wwiv::net;
+using namespace wwiv::net::networkf;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::fido;
+using namespace wwiv::sdk::net;
+using namespace wwiv::strings;
+
+namespace {
+
+void put16(string& s, uint16_t v) { s.append(reinterpret_cast<const char*>(&v), 2); }
+void put32(string& s, uint32_t v) { s.append(reinterpret_cast<const char*>(&v), 4); }
+
+/** Builds a .ZIP file in memory from {name, contents}, storing the files uncompressed. */
+string make_zip(const vector<std::pair<string, string>>& files) {
+  string zip;
+  string cd;
+  for (const auto& [name, contents] : files) {
+    const auto crc = crc32string(contents);
+    const auto size = static_cast<uint32_t>(contents.size());
+    const auto offset = static_cast<uint32_t>(zip.size());
+
+    put32(zip, 0x04034b50);
+    put16(zip, 10);
+    put16(zip, 0);
+    put16(zip, 0);
+    put16(zip, 0);
+    put16(zip, 0x5021);
+    put32(zip, crc);
+    put32(zip, size);
+    put32(zip, size);
+    put16(zip, static_cast<uint16_t>(name.size()));
+    put16(zip, 0);
+    zip.append(name);
+    zip.append(contents);
+
+    put32(cd, 0x02014b50);
+    put16(cd, 10);
+    put16(cd, 10);
+    put16(cd, 0);
+    put16(cd, 0);
+    put16(cd, 0);
+    put16(cd, 0x5021);
+    put32(cd, crc);
+    put32(cd, size);
+    put32(cd, size);
+    put16(cd, static_cast<uint16_t>(name.size()));
+    put16(cd, 0);
+    put16(cd, 0);
+    put16(cd, 0);
+    put16(cd, 0);
+    put32(cd, 0);
+    put32(cd, offset);
+    cd.append(name);
+  }
+  const auto cd_offset = static_cast<uint32_t>(zip.size());
+  zip.append(cd);
+  put32(zip, 0x06054b50);
+  put16(zip, 0);
+  put16(zip, 0);
+  put16(zip, static_cast<uint16_t>(files.size()));
+  put16(zip, static_cast<uint16_t>(files.size()));
+  put32(zip, static_cast<uint32_t>(cd.size()));
+  put32(zip, cd_offset);
+  put16(zip, 0);
+  return zip;
+}
+
+} // namespace
+
+class NetworkFTest : public testing::Test {
+public:
+  NetworkFTest() {
+    for (const auto* d : {"data", "gfiles", "logs", "msgs", "net"}) {
+      helper_.Mkdir(d);
+    }
+    configrec c{};
+    to_char_array(c.datadir, "data");
+    to_char_array(c.gfilesdir, "gfiles");
+    to_char_array(c.logdir, "logs");
+    to_char_array(c.msgsdir, "msgs");
+    c.userreclen = sizeof(userrec);
+    configrec_header_t h{};
+    h.config_size = sizeof(configrec);
+    h.written_by_wwiv_num_version = wwiv_config_version();
+    to_char_array(h.signature, "WWIV");
+    c.header.header = h;
+    {
+      DataFile<configrec> file(FilePath(helper_.TempDir(), CONFIG_DAT),
+                               File::modeBinary | File::modeReadWrite | File::modeCreateFile);
+      EXPECT_TRUE(file.Write(&c));
+    }
+
+    const Config config(helper_.TempDir());
+    Networks networks(config);
+    net_.name = "fidonet";
+    net_.type = network_type_t::ftn;
+    net_.sysnum = 1;
+    net_.dir = helper_.Dir("net");
+    net_.fido.fido_address = "1:100/1";
+    net_.fido.inbound_dir = "in";
+    net_.fido.temp_inbound_dir = "temp_in";
+    net_.fido.temp_outbound_dir = "temp_out";
+    net_.fido.outbound_dir = "out";
+    net_.fido.netmail_dir = "netmail";
+    net_.fido.bad_packets_dir = "badpackets";
+    net_.fido.tic_dir = "tic";
+    net_.fido.unknown_dir = "unknown";
+    networks.insert(0, net_);
+    EXPECT_TRUE(networks.Save());
+  }
+
+  /** Runs networkf on the network with args, i.e. {"--batch", "import"}. */
+  bool Run(const vector<string>& args) {
+    vector<string> argv{"networkf", StrCat("--bbsdir=", helper_.TempDir().string()), "--quiet"};
+    argv.insert(std::end(argv), std::begin(args), std::end(args));
+    CommandLine cmdline(argv, "net");
+    cmdline.add_argument(BooleanCommandLineArgument("batch", "Import in one batch."));
+    const NetworkCommandLine net_cmdline(cmdline, 'f');
+    if (!net_cmdline.IsInitialized()) {
+      ADD_FAILURE() << "Unable to initialize the network command line.";
+      return false;
+    }
+    const auto bbslist = BbsListNet::ReadBbsDataNet(net_.dir);
+    FakeClock clock(DateTime::now());
+    NetworkF nf(net_cmdline, bbslist, clock);
+    return nf.Run();
+  }
+
+  [[nodiscard]] std::filesystem::path net_path(const string& name) const {
+    return FilePath(net_.dir, name);
+  }
+
+  /** Returns a Type-2+ packet from 1:100/2 with an echomail message for each subject. */
+  string CreatePacket(const vector<string>& subjects) {
+    const auto path = helper_.CreateTempFilePath("packet.tmp");
+    File f(path);
+    EXPECT_TRUE(f.Open(File::modeBinary | File::modeReadWrite | File::modeCreateFile |
+                       File::modeTruncate));
+    packet_header_2p_t h{};
+    h.orig_zone = 1;
+    h.orig_net = 100;
+    h.orig_node = 2;
+    h.dest_zone = 1;
+    h.dest_net = 100;
+    h.dest_node = 1;
+    h.packet_ver = 2;
+    EXPECT_TRUE(write_fido_packet_header(f, h));
+    for (const auto& subject : subjects) {
+      fido_packed_message_t nh{};
+      nh.message_type = 2;
+      nh.orig_net = 100;
+      nh.orig_node = 2;
+      nh.dest_net = 100;
+      nh.dest_node = 1;
+      fido_variable_length_header_t vh{};
+      vh.date_time = "01 Jan 20  12:00:00";
+      vh.to_user_name = "All";
+      vh.from_user_name = "Sysop";
+      vh.subject = subject;
+      vh.text = StrCat("AREA:TEST\r\001MSGID: 1:100/2 ", subject, "\rHello\r");
+      FidoPackedMessage msg(nh, vh);
+      EXPECT_TRUE(append_packed_message(f, msg));
+    }
+    EXPECT_TRUE(write_fido_packet_end(f));
+    f.Seek(0, File::Whence::begin);
+    string contents(static_cast<size_t>(f.length()), '\0');
+    EXPECT_EQ(static_cast<int>(contents.size()), f.Read(&contents[0], contents.size()));
+    return contents;
+  }
+
+  /** Writes contents to name in the inbound directory. */
+  std::filesystem::path WriteInbound(const string& name, const string& contents) {
+    File::mkdirs(net_path("in"));
+    const auto path = FilePath(net_path("in"), name);
+    File f(path);
+    EXPECT_TRUE(f.Open(File::modeBinary | File::modeReadWrite | File::modeCreateFile |
+                       File::modeTruncate));
+    EXPECT_EQ(static_cast<int>(contents.size()), f.Write(contents));
+    return path;
+  }
+
+  /** Returns the titles of the posts in local.net, sorted. */
+  [[nodiscard]] vector<string> LocalNetTitles() const {
+    vector<string> titles;
+    File f(net_path(LOCAL_NET));
+    if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+      return titles;
+    }
+    for (;;) {
+      auto [p, response] = read_packet(f, false);
+      if (response != ReadPacketResponse::OK) {
+        break;
+      }
+      titles.push_back(ParsedPacketText::FromPacket(p).title());
+    }
+    std::sort(std::begin(titles), std::end(titles));
+    return titles;
+  }
+
+  /** Writes a post on the TEST echo to be exported, and subscribes subscribers to TEST. */
+  void WriteExportPosts(const vector<string>& titles, const vector<string>& subscribers) {
+    for (const auto& title : titles) {
+      ParsedPacketText ppt(main_type_new_post);
+      ppt.set_subtype("TEST");
+      ppt.set_title(title);
+      ppt.set_sender("Sysop #1");
+      ppt.set_date(DateTime::now().to_daten_t());
+      ppt.set_text("Hello\r\n");
+      net_header_rec nh{};
+      nh.main_type = main_type_new_post;
+      nh.fromsys = 1;
+      nh.fromuser = 1;
+      nh.tosys = FTN_FAKE_OUTBOUND_NODE;
+      nh.daten = DateTime::now().to_daten_t();
+      const Packet p(nh, {}, ppt);
+      EXPECT_TRUE(write_wwivnet_packet(StrCat("s", FTN_FAKE_OUTBOUND_NODE, ".net"), net_, p));
+    }
+    string subs;
+    for (const auto& s : subscribers) {
+      subs.append(s).append("\n");
+    }
+    File f(net_path("nTEST.net"));
+    EXPECT_TRUE(f.Open(File::modeBinary | File::modeReadWrite | File::modeCreateFile |
+                       File::modeTruncate));
+    EXPECT_EQ(static_cast<int>(subs.size()), f.Write(subs));
+  }
+
+  /** Routes 1:200/* through 1:100/2, which is sent packet_config. */
+  void WriteCallout(const fido_packet_config_t& packet_config) {
+    const Config config(helper_.TempDir());
+    FidoCallout callout(config, net_);
+    fido_node_config_t node_config{};
+    node_config.routes = "1:200/*";
+    node_config.packet_config = packet_config;
+    EXPECT_TRUE(callout.insert(FidoAddress("1:100/2"), node_config));
+    EXPECT_TRUE(callout.Save());
+  }
+
+  /** Writes an archiver.dat with only the ZIP archiver. */
+  void WriteArchivers() {
+    arcrec arc{};
+    to_char_array(arc.name, "Zip");
+    to_char_array(arc.extension, "ZIP");
+    to_char_array(arc.arca, "zip -j %1 %2");
+    to_char_array(arc.arce, "unzip -j -C %1 %2");
+    DataFile<arcrec> file(FilePath(helper_.Dir("data"), ARCHIVER_DAT),
+                          File::modeBinary | File::modeReadWrite | File::modeCreateFile);
+    EXPECT_TRUE(file.Write(&arc));
+  }
+
+  /** Returns the subjects of the messages in each packet in the outbound directory. */
+  [[nodiscard]] vector<vector<string>> OutboundPacketSubjects() const {
+    vector<vector<string>> packets;
+    for (const auto& e : FindFiles(FilePath(net_path("out"), "*.pkt"),
+                                   FindFiles::FindFilesType::files)) {
+      File f(FilePath(net_path("out"), e.name));
+      EXPECT_TRUE(f.Open(File::modeBinary | File::modeReadOnly));
+      packet_header_2p_t h{};
+      EXPECT_EQ(static_cast<int>(sizeof(h)), f.Read(&h, sizeof(h)));
+      vector<string> subjects;
+      for (;;) {
+        FidoPackedMessage msg;
+        const auto response = read_packed_message(f, msg);
+        if (response != ReadPacketResponse::OK) {
+          EXPECT_EQ(ReadPacketResponse::END_OF_FILE, response);
+          break;
+        }
+        subjects.push_back(StrCat(msg.vh.subject, "@", msg.nh.dest_net, "/", msg.nh.dest_node));
+      }
+      packets.push_back(subjects);
+    }
+    return packets;
+  }
+
+  /** Returns the number of packets in dead.net. */
+  [[nodiscard]] int DeadNetCount() const {
+    File f(net_path(DEAD_NET));
+    if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+      return 0;
+    }
+    auto count = 0;
+    while (std::get<1>(read_packet(f, false)) == ReadPacketResponse::OK) {
+      ++count;
+    }
+    return count;
+  }
+
+  FileHelper helper_;
+  net_networks_rec net_{};
+};
+
+TEST_F(NetworkFTest, ImportBatch) {
+  const auto pkt = WriteInbound("00000001.pkt", CreatePacket({"one", "two"}));
+  const auto bundle =
+      WriteInbound("00010002.su0", make_zip({{"00000002.pkt", CreatePacket({"three"})}}));
+
+  EXPECT_TRUE(Run({"--batch", "import"}));
+  EXPECT_EQ(vector<string>({"one", "three", "two"}), LocalNetTitles());
+  EXPECT_FALSE(File::Exists(pkt));
+  EXPECT_FALSE(File::Exists(bundle));
+  EXPECT_FALSE(File::Exists(FilePath(net_path("temp_in"), "00010002.su0")));
+}
+
+TEST_F(NetworkFTest, ImportBatch_KeepsBundleWithBadPacket) {
+  const auto pkt = WriteInbound("00000001.pkt", CreatePacket({"one"}));
+  const auto bundle = WriteInbound(
+      "00010002.su0", make_zip({{"00000002.pkt", CreatePacket({"two"})},
+                                {"00000003.pkt", "not a packet"}}));
+
+  EXPECT_TRUE(Run({"--batch", "import"}));
+  EXPECT_EQ(vector<string>({"one", "two"}), LocalNetTitles());
+  EXPECT_FALSE(File::Exists(pkt));
+  // The bundle is kept to be retried, and nothing extracted from it is left behind.
+  EXPECT_TRUE(File::Exists(bundle));
+  EXPECT_FALSE(File::Exists(FilePath(net_path("temp_in"), "00010002.su0")));
+
+  // Retrying skips the message already imported from the bundle.
+  EXPECT_FALSE(Run({"--batch", "import"}));
+  EXPECT_EQ(vector<string>({"one", "two"}), LocalNetTitles());
+  EXPECT_TRUE(File::Exists(bundle));
+}
+
+TEST_F(NetworkFTest, Export_OnePacketPerRoute) {
+  WriteArchivers();
+  fido_packet_config_t packet_config{};
+  packet_config.compression_type = "PKT";
+  WriteCallout(packet_config);
+  File::mkdirs(net_path("out"));
+  WriteExportPosts({"one", "two"}, {"1:200/1", "1:200/2"});
+
+  EXPECT_TRUE(Run({"export"}));
+  // Both posts to both subscribers behind 1:100/2 are in one packet.
+  const vector<vector<string>> expected{{"one@200/1", "one@200/2", "two@200/1", "two@200/2"}};
+  EXPECT_EQ(expected, OutboundPacketSubjects());
+  EXPECT_EQ(0, DeadNetCount());
+  EXPECT_FALSE(File::Exists(net_path(StrCat("s", FTN_FAKE_OUTBOUND_NODE, ".net"))));
+}
+
+TEST_F(NetworkFTest, Export_MaxPacketSize) {
+  WriteArchivers();
+  fido_packet_config_t packet_config{};
+  packet_config.compression_type = "PKT";
+  // Every message fills the packet, so each one starts a new packet.
+  packet_config.max_packet_size = 1;
+  WriteCallout(packet_config);
+  File::mkdirs(net_path("out"));
+  WriteExportPosts({"one", "two"}, {"1:200/1"});
+
+  EXPECT_TRUE(Run({"export"}));
+  auto packets = OutboundPacketSubjects();
+  std::sort(std::begin(packets), std::end(packets));
+  const vector<vector<string>> expected{{"one@200/1"}, {"two@200/1"}};
+  EXPECT_EQ(expected, packets);
+  EXPECT_EQ(0, DeadNetCount());
+}
+
+TEST_F(NetworkFTest, Export_BundleFailureWritesDeadNet) {
+  // Without an archiver.dat, the packet can not be bundled.
+  fido_packet_config_t packet_config{};
+  packet_config.compression_type = "PKT";
+  WriteCallout(packet_config);
+  File::mkdirs(net_path("out"));
+  WriteExportPosts({"one", "two"}, {"1:200/1", "1:200/2"});
+
+  EXPECT_TRUE(Run({"export"}));
+  EXPECT_TRUE(OutboundPacketSubjects().empty());
+  // Each post is written to dead.net once, not once per subscriber.
+  EXPECT_EQ(2, DeadNetCount());
+}
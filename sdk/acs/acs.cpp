@@ -26,6 +26,7 @@
 #include <memory>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 using std::string;
@@ -36,9 +37,23 @@ using namespace wwiv::strings;
 
 namespace wwiv::sdk::acs {
 
+CompiledAcs::CompiledAcs(std::string expression)
+    : expression_(std::move(expression)), empty_(StringTrim(expression_).empty()) {
+  if (empty_) {
+    return;
+  }
+  try {
+    ast_ = Eval::Parse(expression_);
+  } catch (const eval_error& e) {
+    error_text_ = e.what();
+  }
+}
+
 static std::unique_ptr<Eval> make_eval(const Config& config, const User* user, int eff_sl,
-                                       const std::string& expression) {
-  auto eval = std::make_unique<Eval>(expression);
+                                       const std::string& expression,
+                                       std::shared_ptr<core::parser::Ast> ast = nullptr) {
+  auto eval = ast ? std::make_unique<Eval>(expression, std::move(ast))
+                  : std::make_unique<Eval>(expression);
 
   const auto& eslrec = config.sl(eff_sl);
   eval->add("user", std::make_unique<UserValueProvider>(user, eff_sl, eslrec));
@@ -59,6 +74,25 @@ std::tuple<bool, std::vector<std::string>> check_acs(const Config& config, const
   return std::make_tuple(result, eval->debug_info());
 }
 
+std::tuple<bool, std::vector<std::string>> check_acs(const Config& config, const User* user, int eff_sl,
+                                                     const CompiledAcs& acs, acs_debug_t) {
+  if (acs.empty()) {
+    std::vector<std::string> debug_lines;
+    return std::make_tuple(true, debug_lines);
+  }
+  if (!acs.error_text().empty()) {
+    std::vector<std::string> debug_lines{acs.error_text()};
+    return std::make_tuple(false, debug_lines);
+  }
+  if (!acs.ast()) {
+    std::vector<std::string> debug_lines;
+    return std::make_tuple(false, debug_lines);
+  }
+  auto eval = make_eval(config, user, eff_sl, acs.expression(), acs.ast());
+  const auto result = eval->eval();
+  return std::make_tuple(result, eval->debug_info());
+}
+
 std::tuple<bool, std::string, std::vector<std::string>>
 validate_acs(const Config& config, const User* user, int eff_sl, const std::string& expression) {
   auto eval = make_eval(config, user, eff_sl, expression);
@@ -21,19 +21,52 @@
 #include "sdk/config.h"
 #include "sdk/user.h"
 
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
 
+namespace wwiv::core::parser {
+class Ast;
+}
+
 namespace wwiv::sdk::acs {
 
 enum class acs_debug_t { local, remote, none };
 
+/**
+ * An ACS expression that has been lexed and parsed once so that it may be
+ * checked many times, i.e. for every item in a menu.
+ */
+class CompiledAcs {
+public:
+  CompiledAcs() = default;
+  explicit CompiledAcs(std::string expression);
+
+  [[nodiscard]] const std::string& expression() const noexcept { return expression_; }
+  /** An empty expression is always allowed. */
+  [[nodiscard]] bool empty() const noexcept { return empty_; }
+  /** The error from parsing the expression, or empty if none occurred. */
+  [[nodiscard]] const std::string& error_text() const noexcept { return error_text_; }
+  [[nodiscard]] const std::shared_ptr<core::parser::Ast>& ast() const noexcept { return ast_; }
+
+private:
+  std::string expression_;
+  bool empty_{true};
+  std::string error_text_;
+  std::shared_ptr<core::parser::Ast> ast_;
+};
+
 // Result: (true|false), debug lines
 std::tuple<bool, std::vector<std::string>> check_acs(const Config& config, const User* user, int eff_sl,
                                                      const std::string& expression,
                                                      acs_debug_t debug = acs_debug_t::none);
 
+// Result: (true|false), debug lines
+std::tuple<bool, std::vector<std::string>> check_acs(const Config& config, const User* user, int eff_sl,
+                                                     const CompiledAcs& acs,
+                                                     acs_debug_t debug = acs_debug_t::none);
+
 // Result: (true|false), exception message (if any), debug lines
 std::tuple<bool, std::string, std::vector<std::string>> validate_acs(const Config& config, const User* user, int eff_sl,
                                                         const std::string& expression);
@@ -23,6 +23,7 @@
 #include "core/strings.h"
 #include "fmt/printf.h"
 #include "sdk/acs/eval_error.h"
+#include <memory>
 #include <optional>
 #include <string>
 #include <utility>
@@ -86,6 +87,11 @@ Eval::Eval(std::string expression) : expression_(std::move(expression)) {
   add("", std::make_unique<DefaultValueProvider>());  
 }
 
+Eval::Eval(std::string expression, std::shared_ptr<Ast> ast)
+    : expression_(std::move(expression)), ast_(std::move(ast)), parsed_(true) {
+  add("", std::make_unique<DefaultValueProvider>());
+}
+
 
 void Eval::visit(Expression* n) { 
   VLOG(2) << "Evaluating: " << n->ToString(false);  
@@ -130,10 +136,8 @@ void Eval::visit(Factor* n) {
   }
 }
 
-bool Eval::eval_throws() {
-  VLOG(1) << "Eval:eval: " << expression_;
-
-  Lexer l(expression_);
+std::shared_ptr<Ast> Eval::Parse(const std::string& expression) {
+  Lexer l(expression);
   if (!l.ok()) {
     std::string error_token;
     for (const auto& t : l.tokens()) {
@@ -141,23 +145,36 @@ bool Eval::eval_throws() {
         error_token += to_string(t);
       }
     }
-    throw eval_error(fmt::format("Failed to lex expression: '{}'; \r\nError {}: ", expression_, error_token));
+    throw eval_error(fmt::format("Failed to lex expression: '{}'; \r\nError {}: ", expression, error_token));
   }
 
-  Ast ast{};
-  if (!ast.parse(l)) {
-      return false;
+  auto ast = std::make_shared<Ast>();
+  if (!ast->parse(l)) {
+    return nullptr;
   }
-  auto* root = ast.root();
+  auto* root = ast->root();
   if (!root) {
-    throw eval_error(fmt::format("Failed to parse expression: '{}'.", expression_));
+    throw eval_error(fmt::format("Failed to parse expression: '{}'.", expression));
   }
   VLOG(1) << "Root: " << root->ToString();
   if (root->ast_type() == AstType::ERROR) {
     const auto* error_node = dynamic_cast<ErrorNode*>(root);
     throw eval_error(error_node->message);
   }
+  return ast;
+}
 
+bool Eval::eval_throws() {
+  VLOG(1) << "Eval:eval: " << expression_;
+
+  if (!parsed_) {
+    ast_ = Parse(expression_);
+    parsed_ = true;
+  }
+  if (!ast_) {
+    return false;
+  }
+  auto* root = ast_->root();
   root->accept(this);
 
   if (auto* expr = dynamic_cast<Expression*>(root)) {
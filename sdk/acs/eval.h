@@ -37,8 +37,16 @@ enum class debug_message_t { trace, parse };
 class Eval final : public core::parser::AstVisitor {
 public:
   explicit Eval(std::string expression);
+  /** Evaluates expression using ast, which was already created by Parse. */
+  Eval(std::string expression, std::shared_ptr<core::parser::Ast> ast);
   virtual ~Eval() = default;
 
+  /**
+   * Lexes and parses expression, throwing eval_error if it is not valid.
+   * Returns nullptr if the parser gave up without an error.
+   */
+  static std::shared_ptr<core::parser::Ast> Parse(const std::string& expression);
+
   bool eval_throws();
   bool eval();
   bool add(const std::string& prefix, std::unique_ptr<ValueProvider>&& p);
@@ -66,6 +74,8 @@ public:
 
 private:
   std::string expression_;
+  std::shared_ptr<core::parser::Ast> ast_;
+  bool parsed_{false};
   std::unordered_map<std::string, std::unique_ptr<ValueProvider>> providers_;
   std::unordered_map<int, Value> values_;
   std::string error_text_;
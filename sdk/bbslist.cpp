@@ -17,6 +17,7 @@
 /**************************************************************************/
 #include "sdk/bbslist.h"
 
+#include "core/crc32.h"
 #include "core/datafile.h"
 #include "core/file.h"
 #include "core/graphs.h"
@@ -28,12 +29,13 @@
 #include "sdk/filenames.h"
 #include <algorithm>
 #include <cctype>
-#include <cmath>
-#include <iterator>
+#include <cstring>
+#include <limits>
 #include <map>
 #include <optional>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 
 using std::endl;
 using std::map;
@@ -144,12 +146,121 @@ bool ParseBbsListNetLine(const string& ss, net_system_list_rec* con, int32_t* re
     return true;
 }
 
+namespace {
+
+/** Header of bbsdata.rte */
+struct route_cache_header_t {
+  char signature[4];
+  // Node number the routes start from.
+  uint16_t node;
+  uint16_t reserved;
+  // CRC-32 of connect.net the routes were computed from.
+  uint32_t connect_crc;
+  uint32_t num_routes;
+};
+
+/** Route to one node in bbsdata.rte, only reachable nodes are included. */
+struct route_cache_rec_t {
+  uint16_t sysnum;
+  uint16_t forsys;
+  int16_t numhops;
+  uint16_t reserved;
+  float cost;
+};
+
+static_assert(sizeof(route_cache_header_t) == 16, "route_cache_header_t == 16");
+static_assert(sizeof(route_cache_rec_t) == 12, "route_cache_rec_t == 12");
+
+constexpr char kRouteCacheSignature[4] = {'W', 'R', 'T', '1'};
+
+using routes_t = std::unordered_map<uint16_t, route_cache_rec_t>;
+
+} // namespace
+
+static std::optional<routes_t> ReadRouteCache(const std::filesystem::path& network_dir,
+                                              uint16_t net_node_number, uint32_t connect_crc) {
+  File file(FilePath(network_dir, BBSDATA_RTE));
+  if (!file.Open(File::modeBinary | File::modeReadOnly)) {
+    return std::nullopt;
+  }
+  route_cache_header_t h{};
+  if (file.Read(&h, sizeof(h)) != sizeof(h) ||
+      memcmp(h.signature, kRouteCacheSignature, sizeof(kRouteCacheSignature)) != 0 ||
+      h.node != net_node_number || h.connect_crc != connect_crc ||
+      file.length() != static_cast<File::size_type>(sizeof(h) + h.num_routes * sizeof(route_cache_rec_t))) {
+    return std::nullopt;
+  }
+  std::vector<route_cache_rec_t> recs(h.num_routes);
+  const auto len = recs.size() * sizeof(route_cache_rec_t);
+  if (!recs.empty() && file.Read(&recs[0], len) != static_cast<File::size_type>(len)) {
+    return std::nullopt;
+  }
+  routes_t routes;
+  for (const auto& r : recs) {
+    routes.emplace(r.sysnum, r);
+  }
+  VLOG(2) << "Using " << routes.size() << " cached routes from " << BBSDATA_RTE;
+  return {routes};
+}
+
+static void WriteRouteCache(const std::filesystem::path& network_dir, uint16_t net_node_number,
+                            uint32_t connect_crc, const routes_t& routes) {
+  route_cache_header_t h{};
+  memcpy(h.signature, kRouteCacheSignature, sizeof(kRouteCacheSignature));
+  h.node = net_node_number;
+  h.connect_crc = connect_crc;
+  h.num_routes = static_cast<uint32_t>(routes.size());
+
+  std::string data(reinterpret_cast<const char*>(&h), sizeof(h));
+  data.reserve(sizeof(h) + routes.size() * sizeof(route_cache_rec_t));
+  for (const auto& [_, r] : routes) {
+    data.append(reinterpret_cast<const char*>(&r), sizeof(r));
+  }
+  File file(FilePath(network_dir, BBSDATA_RTE));
+  if (!file.Open(File::modeBinary | File::modeReadWrite | File::modeCreateFile |
+                 File::modeTruncate) ||
+      file.Write(data) != static_cast<File::size_type>(data.size())) {
+    LOG(WARNING) << "Unable to write: " << file;
+  }
+}
+
+/** Computes the route to every node in connect.net */
+static routes_t ComputeRoutes(uint16_t net_node_number, const std::filesystem::path& network_dir) {
+  const Connect connect(network_dir);
+
+  // Build the network graph
+  wwiv::graphs::Graph graph(net_node_number, std::numeric_limits<uint16_t>::max());
+  for (const auto& e : connect.node_config()) {
+    const auto& c = e.second;
+    auto source = c.sysnum;
+    
+    auto cost_iter = c.cost.begin();
+    for (auto dest_iter = c.connect.begin(); dest_iter != std::end(c.connect); dest_iter++, cost_iter++) {
+      graph.add_edge(source, *dest_iter, *cost_iter);
+    }
+  }
+
+  routes_t routes;
+  for (const auto& [node, _] : connect.node_config()) {
+    if (!graph.has_node(node) || !graph.reachable(node)) {
+      VLOG(2) << "no path to " << node;
+      continue;
+    }
+    route_cache_rec_t r{};
+    r.sysnum = node;
+    r.forsys = node == net_node_number ? node : graph.next_hop_to(node);
+    r.numhops = static_cast<int16_t>(graph.num_hops_to(node));
+    r.cost = graph.cost_to(node);
+    routes.emplace(node, r);
+  }
+  return routes;
+}
+
 static bool ParseBbsListNetFile(
   std::map<uint16_t, net_system_list_rec>* node_config_map,
   std::map<uint16_t, int32_t>* reg_number_map,
   const std::filesystem::path& network_dir,
-  wwiv::graphs::Graph& graph,
-  uint16_t net_node_number) {
+  const routes_t& routes) {
   TextFile bbs_list_file(FilePath(network_dir, BBSLIST_NET), "rt");
   if (!bbs_list_file.IsOpen()) {
     return false;
@@ -163,29 +274,11 @@ static bool ParseBbsListNetFile(
     int32_t reg_number;
     if (ParseBbsListNetLine(line, &node_config, &reg_number)) {
       // Parsed a line correctly.
-      auto path = graph.shortest_path_to(node_config.sysnum);
-      auto cost = graph.cost_to(node_config.sysnum);
-      if (!std::isfinite(cost)) {
-        if(VLOG_IS_ON(2)) {
-          std::ostringstream ss; 
-          VLOG(2) << "high cost " << cost << " to " << node_config.sysnum;
-          ss << "Path to " << node_config.sysnum << ": ";
-          std::copy(path.begin(), path.end(), std::ostream_iterator<uint16_t>(ss, " "));
-          VLOG(2) << ss.str();
-          VLOG(2) << graph.DumpCosts();
-        }
-      }
-      if (graph.has_node(node_config.sysnum) && path.front() == net_node_number) {
-        path.pop_front();
+      if (const auto it = routes.find(node_config.sysnum); it != std::end(routes)) {
         // We have a path...
-        //std::copy(path.begin(), path.end(), std::ostream_iterator<uint16_t>(std::cout, " "));
-        node_config.numhops = static_cast<int16_t>(path.size());
-        node_config.xx.cost = cost;
-        if (!path.empty()) {
-          node_config.forsys = path.front();
-        } else {
-          node_config.forsys = node_config.sysnum;
-        }
+        node_config.numhops = it->second.numhops;
+        node_config.xx.cost = it->second.cost;
+        node_config.forsys = it->second.forsys;
       } else {
         VLOG(2) << "no path to " << node_config.sysnum;
         node_config.numhops = 10000;
@@ -205,22 +298,17 @@ BbsListNet BbsListNet::ParseBbsListNet(uint16_t net_node_number,
   BbsListNet b;
 
   VLOG(3) << "Processing " << network_dir;
-  // We now need to add in cost and routing information.
-  Connect connect(network_dir);
-
-  // Build the network graph
-  wwiv::graphs::Graph graph(net_node_number, std::numeric_limits<uint16_t>::max());
-  for (const auto& e : connect.node_config()) {
-    const auto& c = e.second;
-    auto source = c.sysnum;
-    
-    auto cost_iter = c.cost.begin();
-    for (auto dest_iter = c.connect.begin(); dest_iter != std::end(c.connect); dest_iter++, cost_iter++) {
-      graph.add_edge(source, *dest_iter, *cost_iter);
-    }
+  // We now need to add in cost and routing information.  These only depend on
+  // connect.net, so reuse the last ones computed if it has not changed.
+  const auto connect_crc = crc32file(FilePath(network_dir, CONNECT_NET));
+  auto routes = ReadRouteCache(network_dir, net_node_number, connect_crc);
+  if (!routes) {
+    routes = ComputeRoutes(net_node_number, network_dir);
+    WriteRouteCache(network_dir, net_node_number, connect_crc, routes.value());
   }
 
-  ParseBbsListNetFile(&b.node_config_, &b.reg_number_, network_dir, graph, net_node_number);
+  ParseBbsListNetFile(&b.node_config_, &b.reg_number_, network_dir, routes.value());
+  b.UpdateForsys();
   return b;
 }
 
@@ -237,6 +325,7 @@ BbsListNet BbsListNet::ReadBbsDataNet(const std::filesystem::path& network_dir)
     }
     file.Close();
   }
+  b.UpdateForsys();
   return b;
 }
 
@@ -246,10 +335,18 @@ BbsListNet::BbsListNet(std::initializer_list<net_system_list_rec> l) {
   for (const auto& r : l) {
     node_config_.emplace(r.sysnum, r);
   }
+  UpdateForsys();
 }
 
 BbsListNet::~BbsListNet() = default;
 
+void BbsListNet::UpdateForsys() {
+  std::fill(std::begin(forsys_), std::end(forsys_), WWIVNET_NO_NODE);
+  for (const auto& [node, n] : node_config_) {
+    forsys_[node] = n.forsys;
+  }
+}
+
 std::optional<net_system_list_rec> BbsListNet::node_config_for(int node) const {
   const auto iter = node_config_.find(static_cast<uint16_t>(node));
   if (iter != end(node_config_)) {
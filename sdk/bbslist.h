@@ -21,12 +21,21 @@
 #include "sdk/net/net.h"
 #include <filesystem>
 #include <initializer_list>
+#include <limits>
 #include <map>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace wwiv::sdk {
   
+/**
+ * Parsed bbslist.net (or bbsdata.net) for a WWIVnet network.
+ *
+ * ParseBbsListNet computes the routes to every node from connect.net and
+ * caches them in bbsdata.rte, keyed by the contents of connect.net, so that
+ * when only bbslist.net changes the network graph is not rebuilt.
+ */
 class BbsListNet {
  public:
    static BbsListNet ParseBbsListNet(uint16_t net_node_number, const std::filesystem::path& network_dir);
@@ -35,17 +44,31 @@ class BbsListNet {
   BbsListNet(std::initializer_list<net_system_list_rec> l);
   virtual ~BbsListNet();
   [[nodiscard]] std::optional<net_system_list_rec> node_config_for(int node) const;
-  BbsListNet& operator=(const BbsListNet& rhs) { node_config_ = rhs.node_config_; return *this; }
+  BbsListNet& operator=(const BbsListNet& rhs) {
+    node_config_ = rhs.node_config_;
+    forsys_ = rhs.forsys_;
+    return *this;
+  }
   [[nodiscard]] std::string ToString() const;
 
   [[nodiscard]] bool empty() const { return node_config_.empty(); }
   [[nodiscard]] const std::map<uint16_t, net_system_list_rec>& node_config() const { return node_config_; }
   [[nodiscard]] const std::map<uint16_t, int32_t>& reg_number() const { return reg_number_; }
+  /**
+   * Returns the node to forward packets for node through, or WWIVNET_NO_NODE if
+   * node is unknown or unreachable.
+   */
+  [[nodiscard]] uint16_t forsys(uint16_t node) const { return forsys_[node]; }
 
  private:
    BbsListNet();
+   void UpdateForsys();
+
    std::map<uint16_t, net_system_list_rec> node_config_;
    std::map<uint16_t, int32_t> reg_number_;
+   // Indexed by node number.
+   std::vector<uint16_t> forsys_ =
+       std::vector<uint16_t>(std::numeric_limits<uint16_t>::max() + 1, WWIVNET_NO_NODE);
 };
 
 bool ParseBbsListNetLine(const std::string& line, net_system_list_rec* config, int32_t* reg_number);
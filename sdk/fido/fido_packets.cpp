@@ -96,28 +96,32 @@ bool write_fido_packet_header(File& f, packet_header_2p_t& header) {
   return true;
 }
 
-bool write_packed_message(File& f, FidoPackedMessage& packet) {
-  const auto num_written = f.Write(&packet.nh, sizeof(fido_packed_message_t));
-  if (num_written != sizeof(fido_packed_message_t)) {
-    LOG(ERROR) << "short write to packet, wrote " << num_written
-               << "; expected: " << sizeof(fido_packed_message_t);
+bool append_packed_message(File& f, FidoPackedMessage& packet) {
+  // The date is always 19 characters followed by a NUL.
+  auto date_time = packet.vh.date_time;
+  date_time.resize(19, '\0');
+  std::string rec(reinterpret_cast<const char*>(&packet.nh), sizeof(fido_packed_message_t));
+  for (const auto* field : {&date_time, &packet.vh.to_user_name, &packet.vh.from_user_name,
+                            &packet.vh.subject, &packet.vh.text}) {
+    rec.append(*field);
+    rec.push_back('\0');
+  }
+  const auto num_written = f.Write(rec);
+  if (num_written != ssize(rec)) {
+    LOG(ERROR) << "short write to packet, wrote " << num_written << "; expected: " << rec.size();
     return false;
   }
-  f.Write(packet.vh.date_time.c_str(), 19);
-  f.Write("\0", 1);
-  f.Write(packet.vh.to_user_name);
-  f.Write("\0", 1);
-  f.Write(packet.vh.from_user_name);
-  f.Write("\0", 1);
-  f.Write(packet.vh.subject);
-  f.Write("\0", 1);
-  f.Write(packet.vh.text);
-  f.Write("\0", 1);
-  // End of packet.
-  f.Write("\0\0", 2);
   return true;
 }
 
+bool write_fido_packet_end(File& f) {
+  return f.Write("\0\0", 2) == 2;
+}
+
+bool write_packed_message(File& f, FidoPackedMessage& packet) {
+  return append_packed_message(f, packet) && write_fido_packet_end(f);
+}
+
 bool write_stored_message(File& f, FidoStoredMessage& packet) {
   const auto num = f.Write(&packet.nh, sizeof(fido_stored_message_t));
   if (num != sizeof(fido_stored_message_t)) {
@@ -263,7 +263,15 @@ public:
 };
 
 bool write_fido_packet_header(wwiv::core::File& f, packet_header_2p_t& header);
+/** Writes packet as the only message in f, including the end of packet marker. */
 bool write_packed_message(wwiv::core::File& f, FidoPackedMessage& packet);
+/**
+ * Writes packet to f without ending the packet, so that more messages may
+ * follow. Call write_fido_packet_end once the last message is written.
+ */
+bool append_packed_message(wwiv::core::File& f, FidoPackedMessage& packet);
+/** Writes the end of packet marker that follows the last message. */
+bool write_fido_packet_end(wwiv::core::File& f);
 bool write_stored_message(wwiv::core::File& f, FidoStoredMessage& packet);
 
 
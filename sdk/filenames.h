@@ -33,6 +33,7 @@
 #define BBSDATA_IND "bbsdata.ind"
 #define BBSDATA_REG "bbsdata.reg"
 #define BBSDATA_ROU "bbsdata.rou"
+#define BBSDATA_RTE "bbsdata.rte"
 #define BBSLIST_NET "bbslist.net"
 
 #define BBSLIST_MSG "bbslist.msg"
@@ -90,6 +91,8 @@ const constexpr auto CHAINS_JSON = "chains.json";
 #define FILESDL_NOEXT "filesdl"
 #define FILESUL_NOEXT "filesul"
 #define FILE_ID_DIZ "file_id.diz"
+#define FILECAT_DAT "filecat.dat"
+#define FILECAT_LOG "filecat.log"
 #define FSED_NOEXT "fsed"
 
 #define FORMASV_MSG "formasv.msg"
@@ -167,11 +170,13 @@ const constexpr auto CHAINS_JSON = "chains.json";
 
 #define SCONFIG_HLP "sconfig.hlp"
 #define SMW_DAT "smw.dat"
+#define SMW_IDX "smw.idx"
 #define SMBMAIN_NOEXT "smbmain"
 #define SONLINE_NOEXT "sonline"
 #define SRESTRCT_NOEXT "srestrct"
 #define STATUS_DAT "status.dat"
 #define SUEDIT_NOEXT "suedit"
+#define SUBQSCAN_DAT "subqscan.dat"
 #define SUBS_CNF "subs.cnf"
 #define SUBS_DAT "subs.dat"
 #define SUBS_JSON "subs.json"
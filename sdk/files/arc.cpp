@@ -20,10 +20,15 @@
 #include "core/datafile.h"
 #include "core/file.h"
 #include "core/log.h"
+#include "core/scope_exit.h"
+#include "core/stl.h"
 #include "core/strings.h"
 #include "sdk/filenames.h"
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <vector>
+#include <zlib.h>
 
 using namespace wwiv::core;
 using namespace wwiv::strings;
@@ -126,55 +131,282 @@ template <typename Z> archive_entry_t create_archive_entry(const Z& z, const cha
   return a;
 }
 
+// Size of the buffers used when inflating members.
+static constexpr size_t ZIP_CHUNK_SIZE = 64 * 1024;
+
+ZipArchive::ZipArchive(std::filesystem::path path) : path_(std::move(path)), file_(path_) {}
+
+bool ZipArchive::Open() {
+  members_.clear();
+  if (!file_.IsOpen() && !file_.Open(File::modeBinary | File::modeReadOnly)) {
+    return false;
+  }
+  const auto len = file_.length();
+  const auto end_size = static_cast<File::size_type>(sizeof(zip_end_dir));
+  if (len < end_size) {
+    return false;
+  }
+  // The end record is followed by at most a 64k comment.
+  const auto tail_size = std::min<File::size_type>(len, end_size + 0xffff);
+  const auto tail_start = len - tail_size;
+  std::vector<char> tail(tail_size);
+  if (file_.Seek(tail_start, File::Whence::begin) != tail_start ||
+      file_.Read(tail.data(), tail_size) != tail_size) {
+    return false;
+  }
+  std::optional<zip_end_dir> end;
+  for (auto i = tail_size - end_size; i >= 0; i--) {
+    uint32_t sig;
+    memcpy(&sig, &tail[i], sizeof(sig));
+    if (sig == ZIP_CENT_END_SIG) {
+      zip_end_dir e{};
+      memcpy(&e, &tail[i], sizeof(e));
+      end = e;
+      break;
+    }
+  }
+  if (!end) {
+    return false;
+  }
+  if (end->ofs_cent_dir == 0xffffffff || end->total_entries_total == 0xffff) {
+    LOG(INFO) << "ZIP64 archives are not supported: " << path_;
+    return false;
+  }
+  const File::size_type cd_start = end->ofs_cent_dir;
+  const File::size_type cd_size = end->central_dir_size;
+  if (cd_start + cd_size > len) {
+    return false;
+  }
+  std::vector<char> cd;
+  if (cd_start >= tail_start) {
+    // Usually the whole central directory is in the tail already.
+    const auto* b = &tail[cd_start - tail_start];
+    cd.assign(b, b + cd_size);
+  } else {
+    cd.resize(cd_size);
+    if (file_.Seek(cd_start, File::Whence::begin) != cd_start ||
+        file_.Read(cd.data(), cd_size) != cd_size) {
+      return false;
+    }
+  }
+
+  File::size_type pos = 0;
+  for (auto i = 0; i < end->total_entries_total; i++) {
+    zip_central_dir zc{};
+    if (pos + static_cast<File::size_type>(sizeof(zc)) > cd_size) {
+      return false;
+    }
+    memcpy(&zc, &cd[pos], sizeof(zc));
+    if (zc.signature != ZIP_CENT_START_SIG) {
+      return false;
+    }
+    pos += sizeof(zc);
+    if (pos + zc.filename_len > cd_size) {
+      return false;
+    }
+    const std::string fn(&cd[pos], zc.filename_len);
+    VLOG(1) << "ZIP_CENT_START_SIG: " << fn;
+    members_.push_back(
+        member_t{create_archive_entry(zc, fn.c_str()), zc.comp_meth, zc.flags, zc.rel_ofs_header});
+    pos += zc.filename_len + zc.extra_len + zc.comment_len;
+  }
+  return true;
+}
+
+std::vector<archive_entry_t> ZipArchive::entries() const {
+  std::vector<archive_entry_t> out;
+  out.reserve(members_.size());
+  for (const auto& m : members_) {
+    out.push_back(m.entry);
+  }
+  return out;
+}
+
+// Returns the part of a member name after any directories.
+static std::string zip_basename(const std::string& name) {
+  const auto idx = name.find_last_of("/\\");
+  return idx == std::string::npos ? name : name.substr(idx + 1);
+}
+
+std::optional<int> ZipArchive::Find(const std::string& name) const {
+  for (auto i = 0; i < wwiv::stl::ssize(members_); i++) {
+    if (iequals(zip_basename(members_[i].entry.filename), name)) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+bool ZipArchive::Inflate(int num, const sink_t& sink) {
+  const auto& m = members_.at(num);
+  if (m.flags & 0x01) {
+    LOG(INFO) << "Encrypted ZIP members are not supported: " << m.entry.filename;
+    return false;
+  }
+  if (m.method != 0 && m.method != 8) {
+    LOG(INFO) << "Unsupported ZIP method: " << m.method << " for: " << m.entry.filename;
+    return false;
+  }
+  zip_local_header zl{};
+  if (file_.Seek(m.offset, File::Whence::begin) != m.offset ||
+      file_.Read(&zl, sizeof(zl)) != sizeof(zl) || zl.signature != ZIP_LOCAL_SIG) {
+    return false;
+  }
+  const File::size_type data_start = m.offset + sizeof(zl) + zl.filename_len + zl.extra_length;
+  if (file_.Seek(data_start, File::Whence::begin) != data_start) {
+    return false;
+  }
+
+  auto remaining = static_cast<uint32_t>(m.entry.compress_size);
+  uLong crc = crc32(0L, Z_NULL, 0);
+  uint32_t total = 0;
+  std::vector<char> in(ZIP_CHUNK_SIZE);
+  auto read_chunk = [&]() -> File::size_type {
+    const auto n = static_cast<File::size_type>(std::min<size_t>(remaining, in.size()));
+    if (file_.Read(in.data(), n) != n) {
+      return -1;
+    }
+    remaining -= static_cast<uint32_t>(n);
+    return n;
+  };
+
+  if (m.method == 0) {
+    while (remaining > 0) {
+      const auto n = read_chunk();
+      if (n < 0) {
+        return false;
+      }
+      crc = crc32(crc, reinterpret_cast<const Bytef*>(in.data()), static_cast<uInt>(n));
+      total += static_cast<uint32_t>(n);
+      if (!sink(in.data(), n)) {
+        return false;
+      }
+    }
+  } else {
+    z_stream zs{};
+    if (inflateInit2(&zs, -MAX_WBITS) != Z_OK) {
+      return false;
+    }
+    ScopeExit at_exit([&zs] { inflateEnd(&zs); });
+    std::vector<char> out(ZIP_CHUNK_SIZE);
+    auto ret = Z_OK;
+    while (ret != Z_STREAM_END) {
+      if (zs.avail_in == 0) {
+        if (remaining == 0) {
+          LOG(ERROR) << "Truncated ZIP member: " << m.entry.filename;
+          return false;
+        }
+        const auto n = read_chunk();
+        if (n < 0) {
+          return false;
+        }
+        zs.next_in = reinterpret_cast<Bytef*>(in.data());
+        zs.avail_in = static_cast<uInt>(n);
+      }
+      zs.next_out = reinterpret_cast<Bytef*>(out.data());
+      zs.avail_out = static_cast<uInt>(out.size());
+      ret = inflate(&zs, Z_NO_FLUSH);
+      if (ret != Z_OK && ret != Z_STREAM_END) {
+        LOG(ERROR) << "Error inflating: " << m.entry.filename << "; ret: " << ret;
+        return false;
+      }
+      const auto produced = out.size() - zs.avail_out;
+      crc = crc32(crc, reinterpret_cast<const Bytef*>(out.data()), static_cast<uInt>(produced));
+      total += static_cast<uint32_t>(produced);
+      if (produced > 0 && !sink(out.data(), produced)) {
+        return false;
+      }
+    }
+  }
+  if (total != static_cast<uint32_t>(m.entry.uncompress_size) || crc != m.entry.crc32) {
+    LOG(ERROR) << "CRC or size mismatch extracting: " << m.entry.filename;
+    return false;
+  }
+  return true;
+}
+
+std::optional<std::string> ZipArchive::Read(int num) {
+  std::string out;
+  out.reserve(static_cast<uint32_t>(members_.at(num).entry.uncompress_size));
+  if (!Inflate(num, [&out](const char* data, size_t size) {
+        out.append(data, size);
+        return true;
+      })) {
+    return std::nullopt;
+  }
+  return out;
+}
+
+bool ZipArchive::Extract(int num, const std::filesystem::path& path) {
+  File out(path);
+  if (!out.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite |
+                File::modeTruncate)) {
+    LOG(ERROR) << "Unable to create: " << path;
+    return false;
+  }
+  const auto ok = Inflate(num, [&out](const char* data, size_t size) {
+    return out.Write(data, size) == static_cast<File::size_type>(size);
+  });
+  out.Close();
+  if (!ok) {
+    File::Remove(path);
+  }
+  return ok;
+}
+
 static std::optional<std::vector<archive_entry_t>>
 list_archive_zip(const std::filesystem::path& path) {
-  std::vector<archive_entry_t> files;
-
-  File file(path);
-  if (!file.Open(File::modeBinary | File::modeReadOnly)) {
+  ZipArchive zip(path);
+  if (!zip.Open()) {
     return std::nullopt;
   }
-  long l = 0;
-  const auto len = file.length();
-  bool done = false;
-  while (l < len && !done) {
-    long sig = 0;
-    file.Seek(l, File::Whence::begin);
-    file.Read(&sig, 4);
-    file.Seek(l, File::Whence::begin);
-    switch (sig) {
-    case ZIP_LOCAL_SIG: {
-      zip_local_header zl{};
-      char s[1024];
-      file.Read(&zl, sizeof(zl));
-      file.Read(s, zl.filename_len);
-      s[zl.filename_len] = '\0';
-      // Since zip_central_dir and zip_local_header both have the same
-      // information, don't add it here.
-      // files.emplace_back(create_archive_entry(zl, s));
-      // VLOG(1) << "ZIP_LOCAL_SIG: " << s;
-      l += static_cast<long>(sizeof(zl)) + zl.comp_size + zl.filename_len + zl.extra_length;
-    } break;
-    case ZIP_CENT_START_SIG: {
-      zip_central_dir zc{};
-      char s[1024];
-      file.Read(&zc, sizeof(zc));
-      file.Read(s, zc.filename_len);
-      s[zc.filename_len] = '\0';
-      VLOG(1) << "ZIP_CENT_START_SIG: " << s;
-      files.emplace_back(create_archive_entry(zc, s));
-      l += sizeof(zc);
-      l += zc.filename_len + zc.extra_len;
-    } break;
-    case ZIP_CENT_END_SIG:
-      [[fallthrough]];
-    default: 
-      done = true;
-      break;
+  return {zip.entries()};
+}
+
+bool extract_archive(const std::filesystem::path& path, const std::filesystem::path& dir,
+                     const std::vector<std::string>& names) {
+  const auto ext = determine_arc_extension(path);
+  if (!ext || ext.value() != "ZIP") {
+    return false;
+  }
+  ZipArchive zip(path);
+  if (!zip.Open()) {
+    return false;
+  }
+  const auto entries = zip.entries();
+  for (auto i = 0; i < wwiv::stl::ssize(entries); i++) {
+    const auto fn = zip_basename(entries[i].filename);
+    if (fn.empty() || fn == "." || fn == "..") {
+      // Directory entry
+      continue;
+    }
+    if (!names.empty() &&
+        std::none_of(std::begin(names), std::end(names),
+                     [&fn](const std::string& n) { return iequals(n, fn); })) {
+      continue;
+    }
+    if (!zip.Extract(i, FilePath(dir, fn))) {
+      return false;
     }
   }
-  file.Close();
-  return {files};
+  return true;
+}
+
+std::optional<std::string> read_archive_file(const std::filesystem::path& path,
+                                             const std::string& name) {
+  const auto ext = determine_arc_extension(path);
+  if (!ext || ext.value() != "ZIP") {
+    return std::nullopt;
+  }
+  ZipArchive zip(path);
+  if (!zip.Open()) {
+    return std::nullopt;
+  }
+  const auto num = zip.Find(name);
+  if (!num) {
+    return std::nullopt;
+  }
+  return zip.Read(num.value());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -18,8 +18,10 @@
 #ifndef INCLUDED_SDK_FILES_ARC_H
 #define INCLUDED_SDK_FILES_ARC_H
 
+#include "core/file.h"
 #include "sdk/vardec.h"
 #include <filesystem>
+#include <functional>
 #include <optional>
 #include <string>
 #include <vector>
@@ -43,6 +45,61 @@ struct archive_entry_t {
   uint32_t crc32;
 };
 
+/**
+ * In-process reader for .ZIP files.  The central directory is loaded with a
+ * single read and stored or deflated members are inflated using zlib, so no
+ * external archiver is needed.  Encrypted and ZIP64 archives are not supported.
+ */
+class ZipArchive final {
+public:
+  explicit ZipArchive(std::filesystem::path path);
+  ~ZipArchive() = default;
+
+  /** Reads the central directory. Returns false if this is not a usable ZIP file. */
+  bool Open();
+  [[nodiscard]] std::vector<archive_entry_t> entries() const;
+  /** Returns the index of the member named name, ignoring case and any directory. */
+  [[nodiscard]] std::optional<int> Find(const std::string& name) const;
+  /** Inflates member num into memory. */
+  std::optional<std::string> Read(int num);
+  /** Inflates member num into the file at path, replacing any existing file. */
+  bool Extract(int num, const std::filesystem::path& path);
+
+private:
+  using sink_t = std::function<bool(const char* data, size_t size)>;
+  bool Inflate(int num, const sink_t& sink);
+
+  struct member_t {
+    archive_entry_t entry;
+    uint16_t method;
+    uint16_t flags;
+    uint32_t offset;
+  };
+
+  const std::filesystem::path path_;
+  core::File file_;
+  std::vector<member_t> members_;
+};
+
+/**
+ * Extracts the files in the archive at path into dir without running an
+ * external archiver, limited to names (compared ignoring case) when not empty.
+ * Any directories in the member names are not created.
+ *
+ * Returns false when the archive type is not supported in-process or it could
+ * not be extracted, in which case callers should fall back to the archiver
+ * from archiver.dat.
+ */
+bool extract_archive(const std::filesystem::path& path, const std::filesystem::path& dir,
+                     const std::vector<std::string>& names = {});
+
+/**
+ * Returns the contents of the file named name within the archive at path, or
+ * std::nullopt if it does not exist or the archive is not supported in-process.
+ */
+std::optional<std::string> read_archive_file(const std::filesystem::path& path,
+                                             const std::string& name);
+
 /**
  * Reads data/archiver.dat and populates a vector of arcrec from it.
  */
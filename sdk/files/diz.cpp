@@ -20,6 +20,8 @@
 #include "core/file.h"
 #include "core/strings.h"
 #include "core/textfile.h"
+#include "sdk/filenames.h"
+#include "sdk/files/arc.h"
 #include <utility>
 
 static const char* invalid_chars = "ڿĳôɻȼͺ̹ոԾͳƵַӽĺǶװ";
@@ -61,10 +63,63 @@ std::optional<wwiv::sdk::files::Diz> wwiv::sdk::files::DizParser::parse(
     return std::nullopt;
   }
 
+  TextFile file(path, "rt");
+  return parse(file.ReadFileIntoVector());
+}
+
+wwiv::sdk::files::archive_diz_t wwiv::sdk::files::DizParser::parse_archive(
+    const std::filesystem::path& archive) const {
+  archive_diz_t result{};
+  const auto ext = determine_arc_extension(archive);
+  if (!ext || ext.value() != "ZIP") {
+    return result;
+  }
+  ZipArchive zip(archive);
+  if (!zip.Open()) {
+    return result;
+  }
+  auto num = zip.Find(FILE_ID_DIZ);
+  result.filename = FILE_ID_DIZ;
+  if (!num) {
+    num = zip.Find(DESC_SDI);
+    result.filename = DESC_SDI;
+  }
+  if (!num) {
+    result.handled = true;
+    result.filename.clear();
+    return result;
+  }
+  const auto text = zip.Read(num.value());
+  if (!text) {
+    // Let the archiver try a member we can not inflate.
+    return result;
+  }
+  result.handled = true;
+  // Split the same way TextFile::ReadLine does.
+  std::vector<std::string> lines;
+  std::string::size_type start = 0;
+  while (start < text->size()) {
+    auto end = text->find('\n', start);
+    if (end == std::string::npos) {
+      end = text->size();
+    }
+    auto line = text->substr(start, end - start);
+    while (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    lines.emplace_back(std::move(line));
+    start = end + 1;
+  }
+  if (auto diz = parse(lines)) {
+    result.diz.emplace(diz.value());
+  }
+  return result;
+}
+
+std::optional<wwiv::sdk::files::Diz> wwiv::sdk::files::DizParser::parse(
+    const std::vector<std::string>& lines) const {
   std::string description;
 
-  TextFile file(path, "rt");
-  auto lines = file.ReadFileIntoVector();
   if (lines.empty()) {
     return std::nullopt;
   }
@@ -21,6 +21,7 @@
 #include <filesystem>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace wwiv::sdk::files {
 
@@ -37,6 +38,17 @@ private:
   const std::string extended_description_;
 };
 
+/** Result of reading the description file straight out of an archive. */
+struct archive_diz_t {
+  // True when the archive could be read in-process, even if it holds no
+  // description file. When false the archiver from archiver.dat must be used.
+  bool handled{false};
+  // Name of the description file found (FILE_ID.DIZ or DESC.SDI), or empty.
+  std::string filename;
+  // The parsed description, if the file was found and is not empty.
+  std::optional<Diz> diz;
+};
+
 class DizParser final {
 public:
   explicit DizParser(bool firstline_as_desc);
@@ -44,6 +56,13 @@ public:
   ~DizParser() = default;
 
   [[nodiscard]] std::optional<Diz> parse(const std::filesystem::path& path) const;
+  /**
+   * Parses the FILE_ID.DIZ (or DESC.SDI) inside of archive without extracting
+   * it to disk. An archive that can be read in-process but has neither is
+   * still handled, so callers only need the archiver when handled is false.
+   */
+  [[nodiscard]] archive_diz_t parse_archive(const std::filesystem::path& archive) const;
+  [[nodiscard]] std::optional<Diz> parse(const std::vector<std::string>& lines) const;
 private:
   bool firstline_as_desc_;
 };
@@ -0,0 +1,447 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "sdk/files/file_catalog.h"
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "core/semaphore_file.h"
+#include "core/stl.h"
+#include "core/strings.h"
+#include "sdk/filenames.h"
+#include "sdk/files/files.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iterator>
+#include <string>
+#include <utility>
+
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+namespace wwiv::sdk::files {
+
+// Once the journal has this many records it is folded into filecat.dat on the
+// next Load.
+static constexpr int kMaxJournalRecords = 4096;
+
+// Held while appending to filecat.log and while compacting it.
+static constexpr char kCatalogBusy[] = "filecat.bsy";
+
+static std::set<std::string> words(const std::string& text, size_t min_len) {
+  std::set<std::string> out;
+  std::string w;
+  for (const auto ch : text) {
+    if (std::isalnum(static_cast<unsigned char>(ch))) {
+      w.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(ch))));
+      continue;
+    }
+    if (w.size() >= min_len) {
+      out.insert(w);
+    }
+    w.clear();
+  }
+  if (w.size() >= min_len) {
+    out.insert(w);
+  }
+  return out;
+}
+
+std::set<std::string> file_catalog_words(const uploadsrec& u) {
+  auto out = words(u.filename, 2);
+  out.merge(words(u.description, 2));
+  return out;
+}
+
+FileCatalog::FileCatalog(std::filesystem::path datadir) : datadir_(std::move(datadir)) {}
+
+bool FileCatalog::to_rec(file_catalog_op_t op, const std::string& area, const uploadsrec& u,
+                         file_catalog_rec_t& rec) {
+  rec = {};
+  rec.op = op;
+  rec.u = u;
+  if (area.size() >= sizeof(rec.area)) {
+    VLOG(1) << "Not cataloging file area with long name: " << area;
+    return false;
+  }
+  return to_char_array(rec.area, ToStringUpperCase(area));
+}
+
+void FileCatalog::Clear() {
+  loaded_ = false;
+  journal_pos_ = 0;
+  snapshot_time_ = 0;
+  entries_.clear();
+  indexed_areas_.clear();
+  by_area_.clear();
+  by_name_.clear();
+  by_word_.clear();
+}
+
+void FileCatalog::AddEntry(const std::string& area, const uploadsrec& u) {
+  const auto id = next_id_++;
+  const std::string name = ToStringUpperCase(u.filename);
+  entries_.emplace(id, file_catalog_entry_t{area, u});
+  by_area_[area].insert(id);
+  by_name_[name].insert(id);
+  for (const auto& w : file_catalog_words(u)) {
+    by_word_[w].insert(id);
+  }
+}
+
+void FileCatalog::RemoveEntry(uint32_t id) {
+  const auto it = entries_.find(id);
+  if (it == std::end(entries_)) {
+    return;
+  }
+  const auto& e = it->second;
+  const std::string name = ToStringUpperCase(e.u.filename);
+  if (auto a = by_area_.find(e.area); a != std::end(by_area_)) {
+    a->second.erase(id);
+  }
+  if (auto n = by_name_.find(name); n != std::end(by_name_)) {
+    n->second.erase(id);
+    if (n->second.empty()) {
+      by_name_.erase(n);
+    }
+  }
+  for (const auto& w : file_catalog_words(e.u)) {
+    if (auto bw = by_word_.find(w); bw != std::end(by_word_)) {
+      bw->second.erase(id);
+      if (bw->second.empty()) {
+        by_word_.erase(bw);
+      }
+    }
+  }
+  entries_.erase(it);
+}
+
+void FileCatalog::Apply(const file_catalog_rec_t& rec) {
+  const std::string area = rec.area;
+  switch (rec.op) {
+  case file_catalog_op_t::add:
+    AddEntry(area, rec.u);
+    break;
+  case file_catalog_op_t::remove: {
+    const std::string name = ToStringUpperCase(rec.u.filename);
+    const auto a = by_area_.find(area);
+    const auto n = by_name_.find(name);
+    if (a == std::end(by_area_) || n == std::end(by_name_)) {
+      break;
+    }
+    for (const auto id : n->second) {
+      if (a->second.count(id)) {
+        RemoveEntry(id);
+        break;
+      }
+    }
+  } break;
+  case file_catalog_op_t::clear_area: {
+    if (const auto a = by_area_.find(area); a != std::end(by_area_)) {
+      const auto ids = a->second;
+      for (const auto id : ids) {
+        RemoveEntry(id);
+      }
+    }
+    indexed_areas_.insert(area);
+  } break;
+  default:
+    LOG(ERROR) << "Unknown file catalog op: " << static_cast<int>(rec.op);
+    break;
+  }
+}
+
+bool FileCatalog::Load() {
+  if (!Reload()) {
+    return false;
+  }
+  if (journal_pos_ > kMaxJournalRecords) {
+    return Compact();
+  }
+  return true;
+}
+
+bool FileCatalog::Reload() {
+  Clear();
+  const auto dat = core::FilePath(datadir_, FILECAT_DAT);
+  {
+    DataFile<file_catalog_rec_t> file(dat, File::modeReadOnly | File::modeBinary);
+    if (file) {
+      std::vector<file_catalog_rec_t> recs;
+      if (!file.ReadVector(recs)) {
+        LOG(ERROR) << "Error reading: " << dat;
+        return false;
+      }
+      for (const auto& r : recs) {
+        Apply(r);
+      }
+    }
+  }
+  snapshot_time_ = File::Exists(dat) ? File::last_write_time(dat) : 0;
+  loaded_ = true;
+  return Refresh();
+}
+
+bool FileCatalog::Refresh() {
+  if (!loaded_) {
+    return Load();
+  }
+  const auto dat = core::FilePath(datadir_, FILECAT_DAT);
+  const auto snapshot_time = File::Exists(dat) ? File::last_write_time(dat) : 0;
+  if (snapshot_time != snapshot_time_) {
+    // Someone else compacted the catalog.
+    return Reload();
+  }
+  DataFile<file_catalog_rec_t> file(core::FilePath(datadir_, FILECAT_LOG),
+                                    File::modeReadOnly | File::modeBinary);
+  if (!file) {
+    if (journal_pos_ > 0) {
+      return Reload();
+    }
+    return true;
+  }
+  const auto num = file.number_of_records();
+  if (num < journal_pos_) {
+    return Reload();
+  }
+  if (num == journal_pos_) {
+    return true;
+  }
+  std::vector<file_catalog_rec_t> recs(num - journal_pos_);
+  if (!file.Seek(journal_pos_) || !file.Read(&recs[0], stl::ssize(recs))) {
+    LOG(ERROR) << "Error reading: " << core::FilePath(datadir_, FILECAT_LOG);
+    return false;
+  }
+  for (const auto& r : recs) {
+    Apply(r);
+  }
+  journal_pos_ = num;
+  return true;
+}
+
+bool FileCatalog::Compact() {
+  if (!loaded_) {
+    return false;
+  }
+  try {
+    // Journal appends while holding the same semaphore, so once everything
+    // journaled so far is applied nothing else can be appended before the
+    // journal is emptied below.
+    auto sem = SemaphoreFile::try_acquire(core::FilePath(datadir_, kCatalogBusy),
+                                          std::chrono::seconds(2));
+    if (!Refresh()) {
+      return false;
+    }
+    std::vector<file_catalog_rec_t> recs;
+    recs.reserve(indexed_areas_.size() + entries_.size());
+    for (const auto& area : indexed_areas_) {
+      file_catalog_rec_t r{};
+      if (to_rec(file_catalog_op_t::clear_area, area, {}, r)) {
+        recs.push_back(r);
+      }
+    }
+    for (const auto& [area, ids] : by_area_) {
+      for (const auto id : ids) {
+        file_catalog_rec_t r{};
+        if (to_rec(file_catalog_op_t::add, area, entries_.at(id).u, r)) {
+          recs.push_back(r);
+        }
+      }
+    }
+    const auto tmp = core::FilePath(datadir_, "filecat.tmp");
+    {
+      DataFile<file_catalog_rec_t> file(tmp, File::modeReadWrite | File::modeBinary |
+                                                 File::modeCreateFile | File::modeTruncate);
+      if (!file || !file.WriteVector(recs)) {
+        LOG(ERROR) << "Error writing: " << tmp;
+        return false;
+      }
+    }
+    const auto dat = core::FilePath(datadir_, FILECAT_DAT);
+    File::Remove(dat);
+    if (!File::Rename(tmp, dat)) {
+      LOG(ERROR) << "Error renaming " << tmp << " to " << dat;
+      return false;
+    }
+    File log(core::FilePath(datadir_, FILECAT_LOG));
+    if (log.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
+      log.set_length(0);
+    }
+    snapshot_time_ = File::last_write_time(dat);
+    journal_pos_ = 0;
+    return true;
+  } catch (const semaphore_not_acquired& e) {
+    VLOG(1) << "Skipping file catalog compaction, busy: " << e.what();
+    return true;
+  }
+}
+
+bool FileCatalog::Journal(const std::vector<file_catalog_rec_t>& recs) {
+  if (recs.empty()) {
+    return true;
+  }
+  try {
+    // Keeps Compact from emptying the journal between our Refresh and append.
+    auto sem = SemaphoreFile::try_acquire(core::FilePath(datadir_, kCatalogBusy),
+                                          std::chrono::seconds(10));
+    // Pick up everyone else's changes first so that journal_pos_ stays in step
+    // with what has been applied.
+    if (loaded_ && !Refresh()) {
+      return false;
+    }
+    {
+      DataFile<file_catalog_rec_t> file(core::FilePath(datadir_, FILECAT_LOG),
+                                        File::modeReadWrite | File::modeBinary |
+                                            File::modeCreateFile | File::modeAppend);
+      if (!file || !file.WriteVector(recs)) {
+        LOG(ERROR) << "Error writing to: " << core::FilePath(datadir_, FILECAT_LOG);
+        return false;
+      }
+    }
+    if (!loaded_) {
+      return true;
+    }
+    // Apply our records to memory.
+    return Refresh();
+  } catch (const semaphore_not_acquired& e) {
+    LOG(ERROR) << "Unable to journal file catalog changes, busy: " << e.what();
+    return false;
+  }
+}
+
+bool FileCatalog::Add(const std::string& area, const uploadsrec& u) {
+  file_catalog_rec_t r{};
+  if (!to_rec(file_catalog_op_t::add, area, u, r)) {
+    return false;
+  }
+  return Journal({r});
+}
+
+bool FileCatalog::Remove(const std::string& area, const std::string& aligned_filename) {
+  uploadsrec u{};
+  to_char_array(u.filename, aligned_filename);
+  file_catalog_rec_t r{};
+  if (!to_rec(file_catalog_op_t::remove, area, u, r)) {
+    return false;
+  }
+  return Journal({r});
+}
+
+bool FileCatalog::ReplaceArea(const std::string& area, const std::vector<uploadsrec>& files) {
+  std::vector<file_catalog_rec_t> recs;
+  recs.reserve(files.size());
+  file_catalog_rec_t r{};
+  if (!to_rec(file_catalog_op_t::clear_area, area, {}, r)) {
+    return false;
+  }
+  recs.push_back(r);
+  for (auto i = 1; i < stl::ssize(files); i++) {
+    if (to_rec(file_catalog_op_t::add, area, files[i], r)) {
+      recs.push_back(r);
+    }
+  }
+  return Journal(recs);
+}
+
+bool FileCatalog::has_area(const std::string& area) const {
+  return indexed_areas_.count(ToStringUpperCase(area)) > 0;
+}
+
+int FileCatalog::size() const {
+  return stl::size_int(entries_);
+}
+
+std::vector<file_catalog_entry_t> FileCatalog::entries(const std::set<uint32_t>& ids) const {
+  std::vector<file_catalog_entry_t> out;
+  out.reserve(ids.size());
+  for (const auto id : ids) {
+    out.push_back(entries_.at(id));
+  }
+  return out;
+}
+
+std::vector<file_catalog_entry_t> FileCatalog::area_files(const std::string& area) const {
+  const auto it = by_area_.find(ToStringUpperCase(area));
+  if (it == std::end(by_area_)) {
+    return {};
+  }
+  return entries(it->second);
+}
+
+std::vector<file_catalog_entry_t>
+FileCatalog::FindFile(const std::string& aligned_filename) const {
+  const auto it = by_name_.find(ToStringUpperCase(aligned_filename));
+  if (it == std::end(by_name_)) {
+    return {};
+  }
+  return entries(it->second);
+}
+
+std::vector<file_catalog_entry_t> FileCatalog::FindMask(const std::string& aligned_mask) const {
+  const auto mask = ToStringUpperCase(aligned_mask);
+  if (mask.find('?') == std::string::npos) {
+    return FindFile(mask);
+  }
+  std::set<uint32_t> ids;
+  for (const auto& [name, n] : by_name_) {
+    if (name.size() == 12 && aligned_wildcard_match(mask, name)) {
+      ids.insert(std::begin(n), std::end(n));
+    }
+  }
+  return entries(ids);
+}
+
+std::vector<file_catalog_entry_t> FileCatalog::FindWords(const std::string& text) const {
+  const auto query = words(text, 1);
+  if (query.empty()) {
+    return {};
+  }
+  std::set<uint32_t> result;
+  auto first = true;
+  for (const auto& q : query) {
+    std::set<uint32_t> matches;
+    for (auto it = by_word_.lower_bound(q);
+         it != std::end(by_word_) && it->first.compare(0, q.size(), q) == 0; ++it) {
+      matches.insert(std::begin(it->second), std::end(it->second));
+    }
+    if (first) {
+      result = std::move(matches);
+      first = false;
+    } else {
+      std::set<uint32_t> both;
+      std::set_intersection(std::begin(result), std::end(result), std::begin(matches),
+                            std::end(matches), std::inserter(both, std::end(both)));
+      result = std::move(both);
+    }
+    if (result.empty()) {
+      break;
+    }
+  }
+  return entries(result);
+}
+
+std::set<std::string> FileCatalog::AreasMatching(const std::string& aligned_mask) const {
+  std::set<std::string> areas;
+  for (const auto& e : FindMask(aligned_mask)) {
+    areas.insert(e.area);
+  }
+  return areas;
+}
+
+} // namespace wwiv::sdk::files
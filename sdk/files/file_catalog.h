@@ -0,0 +1,148 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef __INCLUDED_SDK_FILES_FILE_CATALOG_H__
+#define __INCLUDED_SDK_FILES_FILE_CATALOG_H__
+
+#include "sdk/vardec.h"
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wwiv::sdk::files {
+
+enum class file_catalog_op_t : uint8_t { add = 1, remove = 2, clear_area = 3 };
+
+/**
+ * On disk record for both filecat.dat (where op is always add) and the
+ * filecat.log journal.
+ */
+struct file_catalog_rec_t {
+  file_catalog_op_t op;
+  // Base filename of the file area (directory_t::filename).
+  char area[31];
+  uploadsrec u;
+};
+
+static_assert(sizeof(file_catalog_rec_t) == 176, "file_catalog_rec_t == 176");
+
+struct file_catalog_entry_t {
+  // Uppercase base filename of the file area.
+  std::string area;
+  uploadsrec u;
+};
+
+/**
+ * Index of every file in every file area, keyed by area and aligned filename
+ * and by the words in the filename and description.
+ *
+ * The index lives in filecat.dat with changes appended to filecat.log as they
+ * are saved by FileArea, so that searching all of the areas does not need to
+ * open every .dir file.  Areas are only considered indexed once their full
+ * contents have been recorded using ReplaceArea; see has_area.
+ */
+class FileCatalog final {
+public:
+  explicit FileCatalog(std::filesystem::path datadir);
+  ~FileCatalog() = default;
+
+  /** Loads filecat.dat and replays filecat.log, compacting them if needed. */
+  bool Load();
+  /**
+   * Picks up any changes journaled by other instances since the last Load or
+   * Refresh, loading the catalog if it has not been loaded yet.
+   */
+  bool Refresh();
+  /**
+   * Applies filecat.log, then rewrites filecat.dat with the current contents
+   * and empties filecat.log.
+   */
+  bool Compact();
+
+  // Changes. These are journaled and applied to memory when loaded.
+
+  bool Add(const std::string& area, const uploadsrec& u);
+  bool Remove(const std::string& area, const std::string& aligned_filename);
+  /**
+   * Replaces everything known about area with files, marking the area as indexed.
+   * files uses the layout of a .dir file, so files[0] (the header) is skipped.
+   */
+  bool ReplaceArea(const std::string& area, const std::vector<uploadsrec>& files);
+  /**
+   * Writes all of the records in one append to filecat.log, holding
+   * filecat.bsy so that a concurrent Compact cannot discard them.
+   */
+  bool Journal(const std::vector<file_catalog_rec_t>& recs);
+
+  // Queries
+
+  [[nodiscard]] bool loaded() const noexcept { return loaded_; }
+  [[nodiscard]] bool has_area(const std::string& area) const;
+  [[nodiscard]] int size() const;
+  /** Returns all of the files in area. */
+  [[nodiscard]] std::vector<file_catalog_entry_t> area_files(const std::string& area) const;
+  /** Returns every file named aligned_filename in any area. */
+  [[nodiscard]] std::vector<file_catalog_entry_t> FindFile(const std::string& aligned_filename) const;
+  /** Returns every file matching an aligned wildcard mask, i.e. 'FOO?????.ZIP' */
+  [[nodiscard]] std::vector<file_catalog_entry_t> FindMask(const std::string& aligned_mask) const;
+  /**
+   * Returns every file where each of the words in text starts a word in the
+   * filename or description.
+   */
+  [[nodiscard]] std::vector<file_catalog_entry_t> FindWords(const std::string& text) const;
+  /** Returns the names of areas containing at least one file matching aligned_mask */
+  [[nodiscard]] std::set<std::string> AreasMatching(const std::string& aligned_mask) const;
+
+  /** Creates a record for the journal. Returns false if the area name does not fit. */
+  static bool to_rec(file_catalog_op_t op, const std::string& area, const uploadsrec& u,
+                     file_catalog_rec_t& rec);
+
+private:
+  /** Loads filecat.dat and replays filecat.log without compacting. */
+  bool Reload();
+  void Clear();
+  void Apply(const file_catalog_rec_t& rec);
+  void AddEntry(const std::string& area, const uploadsrec& u);
+  void RemoveEntry(uint32_t id);
+  [[nodiscard]] std::vector<file_catalog_entry_t> entries(const std::set<uint32_t>& ids) const;
+
+  const std::filesystem::path datadir_;
+  bool loaded_{false};
+  // Number of journal records applied to memory.
+  int journal_pos_{0};
+  time_t snapshot_time_{0};
+
+  uint32_t next_id_{1};
+  std::unordered_map<uint32_t, file_catalog_entry_t> entries_;
+  std::set<std::string> indexed_areas_;
+  std::map<std::string, std::set<uint32_t>> by_area_;
+  std::unordered_map<std::string, std::set<uint32_t>> by_name_;
+  // Sorted so that words can be prefix matched.
+  std::map<std::string, std::set<uint32_t>> by_word_;
+};
+
+/** Returns the uppercase words of at least 2 characters in the filename and description */
+std::set<std::string> file_catalog_words(const uploadsrec& u);
+
+} // namespace wwiv::sdk::files
+
+#endif  // __INCLUDED_SDK_FILES_FILE_CATALOG_H__
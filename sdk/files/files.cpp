@@ -57,7 +57,12 @@ bool FileApi::Create(const std::string& filename) {
 
   FileArea area(this, data_directory_, filename);
   // Close should save and write header if needed.
-  return area.Close();
+  if (!area.Close()) {
+    return false;
+  }
+  // The new area is empty, so it's fully indexed as-is.
+  catalog().ReplaceArea(filename, {});
+  return true;
 }
 
 bool FileApi::Create(const directory_t& dir) {
@@ -100,6 +105,21 @@ void FileApi::set_clock(std::unique_ptr<Clock> clock) {
   clock_ = std::move(clock);
 }
 
+FileCatalog& FileApi::catalog() {
+  if (!catalog_) {
+    catalog_ = std::make_unique<FileCatalog>(data_directory_);
+  }
+  return *catalog_;
+}
+
+bool FileApi::IndexArea(const directory_t& dir) {
+  const auto area = Open(dir);
+  if (!area) {
+    return false;
+  }
+  return catalog().ReplaceArea(dir.filename, area->raw_files());
+}
+
 FileAreaHeader::FileAreaHeader(const uploadsrec& u) : u_(u) {}
 
 bool FileAreaHeader::FixHeader(const Clock& clock, uint32_t num_files) {
@@ -148,6 +168,8 @@ FileAreaHeader& FileArea::header() const {
 
 bool FileArea::Load() {
   dirty_ = false;
+  catalog_changes_.clear();
+  catalog_replace_ = false;
   DataFile<uploadsrec> file(path(), File::modeReadOnly | File::modeBinary);
   if (file) {
     if (file.ReadVector(files_)) {
@@ -233,6 +255,7 @@ bool FileArea::AddFile(const FileRecord& f) {
   }
   header_->set_num_files(stl::size_uint32(files_) - 1);
   header_->set_daten(std::max(header_->daten(), f.u().daten));
+  AddCatalogChange(file_catalog_op_t::add, f.u());
   dirty_ = true;
   return true;
 }
@@ -249,6 +272,8 @@ bool FileArea::AddFile(FileRecord& f, const std::string& ext_desc) {
 }
 
 bool FileArea::UpdateFile(FileRecord& f, int num) {
+  AddCatalogChange(file_catalog_op_t::remove, files_.at(num));
+  AddCatalogChange(file_catalog_op_t::add, f.u());
   files_.at(num) = f.u();
   header_->set_daten(std::max(header_->daten(), f.u().daten));
   dirty_ = true;
@@ -280,6 +305,7 @@ bool FileArea::DeleteFile(int file_number) {
   if (!stl::erase_at(files_, file_number)) {
     return false;
   }
+  AddCatalogChange(file_catalog_op_t::remove, old);
   // Attempt to delete the extended descriptions if they existed.
   if (old.mask & mask_extended) {
     DeleteExtendedDescription(old.filename);
@@ -377,6 +403,8 @@ const std::vector<uploadsrec>& FileArea::raw_files() const {
 
 bool FileArea::set_raw_files(std::vector<uploadsrec> nf) {
   files_ = std::move(nf);
+  catalog_changes_.clear();
+  catalog_replace_ = true;
   return true;
 }
 
@@ -439,10 +467,19 @@ bool FileArea::Save() {
   files_.at(0) = header_->u();
 
   const auto result = file.WriteVectorAndTruncate(files_);
-  if (result) {
-    dirty_ = false;
+  if (!result) {
+    return false;
   }
-  return result;
+  dirty_ = false;
+  file.Close();
+  if (catalog_replace_) {
+    api_->catalog().ReplaceArea(base_filename_, files_);
+  } else {
+    api_->catalog().Journal(catalog_changes_);
+  }
+  catalog_changes_.clear();
+  catalog_replace_ = false;
+  return true;
 }
 
 std::filesystem::path FileArea::path() const noexcept {
@@ -458,6 +495,17 @@ std::filesystem::path FileArea::ext_path() {
   return e.value()->path();
 }
 
+void FileArea::AddCatalogChange(file_catalog_op_t op, const uploadsrec& u) {
+  if (catalog_replace_) {
+    // The whole area will be replaced anyway.
+    return;
+  }
+  file_catalog_rec_t r{};
+  if (FileCatalog::to_rec(op, base_filename_, u, r)) {
+    catalog_changes_.push_back(r);
+  }
+}
+
 bool FileArea::ValidateFileNum(const FileRecord& f, int num) {
   const auto& o = stl::at(files_, num);
   if (f.aligned_filename() != o.filename) {
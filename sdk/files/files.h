@@ -21,6 +21,7 @@
 #include "dirs.h"
 #include "core/clock.h"
 #include "sdk/config.h"
+#include "sdk/files/file_catalog.h"
 #include "sdk/files/file_record.h"
 #include "sdk/files/files_ext.h"
 #include <filesystem>
@@ -56,9 +57,18 @@ public:
   [[nodiscard]] const core::Clock* clock() const noexcept;
   void set_clock(std::unique_ptr<core::Clock> clock);
 
+  /**
+   * Index of the files in all areas. Changes saved through FileArea are
+   * journaled here, the catalog is only read into memory once Refresh is called.
+   */
+  [[nodiscard]] FileCatalog& catalog();
+  /** Records the full contents of dir in the catalog. */
+  bool IndexArea(const directory_t& dir);
+
 private:
   std::string data_directory_;
   std::unique_ptr<core::Clock> clock_;
+  std::unique_ptr<FileCatalog> catalog_;
 };
 
 /**
@@ -155,13 +165,15 @@ public:
 
   // Gets the raw files
   [[nodiscard]] const std::vector<uploadsrec>& raw_files() const;
-  // Sets the raw files.  Do not use unless you are doing a "fix" type tool
+  // Sets the raw files.  Do not use unless you are doing a "fix" type tool.
+  // The whole area will be replaced in the catalog on the next Save.
   [[nodiscard]] bool set_raw_files(std::vector<uploadsrec>);
   [[nodiscard]] std::filesystem::path path() const noexcept;
   [[nodiscard]] std::filesystem::path ext_path();
 
 protected:
   bool ValidateFileNum(const FileRecord& f, int num);
+  void AddCatalogChange(file_catalog_op_t op, const uploadsrec& u);
 
   // Not owned.
   FileApi* api_;
@@ -173,6 +185,9 @@ protected:
   bool dirty_{false};
   bool open_{false};
   std::vector<uploadsrec> files_;
+  // Changes to journal to the file catalog on the next Save.
+  std::vector<file_catalog_rec_t> catalog_changes_;
+  bool catalog_replace_{false};
 
   std::unique_ptr<FileAreaHeader> header_;
   std::unique_ptr<FileAreaExtendedDesc> ext_desc_;
@@ -0,0 +1,223 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "sdk/latest_qscan.h"
+
+#include "core/datafile.h"
+#include "core/log.h"
+#include "core/strings.h"
+#include "sdk/filenames.h"
+#include "sdk/vardec.h"
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#include "core/wwiv_windows.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace wwiv::strings;
+
+namespace wwiv::sdk {
+
+static constexpr char kLatestQScanSignature[4] = {'W', 'Q', 'S', 'C'};
+static constexpr uint32_t kLatestQScanVersion = 2;
+static constexpr std::size_t kLatestQScanFileSize =
+    sizeof(latest_qscan_header_t) + sizeof(latest_qscan_slot_t) * kLatestQScanMaxSlots;
+
+enum : uint32_t { slot_unused = 0, slot_claimed = 1, slot_ready = 2 };
+
+// Reads the qscan pointer from status.dat, or 0 if it can not be read.
+static uint32_t read_qscan_pointer(const std::filesystem::path& datadir) {
+  core::DataFile<statusrec_t> file(datadir / STATUS_DAT,
+                                   core::File::modeBinary | core::File::modeReadOnly);
+  statusrec_t statusrec{};
+  if (!file || !file.Read(0, &statusrec)) {
+    return 0;
+  }
+  return statusrec.qscanptr;
+}
+
+LatestQScan::LatestQScan(const std::filesystem::path& datadir) {
+  const auto path = datadir / SUBQSCAN_DAT;
+#ifdef _WIN32
+  const auto h = CreateFileW(path.wstring().c_str(), GENERIC_READ | GENERIC_WRITE,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (h == INVALID_HANDLE_VALUE) {
+    LOG(ERROR) << "Unable to open: " << path.string();
+    return;
+  }
+  // Creating the mapping grows the file to the full size if needed.
+  mapping_handle_ = CreateFileMappingW(h, nullptr, PAGE_READWRITE, 0,
+                                       static_cast<DWORD>(kLatestQScanFileSize), nullptr);
+  CloseHandle(h);
+  if (mapping_handle_ == nullptr) {
+    LOG(ERROR) << "Unable to map: " << path.string();
+    return;
+  }
+  auto* p = MapViewOfFile(mapping_handle_, FILE_MAP_ALL_ACCESS, 0, 0, kLatestQScanFileSize);
+  if (p == nullptr) {
+    CloseHandle(mapping_handle_);
+    mapping_handle_ = nullptr;
+    LOG(ERROR) << "Unable to map: " << path.string();
+    return;
+  }
+#else
+  const auto fd = open(path.string().c_str(), O_RDWR | O_CREAT, 0660);
+  if (fd < 0) {
+    LOG(ERROR) << "Unable to open: " << path.string();
+    return;
+  }
+  struct stat st {};
+  // Growing the file fills it with zeros, which is an empty table.
+  if (fstat(fd, &st) != 0 ||
+      (static_cast<std::size_t>(st.st_size) < kLatestQScanFileSize &&
+       ftruncate(fd, static_cast<off_t>(kLatestQScanFileSize)) != 0)) {
+    close(fd);
+    LOG(ERROR) << "Unable to size: " << path.string();
+    return;
+  }
+  auto* p = mmap(nullptr, kLatestQScanFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    LOG(ERROR) << "Unable to map: " << path.string();
+    return;
+  }
+#endif
+  auto* header = static_cast<latest_qscan_header_t*>(p);
+  if (memcmp(header->signature, "\0\0\0\0", 4) == 0) {
+    // A new file. Two processes doing this at once write the same values,
+    // except for base where the first one wins.
+    auto unset = 0u;
+    header->base.compare_exchange_strong(unset, read_qscan_pointer(datadir));
+    header->version = kLatestQScanVersion;
+    header->num_slots = kLatestQScanMaxSlots;
+    header->slot_size = sizeof(latest_qscan_slot_t);
+    memcpy(header->signature, kLatestQScanSignature, sizeof(kLatestQScanSignature));
+  }
+  if (memcmp(header->signature, kLatestQScanSignature, 4) != 0 ||
+      header->version != kLatestQScanVersion || header->num_slots != kLatestQScanMaxSlots ||
+      header->slot_size != sizeof(latest_qscan_slot_t)) {
+    LOG(ERROR) << "Not compatible, delete it to recreate it: " << path.string();
+#ifdef _WIN32
+    UnmapViewOfFile(p);
+    CloseHandle(mapping_handle_);
+    mapping_handle_ = nullptr;
+#else
+    munmap(p, kLatestQScanFileSize);
+#endif
+    return;
+  }
+  header_ = header;
+  slots_ = reinterpret_cast<latest_qscan_slot_t*>(static_cast<char*>(p) +
+                                                  sizeof(latest_qscan_header_t));
+}
+
+LatestQScan::~LatestQScan() {
+  if (header_ == nullptr) {
+    return;
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(header_);
+  CloseHandle(mapping_handle_);
+#else
+  munmap(header_, kLatestQScanFileSize);
+#endif
+}
+
+// FNV-1a
+static uint32_t hash_key(const std::string& key) {
+  uint32_t h = 2166136261u;
+  for (const auto c : key) {
+    h = (h ^ static_cast<uint8_t>(c)) * 16777619u;
+  }
+  return h;
+}
+
+latest_qscan_slot_t* LatestQScan::find(const std::string& key, bool add) const {
+  if (slots_ == nullptr || key.empty() || key.size() >= sizeof(latest_qscan_slot_t::filename)) {
+    return nullptr;
+  }
+  const auto start = hash_key(key) % kLatestQScanMaxSlots;
+  for (auto i = 0; i < kLatestQScanMaxSlots; i++) {
+    auto& slot = slots_[(start + i) % kLatestQScanMaxSlots];
+    auto state = slot.state.load(std::memory_order_acquire);
+    if (state == slot_unused) {
+      if (!add) {
+        return nullptr;
+      }
+      if (slot.state.compare_exchange_strong(state, slot_claimed)) {
+        memset(slot.filename, 0, sizeof(slot.filename));
+        memcpy(slot.filename, key.data(), key.size());
+        slot.state.store(slot_ready, std::memory_order_release);
+        return &slot;
+      }
+    }
+    // Another process is writing the filename.  Give up on the slot if it
+    // never finishes, since that process may have died.
+    for (auto tries = 0; state == slot_claimed && tries < 1000; tries++) {
+      std::this_thread::yield();
+      state = slot.state.load(std::memory_order_acquire);
+    }
+    if (state == slot_ready && strncmp(slot.filename, key.c_str(), sizeof(slot.filename)) == 0) {
+      return &slot;
+    }
+  }
+  return nullptr;
+}
+
+template <typename T> static void store_max(std::atomic<T>& a, T value) {
+  auto current = a.load(std::memory_order_relaxed);
+  while (current < value && !a.compare_exchange_weak(current, value, std::memory_order_release)) {
+  }
+}
+
+void LatestQScan::Update(const std::string& sub_filename, uint32_t qscan) {
+  auto* slot = find(ToStringLowerCase(sub_filename), true);
+  if (slot == nullptr) {
+    VLOG(1) << "No room in " << SUBQSCAN_DAT << " for sub: " << sub_filename;
+    return;
+  }
+  store_max(slot->qscan, qscan);
+  const auto base = header_->base.load(std::memory_order_acquire);
+  if (base != 0 && qscan >= base) {
+    header_->recorded.fetch_add(1, std::memory_order_release);
+  }
+}
+
+uint32_t LatestQScan::latest(const std::string& sub_filename) const {
+  const auto* slot = find(ToStringLowerCase(sub_filename), false);
+  return slot == nullptr ? 0 : slot->qscan.load(std::memory_order_acquire);
+}
+
+bool LatestQScan::complete(uint32_t qscan_pointer) const {
+  if (header_ == nullptr) {
+    return false;
+  }
+  const auto base = header_->base.load(std::memory_order_acquire);
+  if (base == 0 || qscan_pointer < base) {
+    return false;
+  }
+  return header_->recorded.load(std::memory_order_acquire) == qscan_pointer - base;
+}
+
+} // namespace wwiv::sdk
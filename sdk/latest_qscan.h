@@ -0,0 +1,107 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_LATEST_QSCAN_H
+#define INCLUDED_SDK_LATEST_QSCAN_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace wwiv::sdk {
+
+static constexpr int kLatestQScanMaxSlots = 8192;
+
+/** The newest post on one sub in subqscan.dat */
+struct latest_qscan_slot_t {
+  // 0 when unused, 1 while the filename is being written and 2 once ready.
+  std::atomic<uint32_t> state;
+  // Highest qscan value posted to the sub.
+  std::atomic<uint32_t> qscan;
+  // Lowercase base filename of the sub (subboard_t::filename).
+  char filename[24];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "subqscan.dat is shared between processes so must be lock free.");
+
+/** Header of subqscan.dat, followed by kLatestQScanMaxSlots latest_qscan_slot_t */
+struct latest_qscan_header_t {
+  char signature[4];
+  uint32_t version;
+  uint32_t num_slots;
+  uint32_t slot_size;
+  // The qscan pointer in status.dat when the file was created, or 0 if it
+  // could not be read.
+  std::atomic<uint32_t> base;
+  // Number of posts recorded with a qscan value of at least base.
+  std::atomic<uint32_t> recorded;
+};
+
+/**
+ * The qscan value of the newest post on every sub, shared by all of the
+ * instances and network tools through a memory mapped file (subqscan.dat in
+ * the data directory).
+ *
+ * Everything that adds posts through add_post or WWIVMessageArea records the
+ * new qscan value here once the post is written, so a new scan can tell that
+ * a sub has nothing new without opening its .sub file.  Subs are found by
+ * hashing their filename and claim a slot with a compare-and-swap, so nothing
+ * ever locks the file.
+ *
+ * A sub missing from the table reads as 0, meaning unknown; callers must then
+ * look at the .sub file.  Every post takes one value from the qscan pointer in
+ * status.dat, so when something posts without updating the table (an older
+ * binary, for example) fewer posts are recorded than the pointer has moved
+ * since the file was created, and complete() stays false.  Delete
+ * subqscan.dat to start over once that has happened.
+ */
+class LatestQScan final {
+public:
+  /** Maps subqscan.dat in datadir, creating it if needed. */
+  explicit LatestQScan(const std::filesystem::path& datadir);
+  ~LatestQScan();
+  LatestQScan(const LatestQScan&) = delete;
+  LatestQScan& operator=(const LatestQScan&) = delete;
+
+  [[nodiscard]] bool is_open() const noexcept { return header_ != nullptr; }
+
+  /** Records a post with qscan on the sub named sub_filename.  Never lowers the value. */
+  void Update(const std::string& sub_filename, uint32_t qscan);
+  /** The qscan value of the newest post on sub_filename, or 0 when it is not known. */
+  [[nodiscard]] uint32_t latest(const std::string& sub_filename) const;
+  /**
+   * True when a post was recorded for every qscan value handed out since the
+   * file was created, up to qscan_pointer (the next one to be handed out, from
+   * status.dat), so that latest can be trusted.
+   */
+  [[nodiscard]] bool complete(uint32_t qscan_pointer) const;
+
+private:
+  [[nodiscard]] latest_qscan_slot_t* find(const std::string& key, bool add) const;
+
+  latest_qscan_header_t* header_{nullptr};
+  latest_qscan_slot_t* slots_{nullptr};
+#ifdef _WIN32
+  void* mapping_handle_{nullptr};
+#endif
+};
+
+} // namespace wwiv::sdk
+
+#endif
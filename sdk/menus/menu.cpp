@@ -284,6 +284,16 @@ static std::string generate_menu_item_line(generated_menu_56_t g, const std::str
 }
 
 std::vector<std::string> GenerateMenuLines(const Config& config, int eff_sl, const menu_56_t& menu, const sdk::User& user, menu_type_t typ) {
+  std::vector<bool> allowed;
+  for (const auto& mi : menu.items) {
+    auto [result, debug_lines] = acs::check_acs(config, &user, eff_sl, mi.acs);
+    allowed.push_back(result);
+  }
+  return GenerateMenuLines(menu, user.GetScreenChars(), allowed, typ);
+}
+
+std::vector<std::string> GenerateMenuLines(const menu_56_t& menu, int screen_chars,
+                                           const std::vector<bool>& allowed, menu_type_t typ) {
   std::vector<std::string> out;
   out.emplace_back("|#0");
 
@@ -291,7 +301,7 @@ std::vector<std::string> GenerateMenuLines(const Config& config, int eff_sl, con
   const auto& g = menu.generated_menu;
   const auto& title = menu.title;
   const auto num_cols = typ == menu_type_t::short_menu ? g.num_cols : 1;
-  const auto screen_width = user.GetScreenChars() - num_cols + 1;
+  const auto screen_width = screen_chars - num_cols + 1;
   const auto col_width =
       typ == menu_type_t::short_menu ? screen_width / num_cols : screen_width - 1;
   if (!title.empty()) {
@@ -306,11 +316,12 @@ std::vector<std::string> GenerateMenuLines(const Config& config, int eff_sl, con
     ++lines_displayed;
   }
   auto just_nled = false;
-  for (const auto& mi : menu.items) {
+  for (auto i = 0; i < ssize(menu.items); i++) {
+    const auto& mi = menu.items[i];
     if (mi.item_key.empty()) {
       continue;
     }
-    if (auto [result, debug_lines] = acs::check_acs(config, &user, eff_sl, mi.acs); !result) {
+    if (i >= ssize(allowed) || !allowed[i]) {
       continue;
     }
     if (!g.show_empty_text && StringTrim(mi.item_text).empty()) {
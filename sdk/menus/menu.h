@@ -266,6 +266,13 @@ enum class menu_type_t { short_menu, long_menu };
 std::vector<std::string> GenerateMenuLines(const Config& config, int eff_sl, const menu_56_t& menu,
                                            const sdk::User& user, menu_type_t typ);
 
+/**
+ * Generates the menu for a screen screen_chars wide, where allowed[i] is the
+ * result of the ACS check for menu.items[i].
+ */
+std::vector<std::string> GenerateMenuLines(const menu_56_t& menu, int screen_chars,
+                                           const std::vector<bool>& allowed, menu_type_t typ);
+
 
 } 
 #endif
\ No newline at end of file
@@ -173,6 +173,13 @@ WWIVEmail* WWIVMessageApi::OpenEmail() {
   return new WWIVEmail(config_, data, text, stl::size_int(net_networks_));
 }
 
+LatestQScan& WWIVMessageApi::latest_qscan() {
+  if (!latest_qscan_) {
+    latest_qscan_ = std::make_unique<LatestQScan>(subs_directory_);
+  }
+  return *latest_qscan_;
+}
+
 uint32_t WWIVMessageApi::last_read(int area) const {
   if (last_read_) {
     return last_read_->last_read(area);
@@ -19,6 +19,7 @@
 #define INCLUDED_SDK_MSGAPI_MESSAGE_API_WWIV_H
 
 #include "sdk/config.h"
+#include "sdk/latest_qscan.h"
 #include "sdk/msgapi/email_wwiv.h"
 #include "sdk/msgapi/message_api.h"
 #include "sdk/net/net.h"
@@ -67,10 +68,13 @@ public:
   [[nodiscard]] uint32_t last_read(int area) const;
   void set_last_read(int area, uint32_t last_read);
   [[nodiscard]] const Config& config() const noexcept { return config_; }
+  /** The shared table of the newest post on each sub, mapped on first use. */
+  [[nodiscard]] LatestQScan& latest_qscan();
 
 private:
   std::unique_ptr<WWIVLastReadImpl> last_read_;
   const Config config_;
+  std::unique_ptr<LatestQScan> latest_qscan_;
 };
 
 } // namespace
@@ -343,46 +343,34 @@ static uint32_t next_qscan_value_and_increment_post(const string& bbsdir) {
  * Returns the number of messages deleted.
  */
 int WWIVMessageArea::DeleteExcess() {
-  if (api_->options().overflow_strategy == OverflowStrategy::delete_none) {
+  const auto strategy = api_->options().overflow_strategy;
+  if (strategy == OverflowStrategy::delete_none) {
     LOG(INFO) << "overflow_strategy is delete_none. Not deleting overflow messages";
     return 0;
   }
 
-  int result = 0;
-  auto done = false;
-  while (!done) {
-    if (api_->options().overflow_strategy == OverflowStrategy::delete_one) {
-      LOG(INFO) << "overflow_strategy is delete_one.";
-      done = true;
-    }
-    const auto num = number_of_messages();
-    if (num <= max_messages_) {
-      VLOG(1) << "No overflow messages. " << num << " <= " << max_messages_;
-      return result;
-    }
-    int i = 1;
-    int dm = 0;
-    while (i <= number_of_messages()) {
-      const auto pp = ReadMessageHeader(i);
-      if (!pp) {
-        break;
-      }
-      if (!pp->locked()) {
-        dm = i;
-        break;
-      }
-      ++i;
-    }
-    if (dm == 0) {
-      LOG(INFO) << "DeleteExcess: No message to delete.";
-      return result;
-    }
-    if (!DeleteMessage(dm)) {
-      LOG(INFO) << "DeleteExcess: Failed to delete message #" << dm;
-      return result;
+  const auto num = number_of_messages();
+  if (num <= max_messages_) {
+    VLOG(1) << "No overflow messages. " << num << " <= " << max_messages_;
+    return 0;
+  }
+  auto remaining = num - max_messages_;
+  if (strategy == OverflowStrategy::delete_one) {
+    LOG(INFO) << "overflow_strategy is delete_one.";
+    remaining = 1;
+  }
+  // Delete the oldest messages that are not locked.
+  const auto result = DeleteMessages([&remaining](int, const postrec& p) {
+    if (remaining <= 0 || (p.status & status_no_delete)) {
+      return false;
     }
-    LOG(INFO) << "DeleteExcess: Deleted message #" << dm;
-    ++result;
+    --remaining;
+    return true;
+  });
+  if (result == 0) {
+    LOG(INFO) << "DeleteExcess: No message to delete.";
+  } else {
+    LOG(INFO) << "DeleteExcess: Deleted " << result << " messages.";
   }
   return result;
 }
@@ -496,53 +484,76 @@ bool WWIVMessageArea::AddMessage(const Message& message, const MessageAreaOption
   p.msg = msg.value();
   auto result = add_post(p);
   if (result) {
+    wwiv_api_->latest_qscan().Update(sub_.filename, p.qscan);
     DeleteExcess();
   }
   return result;
 }
 
 bool WWIVMessageArea::DeleteMessage(int message_number) {
-  const auto num_messages = number_of_messages();
-  if (message_number < 1) {
-    return false;
-  }
-  if (message_number > num_messages) {
-    return false;
-  }
+  return DeleteMessages(message_number, message_number) == 1;
+}
+
+int WWIVMessageArea::DeleteMessages(int start, int end) {
+  return DeleteMessages(
+      [start, end](int message_number, const postrec&) {
+        return message_number >= start && message_number <= end;
+      });
+}
 
-  DataFile<postrec> sub(sub_filename_,
-                        File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+int WWIVMessageArea::DeleteMessages(const std::function<bool(int, const postrec&)>& pred) {
+  DataFile<postrec> sub(sub_filename_, File::modeBinary | File::modeReadWrite);
   if (!sub) {
     // TODO: throw exception
-    return false;
+    return 0;
   }
-  postrec post{};
-  sub.Read(message_number, &post);
-  if (post.msg.storage_type != 2) {
+  auto wwiv_header = ReadHeader(sub);
+  if (!wwiv_header->initialized()) {
+    return 0;
+  }
+  // Record 0 is the header.
+  std::vector<postrec> posts;
+  if (!sub.Seek(0) || !sub.ReadVector(posts, wwiv_header->active_message_count() + 1)) {
+    return 0;
+  }
+  const auto num_messages = ssize(posts) - 1;
+
+  std::vector<messagerec> deleted;
+  auto first_deleted = 0;
+  auto dest = 1;
+  for (auto i = 1; i <= num_messages; i++) {
+    const auto& post = posts[i];
     // We only support type-2 on the WWIV API.
-    return false;
+    if (post.msg.storage_type == 2 && pred(i, post)) {
+      if (first_deleted == 0) {
+        first_deleted = i;
+      }
+      deleted.push_back(post.msg);
+      continue;
+    }
+    if (dest != i) {
+      posts[dest] = post;
+    }
+    ++dest;
+  }
+  if (deleted.empty()) {
+    return 0;
   }
 
-  // Remove text.  Ignore the return code, try to remove the header anyway.
-  (void)remove_link(post.msg);
+  // Remove text.  Ignore the return code, try to remove the headers anyway.
+  (void)remove_links(deleted);
 
-  // Remove post record.
-  for (auto cur = message_number + 1; cur <= num_messages; cur++) {
-    postrec tmp{};
-    sub.Read(cur, &tmp);
-    sub.Write(cur - 1, &tmp);
+  // Rewrite everything after the first deleted post and drop the rest.
+  const auto num_remaining = dest - 1;
+  if (dest > first_deleted) {
+    sub.Seek(first_deleted);
+    sub.Write(&posts[first_deleted], dest - first_deleted);
   }
+  sub.file().set_length(dest * static_cast<File::size_type>(sizeof(postrec)));
 
-  // Update header.
-  postrec header{};
-  sub.Read(0, &header);
-  // decrement number of posts.
-  // TODO(rushfan): Should we check these?
-  --header.owneruser;
-  header.owneruser = static_cast<uint16_t>(std::max(0, num_messages - 1));
-  sub.Write(0, &header);
-
-  return true;
+  wwiv_header->set_active_message_count(static_cast<uint16_t>(num_remaining));
+  WriteHeader(sub, *wwiv_header);
+  return ssize(deleted);
 }
 
 bool WWIVMessageArea::ResyncMessage(int& message_number) {
@@ -24,6 +24,7 @@
 #include "sdk/msgapi/type2_text.h"
 #include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -99,6 +100,15 @@ public:
   std::unique_ptr<MessageText> ReadMessageText(int message_number) override;
   bool AddMessage(const Message& message, const MessageAreaOptions& options) override;
   bool DeleteMessage(int message_number) override;
+  /**
+   * Deletes every message for which pred(message_number, post) returns true.
+   * The remaining headers are compacted in one pass over the .sub file, and the
+   * text of all of the deleted messages is freed with one GAT update per section.
+   * Only type-2 messages are deleted. Returns the number of messages deleted.
+   */
+  int DeleteMessages(const std::function<bool(int, const postrec&)>& pred);
+  /** Deletes messages start through end (inclusive). Returns the number deleted. */
+  int DeleteMessages(int start, int end);
   bool ResyncMessage(int& message_number) override;
   bool ResyncMessage(int& message_number, Message& message) override;
 
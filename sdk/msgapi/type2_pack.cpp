@@ -0,0 +1,237 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "sdk/msgapi/type2_pack.h"
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "core/stl.h"
+#include "sdk/msgapi/type2_text.h"
+#include "sdk/vardec.h"
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace wwiv::core;
+using namespace wwiv::stl;
+
+namespace wwiv::sdk::msgapi {
+
+namespace {
+
+/** Reads message text chains from an existing type-2 text file. */
+class Type2Reader {
+public:
+  explicit Type2Reader(File& file) : file_(file) {}
+
+  /**
+   * Returns the raw blocks of the chain starting at msg, or std::nullopt if
+   * the chain is empty or broken.
+   */
+  std::optional<std::string> ReadChain(const messagerec& msg) {
+    const auto section = static_cast<int>(msg.stored_as / GAT_NUMBER_ELEMENTS);
+    const auto& gat = gat_for(section);
+    std::vector<int> blocks;
+    for (auto current = static_cast<int>(msg.stored_as % GAT_NUMBER_ELEMENTS);
+         current > 0 && current < GAT_NUMBER_ELEMENTS; current = gat[current]) {
+      if (ssize(blocks) >= GAT_NUMBER_ELEMENTS) {
+        // The GAT has a loop in it.
+        return std::nullopt;
+      }
+      blocks.push_back(current);
+    }
+    if (blocks.empty()) {
+      return std::nullopt;
+    }
+
+    std::string out(blocks.size() * MSG_BLOCK_SIZE, '\0');
+    // Read each run of consecutive blocks with a single read.
+    for (auto i = 0; i < ssize(blocks);) {
+      auto run = 1;
+      while (i + run < ssize(blocks) && blocks[i + run] == blocks[i] + run) {
+        ++run;
+      }
+      const auto pos = static_cast<File::size_type>(section) * GATSECLEN + GAT_SECTION_SIZE +
+                       static_cast<File::size_type>(blocks[i]) * MSG_BLOCK_SIZE;
+      if (file_.Seek(pos, File::Whence::begin) != pos) {
+        return std::nullopt;
+      }
+      // A short read leaves the rest of the blocks zeroed, the same as readfile.
+      if (file_.Read(&out[i * MSG_BLOCK_SIZE], run * MSG_BLOCK_SIZE) < 0) {
+        return std::nullopt;
+      }
+      i += run;
+    }
+    return {out};
+  }
+
+private:
+  const std::vector<gati_t>& gat_for(int section) {
+    if (const auto it = gats_.find(section); it != std::end(gats_)) {
+      return it->second;
+    }
+    std::vector<gati_t> gat(GAT_NUMBER_ELEMENTS);
+    const auto pos = static_cast<File::size_type>(section) * GATSECLEN;
+    if (file_.Seek(pos, File::Whence::begin) == pos) {
+      file_.Read(&gat[0], GAT_SECTION_SIZE);
+    }
+    return gats_.emplace(section, std::move(gat)).first->second;
+  }
+
+  File& file_;
+  std::map<int, std::vector<gati_t>> gats_;
+};
+
+/** Writes a new type-2 text file one section at a time. */
+class Type2Writer {
+public:
+  explicit Type2Writer(File& file) : file_(file) {}
+
+  /** Adds the chain of raw blocks, returning where it was stored. */
+  std::optional<messagerec> Add(const std::string& blocks) {
+    const auto num_blocks = static_cast<int>(blocks.size() / MSG_BLOCK_SIZE);
+    if (num_blocks >= GAT_NUMBER_ELEMENTS) {
+      return std::nullopt;
+    }
+    if (next_ + num_blocks > GAT_NUMBER_ELEMENTS) {
+      if (!Flush()) {
+        return std::nullopt;
+      }
+      ++section_;
+      next_ = 1;
+    }
+    const auto first = next_;
+    for (auto i = 0; i < num_blocks; i++) {
+      const auto b = first + i;
+      gat_[b] = (i + 1 < num_blocks) ? static_cast<gati_t>(b + 1) : static_cast<gati_t>(-1);
+    }
+    data_.append(blocks);
+    next_ += num_blocks;
+
+    messagerec m{};
+    m.storage_type = STORAGE_TYPE;
+    m.stored_as = static_cast<uint32_t>(section_) * GAT_NUMBER_ELEMENTS + first;
+    return {m};
+  }
+
+  /** Writes the current section. */
+  bool Flush() {
+    if (next_ == 1 && section_ > 0) {
+      return true;
+    }
+    const auto pos = static_cast<File::size_type>(section_) * GATSECLEN;
+    if (file_.Seek(pos, File::Whence::begin) != pos) {
+      return false;
+    }
+    if (file_.Write(&gat_[0], GAT_SECTION_SIZE) != GAT_SECTION_SIZE) {
+      return false;
+    }
+    if (!data_.empty() && file_.Write(data_) != ssize(data_)) {
+      return false;
+    }
+    std::fill(std::begin(gat_), std::end(gat_), static_cast<gati_t>(0));
+    // Block 0 is never used, but keep its space so the offsets line up.
+    data_.assign(MSG_BLOCK_SIZE, '\0');
+    return true;
+  }
+
+  [[nodiscard]] int num_sections() const noexcept { return section_ + 1; }
+
+private:
+  File& file_;
+  int section_{0};
+  // Next free block in the current section.
+  int next_{1};
+  std::vector<gati_t> gat_ = std::vector<gati_t>(GAT_NUMBER_ELEMENTS);
+  // Blocks of the current section, starting at block 0.
+  std::string data_ = std::string(MSG_BLOCK_SIZE, '\0');
+};
+
+} // namespace
+
+std::optional<type2_pack_stats_t> pack_type2_area(const std::filesystem::path& sub_fn,
+                                                  const std::filesystem::path& dat_fn,
+                                                  const std::filesystem::path& new_sub_fn,
+                                                  const std::filesystem::path& new_dat_fn) {
+  std::vector<postrec> posts;
+  {
+    DataFile<postrec> sub(sub_fn, File::modeBinary | File::modeReadOnly);
+    if (!sub || !sub.ReadVector(posts) || posts.empty()) {
+      LOG(ERROR) << "Unable to read: " << sub_fn;
+      return std::nullopt;
+    }
+  }
+  auto& header = *reinterpret_cast<subfile_header_t*>(&posts[0]);
+  const auto num_messages =
+      std::min<int>(header.active_message_count, ssize(posts) - 1);
+
+  File dat(dat_fn);
+  if (!dat.Open(File::modeBinary | File::modeReadOnly)) {
+    LOG(ERROR) << "Unable to read: " << dat_fn;
+    return std::nullopt;
+  }
+  File new_dat(new_dat_fn);
+  if (!new_dat.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite |
+                    File::modeTruncate)) {
+    LOG(ERROR) << "Unable to create: " << new_dat_fn;
+    return std::nullopt;
+  }
+
+  type2_pack_stats_t stats{};
+  Type2Reader reader(dat);
+  Type2Writer writer(new_dat);
+  auto dest = 1;
+  for (auto i = 1; i <= num_messages; i++) {
+    auto post = posts[i];
+    if (post.msg.storage_type == STORAGE_TYPE) {
+      auto blocks = reader.ReadChain(post.msg);
+      if (!blocks) {
+        LOG(ERROR) << "Unable to read the text of message #" << i << "; title: " << post.title;
+        ++stats.dropped;
+        continue;
+      }
+      auto m = writer.Add(blocks.value());
+      if (!m) {
+        LOG(ERROR) << "Unable to write the text of message #" << i << "; title: " << post.title;
+        ++stats.dropped;
+        continue;
+      }
+      post.msg = m.value();
+    }
+    posts[dest++] = post;
+    ++stats.messages;
+  }
+  if (!writer.Flush()) {
+    LOG(ERROR) << "Unable to write: " << new_dat_fn;
+    return std::nullopt;
+  }
+  stats.sections = writer.num_sections();
+
+  posts.resize(dest);
+  header.active_message_count = static_cast<uint16_t>(stats.messages);
+  header.mod_count++;
+  DataFile<postrec> new_sub(new_sub_fn, File::modeBinary | File::modeCreateFile |
+                                            File::modeReadWrite | File::modeTruncate);
+  if (!new_sub || !new_sub.WriteVector(posts)) {
+    LOG(ERROR) << "Unable to write: " << new_sub_fn;
+    return std::nullopt;
+  }
+  return {stats};
+}
+
+} // namespace wwiv::sdk::msgapi
@@ -0,0 +1,53 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_SDK_MSGAPI_TYPE2_PACK_H
+#define INCLUDED_SDK_MSGAPI_TYPE2_PACK_H
+
+#include <filesystem>
+#include <optional>
+
+namespace wwiv::sdk::msgapi {
+
+struct type2_pack_stats_t {
+  // Number of messages copied to the packed area.
+  int messages{0};
+  // Number of messages dropped since their text could not be read.
+  int dropped{0};
+  // Number of GAT sections in the packed text file.
+  int sections{0};
+};
+
+/**
+ * Packs a WWIV type-2 message area (sub_fn and dat_fn) into new_sub_fn and
+ * new_dat_fn.
+ *
+ * The text blocks of each message are copied as-is into the new text file, in
+ * message order, with every chain laid out contiguously and the sections
+ * filled one after another.  Each section of the new file and the new .sub
+ * file are written once.  Messages that are not type-2 are copied unchanged.
+ *
+ * Returns std::nullopt if either of the areas can not be read or written.
+ */
+std::optional<type2_pack_stats_t> pack_type2_area(const std::filesystem::path& sub_fn,
+                                                  const std::filesystem::path& dat_fn,
+                                                  const std::filesystem::path& new_sub_fn,
+                                                  const std::filesystem::path& new_dat_fn);
+
+} // namespace wwiv::sdk::msgapi
+
+#endif
@@ -22,6 +22,7 @@
 #include "core/stl.h"
 #include "core/strings.h"
 #include "sdk/vardec.h"
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -50,19 +51,33 @@ Type2Text::Type2Text(std::filesystem::path p) : path_(std::move(p)) {}
 // Implementation Details
 
 bool Type2Text::remove_link(const messagerec& msg) {
+  return remove_links({msg});
+}
+
+bool Type2Text::remove_links(const std::vector<messagerec>& msgs) {
+  if (msgs.empty()) {
+    return true;
+  }
   auto file = OpenMessageFile();
   if (!file || !file->IsOpen()) {
     return false;
   }
-  const auto section = static_cast<int>(msg.stored_as / GAT_NUMBER_ELEMENTS);
-  auto gat = load_gat(*file, section);
-  auto current_section = msg.stored_as % GAT_NUMBER_ELEMENTS;
-  while (current_section > 0 && current_section < GAT_NUMBER_ELEMENTS) {
-    const uint32_t next_section = static_cast<long>(gat[current_section]);
-    gat[current_section] = 0;
-    current_section = next_section;
+  std::map<int, std::vector<uint32_t>> sections;
+  for (const auto& msg : msgs) {
+    const auto section = static_cast<int>(msg.stored_as / GAT_NUMBER_ELEMENTS);
+    sections[section].push_back(msg.stored_as % GAT_NUMBER_ELEMENTS);
+  }
+  for (const auto& [section, starts] : sections) {
+    auto gat = load_gat(*file, section);
+    for (auto current_section : starts) {
+      while (current_section > 0 && current_section < GAT_NUMBER_ELEMENTS) {
+        const uint32_t next_section = static_cast<long>(gat[current_section]);
+        gat[current_section] = 0;
+        current_section = next_section;
+      }
+    }
+    save_gat(*file, section, gat);
   }
-  save_gat(*file, section, gat);
   file->Close();
   return true;
 }
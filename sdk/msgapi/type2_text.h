@@ -47,6 +47,11 @@ public:
   [[nodiscard]] std::optional<std::string> readfile(const messagerec& msg);
   [[nodiscard]] std::optional<messagerec> savefile(const std::string& text);
   [[nodiscard]] bool remove_link(const messagerec& msg);
+  /**
+   * Frees the text of all of msgs, loading and saving the GAT of each section
+   * used only once.
+   */
+  [[nodiscard]] bool remove_links(const std::vector<messagerec>& msgs);
 
 private:
   [[nodiscard]] std::optional<core::File> OpenMessageFile() const;
@@ -194,6 +194,13 @@ bool FtnMessageDupe::add(const FidoPackedMessage& msg) {
 }
 
 bool FtnMessageDupe::add(uint32_t header_crc32, uint32_t msgid_crc32) {
+  if (!add_deferred(header_crc32, msgid_crc32)) {
+    return false;
+  }
+  return Save();
+}
+
+bool FtnMessageDupe::add_deferred(uint32_t header_crc32, uint32_t msgid_crc32) {
   if (header_crc32 != 0) {
     header_dupes_.insert(header_crc32);
   }
@@ -206,7 +213,7 @@ bool FtnMessageDupe::add(uint32_t header_crc32, uint32_t msgid_crc32) {
   ids.msgid = msgid_crc32;
 
   dupes_.emplace_back(ids);
-  return Save();
+  return true;
 }
 
 bool FtnMessageDupe::remove(uint32_t header_crc32, uint32_t msgid_crc32) {
@@ -47,6 +47,13 @@ public:
   [[nodiscard]] std::string CreateMessageID(const fido::FidoAddress& a);
   bool add(const fido::FidoPackedMessage& msg);
   bool add(uint32_t header_crc32, uint32_t msgid_crc32);
+  /**
+   * Adds the crcs to the in-memory dupe list without rewriting MSGDUPE.DAT.
+   * Used by batch imports, which must call Save() once the batch is written.
+   */
+  bool add_deferred(uint32_t header_crc32, uint32_t msgid_crc32);
+  /** Writes the dupe list (including any deferred entries) to MSGDUPE.DAT */
+  bool Save();
   bool remove(uint32_t header_crc32, uint32_t msgid_crc32);
   /** returns true if either the header or msgid crc is duplicated */
   [[nodiscard]] bool is_dupe(uint32_t header_crc32, uint32_t msgid_crc32) const;
@@ -65,7 +72,6 @@ public:
 
 private:
   bool Load();
-  bool Save();
 
   bool initialized_;
   std::string datadir_;
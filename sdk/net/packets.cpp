@@ -20,11 +20,15 @@
 #include "core/datetime.h"
 #include "core/file.h"
 #include "core/log.h"
+#include "core/stl.h"
 #include "core/strings.h"
 #include "core/version.h"
 #include "fmt/format.h"
 #include "sdk/filenames.h"
 #include "sdk/net/subscribers.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <string>
 #include <utility>
 
@@ -106,6 +110,89 @@ std::tuple<Packet, ReadPacketResponse>  read_packet(File& f, bool process_de) {
   return std::make_tuple(packet, ReadPacketResponse::OK);
 }
 
+PacketView::PacketView(const net_header_rec& h, const char* list, std::string_view text)
+    : nh_(h), list_(list), text_(text) {}
+
+uint16_t PacketView::list(int i) const noexcept {
+  uint16_t node;
+  memcpy(&node, list_ + i * sizeof(uint16_t), sizeof(uint16_t));
+  return node;
+}
+
+std::vector<uint16_t> PacketView::list_vector() const {
+  std::vector<uint16_t> list(nh_.list_len);
+  if (!list.empty()) {
+    memcpy(&list[0], list_, list.size() * sizeof(uint16_t));
+  }
+  return list;
+}
+
+Packet PacketView::ToPacket() const {
+  Packet p{};
+  p.nh = nh_;
+  p.list = list_vector();
+  p.set_text(std::string(text_));
+  return p;
+}
+
+PacketReader::PacketReader(const std::filesystem::path& path, bool process_de)
+    : file_(path), process_de_(process_de) {}
+
+bool PacketReader::Open() {
+  pos_ = 0;
+  return file_.Open();
+}
+
+std::tuple<PacketView, ReadPacketResponse> PacketReader::Next() {
+  const auto remaining = file_.size() - pos_;
+  if (remaining == 0) {
+    // at the end of the packet.
+    return std::make_tuple(PacketView{}, ReadPacketResponse::END_OF_FILE);
+  }
+  if (remaining < sizeof(net_header_rec)) {
+    LOG(INFO) << "error reading header, got short read of size: " << remaining
+              << "; expected: " << sizeof(net_header_rec);
+    return std::make_tuple(PacketView{}, ReadPacketResponse::ERROR);
+  }
+  const auto* data = file_.data() + pos_;
+  net_header_rec nh{};
+  memcpy(&nh, data, sizeof(net_header_rec));
+  auto pos = pos_ + sizeof(net_header_rec);
+
+  if (nh.method > 0) {
+    LOG(INFO) << "compression: de" << nh.method;
+  }
+
+  const auto* list = file_.data() + pos;
+  const auto list_size = sizeof(uint16_t) * nh.list_len;
+  if (file_.size() - pos < list_size) {
+    LOG(INFO) << "error reading list, got short read of size: " << file_.size() - pos
+              << "; expected: " << list_size;
+    return std::make_tuple(PacketView{}, ReadPacketResponse::ERROR);
+  }
+  pos += list_size;
+
+  if (nh.length > static_cast<uint32_t>(std::numeric_limits<int32_t>::max())) {
+    LOG(INFO) << "error reading header, got length too big (underflow?): " << nh.length;
+    return std::make_tuple(PacketView{}, ReadPacketResponse::ERROR);
+  }
+  std::size_t length = nh.length;
+  if (nh.method > 0 && process_de_ && length > 146 /* Make sure we have enough for a header */) {
+    // HACK - this should do this in a shim DE
+    // 146 is the sizeof EN/DE header.
+    const std::string de_header(file_.data() + pos, std::min<std::size_t>(146, file_.size() - pos));
+    LOG(INFO) << de_header.c_str();
+    length -= 146;
+    pos += de_header.size();
+  }
+  // Like read_packet, use whatever text is there when the file is short.
+  length = std::min(length, file_.size() - pos);
+  nh.length = static_cast<uint32_t>(length);
+  const std::string_view text(file_.data() + pos, length);
+  pos_ = pos + length;
+  return std::make_tuple(PacketView(nh, list, text), ReadPacketResponse::OK);
+}
+
 bool write_wwivnet_packet(const string& filename, const net_networks_rec& net, const Packet& p) {
   VLOG(2) << "write_wwivnet_packet: " << filename;
   LOG(INFO) << "write_wwivnet_packet: Writing type " << p.nh.main_type << "/" << p.nh.minor_type
@@ -142,6 +229,81 @@ bool write_wwivnet_packet(const string& filename, const net_networks_rec& net, c
   return true;
 }
 
+bool write_wwivnet_packet(const std::string& filename, const net_networks_rec& net,
+                          const PacketView& p) {
+  VLOG(2) << "write_wwivnet_packet: " << filename;
+  LOG(INFO) << "write_wwivnet_packet: Writing type " << p.nh().main_type << "/"
+            << p.nh().minor_type << " message to packet: " << filename;
+  File file(FilePath(net.dir, filename));
+  if (!file.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
+    LOG(ERROR) << "Error while writing packet: " << net.dir << filename << "Unable to open file.";
+    return false;
+  }
+  file.Seek(0L, File::Whence::end);
+  const auto num = file.Write(&p.nh(), sizeof(net_header_rec));
+  if (num != sizeof(net_header_rec)) {
+    LOG(ERROR) << "Error while writing packet: " << net.dir << filename << " num written (" << num
+               << ") != net_header_rec size.";
+    return false;
+  }
+  if (p.list_size() > 0) {
+    const auto list = p.list_vector();
+    file.Write(&list[0], sizeof(uint16_t) * list.size());
+  }
+  if (!p.text().empty()) {
+    file.Write(p.text().data(), static_cast<File::size_type>(p.text().size()));
+  }
+  return true;
+}
+
+bool write_wwivnet_packets(const std::string& filename, const net_networks_rec& net,
+                           const std::vector<Packet>& packets) {
+  if (packets.empty()) {
+    return true;
+  }
+  VLOG(2) << "write_wwivnet_packets: " << filename << "; num packets: " << packets.size();
+  std::string buffer;
+  size_t total = 0;
+  for (const auto& p : packets) {
+    total += sizeof(net_header_rec) + p.list.size() * sizeof(uint16_t) + p.text().size();
+  }
+  buffer.reserve(total);
+  for (const auto& p : packets) {
+    if (p.nh.length != p.text().size()) {
+      LOG(ERROR) << "Error while writing packet: " << net.dir << filename;
+      LOG(ERROR) << "Mismatched text and p.nh.length.  text =" << p.text().size()
+                 << " nh.length = " << p.nh.length;
+      return false;
+    }
+    if (p.nh.list_len != p.list.size()) {
+      LOG(ERROR) << "p.nh.list_len [" << p.nh.list_len << "] != p.list.size() ["
+                 << p.list.size() << "]";
+      return false;
+    }
+    buffer.append(reinterpret_cast<const char*>(&p.nh), sizeof(net_header_rec));
+    if (p.nh.list_len) {
+      buffer.append(reinterpret_cast<const char*>(&p.list[0]),
+                    sizeof(uint16_t) * p.nh.list_len);
+    }
+    buffer.append(p.text());
+  }
+
+  File file(FilePath(net.dir, filename));
+  if (!file.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
+    LOG(ERROR) << "Error while writing packet: " << net.dir << filename << "Unable to open file.";
+    return false;
+  }
+  file.Seek(0L, File::Whence::end);
+  const auto size = static_cast<File::size_type>(buffer.size());
+  const auto num = file.Write(buffer.data(), size);
+  if (num != size) {
+    LOG(ERROR) << "Error while writing packets: " << net.dir << filename << " num written ("
+               << num << ") != " << size;
+    return false;
+  }
+  return true;
+}
+
 static string NetInfoFileName(uint16_t type) {
   switch (type) {
   case net_info_bbslist:
@@ -220,7 +382,7 @@ NetInfoFileInfo GetNetInfoFileInfo(Packet& p) {
   return info;
 }
 
-static bool need_to_update_routing(uint16_t main_type) {
+bool need_to_update_routing(uint16_t main_type) {
   switch (main_type) {
   case main_type_email:
   case main_type_post:
@@ -325,17 +487,13 @@ uint16_t get_forsys(const wwiv::sdk::BbsListNet& b, uint16_t node) {
     return 0;
   }
 
-  auto n = b.node_config_for(node);
-  if (!n) {
-    VLOG(2) << "get_forsys: no route to node: " << node;
-    return WWIVNET_NO_NODE;
-  }
-  if (n->forsys == WWIVNET_NO_NODE) {
+  const auto forsys = b.forsys(node);
+  if (forsys == WWIVNET_NO_NODE) {
     VLOG(2) << "get_forsys: no route to node: " << node;
     return WWIVNET_NO_NODE;
   }
-  VLOG(2) << "get_forsys: route to node: " << node << "; is through node: " << n->forsys;
-  return n->forsys;
+  VLOG(2) << "get_forsys: route to node: " << node << "; is through node: " << forsys;
+  return forsys;
 }
 
 // static
@@ -600,6 +758,43 @@ bool write_wwivnet_packet_or_log(const net_networks_rec& net, char network_app_i
   return true;
 }
 
+// Flush once this much has been buffered, so that a large batch of posts
+// does not need to be held in memory until the end.
+static constexpr std::size_t kMaxPendingBytes = 4 * 1024 * 1024;
+
+PendingPacketWriter::PendingPacketWriter(char network_app_id) : network_app_id_(network_app_id) {}
+
+PendingPacketWriter::~PendingPacketWriter() { Flush(); }
+
+void PendingPacketWriter::Add(const net_networks_rec& net, Packet p) {
+  pending_bytes_ += sizeof(net_header_rec) + p.list.size() * sizeof(uint16_t) + p.text().size();
+  auto it = pending_.find(net.dir);
+  if (it == pending_.end()) {
+    it = pending_.emplace(net.dir, std::make_pair(net, std::vector<Packet>{})).first;
+  }
+  it->second.second.emplace_back(std::move(p));
+  if (pending_bytes_ > kMaxPendingBytes) {
+    Flush();
+  }
+}
+
+bool PendingPacketWriter::Flush() {
+  auto result = true;
+  for (const auto& [dir, e] : pending_) {
+    const auto& [net, packets] = e;
+    const auto fn = create_pend(dir, false, network_app_id_);
+    if (fn.empty() || !write_wwivnet_packets(fn, net, packets)) {
+      LOG(ERROR) << "Error writing packets: " << dir.string() << " " << fn;
+      result = false;
+      continue;
+    }
+    VLOG(1) << "Wrote " << packets.size() << " packets: " << fn;
+  }
+  pending_.clear();
+  pending_bytes_ = 0;
+  return result;
+}
+
 /**
  * Sends the post out via WWIVnet or other networks to the other parties if needed.
  *
@@ -609,10 +804,23 @@ bool send_post_to_subscribers(const std::vector<net_networks_rec>& nets, int ori
                               const std::string& original_subtype, const subboard_t& sub,
                               Packet& template_packet, const std::set<uint16_t>& subscribers_to_skip,
                               const subscribers_send_to_t& send_to) {
+  SubscriberCache subscribers;
+  // TODO(rushfan): Replace '2' with a network_app_id passed in
+  PendingPacketWriter writer('2');
+  if (!send_post_to_subscribers(nets, original_net_num, original_subtype, sub, template_packet,
+                                subscribers_to_skip, send_to, subscribers, writer)) {
+    return false;
+  }
+  return writer.Flush();
+}
+
+bool send_post_to_subscribers(const std::vector<net_networks_rec>& nets, int original_net_num,
+                              const std::string& original_subtype, const subboard_t& sub,
+                              Packet& template_packet, const std::set<uint16_t>& subscribers_to_skip,
+                              const subscribers_send_to_t& send_to, SubscriberCache& subscribers,
+                              PendingPacketWriter& writer) {
   VLOG(1) << "DEBUG: send_post_to_subscribers; original subtype: " << original_subtype;
 
-  // TODO(rushfan): Replace '2' with a network_app_id passed in
-  const auto network_app_id = '2';
   for (const auto& subnet : sub.nets) {
     auto h = template_packet.nh;
     VLOG(1) << "DEBUG: Current network subtype: " << subnet.stype;
@@ -653,36 +861,34 @@ bool send_post_to_subscribers(const std::vector<net_networks_rec>& nets, int ori
       h.tosys = FTN_FAKE_OUTBOUND_NODE;
       VLOG(1) << "current network is FTN";
       h.list_len = 0;
-      write_wwivnet_packet_or_log(current_net, network_app_id, Packet(h, {}, text));
+      writer.Add(current_net, Packet(h, {}, text));
     } else if (current_net.type == network_type_t::wwivnet) {
       if (subnet.host == 0) {
         // We are the host.
-        std::set<uint16_t> subscribers;
-        const auto subscribers_read =
-            ReadSubcriberFile(FilePath(current_net.dir, StrCat("n", subnet.stype, ".net")), subscribers);
-        if (subscribers_read) {
-          // Remove the original sender from the set of systems
-          // that we will resend this to.
-          subscribers.erase(template_packet.nh.fromsys);
-          for (const auto& skip : subscribers_to_skip) {
-            // Skip the subscribers to skip too.
-            subscribers.erase(skip);
+        const auto* all_subscribers =
+            subscribers.subscribers(FilePath(current_net.dir, StrCat("n", subnet.stype, ".net")));
+        if (all_subscribers) {
+          // Remove the original sender and the subscribers to skip from the
+          // set of systems that we will resend this to.
+          std::vector<uint16_t> list;
+          for (const auto s : *all_subscribers) {
+            if (s != template_packet.nh.fromsys && !stl::contains(subscribers_to_skip, s)) {
+              list.push_back(s);
+            }
           }
           VLOG(1) << "Removing subscriber (sender): " << template_packet.nh.fromsys;
-          VLOG(1) << "Read subscribers #: " << subscribers.size();
+          VLOG(1) << "Read subscribers #: " << all_subscribers->size();
           VLOG(1) << "Creating wwivnet packet to: ";
-          for (const auto x : subscribers) {
+          for (const auto x : list) {
             VLOG(1) << "        @" << x;
           }
 
-          if (subscribers.empty()) {
+          if (list.empty()) {
             VLOG(1) << "No subscribers left, skipping sending this packet";
           }
-          h.list_len = static_cast<uint16_t>(subscribers.size());
+          h.list_len = static_cast<uint16_t>(list.size());
           h.tosys = 0;
-          write_wwivnet_packet_or_log(
-              current_net, network_app_id,
-              Packet(h, std::vector<uint16_t>(subscribers.begin(), subscribers.end()), text));
+          writer.Add(current_net, Packet(h, std::move(list), text));
         } else {
           LOG(ERROR) << "Unable to read subscribers for " << current_net.dir << " " << subnet.stype;
         }
@@ -690,7 +896,7 @@ bool send_post_to_subscribers(const std::vector<net_networks_rec>& nets, int ori
         // We are not the host.  Send message to host.
         h.tosys = subnet.host;
         h.list_len = 0;
-        write_wwivnet_packet_or_log(current_net, network_app_id, Packet(h, {}, text));
+        writer.Add(current_net, Packet(h, {}, text));
       }
     }
   }
@@ -19,12 +19,17 @@
 #define INCLUDED_SDK_NET_PACKETS_H
 
 #include "core/file.h"
+#include "core/mapped_file.h"
 #include "sdk/bbslist.h"
 #include "sdk/msgapi/message_wwiv.h"
 #include "sdk/net/net.h"
+#include "sdk/net/subscribers.h"
 #include <filesystem>
+#include <map>
 #include <set>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <vector>
 
 namespace wwiv::sdk::net {
@@ -154,11 +159,74 @@ static std::string get_message_field(const C& c, I& iter, std::set<char> stop, s
  */
 uint16_t get_forsys(const wwiv::sdk::BbsListNet& b, uint16_t node);
 
+/** Returns true if Packet::UpdateRouting adds routing information to packets of main_type */
+bool need_to_update_routing(uint16_t main_type);
+
 std::tuple<Packet, ReadPacketResponse> read_packet(wwiv::core::File& file, bool process_de);
 
+/**
+ * A packet inside of the packet file mapped by a PacketReader.  The list and
+ * text point into the mapping, so a PacketView is only valid for as long as
+ * the PacketReader that returned it.
+ */
+class PacketView final {
+public:
+  PacketView() = default;
+  PacketView(const net_header_rec& h, const char* list, std::string_view text);
+
+  [[nodiscard]] const net_header_rec& nh() const noexcept { return nh_; }
+  [[nodiscard]] int list_size() const noexcept { return nh_.list_len; }
+  /** Gets entry i of the system list. Packets are not aligned in the file, so it is copied. */
+  [[nodiscard]] uint16_t list(int i) const noexcept;
+  [[nodiscard]] std::vector<uint16_t> list_vector() const;
+  [[nodiscard]] std::string_view text() const noexcept { return text_; }
+  [[nodiscard]] int length() const noexcept { return static_cast<int>(nh_.length); }
+
+  /** Copies this into a Packet, for handlers that need to change it. */
+  [[nodiscard]] Packet ToPacket() const;
+
+private:
+  // Copied since the DE header, when skipped, changes the length.
+  net_header_rec nh_{};
+  const char* list_{nullptr};
+  std::string_view text_;
+};
+
+/**
+ * Reads the packets in a packet file without a read (or copy) per packet by
+ * mapping the whole file into memory.  This behaves like calling read_packet
+ * until it returns END_OF_FILE.
+ */
+class PacketReader final {
+public:
+  PacketReader(const std::filesystem::path& path, bool process_de);
+
+  /** Maps the packet file. Returns false if it can not be opened. */
+  bool Open();
+  /** Returns the next packet from the file. */
+  std::tuple<PacketView, ReadPacketResponse> Next();
+
+private:
+  wwiv::core::MappedFile file_;
+  const bool process_de_;
+  std::size_t pos_{0};
+};
+
 bool write_wwivnet_packet(const std::string& filename, const net_networks_rec& net,
                           const Packet& packet);
 
+/** Appends the packet p to filename without first copying it into a Packet. */
+bool write_wwivnet_packet(const std::string& filename, const net_networks_rec& net,
+                          const PacketView& p);
+
+/**
+ * Appends all of packets to filename using a single buffered write instead of
+ * opening the packet file once per packet.  Packets with mismatched lengths
+ * are logged and nothing is written.
+ */
+bool write_wwivnet_packets(const std::string& filename, const net_networks_rec& net,
+                           const std::vector<Packet>& packets);
+
 bool send_local_email(const net_networks_rec& network, net_header_rec& nh, const std::string& text,
                       const std::string& byname, const std::string& title);
 
@@ -195,12 +263,46 @@ Packet create_packet_from_wwiv_message(const wwiv::sdk::msgapi::WWIVMessage& m,
 // system Logger.
 bool write_wwivnet_packet_or_log(const net_networks_rec& net, char network_app_id, const Packet& p);
 
+/**
+ * Buffers outbound packets, writing all of the packets for each network to a
+ * single new pending file with one write, instead of creating a pending file
+ * for every packet like write_wwivnet_packet_or_log.
+ */
+class PendingPacketWriter final {
+public:
+  explicit PendingPacketWriter(char network_app_id);
+  PendingPacketWriter(const PendingPacketWriter&) = delete;
+  PendingPacketWriter& operator=(const PendingPacketWriter&) = delete;
+  /** Writes anything not yet flushed. */
+  ~PendingPacketWriter();
+
+  void Add(const net_networks_rec& net, Packet p);
+  /** Writes the buffered packets for each network to a new pending file. */
+  bool Flush();
+
+private:
+  const char network_app_id_;
+  // Buffered packets for each network, keyed by the network directory.
+  std::map<std::filesystem::path, std::pair<net_networks_rec, std::vector<Packet>>> pending_;
+  std::size_t pending_bytes_{0};
+};
+
 enum class subscribers_send_to_t { hosted_and_gated_only, all_subscribers };
 bool send_post_to_subscribers(const std::vector<net_networks_rec>& nets, int original_net_num,
                               const std::string& original_subtype, const subboard_t& sub,
                               Packet& template_packet, const std::set<uint16_t>& subscribers_to_skip,
                               const subscribers_send_to_t& send_to);
 
+/**
+ * Same as above, but reads the subscribers through subscribers and adds the
+ * outbound packets to writer, for callers sending many posts.
+ */
+bool send_post_to_subscribers(const std::vector<net_networks_rec>& nets, int original_net_num,
+                              const std::string& original_subtype, const subboard_t& sub,
+                              Packet& template_packet, const std::set<uint16_t>& subscribers_to_skip,
+                              const subscribers_send_to_t& send_to, SubscriberCache& subscribers,
+                              PendingPacketWriter& writer);
+
 } // namespace
 
 #endif
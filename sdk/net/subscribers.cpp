@@ -26,6 +26,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
 
 using std::set;
 using std::string;
@@ -92,6 +93,19 @@ bool WriteSubcriberFile(const std::filesystem::path& path, const std::set<uint16
   return true;
 }
 
+const std::set<uint16_t>* SubscriberCache::subscribers(const std::filesystem::path& filename) {
+  if (const auto it = cache_.find(filename); it != cache_.end()) {
+    return &it->second;
+  }
+  std::set<uint16_t> subscribers;
+  if (!ReadSubcriberFile(filename, subscribers)) {
+    return nullptr;
+  }
+  return &cache_.emplace(filename, std::move(subscribers)).first->second;
+}
+
+void SubscriberCache::Invalidate(const std::filesystem::path& filename) { cache_.erase(filename); }
+
 bool WriteFidoSubcriberFile(const std::filesystem::path& path, const std::set<FidoAddress>& subscribers) {
   TextFile file(path, "wt");
   if (!file.IsOpen()) {
@@ -20,6 +20,7 @@
 
 #include "sdk/fido/fido_address.h"
 #include <filesystem>
+#include <map>
 #include <set>
 
 namespace wwiv::sdk {
@@ -30,6 +31,21 @@ bool WriteSubcriberFile(const std::filesystem::path& path, const std::set<uint16
 bool WriteFidoSubcriberFile(const std::filesystem::path& path,
                             const std::set<fido::FidoAddress>& subscribers);
 
+/**
+ * Subscriber files (n<subtype>.net) that have already been read, so that
+ * sending many posts on the same sub only reads its subscribers once.
+ * Anything that writes a subscriber file must Invalidate it.
+ */
+class SubscriberCache final {
+public:
+  /** Returns the subscribers in filename, or nullptr if it can not be read. */
+  const std::set<uint16_t>* subscribers(const std::filesystem::path& filename);
+  void Invalidate(const std::filesystem::path& filename);
+
+private:
+  std::map<std::filesystem::path, std::set<uint16_t>> cache_;
+};
+
 } // namespace wwiv::sdk
 
 #endif
@@ -20,12 +20,18 @@
 #include "core/datafile.h"
 #include "core/datetime.h"
 #include "core/file.h"
+#include "core/log.h"
+#include "core/stl.h"
 #include "core/strings.h"
 #include "sdk/config.h"
 #include "sdk/filenames.h"
 #include "sdk/vardec.h"
 #include "sdk/net/net.h"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
 #include <string>
+#include <vector>
 
 using std::endl;
 using std::string;
@@ -70,44 +76,135 @@ bool SSM::send_remote(const net_networks_rec& net, uint16_t system_number, uint3
   return true;
 }
 
+static constexpr char kIndexSignature[4] = {'S', 'M', 'W', 'I'};
+static constexpr uint32_t kIndexVersion = 2;
+
+static bool is_empty(const shortmsgrec& sm) { return sm.tosys == 0 && sm.touser == 0; }
+
+/**
+ * Returns the modification time of smw.dat to record in the index, or 0 if it
+ * was modified this second, since another write later in the same second
+ * would not change it.  An index recording 0 is rebuilt the next time it is read.
+ */
+static int64_t index_mtime(const std::filesystem::path& smw) {
+  const auto t = File::last_write_time(smw);
+  return t < time(nullptr) ? t : 0;
+}
+
+/** Returns true if h was written for smw.dat as it is now, holding num_records. */
+static bool is_current(const ssm_index_header_t& h, const std::filesystem::path& smw,
+                       int num_records) {
+  return h.num_records == static_cast<uint32_t>(num_records) && h.smw_mtime != 0 &&
+         h.smw_mtime == File::last_write_time(smw);
+}
+
+static bool read_index_header(File& f, ssm_index_header_t& h) {
+  const auto len = f.length();
+  if (len < static_cast<File::size_type>(sizeof(ssm_index_header_t))) {
+    return false;
+  }
+  f.Seek(0, File::Whence::begin);
+  if (f.Read(&h, sizeof(h)) != sizeof(h)) {
+    return false;
+  }
+  return memcmp(h.signature, kIndexSignature, sizeof(kIndexSignature)) == 0 &&
+         h.version == kIndexVersion &&
+         len == static_cast<File::size_type>(sizeof(ssm_index_header_t) +
+                                             h.num_entries * sizeof(ssm_index_entry_t));
+}
+
 bool SSM::send_local(uint32_t user_number, const std::string& text) {
   User user;
   user_manager_.readuser(&user, user_number);
   if (user.IsUserDeleted()) {
     return false;
   }
-  File file(FilePath(data_directory_, SMW_DAT));
-  if (!file.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
+  const auto smw = FilePath(data_directory_, SMW_DAT);
+  DataFile<shortmsgrec> file(smw, File::modeReadWrite | File::modeBinary | File::modeCreateFile);
+  if (!file) {
     return false;
   }
-  int size = static_cast<int>(file.length() / sizeof(shortmsgrec));
-  int pos = size - 1;
-  shortmsgrec sm;
-  if (pos >= 0) {
-    file.Seek(pos * sizeof(shortmsgrec), File::Whence::begin);
-    file.Read(&sm, sizeof(shortmsgrec));
-    while (sm.tosys == 0 && sm.touser == 0 && pos > 0) {
-      --pos;
-      file.Seek(pos * sizeof(shortmsgrec), File::Whence::begin);
-      file.Read(&sm, sizeof(shortmsgrec));
-    }
-    if (sm.tosys != 0 || sm.touser != 0) {
-      pos++;
-    }
-  } else {
-    pos = 0;
-  }
+  // Always append, the empty slots left by read messages are reclaimed by compact.
+  const auto slot = file.number_of_records();
+  // Check the index before writing, since the write changes smw.dat's modification time.
+  File idx(FilePath(data_directory_, SMW_IDX));
+  ssm_index_header_t h{};
+  const auto index_ok = idx.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile) &&
+                        read_index_header(idx, h) && is_current(h, smw, slot);
+
+  shortmsgrec sm{};
   sm.tosys = static_cast<uint16_t>(0);  // 0 means local
   sm.touser = static_cast<uint16_t>(user_number);
   to_char_array(sm.message, text);
-  file.Seek(pos * sizeof(shortmsgrec), File::Whence::begin);
-  file.Write(&sm, sizeof(shortmsgrec));
+  if (!file.Write(slot, &sm)) {
+    return false;
+  }
+
+  if (index_ok) {
+    const ssm_index_entry_t e{static_cast<uint32_t>(slot), static_cast<uint16_t>(user_number), 0};
+    idx.Seek(0, File::Whence::end);
+    idx.Write(&e, sizeof(e));
+    h.num_records = static_cast<uint32_t>(slot + 1);
+    ++h.num_entries;
+    h.smw_mtime = index_mtime(smw);
+    idx.Seek(0, File::Whence::begin);
+    idx.Write(&h, sizeof(h));
+  } else {
+    // Someone changed smw.dat without the index, rebuild it including this message.
+    idx.Close();
+    rebuild_index(file);
+  }
   file.Close();
-  user.SetStatusFlag(User::SMW);
-  user_manager_.writeuser(&user, user_number);
+
+  if (!user.HasStatusFlag(User::SMW)) {
+    user.SetStatusFlag(User::SMW);
+    user_manager_.writeuser(&user, user_number);
+  }
   return true;
 }
 
+std::vector<ssm_message_t> SSM::messages_for(uint32_t user_number) {
+  std::vector<ssm_message_t> messages;
+  DataFile<shortmsgrec> file(FilePath(data_directory_, SMW_DAT),
+                             File::modeReadOnly | File::modeBinary);
+  if (!file) {
+    return messages;
+  }
+  for (const auto& e : read_index(file)) {
+    if (e.touser != user_number) {
+      continue;
+    }
+    shortmsgrec sm{};
+    if (!file.Read(e.slot, &sm) || sm.tosys != 0 || sm.touser != user_number) {
+      continue;
+    }
+    sm.message[sizeof(sm.message) - 1] = '\0';
+    messages.push_back({static_cast<int>(e.slot), sm.message});
+  }
+  return messages;
+}
+
+bool SSM::delete_message(int slot) {
+  DataFile<shortmsgrec> file(FilePath(data_directory_, SMW_DAT),
+                             File::modeReadWrite | File::modeBinary | File::modeCreateFile);
+  if (!file) {
+    return false;
+  }
+  const auto num_records = file.number_of_records();
+  if (slot < 0 || slot >= num_records) {
+    return false;
+  }
+  auto entries = read_index(file);
+  shortmsgrec sm{};
+  if (!file.Write(slot, &sm)) {
+    return false;
+  }
+  entries.erase(std::remove_if(std::begin(entries), std::end(entries),
+                               [=](const auto& e) { return e.slot == static_cast<uint32_t>(slot); }),
+                std::end(entries));
+  return write_index(num_records, entries);
+}
+
 bool SSM::delete_local_to_user(uint32_t user_number) {
   DataFile<shortmsgrec> file(FilePath(data_directory_, SMW_DAT),
                              File::modeReadWrite | File::modeBinary | File::modeCreateFile);
@@ -115,18 +212,107 @@ bool SSM::delete_local_to_user(uint32_t user_number) {
     return false;
   }
 
-  int num_recs = file.number_of_records();
-  for (int i = 0; i < num_recs; i++) {
+  const auto num_records = file.number_of_records();
+  auto entries = read_index(file);
+  std::vector<ssm_index_entry_t> keep;
+  for (const auto& e : entries) {
+    if (e.touser != user_number) {
+      keep.push_back(e);
+      continue;
+    }
     shortmsgrec sm{};
-    if (!file.Read(i, &sm)) {
-      break;
+    file.Write(e.slot, &sm);
+  }
+  if (keep.size() == entries.size()) {
+    return true;
+  }
+  return write_index(num_records, keep);
+}
+
+bool SSM::compact() {
+  DataFile<shortmsgrec> file(FilePath(data_directory_, SMW_DAT),
+                             File::modeReadWrite | File::modeBinary | File::modeCreateFile);
+  if (!file) {
+    return false;
+  }
+  std::vector<shortmsgrec> recs;
+  file.Seek(0);
+  if (!file.ReadVector(recs)) {
+    return false;
+  }
+  const auto num_before = recs.size();
+  recs.erase(std::remove_if(std::begin(recs), std::end(recs), is_empty), std::end(recs));
+
+  std::vector<ssm_index_entry_t> entries;
+  for (auto i = 0; i < stl::ssize(recs); i++) {
+    if (recs[i].tosys == 0) {
+      entries.push_back({static_cast<uint32_t>(i), recs[i].touser, 0});
     }
-    if (sm.tosys == 0 && sm.touser == user_number) {
-      memset(&sm, 0, sizeof(sm));
-      file.Write(i, &sm);
+  }
+  if (recs.size() != num_before) {
+    file.Seek(0);
+    if (!file.WriteVectorAndTruncate(recs)) {
+      return false;
     }
   }
-  return true;
+  return write_index(stl::ssize(recs), entries);
+}
+
+std::vector<ssm_index_entry_t> SSM::read_index(DataFile<shortmsgrec>& file) {
+  const auto num_records = file.number_of_records();
+  File idx(FilePath(data_directory_, SMW_IDX));
+  if (!idx.Open(File::modeReadOnly | File::modeBinary)) {
+    return rebuild_index(file);
+  }
+  ssm_index_header_t h{};
+  if (!read_index_header(idx, h) ||
+      !is_current(h, FilePath(data_directory_, SMW_DAT), num_records)) {
+    idx.Close();
+    return rebuild_index(file);
+  }
+  std::vector<ssm_index_entry_t> entries(h.num_entries);
+  if (!entries.empty()) {
+    const auto size = static_cast<int>(entries.size() * sizeof(ssm_index_entry_t));
+    if (idx.Read(&entries[0], size) != size) {
+      idx.Close();
+      return rebuild_index(file);
+    }
+  }
+  return entries;
+}
+
+bool SSM::write_index(int num_records, const std::vector<ssm_index_entry_t>& entries) {
+  File idx(FilePath(data_directory_, SMW_IDX));
+  if (!idx.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile | File::modeTruncate)) {
+    return false;
+  }
+  ssm_index_header_t h{};
+  memcpy(h.signature, kIndexSignature, sizeof(kIndexSignature));
+  h.version = kIndexVersion;
+  h.num_records = static_cast<uint32_t>(num_records);
+  h.num_entries = static_cast<uint32_t>(entries.size());
+  h.smw_mtime = index_mtime(FilePath(data_directory_, SMW_DAT));
+  std::string buf(reinterpret_cast<const char*>(&h), sizeof(h));
+  if (!entries.empty()) {
+    buf.append(reinterpret_cast<const char*>(&entries[0]), entries.size() * sizeof(ssm_index_entry_t));
+  }
+  return idx.Write(buf.data(), buf.size()) == static_cast<File::size_type>(buf.size());
+}
+
+std::vector<ssm_index_entry_t> SSM::rebuild_index(DataFile<shortmsgrec>& file) {
+  std::vector<ssm_index_entry_t> entries;
+  std::vector<shortmsgrec> recs;
+  file.Seek(0);
+  file.ReadVector(recs);
+  for (auto i = 0; i < stl::ssize(recs); i++) {
+    const auto& sm = recs[i];
+    if (sm.tosys == 0 && sm.touser != 0) {
+      entries.push_back({static_cast<uint32_t>(i), sm.touser, 0});
+    }
+  }
+  VLOG(1) << "Rebuilt " << SMW_IDX << " with " << entries.size() << " entries.";
+  write_index(stl::ssize(recs), entries);
+  return entries;
 }
 
 }
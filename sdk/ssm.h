@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 
+#include "core/datafile.h"
 #include "sdk/config.h"
 #include "sdk/net/net.h"
 #include "sdk/vardec.h"
@@ -29,6 +30,46 @@
 namespace wwiv {
 namespace sdk {
 
+/** Header of smw.idx, followed by num_entries ssm_index_entry_t */
+struct ssm_index_header_t {
+  char signature[4];
+  uint32_t version;
+  // Number of records in smw.dat when the index was written.
+  uint32_t num_records;
+  uint32_t num_entries;
+  // Modification time of smw.dat when the index was written, or 0 if it
+  // was modified in that same second.
+  int64_t smw_mtime;
+};
+
+/** A local short message in smw.dat */
+struct ssm_index_entry_t {
+  uint32_t slot;
+  uint16_t touser;
+  uint16_t reserved;
+};
+
+static_assert(sizeof(ssm_index_header_t) == 24, "ssm_index_header_t == 24");
+static_assert(sizeof(ssm_index_entry_t) == 8, "ssm_index_entry_t == 8");
+
+/** A short message waiting for a local user */
+struct ssm_message_t {
+  // Record number in smw.dat
+  int slot;
+  std::string text;
+};
+
+/**
+ * Short messages (SSMs) for local users.
+ *
+ * The messages live in smw.dat as they always have, with smw.idx listing
+ * which slot of smw.dat holds a message for which user.  New messages are
+ * appended to smw.dat (empty slots are reclaimed by compact at logoff) and
+ * to the index, and looking up or deleting the messages for a user reads
+ * only the index and that user's slots.  The index is rebuilt from smw.dat
+ * whenever smw.dat has been written behind its back, as older versions do
+ * when they reuse an empty slot, which is noticed by its modification time.
+ */
 class SSM {
 public:
   SSM(const wwiv::sdk::Config& config, wwiv::sdk::UserManager& user_manager);
@@ -37,12 +78,24 @@ public:
   bool send_local(uint32_t user_number, const std::string& text);
   bool send_remote(const net_networks_rec& net, uint16_t system_number, uint32_t from_user_number, uint32_t user_number, const std::string& text);
   bool delete_local_to_user(uint32_t user_number);
+
+  /** Returns the messages waiting for user_number, oldest first. */
+  [[nodiscard]] std::vector<ssm_message_t> messages_for(uint32_t user_number);
+  /** Deletes the message in slot. */
+  bool delete_message(int slot);
+  /** Removes the empty slots from smw.dat and rewrites the index. */
+  bool compact();
+
 private:
+  // Reads the index for the open smw.dat, rebuilding it if it does not match.
+  std::vector<ssm_index_entry_t> read_index(core::DataFile<shortmsgrec>& file);
+  bool write_index(int num_records, const std::vector<ssm_index_entry_t>& entries);
+  std::vector<ssm_index_entry_t> rebuild_index(core::DataFile<shortmsgrec>& file);
+
   const std::string data_directory_;
   wwiv::sdk::UserManager& user_manager_;
 };
 
-
 }
 }
 
@@ -85,6 +85,7 @@ void serialize(Archive & ar, wwivd_config_t &a) {
   SERIALIZE(a, ssh_port);
   SERIALIZE(a, binkp_port);
   SERIALIZE(a, binkp_cmd);
+  SERIALIZE(a, binkp_in_process);
   SERIALIZE(a, do_network_callouts);
   SERIALIZE(a, network_callout_cmd);
   SERIALIZE(a, do_beginday_event);
@@ -77,6 +77,8 @@ public:
 
   int binkp_port{-1};
   std::string binkp_cmd;
+  /** Answer binkp sessions inside of wwivd instead of running binkp_cmd for each. */
+  bool binkp_in_process{true};
   bool do_network_callouts{false};
   std::string network_callout_cmd;
   bool do_beginday_event{true};
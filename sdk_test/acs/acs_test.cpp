@@ -23,6 +23,7 @@
 #include "core/parser/ast.h"
 #include "core/parser/lexer.h"
 #include "sdk/user.h"
+#include "sdk/acs/acs.h"
 #include "sdk/acs/eval.h"
 #include "sdk/acs/uservalueprovider.h"
 #include <string>
@@ -181,3 +182,29 @@ TEST_F(AcsTest, CoSysop_Fail) {
   createEval("user.cosysop == true");
   EXPECT_FALSE(eval->eval());
 }
+
+TEST_F(AcsTest, Parsed_ReusedForEachUser) {
+  const std::string expr = "user.sl>200 || user.dsl > 200";
+  const auto ast = Eval::Parse(expr);
+  ASSERT_TRUE(ast);
+  for (const auto sl : {10, 201, 50, 255}) {
+    user_.SetSl(sl);
+    Eval e(expr, ast);
+    e.add("user", std::make_unique<UserValueProvider>(&user_, user_.GetSl(), sl_));
+    EXPECT_EQ(sl > 200, e.eval()) << "sl: " << sl;
+  }
+}
+
+TEST_F(AcsTest, CompiledAcs) {
+  EXPECT_TRUE(CompiledAcs("").empty());
+  EXPECT_TRUE(CompiledAcs("  ").empty());
+
+  const CompiledAcs ok("user.sl > 20");
+  EXPECT_FALSE(ok.empty());
+  EXPECT_TRUE(ok.error_text().empty());
+  EXPECT_TRUE(ok.ast());
+
+  const CompiledAcs bad("user.sl > 20 & user.dsl > 20");
+  EXPECT_FALSE(bad.empty());
+  EXPECT_FALSE(bad.error_text().empty());
+}
@@ -0,0 +1,92 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/file.h"
+#include "core_test/file_helper.h"
+#include "sdk/bbslist.h"
+#include "sdk/filenames.h"
+#include "sdk/net/packets.h"
+#include <string>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::net;
+
+class BbsListTest : public testing::Test {
+public:
+  BbsListTest() {
+    helper.CreateTempFile(BBSLIST_NET, "@1 *111-111-1111 #9600 \"One\"\n"
+                                       "@2 *222-222-2222 #9600 \"Two\"\n"
+                                       "@3 *333-333-3333 #9600 \"Three\"\n"
+                                       "@4 *444-444-4444 #9600 \"Four\"\n");
+    helper.CreateTempFile(CONNECT_NET, "@1 2=1 3=5\n"
+                                       "@2 1=1 3=1\n"
+                                       "@3 1=5 2=1\n"
+                                       "@4 3=1\n");
+  }
+
+  FileHelper helper;
+};
+
+TEST_F(BbsListTest, ParseBbsListNet) {
+  const auto b = BbsListNet::ParseBbsListNet(1, helper.TempDir());
+  ASSERT_EQ(4u, b.node_config().size());
+  const auto n3 = b.node_config_for(3);
+  ASSERT_TRUE(n3);
+  EXPECT_EQ(2, n3->forsys);
+  EXPECT_EQ(2, n3->numhops);
+  EXPECT_FLOAT_EQ(2.0f, n3->xx.cost);
+  EXPECT_EQ(1, b.node_config_for(1)->forsys);
+  EXPECT_EQ(0, b.node_config_for(1)->numhops);
+
+  // Nothing connects to 4.
+  EXPECT_EQ(WWIVNET_NO_NODE, b.node_config_for(4)->forsys);
+  EXPECT_EQ(2, get_forsys(b, 3));
+  EXPECT_EQ(WWIVNET_NO_NODE, get_forsys(b, 4));
+  EXPECT_EQ(WWIVNET_NO_NODE, get_forsys(b, 5));
+}
+
+TEST_F(BbsListTest, RouteCache) {
+  const auto b = BbsListNet::ParseBbsListNet(1, helper.TempDir());
+  ASSERT_TRUE(File::Exists(FilePath(helper.TempDir(), BBSDATA_RTE)));
+
+  // Changing only bbslist.net reuses the cached routes.
+  helper.CreateTempFile(BBSLIST_NET, "@1 *111-111-1111 #9600 \"One\"\n"
+                                     "@3 *333-333-3333 #9600 \"New Three\"\n");
+  auto updated = BbsListNet::ParseBbsListNet(1, helper.TempDir());
+  ASSERT_EQ(2u, updated.node_config().size());
+  EXPECT_STREQ("New Three", updated.node_config_for(3)->name);
+  EXPECT_EQ(2, updated.forsys(3));
+
+  // Changing connect.net recomputes them.
+  helper.CreateTempFile(CONNECT_NET, "@1 3=1\n"
+                                     "@3 1=1\n");
+  updated = BbsListNet::ParseBbsListNet(1, helper.TempDir());
+  EXPECT_EQ(3, updated.forsys(3));
+  EXPECT_EQ(1, updated.node_config_for(3)->numhops);
+}
+
+TEST_F(BbsListTest, Forsys_InitializerList) {
+  net_system_list_rec r{};
+  r.sysnum = 2;
+  r.forsys = 7;
+  const BbsListNet b({r});
+  EXPECT_EQ(7, b.forsys(2));
+  EXPECT_EQ(WWIVNET_NO_NODE, b.forsys(3));
+}
@@ -0,0 +1,140 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*            Copyright (C)2016-2020, WWIV Software Services              */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "core/file.h"
+#include "core/strings.h"
+#include "core_test/file_helper.h"
+#include "sdk/fido/fido_packets.h"
+#include "sdk/net/packets.h"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+
+using namespace wwiv::core;
+using namespace wwiv::strings;
+using namespace wwiv::sdk::fido;
+using namespace wwiv::sdk::net;
+
+class FidoPacketsTest : public testing::Test {
+public:
+  FidoPacketsTest() : path_(helper_.TempDir() / "test.pkt") {}
+
+  static FidoPackedMessage CreateMessage(const std::string& subject) {
+    fido_packed_message_t nh{};
+    nh.message_type = 2;
+    nh.orig_net = 100;
+    nh.orig_node = 1;
+    nh.dest_net = 200;
+    nh.dest_node = 2;
+    fido_variable_length_header_t vh;
+    vh.date_time = "19 Oct 26  12:34:56";
+    vh.to_user_name = "All";
+    vh.from_user_name = "Sysop";
+    vh.subject = subject;
+    vh.text = StrCat("AREA:TEST\r", subject, "\r");
+    return FidoPackedMessage(nh, vh);
+  }
+
+  bool WriteHeader(File& f) {
+    packet_header_2p_t header{};
+    header.packet_ver = 2;
+    return write_fido_packet_header(f, header);
+  }
+
+  std::vector<FidoPackedMessage> ReadAll() {
+    File f(path_);
+    EXPECT_TRUE(f.Open(File::modeBinary | File::modeReadOnly));
+    packet_header_2p_t header{};
+    EXPECT_EQ(static_cast<int>(sizeof(packet_header_2p_t)), f.Read(&header, sizeof(header)));
+    std::vector<FidoPackedMessage> msgs;
+    for (;;) {
+      FidoPackedMessage msg;
+      const auto r = read_packed_message(f, msg);
+      if (r != ReadPacketResponse::OK) {
+        EXPECT_EQ(ReadPacketResponse::END_OF_FILE, r);
+        break;
+      }
+      msgs.push_back(msg);
+    }
+    return msgs;
+  }
+
+protected:
+  FileHelper helper_;
+  std::filesystem::path path_;
+};
+
+TEST_F(FidoPacketsTest, WritePackedMessage_RoundTrip) {
+  auto expected = CreateMessage("one");
+  {
+    File f(path_);
+    ASSERT_TRUE(f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite));
+    ASSERT_TRUE(WriteHeader(f));
+    ASSERT_TRUE(write_packed_message(f, expected));
+  }
+
+  const auto msgs = ReadAll();
+  ASSERT_EQ(1u, msgs.size());
+  const auto& m = msgs.front();
+  EXPECT_EQ(2, m.nh.message_type);
+  EXPECT_EQ(100, m.nh.orig_net);
+  EXPECT_EQ(2, m.nh.dest_node);
+  EXPECT_EQ(expected.vh.date_time, m.vh.date_time);
+  EXPECT_EQ("All", m.vh.to_user_name);
+  EXPECT_EQ("Sysop", m.vh.from_user_name);
+  EXPECT_EQ("one", m.vh.subject);
+  EXPECT_EQ(expected.vh.text, m.vh.text);
+}
+
+TEST_F(FidoPacketsTest, AppendPackedMessage_MultipleMessages) {
+  {
+    File f(path_);
+    ASSERT_TRUE(f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite));
+    ASSERT_TRUE(WriteHeader(f));
+    for (const auto& s : {"one", "two", "three"}) {
+      auto msg = CreateMessage(s);
+      ASSERT_TRUE(append_packed_message(f, msg));
+    }
+    ASSERT_TRUE(write_fido_packet_end(f));
+  }
+
+  const auto msgs = ReadAll();
+  ASSERT_EQ(3u, msgs.size());
+  EXPECT_EQ("one", msgs.at(0).vh.subject);
+  EXPECT_EQ("two", msgs.at(1).vh.subject);
+  EXPECT_EQ("three", msgs.at(2).vh.subject);
+  EXPECT_EQ("AREA:TEST\rthree\r", msgs.at(2).vh.text);
+}
+
+TEST_F(FidoPacketsTest, WriteFidoPacketEnd_Terminator) {
+  {
+    File f(path_);
+    ASSERT_TRUE(f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite));
+    ASSERT_TRUE(WriteHeader(f));
+    auto msg = CreateMessage("one");
+    ASSERT_TRUE(append_packed_message(f, msg));
+    ASSERT_TRUE(write_fido_packet_end(f));
+  }
+
+  File f(path_);
+  ASSERT_TRUE(f.Open(File::modeBinary | File::modeReadOnly));
+  std::string contents(static_cast<size_t>(f.length()), '\0');
+  ASSERT_EQ(f.length(), f.Read(&contents[0], f.length()));
+  // The last message's text is NUL terminated, then the packet ends with 2 NULs.
+  ASSERT_GE(contents.size(), 4u);
+  EXPECT_EQ(std::string("\r\0\0\0", 4), contents.substr(contents.size() - 4));
+}
@@ -0,0 +1,232 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/file.h"
+#include "core_test/file_helper.h"
+#include "sdk/filenames.h"
+#include "sdk/files/arc.h"
+#include "sdk/files/diz.h"
+#include <cstring>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk::files;
+
+namespace {
+
+void put16(std::string& s, uint16_t v) { s.append(reinterpret_cast<const char*>(&v), 2); }
+void put32(std::string& s, uint32_t v) { s.append(reinterpret_cast<const char*>(&v), 4); }
+
+std::string raw_deflate(const std::string& data) {
+  z_stream zs{};
+  deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+  std::string out(deflateBound(&zs, static_cast<uLong>(data.size())), '\0');
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  zs.avail_in = static_cast<uInt>(data.size());
+  zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+  zs.avail_out = static_cast<uInt>(out.size());
+  deflate(&zs, Z_FINISH);
+  out.resize(zs.total_out);
+  deflateEnd(&zs);
+  return out;
+}
+
+/** Builds a .ZIP file in memory from {name, contents}, deflating when deflate is true */
+std::string make_zip(const std::vector<std::pair<std::string, std::string>>& files, bool deflate) {
+  std::string zip;
+  std::string cd;
+  for (const auto& [name, contents] : files) {
+    const auto data = deflate ? raw_deflate(contents) : contents;
+    const auto crc = static_cast<uint32_t>(
+        crc32(0L, reinterpret_cast<const Bytef*>(contents.data()), static_cast<uInt>(contents.size())));
+    const auto offset = static_cast<uint32_t>(zip.size());
+    const uint16_t method = deflate ? 8 : 0;
+
+    put32(zip, 0x04034b50);
+    put16(zip, 20);
+    put16(zip, 0);
+    put16(zip, method);
+    put16(zip, 0);
+    put16(zip, 0x5021);
+    put32(zip, crc);
+    put32(zip, static_cast<uint32_t>(data.size()));
+    put32(zip, static_cast<uint32_t>(contents.size()));
+    put16(zip, static_cast<uint16_t>(name.size()));
+    put16(zip, 0);
+    zip.append(name);
+    zip.append(data);
+
+    put32(cd, 0x02014b50);
+    put16(cd, 20);
+    put16(cd, 20);
+    put16(cd, 0);
+    put16(cd, method);
+    put16(cd, 0);
+    put16(cd, 0x5021);
+    put32(cd, crc);
+    put32(cd, static_cast<uint32_t>(data.size()));
+    put32(cd, static_cast<uint32_t>(contents.size()));
+    put16(cd, static_cast<uint16_t>(name.size()));
+    put16(cd, 0);
+    put16(cd, 0);
+    put16(cd, 0);
+    put16(cd, 0);
+    put32(cd, 0);
+    put32(cd, offset);
+    cd.append(name);
+  }
+  const auto cd_offset = static_cast<uint32_t>(zip.size());
+  zip.append(cd);
+  put32(zip, 0x06054b50);
+  put16(zip, 0);
+  put16(zip, 0);
+  put16(zip, static_cast<uint16_t>(files.size()));
+  put16(zip, static_cast<uint16_t>(files.size()));
+  put32(zip, static_cast<uint32_t>(cd.size()));
+  put32(zip, cd_offset);
+  put16(zip, 0);
+  return zip;
+}
+
+} // namespace
+
+class ArcTest : public testing::Test {
+public:
+  std::filesystem::path CreateZip(const std::string& name,
+                                  const std::vector<std::pair<std::string, std::string>>& files,
+                                  bool deflate = true) {
+    const auto path = helper.CreateTempFilePath(name);
+    File f(path);
+    f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite | File::modeTruncate);
+    f.Write(make_zip(files, deflate));
+    return path;
+  }
+
+  FileHelper helper;
+  const std::string big_{std::string(200000, 'x') + "end"};
+};
+
+TEST_F(ArcTest, ListArchive_Zip) {
+  const auto path = CreateZip("test.zip", {{"one.txt", "Hello"}, {"dir/two.txt", big_}});
+  const auto o = list_archive(path);
+  ASSERT_TRUE(o);
+  const auto& files = o.value();
+  ASSERT_EQ(2u, files.size());
+  EXPECT_EQ("one.txt", files[0].filename);
+  EXPECT_EQ(5, files[0].uncompress_size);
+  EXPECT_EQ(archive_method_t::ZIP_DEFLATED, files[0].method);
+  EXPECT_EQ("dir/two.txt", files[1].filename);
+  EXPECT_EQ(static_cast<int32_t>(big_.size()), files[1].uncompress_size);
+}
+
+TEST_F(ArcTest, ZipArchive_Read) {
+  for (const auto deflate : {true, false}) {
+    const auto path = CreateZip("test.zip", {{"one.txt", "Hello"}, {"dir/two.txt", big_}}, deflate);
+    ZipArchive zip(path);
+    ASSERT_TRUE(zip.Open());
+    const auto num = zip.Find("TWO.TXT");
+    ASSERT_TRUE(num);
+    EXPECT_EQ(1, num.value());
+    EXPECT_EQ(big_, zip.Read(num.value()).value_or(""));
+    EXPECT_EQ("Hello", zip.Read(0).value_or(""));
+    EXPECT_FALSE(zip.Find("three.txt"));
+  }
+}
+
+TEST_F(ArcTest, ZipArchive_BadCrc) {
+  auto zip_data = make_zip({{"one.txt", "Hello"}}, false);
+  // Corrupt the stored data.
+  zip_data[30 + 7] = 'J';
+  const auto path = helper.CreateTempFilePath("bad.zip");
+  {
+    File f(path);
+    f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+    f.Write(zip_data);
+  }
+  ZipArchive zip(path);
+  ASSERT_TRUE(zip.Open());
+  EXPECT_FALSE(zip.Read(0));
+}
+
+TEST_F(ArcTest, ExtractArchive) {
+  const auto path = CreateZip("test.zip", {{"one.txt", "Hello"}, {"dir/two.txt", big_}});
+  ASSERT_TRUE(helper.Mkdir("out"));
+  const auto out = FilePath(helper.TempDir(), "out");
+  ASSERT_TRUE(extract_archive(path, out, {"TWO.TXT"}));
+  EXPECT_FALSE(File::Exists(FilePath(out, "one.txt")));
+  EXPECT_EQ(big_, helper.ReadFile(FilePath(out, "two.txt")));
+
+  ASSERT_TRUE(extract_archive(path, out));
+  EXPECT_EQ("Hello", helper.ReadFile(FilePath(out, "one.txt")));
+}
+
+TEST_F(ArcTest, ExtractArchive_NotZip) {
+  const auto path = helper.CreateTempFile("test.arj", "not an archive");
+  EXPECT_FALSE(extract_archive(path, helper.TempDir()));
+  EXPECT_FALSE(read_archive_file(path, "file_id.diz"));
+}
+
+TEST_F(ArcTest, DizParser_ParseArchive) {
+  const auto path = CreateZip("test.zip", {{"FILE_ID.DIZ", "Line1\r\nLine2\r\nLine3\r\n"}});
+  const DizParser p(true);
+  const auto o = p.parse_archive(path);
+  EXPECT_TRUE(o.handled);
+  EXPECT_EQ(FILE_ID_DIZ, o.filename);
+  ASSERT_TRUE(o.diz);
+  EXPECT_EQ(o.diz->description(), "Line1");
+  EXPECT_EQ(o.diz->extended_description(), "Line2\nLine3\n");
+}
+
+TEST_F(ArcTest, DizParser_ParseArchive_DescSdi) {
+  const auto path = CreateZip("test.zip", {{"DESC.SDI", "Line1\r\n"}});
+  const DizParser p(true);
+  const auto o = p.parse_archive(path);
+  EXPECT_TRUE(o.handled);
+  EXPECT_EQ(DESC_SDI, o.filename);
+  ASSERT_TRUE(o.diz);
+  EXPECT_EQ(o.diz->description(), "Line1");
+}
+
+TEST_F(ArcTest, DizParser_ParseArchive_NoDiz) {
+  const auto path = CreateZip("test.zip", {{"ONE.TXT", "Hello"}});
+  const DizParser p(true);
+  const auto o = p.parse_archive(path);
+  EXPECT_TRUE(o.handled);
+  EXPECT_TRUE(o.filename.empty());
+  EXPECT_FALSE(o.diz);
+}
+
+TEST_F(ArcTest, DizParser_ParseArchive_EmptyDiz) {
+  const auto path = CreateZip("test.zip", {{"FILE_ID.DIZ", ""}});
+  const DizParser p(true);
+  const auto o = p.parse_archive(path);
+  EXPECT_TRUE(o.handled);
+  EXPECT_EQ(FILE_ID_DIZ, o.filename);
+  EXPECT_FALSE(o.diz);
+}
+
+TEST_F(ArcTest, DizParser_ParseArchive_NotZip) {
+  const auto path = helper.CreateTempFile("test.arj", "not an archive");
+  const DizParser p(true);
+  const auto o = p.parse_archive(path);
+  EXPECT_FALSE(o.handled);
+  EXPECT_FALSE(o.diz);
+}
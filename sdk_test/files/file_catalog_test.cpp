@@ -0,0 +1,149 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/file.h"
+#include "core/stl.h"
+#include "sdk/config.h"
+#include "sdk/filenames.h"
+#include "sdk/files/file_catalog.h"
+#include "sdk/files/files.h"
+#include "sdk_test/sdk_helper.h"
+#include "sdk_test/files/filesapi_helper.h"
+#include <string>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::files;
+using namespace wwiv::stl;
+
+class FileCatalogTest : public testing::Test {
+public:
+  FileCatalogTest() : api_(helper.data()), api_helper_(&api_) {}
+
+  SdkHelper helper;
+  FileApi api_;
+  FilesApiHelper api_helper_;
+};
+
+TEST_F(FileCatalogTest, Words) {
+  const auto u = ul("WWIV52.ZIP", "The WWIV-5 BBS, a", 1234);
+  const auto w = file_catalog_words(u);
+  EXPECT_EQ(w, (std::set<std::string>{"WWIV52", "ZIP", "THE", "WWIV", "BBS"}));
+}
+
+TEST_F(FileCatalogTest, AddFile_Journaled) {
+  auto area = api_helper_.CreateAndPopulate("one", {FileRecord(ul("FOO.ZIP", "Foo Game", 1))});
+  ASSERT_TRUE(area);
+
+  FileCatalog cat(helper.data());
+  ASSERT_TRUE(cat.Load());
+  EXPECT_TRUE(cat.has_area("one"));
+  EXPECT_EQ(1, cat.size());
+  const auto found = cat.FindFile("FOO     .ZIP");
+  ASSERT_EQ(1, ssize(found));
+  EXPECT_EQ("ONE", found.front().area);
+  EXPECT_EQ(1u, found.front().u.numbytes);
+}
+
+TEST_F(FileCatalogTest, UpdateAndDelete) {
+  auto area = api_helper_.CreateAndPopulate(
+      "one", {FileRecord(ul("FOO.ZIP", "Foo Game", 1)), FileRecord(ul("BAR.ZIP", "Bar", 2))});
+  ASSERT_TRUE(area);
+  FileCatalog cat(helper.data());
+  ASSERT_TRUE(cat.Load());
+  ASSERT_EQ(2, cat.size());
+
+  auto num = area->FindFile("FOO     .ZIP");
+  ASSERT_TRUE(num);
+  auto f = area->ReadFile(num.value());
+  f.set_description("Updated");
+  ASSERT_TRUE(area->UpdateFile(f, num.value()));
+  num = area->FindFile("BAR     .ZIP");
+  ASSERT_TRUE(num);
+  ASSERT_TRUE(area->DeleteFile(num.value()));
+  // Nothing is journaled until the area is saved.
+  ASSERT_TRUE(cat.Refresh());
+  EXPECT_EQ(2, cat.size());
+
+  ASSERT_TRUE(area->Save());
+  ASSERT_TRUE(cat.Refresh());
+  ASSERT_EQ(1, cat.size());
+  EXPECT_TRUE(cat.FindFile("BAR     .ZIP").empty());
+  EXPECT_TRUE(cat.FindWords("game").empty());
+  EXPECT_EQ(1, ssize(cat.FindWords("upd")));
+}
+
+TEST_F(FileCatalogTest, FindMaskAndWords) {
+  api_helper_.CreateAndPopulate("one", {FileRecord(ul("FOO1.ZIP", "Space Game", 1)),
+                                        FileRecord(ul("BAR.ZIP", "Space Editor", 1))});
+  api_helper_.CreateAndPopulate("two", {FileRecord(ul("FOO2.ARJ", "Chess Game", 1))});
+  FileCatalog cat(helper.data());
+  ASSERT_TRUE(cat.Load());
+
+  EXPECT_EQ(2, ssize(cat.FindMask("FOO?????.???")));
+  EXPECT_EQ(1, ssize(cat.FindMask("????????.ARJ")));
+  EXPECT_EQ((std::set<std::string>{"ONE", "TWO"}), cat.AreasMatching("FOO?????.???"));
+  EXPECT_EQ(2, ssize(cat.FindWords("game")));
+  EXPECT_EQ(1, ssize(cat.FindWords("spa gam")));
+  EXPECT_TRUE(cat.FindWords("checkers").empty());
+}
+
+TEST_F(FileCatalogTest, Compact) {
+  api_helper_.CreateAndPopulate("one", {FileRecord(ul("FOO.ZIP", "Foo", 1))});
+  FileCatalog cat(helper.data());
+  ASSERT_TRUE(cat.Load());
+  ASSERT_TRUE(cat.Compact());
+  EXPECT_EQ(0u, std::filesystem::file_size(FilePath(helper.data(), FILECAT_LOG)));
+
+  FileCatalog reloaded(helper.data());
+  ASSERT_TRUE(reloaded.Load());
+  EXPECT_TRUE(reloaded.has_area("one"));
+  EXPECT_EQ(1, ssize(reloaded.FindFile("FOO     .ZIP")));
+}
+
+TEST_F(FileCatalogTest, Compact_KeepsChangesJournaledByOthers) {
+  api_helper_.CreateAndPopulate("one", {FileRecord(ul("FOO.ZIP", "Foo", 1))});
+  FileCatalog stale(helper.data());
+  ASSERT_TRUE(stale.Load());
+
+  FileCatalog other(helper.data());
+  ASSERT_TRUE(other.Load());
+  ASSERT_TRUE(other.Add("one", ul("BAR.ZIP", "Bar", 1)));
+
+  // stale has not seen BAR.ZIP yet, but compacting must not lose it.
+  ASSERT_TRUE(stale.Compact());
+  EXPECT_EQ(2, stale.size());
+  EXPECT_EQ(0u, std::filesystem::file_size(FilePath(helper.data(), FILECAT_LOG)));
+
+  FileCatalog reloaded(helper.data());
+  ASSERT_TRUE(reloaded.Load());
+  EXPECT_EQ(1, ssize(reloaded.FindFile("BAR     .ZIP")));
+}
+
+TEST_F(FileCatalogTest, SetRawFiles_ReplacesArea) {
+  auto area = api_helper_.CreateAndPopulate("one", {FileRecord(ul("FOO.ZIP", "Foo", 1))});
+  auto files = area->raw_files();
+  files.push_back(ul("BAR.ZIP", "Bar", 1));
+  ASSERT_TRUE(area->set_raw_files(files));
+  ASSERT_TRUE(area->Save());
+
+  FileCatalog cat(helper.data());
+  ASSERT_TRUE(cat.Load());
+  EXPECT_EQ(2, ssize(cat.area_files("one")));
+}
@@ -0,0 +1,128 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core_test/file_helper.h"
+#include "sdk/filenames.h"
+#include "sdk/latest_qscan.h"
+#include "sdk/vardec.h"
+#include <string>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+
+class LatestQScanTest : public testing::Test {
+public:
+  // Writes status.dat with the qscan pointer at qscanptr.
+  void CreateStatus(uint32_t qscanptr) {
+    DataFile<statusrec_t> file(FilePath(helper_.TempDir(), STATUS_DAT),
+                               File::modeBinary | File::modeReadWrite | File::modeCreateFile);
+    statusrec_t s{};
+    s.qscanptr = qscanptr;
+    ASSERT_TRUE(file.Write(0, &s));
+  }
+
+  FileHelper helper_;
+};
+
+TEST_F(LatestQScanTest, UpdateAndLatest) {
+  LatestQScan l(helper_.TempDir());
+  ASSERT_TRUE(l.is_open());
+  EXPECT_TRUE(File::Exists(FilePath(helper_.TempDir(), SUBQSCAN_DAT)));
+  EXPECT_EQ(0u, l.latest("general"));
+
+  l.Update("general", 10);
+  l.Update("GENERAL", 12);
+  // Older posts never lower the value.
+  l.Update("general", 11);
+  l.Update("sysop", 5);
+  EXPECT_EQ(12u, l.latest("General"));
+  EXPECT_EQ(5u, l.latest("sysop"));
+  EXPECT_EQ(0u, l.latest("other"));
+}
+
+TEST_F(LatestQScanTest, SharedBetweenInstances) {
+  LatestQScan one(helper_.TempDir());
+  LatestQScan two(helper_.TempDir());
+  one.Update("general", 10);
+  EXPECT_EQ(10u, two.latest("general"));
+  two.Update("general", 20);
+  EXPECT_EQ(20u, one.latest("general"));
+}
+
+TEST_F(LatestQScanTest, Reopen) {
+  {
+    LatestQScan l(helper_.TempDir());
+    l.Update("general", 10);
+  }
+  LatestQScan l(helper_.TempDir());
+  EXPECT_EQ(10u, l.latest("general"));
+}
+
+TEST_F(LatestQScanTest, Complete) {
+  CreateStatus(10);
+  LatestQScan l(helper_.TempDir());
+  // Nothing has been posted yet.
+  EXPECT_TRUE(l.complete(10));
+  // Something posted qscan 10 without updating the table.
+  EXPECT_FALSE(l.complete(11));
+  l.Update("general", 10);
+  EXPECT_TRUE(l.complete(11));
+  l.Update("sysop", 11);
+  EXPECT_TRUE(l.complete(12));
+  EXPECT_FALSE(l.complete(13));
+}
+
+TEST_F(LatestQScanTest, Complete_UnrecordedPostOnAnotherSub) {
+  CreateStatus(10);
+  LatestQScan l(helper_.TempDir());
+  l.Update("general", 10);
+  // Something posted qscan 11 on sysop without updating the table, then 12
+  // was posted on general.
+  l.Update("general", 12);
+  EXPECT_FALSE(l.complete(13));
+}
+
+TEST_F(LatestQScanTest, Complete_IgnoresPostsBeforeCreated) {
+  CreateStatus(10);
+  LatestQScan l(helper_.TempDir());
+  // Posted before the table was created but recorded after.
+  l.Update("general", 9);
+  EXPECT_EQ(9u, l.latest("general"));
+  EXPECT_TRUE(l.complete(10));
+  EXPECT_FALSE(l.complete(11));
+}
+
+TEST_F(LatestQScanTest, Complete_NoStatus) {
+  LatestQScan l(helper_.TempDir());
+  l.Update("general", 1);
+  EXPECT_FALSE(l.complete(1));
+  EXPECT_FALSE(l.complete(2));
+}
+
+TEST_F(LatestQScanTest, ManySubs) {
+  LatestQScan l(helper_.TempDir());
+  for (auto i = 1; i <= 2000; i++) {
+    l.Update(std::to_string(i), i);
+  }
+  for (auto i = 1; i <= 2000; i++) {
+    ASSERT_EQ(static_cast<uint32_t>(i), l.latest(std::to_string(i)));
+  }
+}
@@ -22,7 +22,9 @@
 #include "core/strings.h"
 #include "core_test/file_helper.h"
 #include "sdk/config.h"
+#include "sdk/latest_qscan.h"
 #include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/message_area_wwiv.h"
 #include "sdk/msgapi/msgapi.h"
 #include "sdk_test/sdk_helper.h"
 #include <memory>
@@ -94,6 +96,20 @@ TEST_F(MsgApiTest, SmokeTest) {
   EXPECT_EQ("From", m1->header().from());
 }
 
+TEST_F(MsgApiTest, AddMessage_UpdatesLatestQScan) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  unique_ptr<MessageArea> area(api->Open(sub, -1));
+  const auto msg(CreateMessage(*area, 1234, "From", "Title", "Line1\r\n"));
+  EXPECT_TRUE(area->AddMessage(*msg, {}));
+  const auto h = area->ReadMessageHeader(1);
+  ASSERT_TRUE(h);
+
+  LatestQScan latest(helper.data());
+  EXPECT_EQ(h->last_read(), latest.latest("a1"));
+}
+
 TEST_F(MsgApiTest, ToName) {
   subboard_t sub{};
   sub.filename = "a1";
@@ -175,3 +191,58 @@ TEST_F(MsgApiTest, Resynch_MessageNumber) {
   a2->ResyncMessage(msgnum);
   EXPECT_EQ(1, msgnum);
 }
+
+TEST_F(MsgApiTest, DeleteMessages) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  unique_ptr<MessageArea> area(api->Open(sub, -1));
+  for (auto i = 1; i <= 5; i++) {
+    auto m(CreateMessage(*area, 1, StrCat("From", i), "Title", "Line1\r\nLine2\r\n"));
+    ASSERT_TRUE(area->AddMessage(*m, {}));
+  }
+  auto* wa = dynamic_cast<WWIVMessageArea*>(area.get());
+  ASSERT_NE(nullptr, wa);
+
+  EXPECT_EQ(2, wa->DeleteMessages([](int num, const postrec&) { return num % 2 == 0; }));
+  ASSERT_EQ(3, area->number_of_messages());
+  EXPECT_EQ("From1", area->ReadMessage(1)->header().from());
+  EXPECT_EQ("From3", area->ReadMessage(2)->header().from());
+  EXPECT_EQ("From5", area->ReadMessage(3)->header().from());
+
+  EXPECT_EQ(2, wa->DeleteMessages(2, 3));
+  ASSERT_EQ(1, area->number_of_messages());
+  EXPECT_EQ("From1", area->ReadMessage(1)->header().from());
+  EXPECT_EQ(0, wa->DeleteMessages(2, 3));
+
+  // The space used by the deleted messages is reused.
+  auto m(CreateMessage(*area, 1, "From6", "Title", "Line1\r\nLine2\r\n"));
+  ASSERT_TRUE(area->AddMessage(*m, {}));
+  EXPECT_EQ("From6", area->ReadMessage(2)->header().from());
+}
+
+TEST_F(MsgApiTest, DeleteExcess_DeleteAll) {
+  MessageApiOptions options;
+  options.overflow_strategy = OverflowStrategy::delete_all;
+  WWIVMessageApi delete_all_api(options, *config, {}, new NullLastReadImpl());
+
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(delete_all_api.Create(sub, -1));
+  unique_ptr<MessageArea> area(delete_all_api.Open(sub, -1));
+  for (auto i = 1; i <= 4; i++) {
+    auto m(CreateMessage(*area, 1, StrCat("From", i), "Title", "Line1\r\nLine2\r\n"));
+    if (i == 1) {
+      m->header().set_locked(true);
+    }
+    ASSERT_TRUE(area->AddMessage(*m, {}));
+  }
+  area->set_max_messages(2);
+  auto m(CreateMessage(*area, 1, "From5", "Title", "Line1\r\nLine2\r\n"));
+  ASSERT_TRUE(area->AddMessage(*m, {}));
+
+  // The locked first message is kept, the oldest unlocked ones are removed.
+  ASSERT_EQ(2, area->number_of_messages());
+  EXPECT_EQ("From1", area->ReadMessage(1)->header().from());
+  EXPECT_EQ("From5", area->ReadMessage(2)->header().from());
+}
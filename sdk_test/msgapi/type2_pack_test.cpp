@@ -0,0 +1,115 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/file.h"
+#include "core/strings.h"
+#include "sdk/config.h"
+#include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/type2_pack.h"
+#include "sdk/msgapi/type2_text.h"
+#include "sdk_test/sdk_helper.h"
+#include <memory>
+#include <string>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::msgapi;
+using namespace wwiv::strings;
+
+class Type2PackTest : public testing::Test {
+public:
+  void SetUp() override {
+    MessageApiOptions options;
+    options.overflow_strategy = OverflowStrategy::delete_none;
+    config_ = std::make_unique<Config>(helper.root());
+    api_ = std::make_unique<WWIVMessageApi>(options, *config_, std::vector<net_networks_rec>{},
+                                            new NullLastReadImpl());
+    sub_.filename = "a1";
+    ASSERT_TRUE(api_->Create(sub_, -1));
+  }
+
+  void Add(MessageArea& area, const std::string& from, const std::string& text) {
+    auto msg(area.CreateMessage());
+    auto& h = msg->header();
+    h.set_from_usernum(1);
+    h.set_title("Title");
+    h.set_from(from);
+    h.set_daten(915192000);
+    msg->text().set_text(text);
+    ASSERT_TRUE(area.AddMessage(*msg, {}));
+  }
+
+  bool Pack() {
+    const auto stats = pack_type2_area(FilePath(helper.data(), "a1.sub"),
+                                       FilePath(helper.msgs(), "a1.dat"),
+                                       FilePath(helper.data(), "a1.new.sub"),
+                                       FilePath(helper.msgs(), "a1.new.dat"));
+    return stats.has_value();
+  }
+
+  SdkHelper helper;
+  std::unique_ptr<Config> config_;
+  std::unique_ptr<WWIVMessageApi> api_;
+  subboard_t sub_{};
+};
+
+TEST_F(Type2PackTest, PacksChainsContiguously) {
+  const std::string big(2000, 'x');
+  {
+    std::unique_ptr<MessageArea> area(api_->Open(sub_, -1));
+    Add(*area, "From1", "Small");
+    Add(*area, "From2", big);
+    Add(*area, "From3", big);
+    Add(*area, "From4", "Last");
+    ASSERT_TRUE(area->DeleteMessage(2));
+  }
+  ASSERT_TRUE(Pack());
+
+  subboard_t packed{};
+  packed.filename = "a1.new";
+  std::unique_ptr<MessageArea> area(api_->Open(packed, -1));
+  ASSERT_EQ(3, area->number_of_messages());
+  EXPECT_EQ("From1", area->ReadMessage(1)->header().from());
+  EXPECT_EQ("From3", area->ReadMessage(2)->header().from());
+  EXPECT_EQ(big + "\r\n", area->ReadMessage(2)->text().text());
+  EXPECT_EQ("Last\r\n", area->ReadMessage(3)->text().text());
+
+  // Blocks 1 (From1), then 2-6 (From3) and 7 (From4).
+  const auto dat_fn = FilePath(helper.msgs(), "a1.new.dat");
+  Type2Text t(dat_fn);
+  File dat(dat_fn);
+  ASSERT_TRUE(dat.Open(File::modeBinary | File::modeReadWrite));
+  const auto gat = t.load_gat(dat, 0);
+  EXPECT_EQ(0, gat[0]);
+  EXPECT_EQ(0xffff, gat[1]);
+  for (auto i = 2; i < 6; i++) {
+    EXPECT_EQ(i + 1, gat[i]);
+  }
+  EXPECT_EQ(0xffff, gat[6]);
+  EXPECT_EQ(0xffff, gat[7]);
+  EXPECT_EQ(0, gat[8]);
+}
+
+TEST_F(Type2PackTest, Empty) {
+  ASSERT_TRUE(Pack());
+  subboard_t packed{};
+  packed.filename = "a1.new";
+  std::unique_ptr<MessageArea> area(api_->Open(packed, -1));
+  EXPECT_EQ(0, area->number_of_messages());
+}
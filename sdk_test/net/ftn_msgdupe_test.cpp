@@ -133,4 +133,19 @@ TEST_F(FtnMsgDupeTest, Remove) {
   EXPECT_TRUE(dupe.is_dupe(1, 2));
   dupe.remove(1, 2);
   EXPECT_FALSE(dupe.is_dupe(1, 2));
-}
\ No newline at end of file
+}
+TEST_F(FtnMsgDupeTest, AddDeferred) {
+  {
+    FtnMessageDupe dupe(config_.datadir(), true);
+    dupe.add_deferred(1, 2);
+    dupe.add_deferred(3, 4);
+    EXPECT_TRUE(dupe.is_dupe(1, 2));
+    EXPECT_TRUE(dupe.is_dupe(3, 0));
+    FtnMessageDupe before_save(config_.datadir(), true);
+    EXPECT_FALSE(before_save.is_dupe(1, 2));
+    ASSERT_TRUE(dupe.Save());
+  }
+  FtnMessageDupe dupe(config_.datadir(), true);
+  EXPECT_TRUE(dupe.is_dupe(1, 2));
+  EXPECT_TRUE(dupe.is_dupe(0, 4));
+}
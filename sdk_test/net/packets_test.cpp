@@ -21,6 +21,7 @@
 #include "core_test/file_helper.h"
 #include "sdk/net/packets.h"
 #include "gtest/gtest.h"
+#include <cstring>
 #include <string>
 
 using std::endl;
@@ -172,3 +173,147 @@ TEST_F(PacketsTest, FromPacketText_Malformed) {
   EXPECT_EQ(pp.sender(), "");
   EXPECT_EQ(pp.date(), "");
 }
+
+TEST_F(PacketsTest, WriteWWIVNetPackets_RoundTrip) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+  net.name = "My Network";
+  net.type = network_type_t::wwivnet;
+
+  std::vector<Packet> packets;
+  for (const auto* text : {"one", "two", "three"}) {
+    net_header_rec nh{};
+    nh.daten = daten_t_now();
+    nh.main_type = main_type_new_post;
+    nh.tosys = 1;
+    nh.length = static_cast<uint32_t>(strlen(text));
+    packets.emplace_back(nh, std::vector<uint16_t>{}, text);
+  }
+  ASSERT_TRUE(write_wwivnet_packets("local.net", net, packets));
+
+  File f(FilePath(net.dir, "local.net"));
+  ASSERT_TRUE(f.Open(File::modeBinary | File::modeReadOnly));
+  for (const auto& expected : packets) {
+    auto [p, response] = read_packet(f, false);
+    ASSERT_EQ(ReadPacketResponse::OK, response);
+    EXPECT_EQ(expected.text(), p.text());
+  }
+  auto [p, response] = read_packet(f, false);
+  EXPECT_EQ(ReadPacketResponse::END_OF_FILE, response);
+}
+
+TEST_F(PacketsTest, WriteWWIVNetPackets_BadLength) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+
+  std::vector<Packet> packets{Packet(net_header_rec{}, {}, "short")};
+  packets.front().nh.length = 100;
+  EXPECT_FALSE(write_wwivnet_packets("local.net", net, packets));
+  EXPECT_FALSE(File::Exists(FilePath(net.dir, "local.net")));
+}
+
+TEST_F(PacketsTest, PacketReader) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+  net.name = "My Network";
+  net.type = network_type_t::wwivnet;
+
+  std::vector<Packet> packets;
+  // Odd length text so that the lists that follow are not aligned.
+  for (const auto* text : {"one", "three", ""}) {
+    net_header_rec nh{};
+    nh.daten = daten_t_now();
+    nh.main_type = main_type_net_info;
+    packets.emplace_back(nh, std::vector<uint16_t>{2, 3}, text);
+  }
+  ASSERT_TRUE(write_wwivnet_packets("p1.net", net, packets));
+
+  PacketReader reader(FilePath(net.dir, "p1.net"), false);
+  ASSERT_TRUE(reader.Open());
+  for (const auto& expected : packets) {
+    auto [v, response] = reader.Next();
+    ASSERT_EQ(ReadPacketResponse::OK, response);
+    EXPECT_EQ(expected.text(), v.text());
+    EXPECT_EQ(expected.list, v.list_vector());
+    EXPECT_EQ(3, v.list(1));
+    const auto p = v.ToPacket();
+    EXPECT_EQ(expected.text(), p.text());
+    EXPECT_EQ(expected.nh.length, p.nh.length);
+  }
+  auto [v, response] = reader.Next();
+  EXPECT_EQ(ReadPacketResponse::END_OF_FILE, response);
+}
+
+TEST_F(PacketsTest, PacketReader_ShortHeader) {
+  const auto path = helper_.CreateTempFile("p1.net", "short");
+  PacketReader reader(path, false);
+  ASSERT_TRUE(reader.Open());
+  auto [v, response] = reader.Next();
+  EXPECT_EQ(ReadPacketResponse::ERROR, response);
+}
+
+TEST_F(PacketsTest, WritePacketView) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+
+  net_header_rec nh{};
+  nh.main_type = main_type_net_info;
+  nh.tosys = 1;
+  ASSERT_TRUE(write_wwivnet_packet("p1.net", net, Packet(nh, {}, "hello")));
+
+  PacketReader reader(FilePath(net.dir, "p1.net"), false);
+  ASSERT_TRUE(reader.Open());
+  auto [v, response] = reader.Next();
+  ASSERT_EQ(ReadPacketResponse::OK, response);
+  ASSERT_TRUE(write_wwivnet_packet("s1.net", net, v));
+
+  File f(FilePath(net.dir, "s1.net"));
+  ASSERT_TRUE(f.Open(File::modeBinary | File::modeReadOnly));
+  auto [p, r] = read_packet(f, false);
+  ASSERT_EQ(ReadPacketResponse::OK, r);
+  EXPECT_EQ("hello", p.text());
+  EXPECT_EQ(1, p.nh.tosys);
+}
+
+TEST_F(PacketsTest, PendingPacketWriter) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+  net.type = network_type_t::wwivnet;
+  {
+    PendingPacketWriter writer('2');
+    for (const auto* text : {"one", "two"}) {
+      net_header_rec nh{};
+      nh.main_type = main_type_new_post;
+      writer.Add(net, Packet(nh, {2, 3}, text));
+    }
+    EXPECT_FALSE(File::Exists(FilePath(net.dir, "p1-2-0.net")));
+    ASSERT_TRUE(writer.Flush());
+    writer.Add(net, Packet(net_header_rec{}, {}, "three"));
+  }
+  // Both packets were written to one pending file, and the last one to
+  // another when the writer was destroyed.
+  PacketReader reader(FilePath(net.dir, "p1-2-0.net"), false);
+  ASSERT_TRUE(reader.Open());
+  for (const auto* expected : {"one", "two"}) {
+    auto [v, response] = reader.Next();
+    ASSERT_EQ(ReadPacketResponse::OK, response);
+    EXPECT_EQ(expected, v.text());
+  }
+  EXPECT_EQ(ReadPacketResponse::END_OF_FILE, std::get<1>(reader.Next()));
+  EXPECT_TRUE(File::Exists(FilePath(net.dir, "p1-2-1.net")));
+}
+
+TEST_F(PacketsTest, SubscriberCache) {
+  const auto path = helper_.CreateTempFile("nFOO.net", "1\n2\n");
+  SubscriberCache cache;
+  const auto* s = cache.subscribers(path);
+  ASSERT_NE(nullptr, s);
+  EXPECT_EQ((std::set<uint16_t>{1, 2}), *s);
+
+  ASSERT_TRUE(WriteSubcriberFile(path, {3}));
+  EXPECT_EQ((std::set<uint16_t>{1, 2}), *cache.subscribers(path));
+  cache.Invalidate(path);
+  EXPECT_EQ((std::set<uint16_t>{3}), *cache.subscribers(path));
+
+  EXPECT_EQ(nullptr, cache.subscribers(helper_.CreateTempFilePath("nBAR.net")));
+}
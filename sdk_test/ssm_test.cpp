@@ -0,0 +1,161 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "sdk/config.h"
+#include "sdk/filenames.h"
+#include "sdk/ssm.h"
+#include "sdk/user.h"
+#include "sdk/usermanager.h"
+#include "sdk_test/sdk_helper.h"
+#include <ctime>
+#include <string>
+#include <vector>
+
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+
+class SSMTest : public testing::Test {
+public:
+  SSMTest() : config_(helper.root()), um_(config_) {
+    for (auto i = 1; i <= 2; i++) {
+      User u{};
+      User::CreateNewUserRecord(&u, 50, 20, 0, 0.1234f, {7, 11, 14, 13, 31, 10, 12, 9, 5, 3},
+                                {7, 15, 15, 15, 112, 15, 15, 7, 7, 7});
+      um_.writeuser(&u, i);
+    }
+  }
+
+  std::vector<std::string> texts(SSM& ssm, int user_number) {
+    std::vector<std::string> v;
+    for (const auto& m : ssm.messages_for(user_number)) {
+      v.push_back(m.text);
+    }
+    return v;
+  }
+
+  /** Sets smw.dat's modification time into the past, returning it. */
+  time_t age_smw() {
+    const auto t = time(nullptr) - 10;
+    File f(FilePath(config_.datadir(), SMW_DAT));
+    EXPECT_TRUE(f.set_last_write_time(t));
+    return t;
+  }
+
+  int num_records() {
+    return static_cast<int>(File(FilePath(config_.datadir(), SMW_DAT)).length() / sizeof(shortmsgrec));
+  }
+
+  SdkHelper helper;
+  Config config_;
+  UserManager um_;
+};
+
+TEST_F(SSMTest, SendAndRead) {
+  SSM ssm(config_, um_);
+  ASSERT_TRUE(ssm.send_local(1, "one"));
+  ASSERT_TRUE(ssm.send_local(2, "two"));
+  ASSERT_TRUE(ssm.send_local(1, "three"));
+
+  EXPECT_EQ((std::vector<std::string>{"one", "three"}), texts(ssm, 1));
+  EXPECT_EQ((std::vector<std::string>{"two"}), texts(ssm, 2));
+
+  User u{};
+  um_.readuser(&u, 1);
+  EXPECT_TRUE(u.HasStatusFlag(User::SMW));
+}
+
+TEST_F(SSMTest, DeleteAndCompact) {
+  SSM ssm(config_, um_);
+  ssm.send_local(1, "one");
+  ssm.send_local(2, "two");
+  ssm.send_local(1, "three");
+
+  const auto msgs = ssm.messages_for(1);
+  ASSERT_EQ(2u, msgs.size());
+  ASSERT_TRUE(ssm.delete_message(msgs.front().slot));
+  EXPECT_EQ((std::vector<std::string>{"three"}), texts(ssm, 1));
+
+  // Sending appends rather than reusing the empty slot.
+  ssm.send_local(2, "four");
+  EXPECT_EQ(4, num_records());
+
+  ASSERT_TRUE(ssm.compact());
+  EXPECT_EQ(3, num_records());
+  EXPECT_EQ((std::vector<std::string>{"three"}), texts(ssm, 1));
+  EXPECT_EQ((std::vector<std::string>{"two", "four"}), texts(ssm, 2));
+
+  ASSERT_TRUE(ssm.delete_local_to_user(2));
+  EXPECT_TRUE(texts(ssm, 2).empty());
+  EXPECT_EQ((std::vector<std::string>{"three"}), texts(ssm, 1));
+}
+
+TEST_F(SSMTest, RebuildsIndex_WhenChangedElsewhere) {
+  SSM ssm(config_, um_);
+  ssm.send_local(1, "one");
+  {
+    // Append a message the way older versions did, without touching smw.idx
+    DataFile<shortmsgrec> file(FilePath(config_.datadir(), SMW_DAT),
+                               File::modeReadWrite | File::modeBinary);
+    ASSERT_TRUE(file);
+    shortmsgrec sm{};
+    sm.touser = 1;
+    strcpy(sm.message, "old");
+    file.Write(1, &sm);
+  }
+  EXPECT_EQ((std::vector<std::string>{"one", "old"}), texts(ssm, 1));
+  ssm.send_local(1, "new");
+  EXPECT_EQ((std::vector<std::string>{"one", "old", "new"}), texts(ssm, 1));
+
+  File::Remove(FilePath(config_.datadir(), SMW_IDX));
+  EXPECT_EQ((std::vector<std::string>{"one", "old", "new"}), texts(ssm, 1));
+}
+
+TEST_F(SSMTest, RebuildsIndex_WhenSlotReusedElsewhere) {
+  SSM ssm(config_, um_);
+  ssm.send_local(1, "one");
+  ssm.send_local(2, "two");
+  ASSERT_TRUE(ssm.delete_message(0));
+
+  // smw.dat was written this second, so the index is rebuilt when read and
+  // then records the modification time.
+  const auto mtime = age_smw();
+  EXPECT_EQ((std::vector<std::string>{"two"}), texts(ssm, 2));
+  {
+    File idx(FilePath(config_.datadir(), SMW_IDX));
+    ASSERT_TRUE(idx.Open(File::modeReadOnly | File::modeBinary));
+    ssm_index_header_t h{};
+    ASSERT_EQ(static_cast<int>(sizeof(h)), idx.Read(&h, sizeof(h)));
+    EXPECT_EQ(mtime, h.smw_mtime);
+  }
+  {
+    // Reuse the empty slot the way older versions did, without touching smw.idx
+    DataFile<shortmsgrec> file(FilePath(config_.datadir(), SMW_DAT),
+                               File::modeReadWrite | File::modeBinary);
+    ASSERT_TRUE(file);
+    shortmsgrec sm{};
+    sm.touser = 1;
+    strcpy(sm.message, "old");
+    file.Write(0, &sm);
+  }
+  EXPECT_EQ(2, num_records());
+  EXPECT_EQ((std::vector<std::string>{"old"}), texts(ssm, 1));
+  EXPECT_EQ((std::vector<std::string>{"two"}), texts(ssm, 2));
+}
@@ -339,6 +339,10 @@ void wwivd_ui(const Config& config) {
             new StringEditItem<std::string&>(52, c.binkp_cmd, EditLineMode::ALL),
             "Command to execute for an inbound network request.", 1, y);
   y++;
+  items.add(new Label("Net receive in wwivd:"),
+            new BooleanEditItem(&c.binkp_in_process),
+            "Answer inbound network requests inside of wwivd instead of the receive cmd.", 1, y);
+  y++;
   items.add(
       new Label("Matrix Filename:"),
       new StringEditItem<std::string&>(12, c.matrix_filename, EditLineMode::ALL),
@@ -0,0 +1,207 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "wwivd/binkp_answer.h"
+
+#include "binkp/binkp.h"
+#include "binkp/binkp_config.h"
+#include "binkp/wfile_transfer_file.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "core/os.h"
+#include "core/semaphore_file.h"
+#include "core/socket_connection.h"
+#include "core/strings.h"
+#include "sdk/filenames.h"
+#include "sdk/fido/fido_callout.h"
+#include "sdk/status.h"
+#include "wwivd/wwivd.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wwiv::wwivd {
+
+using std::string;
+using namespace std::chrono_literals;
+using namespace wwiv::core;
+using namespace wwiv::net;
+using namespace wwiv::os;
+using namespace wwiv::sdk;
+using namespace wwiv::strings;
+
+NetworkProcessingQueue::NetworkProcessingQueue(processor_t processor)
+    : processor_(std::move(processor)), thread_([this] { Run(); }) {}
+
+NetworkProcessingQueue::~NetworkProcessingQueue() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void NetworkProcessingQueue::Enqueue(int network_number) {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (std::find(queue_.begin(), queue_.end(), network_number) != queue_.end()) {
+      VLOG(1) << "Network already queued for processing: " << network_number;
+      return;
+    }
+    queue_.push_back(network_number);
+  }
+  cv_.notify_one();
+}
+
+void NetworkProcessingQueue::Run() {
+  for (;;) {
+    int network_number;
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (stop_) {
+        return;
+      }
+      network_number = queue_.front();
+      queue_.pop_front();
+    }
+    // Anything received for this network from here on needs another pass,
+    // so it may be queued again while networkc is running.
+    processor_(network_number);
+  }
+}
+
+static NetworkProcessingQueue::processor_t networkc_processor(const wwivd_config_t& c,
+                                                              std::filesystem::path bindir,
+                                                              int verbose) {
+  return [&c, bindir = std::move(bindir), verbose](int network_number) {
+    const auto cmd = StrCat(FilePath(bindir, "networkc").string(), " .", network_number,
+                            " --v=", verbose);
+    if (!ExecCommandAndWait(c, cmd, StrCat("[", get_pid(), "]"), -1, INVALID_SOCKET)) {
+      LOG(ERROR) << "Error executing command: '" << cmd << "'";
+    }
+  };
+}
+
+BinkpAnswerer::BinkpAnswerer(const Config& config, const wwivd_config_t& c,
+                             std::filesystem::path bindir, int verbose)
+    : config_(config), verbose_(verbose),
+      queue_(networkc_processor(c, std::move(bindir), verbose)) {}
+
+static std::vector<std::filesystem::path> snapshot_files(const Config& config,
+                                                         const Networks& networks) {
+  std::vector<std::filesystem::path> files{FilePath(config.datadir(), NETWORKS_JSON),
+                                           FilePath(config.datadir(), NETWORKS_DAT)};
+  for (const auto& n : networks.networks()) {
+    if (n.type == network_type_t::wwivnet) {
+      files.emplace_back(FilePath(n.dir, CALLOUT_NET));
+    } else if (n.type == network_type_t::ftn) {
+      files.emplace_back(FilePath(n.dir, FIDO_CALLOUT_JSON));
+    }
+  }
+  return files;
+}
+
+std::shared_ptr<const binkp_snapshot_t> BinkpAnswerer::LoadSnapshot() const {
+  VLOG(1) << "Loading networks and callouts for binkp.";
+  std::map<std::filesystem::path, time_t> mtimes;
+  // Note the times before loading, so that anything written while loading
+  // causes another load.
+  mtimes[FilePath(config_.datadir(), NETWORKS_JSON)] =
+      File::last_write_time(FilePath(config_.datadir(), NETWORKS_JSON));
+  mtimes[FilePath(config_.datadir(), NETWORKS_DAT)] =
+      File::last_write_time(FilePath(config_.datadir(), NETWORKS_DAT));
+
+  auto s = std::make_shared<binkp_snapshot_t>(config_);
+  for (const auto& f : snapshot_files(config_, s->networks)) {
+    if (mtimes.find(f) == mtimes.end()) {
+      mtimes[f] = File::last_write_time(f);
+    }
+  }
+  for (const auto& n : s->networks.networks()) {
+    const auto lower_case_network_name = ToStringLowerCase(n.name);
+    if (n.type == network_type_t::wwivnet) {
+      s->callouts[lower_case_network_name] = std::make_shared<Callout>(n, config_.max_backups());
+    } else if (n.type == network_type_t::ftn) {
+      s->callouts[lower_case_network_name] = std::make_shared<fido::FidoCallout>(config_, n);
+    }
+  }
+  StatusMgr sm(config_.datadir(), [](int) {});
+  s->network_version = sm.GetStatus()->GetNetworkVersion();
+  s->mtimes = std::move(mtimes);
+  return s;
+}
+
+bool BinkpAnswerer::changed(const binkp_snapshot_t& s) const {
+  for (const auto& [path, mtime] : s.mtimes) {
+    if (File::last_write_time(path) != mtime) {
+      VLOG(1) << "Changed: " << path.string();
+      return true;
+    }
+  }
+  return false;
+}
+
+std::shared_ptr<const binkp_snapshot_t> BinkpAnswerer::snapshot() {
+  std::lock_guard<std::mutex> lock(mu_);
+  if (!snapshot_ || changed(*snapshot_)) {
+    snapshot_ = LoadSnapshot();
+  }
+  return snapshot_;
+}
+
+void BinkpAnswerer::Answer(SOCKET sock, const std::string& remote_peer) {
+  // Owns sock from here on; BinkP closes it at the end of the session.
+  SocketConnection conn(sock, SocketConnection::ExitMode::CLOSE_SOCKET);
+  try {
+    const auto s = snapshot();
+    if (s->networks.networks().empty()) {
+      LOG(ERROR) << "Unable to answer binkp from " << remote_peer << "; no networks defined.";
+      return;
+    }
+    // Same as networkb: sessions are answered on behalf of the first network,
+    // holding its networkb semaphore.
+    const auto& net = s->networks.networks().front();
+    auto semaphore = SemaphoreFile::try_acquire(FilePath(net.dir, "networkb.bsy"), 30s);
+
+    BinkConfig bink_config(net.name, config_, s->networks);
+    bink_config.set_verbose(verbose_);
+    bink_config.set_network_version(s->network_version);
+    for (const auto& [name, callout] : s->callouts) {
+      bink_config.callouts()[name] = callout;
+    }
+
+    BinkP::received_transfer_file_factory_t factory = [&](const string& network_name,
+                                                          const string& filename) {
+      const auto dir = bink_config.receive_dir(network_name);
+      return new WFileTransferFile(filename, std::make_unique<File>(FilePath(dir, filename)));
+    };
+    BinkP binkp(&conn, &bink_config, BinkSide::ANSWERING, "0", factory);
+    binkp.set_network_processor([this](int network_number) { queue_.Enqueue(network_number); });
+    binkp.Run();
+  } catch (const semaphore_not_acquired& e) {
+    LOG(ERROR) << "Unable to Acquire Network Semaphore: " << e.what();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Error answering binkp from " << remote_peer << ": " << e.what();
+  }
+}
+
+} // namespace wwiv::wwivd
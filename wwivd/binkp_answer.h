@@ -0,0 +1,116 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef INCLUDED_WWIVD_BINKP_ANSWER_H
+#define INCLUDED_WWIVD_BINKP_ANSWER_H
+
+#include "core/net.h"
+#include "sdk/config.h"
+#include "sdk/net/callout.h"
+#include "sdk/net/networks.h"
+#include "sdk/wwivd_config.h"
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace wwiv::wwivd {
+
+/**
+ * Processes networks that have received files (runs networkc for them), one
+ * network at a time on a single thread.  A network that is already waiting to
+ * be processed is only queued once.
+ */
+class NetworkProcessingQueue final {
+public:
+  // Processes the files received for network_number, i.e. by running networkc.
+  typedef std::function<void(int network_number)> processor_t;
+  explicit NetworkProcessingQueue(processor_t processor);
+  NetworkProcessingQueue(const NetworkProcessingQueue&) = delete;
+  NetworkProcessingQueue& operator=(const NetworkProcessingQueue&) = delete;
+  /** Stops the thread once the network being processed, if any, is done. */
+  ~NetworkProcessingQueue();
+
+  void Enqueue(int network_number);
+
+private:
+  void Run();
+
+  const processor_t processor_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<int> queue_;
+  bool stop_{false};
+  std::thread thread_;
+};
+
+/**
+ * Networks and callouts used to answer binkp sessions, loaded together so
+ * that every session started from them sees the same configuration.
+ */
+struct binkp_snapshot_t {
+  explicit binkp_snapshot_t(const sdk::Config& config) : networks(config) {}
+
+  sdk::Networks networks;
+  std::map<const std::string, std::shared_ptr<sdk::Callout>> callouts;
+  int network_version{0};
+  // Last write time of each file the snapshot was loaded from.
+  std::map<std::filesystem::path, time_t> mtimes;
+};
+
+/**
+ * Answers binkp sessions inside of wwivd, rather than running binkp_cmd
+ * (networkb) for each one.
+ *
+ * The networks and callouts are loaded once and shared by every session,
+ * being reloaded only once one of their files has changed.  Received network
+ * files are processed by a NetworkProcessingQueue.
+ */
+class BinkpAnswerer final {
+public:
+  BinkpAnswerer(const sdk::Config& config, const sdk::wwivd_config_t& c,
+                std::filesystem::path bindir, int verbose);
+
+  /**
+   * Answers the binkp session on sock on the calling thread, closing sock
+   * once the session is over.
+   */
+  void Answer(SOCKET sock, const std::string& remote_peer);
+
+  /** Returns the current snapshot, reloading it if any of its files have changed. */
+  std::shared_ptr<const binkp_snapshot_t> snapshot();
+
+private:
+  [[nodiscard]] std::shared_ptr<const binkp_snapshot_t> LoadSnapshot() const;
+  [[nodiscard]] bool changed(const binkp_snapshot_t& s) const;
+
+  const sdk::Config& config_;
+  const int verbose_;
+  std::mutex mu_;
+  std::shared_ptr<const binkp_snapshot_t> snapshot_;
+  NetworkProcessingQueue queue_;
+};
+
+} // namespace wwiv::wwivd
+
+#endif
@@ -21,6 +21,7 @@
 #include "core/net.h"
 #include "sdk/config.h"
 #include "sdk/wwivd_config.h"
+#include "wwivd/binkp_answer.h"
 #include "wwivd/ips.h"
 #include "wwivd/node_manager.h"
 #include <map>
@@ -41,6 +42,8 @@ struct ConnectionData {
   std::shared_ptr<GoodIp> good_ips_;
   std::shared_ptr<BadIp> bad_ips_;
   std::shared_ptr<AutoBlocker> auto_blocker_;
+  // Set when binkp sessions are answered inside of wwivd.
+  std::shared_ptr<BinkpAnswerer> binkp_answerer_;
 };
 
 }  // namespace wwivd
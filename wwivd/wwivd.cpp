@@ -22,6 +22,7 @@
 #include "core/file.h"
 #include "core/http_server.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/net.h"
 #include "core/os.h"
 #include "core/scope_exit.h"
@@ -110,6 +111,10 @@ int Main(CommandLine& cmdline) {
     return EXIT_FAILURE;
   }
 
+  if (!Metrics::Init(config.datadir())) {
+    LOG(WARNING) << "Unable to open the metrics file; /metrics will only show wwivd.";
+  }
+
   wwivd_config_t c{};
   c.Load(config);
   File::set_current_directory(config.root_directory());
@@ -146,6 +151,11 @@ int Main(CommandLine& cmdline) {
     }
     data.auto_blocker_ = std::make_shared<AutoBlocker>(data.bad_ips_, c.blocking);
   }
+  if (c.binkp_port > 0 && c.binkp_in_process) {
+    LOG(INFO) << "WWIVD is answering binkp sessions.";
+    data.binkp_answerer_ =
+        std::make_shared<BinkpAnswerer>(config, c, cmdline.bindir(), cmdline.verbose());
+  }
 
   auto telnet_or_ssh_fn = [&](accepted_socket_t r) {
     std::thread client(HandleConnection, std::make_unique<ConnectionHandler>(data, r));
@@ -30,6 +30,7 @@
 #include "core/http_server.h"
 #include "core/jsonfile.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/net.h"
 #include "core/os.h"
 #include "core/semaphore_file.h"
@@ -99,6 +100,16 @@ private:
   std::map<const string, std::shared_ptr<NodeManager>>* nodes_;
 };
 
+class MetricsHandler : public HttpHandler {
+public:
+  HttpResponse Handle(HttpMethod, const std::string&, std::vector<std::string>) override {
+    HttpResponse response(200);
+    response.headers.emplace("Content-Type: ", "text/plain; version=0.0.4");
+    response.text = Metrics::instance().ToPrometheusText();
+    return response;
+  }
+};
+
 void HandleHttpConnection(ConnectionData data, accepted_socket_t r) {
   const auto sock = r.client_socket;
   const auto& b = data.c->blocking;
@@ -115,6 +126,8 @@ void HandleHttpConnection(ConnectionData data, accepted_socket_t r) {
     HttpServer h(std::make_unique<SocketConnection>(r.client_socket));
     StatusHandler status(data.nodes);
     h.add(HttpMethod::GET, "/status", &status);
+    MetricsHandler metrics;
+    h.add(HttpMethod::GET, "/metrics", &metrics);
     h.Run();
 
   }
@@ -19,6 +19,7 @@
 
 #include "core/file.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/net.h"
 #include "core/os.h"
 #include "core/scope_exit.h"
@@ -51,6 +52,18 @@ using namespace wwiv::stl;
 using namespace wwiv::strings;
 using namespace wwiv::os;
 
+static void CountDenied() {
+  Metrics::instance()
+      .counter("wwivd_connections_denied_total", "Connections refused by the blocking rules")
+      .inc();
+}
+
+static void CountBusy() {
+  Metrics::instance()
+      .counter("wwivd_connections_busy_total", "Connections sent BUSY due to node or concurrency limits")
+      .inc();
+}
+
 string to_string(const wwivd_matrix_entry_t& e) {
   std::ostringstream ss;
   ss << "[" << e.key << "] " << e.name << " (" << e.description << ")";
@@ -250,6 +263,7 @@ ConnectionHandler::BlockedConnectionResult ConnectionHandler::CheckForBlockedCon
   const auto sock = r.client_socket;
   string remote_peer;
   const auto& b = data.c->blocking;
+  Metrics::instance().counter("wwivd_connections_total", "Connections accepted by wwivd").inc();
 
   // We fail open when we can't get the remote peer
   if (!GetRemotePeerAddress(sock, remote_peer)) {
@@ -270,6 +284,7 @@ ConnectionHandler::BlockedConnectionResult ConnectionHandler::CheckForBlockedCon
     if (data.bad_ips_->IsBlocked(remote_peer)) {
       // We have a connection from a blocked country
       LOG(INFO) << "Denying connection attempt from badip.txt blocked peer: " << remote_peer;
+      CountDenied();
       return BlockedConnectionResult(BlockedConnectionAction::DENY, remote_peer);
     }
   }
@@ -282,6 +297,7 @@ ConnectionHandler::BlockedConnectionResult ConnectionHandler::CheckForBlockedCon
     if (contains(data.c->blocking.block_cc_countries, cc)) {
       // We have a connection from a blocked country
       LOG(INFO) << "Denying connection attempt from country " << cc << " for peer: " << remote_peer;
+      CountDenied();
       return BlockedConnectionResult(BlockedConnectionAction::DENY, remote_peer);
     }
   }
@@ -292,6 +308,7 @@ ConnectionHandler::BlockedConnectionResult ConnectionHandler::CheckForBlockedCon
     if (!data.auto_blocker_->Connection(remote_peer)) {
       // We have a newly blocked address.
       LOG(INFO) << "Denying connection attempt from AutoBlocker: " << remote_peer;
+      CountDenied();
       return BlockedConnectionResult(BlockedConnectionAction::DENY, remote_peer);
     }
   }
@@ -314,6 +331,7 @@ void ConnectionHandler::HandleBinkPConnection() {
     }
     if (!data.concurrent_connections_->aquire(result.remote_peer)) {
       LOG(INFO) << "Binkp Connection blocked by concurent connection limit.";
+      CountBusy();
       SocketConnection conn(r.client_socket);
       conn.send_line("BUSY\r\n", 10s);
       closesocket(sock);
@@ -324,6 +342,13 @@ void ConnectionHandler::HandleBinkPConnection() {
     auto& nodemgr = data.nodes->at("BINKP");
     int node = -1;
     if (nodemgr->AcquireNode(node)) {
+      if (data.binkp_answerer_) {
+        nodemgr->set_node(node, ConnectionType::BINKP, StrCat("Connected: ", result.remote_peer));
+        ScopeExit release_node([&] { nodemgr->ReleaseNode(node); });
+        // The answerer closes the socket.
+        data.binkp_answerer_->Answer(sock, result.remote_peer);
+        return;
+      }
       ScopeExit at_exit2([=] {
         closesocket(sock);
         VLOG(2) << "closed socket: " << sock;
@@ -372,6 +397,7 @@ void ConnectionHandler::HandleConnection() {
     }
     if (!data.concurrent_connections_->aquire(result.remote_peer)) {
       LOG(INFO) << " Blocked by concurrent limit: " << result.remote_peer;
+      CountBusy();
       conn.send_line("BUSY\r\n", 10s);
       closesocket(sock);
       return;
@@ -426,6 +452,7 @@ void ConnectionHandler::HandleConnection() {
     } else {
       using namespace std::chrono_literals;
       LOG(INFO) << "Sending BUSY. No available node to handle connection.";
+      CountBusy();
       conn.send_line("BUSY\r\n", 10s);
       VLOG(1) << "Exiting HandleConnection (busy)";
     }
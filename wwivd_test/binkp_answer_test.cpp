@@ -0,0 +1,203 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*               Copyright (C)2020, WWIV Software Services                */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/stl.h"
+#include "core/strings.h"
+#include "core_test/file_helper.h"
+#include "sdk/config.h"
+#include "sdk/filenames.h"
+#include "sdk/net/networks.h"
+#include "sdk/vardec.h"
+#include "sdk/wwivd_config.h"
+#include "wwivd/binkp_answer.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+using namespace std::chrono_literals;
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::stl;
+using namespace wwiv::strings;
+using namespace wwiv::wwivd;
+
+class NetworkProcessingQueueTest : public testing::Test {
+public:
+  NetworkProcessingQueue::processor_t processor() {
+    return [this](int network_number) {
+      std::unique_lock<std::mutex> lock(mu_);
+      started_.push_back(network_number);
+      cv_.notify_all();
+      cv_.wait(lock, [this] { return released_; });
+      processed_.push_back(network_number);
+      cv_.notify_all();
+    };
+  }
+
+  // Waits until the processor has been called count times.
+  bool WaitForStarted(int count) {
+    std::unique_lock<std::mutex> lock(mu_);
+    return cv_.wait_for(lock, 10s, [&] { return static_cast<int>(started_.size()) >= count; });
+  }
+
+  // Waits until the processor has finished count times.
+  bool WaitForProcessed(int count) {
+    std::unique_lock<std::mutex> lock(mu_);
+    return cv_.wait_for(lock, 10s, [&] { return static_cast<int>(processed_.size()) >= count; });
+  }
+
+  void Release() {
+    std::lock_guard<std::mutex> lock(mu_);
+    released_ = true;
+    cv_.notify_all();
+  }
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool released_{false};
+  vector<int> started_;
+  vector<int> processed_;
+};
+
+TEST_F(NetworkProcessingQueueTest, QueuedOnce) {
+  NetworkProcessingQueue queue(processor());
+  queue.Enqueue(1);
+  ASSERT_TRUE(WaitForStarted(1));
+  // Network 1 is being processed, so 2 waits in the queue.
+  queue.Enqueue(2);
+  queue.Enqueue(2);
+  Release();
+  ASSERT_TRUE(WaitForProcessed(2));
+  std::lock_guard<std::mutex> lock(mu_);
+  EXPECT_EQ(vector<int>({1, 2}), processed_);
+}
+
+TEST_F(NetworkProcessingQueueTest, QueuedAgainWhileProcessing) {
+  NetworkProcessingQueue queue(processor());
+  queue.Enqueue(1);
+  ASSERT_TRUE(WaitForStarted(1));
+  // Files received while network 1 is processed need another pass.
+  queue.Enqueue(1);
+  Release();
+  ASSERT_TRUE(WaitForProcessed(2));
+  std::lock_guard<std::mutex> lock(mu_);
+  EXPECT_EQ(vector<int>({1, 1}), processed_);
+}
+
+class BinkpAnswererTest : public testing::Test {
+public:
+  BinkpAnswererTest() : config_(helper_.TempDir()) {
+    helper_.Mkdir("data");
+    helper_.Mkdir("net");
+    data_ = helper_.Dir("data");
+    net_dir_ = helper_.Dir("net");
+
+    configrec c{};
+    to_char_array(c.datadir, data_.string());
+    config_.set_config(&c, true);
+    config_.set_initialized_for_test(true);
+
+    {
+      DataFile<statusrec_t> file(FilePath(data_, STATUS_DAT),
+                                 File::modeBinary | File::modeReadWrite | File::modeCreateFile);
+      statusrec_t s{};
+      s.net_version = 51;
+      EXPECT_TRUE(file.Write(0, &s));
+    }
+
+    Networks networks(config_);
+    net_networks_rec net{};
+    net.name = "testnet";
+    net.type = network_type_t::wwivnet;
+    net.sysnum = 1;
+    net.dir = net_dir_.string();
+    networks.insert(0, net);
+    EXPECT_TRUE(networks.Save());
+
+    callout_net_ = helper_.CreateTempFile("net/callout.net", "@2 \"one\"\r\n");
+  }
+
+  // Marks path as written at t.
+  static void Touch(const std::filesystem::path& path, time_t t) {
+    File f(path);
+    ASSERT_TRUE(f.set_last_write_time(t));
+  }
+
+  FileHelper helper_;
+  Config config_;
+  wwivd_config_t c_{};
+  std::filesystem::path data_;
+  std::filesystem::path net_dir_;
+  std::filesystem::path callout_net_;
+};
+
+TEST_F(BinkpAnswererTest, Snapshot) {
+  BinkpAnswerer answerer(config_, c_, helper_.TempDir(), 0);
+  const auto s = answerer.snapshot();
+  ASSERT_EQ(1, ssize(s->networks.networks()));
+  EXPECT_EQ(51, s->network_version);
+  ASSERT_EQ(1u, s->callouts.count("testnet"));
+  const auto* con = s->callouts.at("testnet")->net_call_out_for(2);
+  ASSERT_NE(nullptr, con);
+  EXPECT_EQ("one", con->session_password);
+
+  // Nothing changed, so the same snapshot is used.
+  EXPECT_EQ(s, answerer.snapshot());
+}
+
+TEST_F(BinkpAnswererTest, Snapshot_ReloadsChangedCallout) {
+  BinkpAnswerer answerer(config_, c_, helper_.TempDir(), 0);
+  const auto s = answerer.snapshot();
+
+  helper_.CreateTempFile("net/callout.net", "@2 \"two\"\r\n");
+  Touch(callout_net_, File::last_write_time(callout_net_) + 10);
+  const auto reloaded = answerer.snapshot();
+  EXPECT_NE(s, reloaded);
+  const auto* con = reloaded->callouts.at("testnet")->net_call_out_for(2);
+  ASSERT_NE(nullptr, con);
+  EXPECT_EQ("two", con->session_password);
+  // Sessions already using the old snapshot keep it.
+  EXPECT_EQ("one", s->callouts.at("testnet")->net_call_out_for(2)->session_password);
+}
+
+TEST_F(BinkpAnswererTest, Snapshot_ReloadsNewFidoCallout) {
+  Networks networks(config_);
+  net_networks_rec net{};
+  net.name = "fidonet";
+  net.type = network_type_t::ftn;
+  net.dir = net_dir_.string();
+  net.fido.fido_address = "1:2/3";
+  networks.insert(1, net);
+  ASSERT_TRUE(networks.Save());
+
+  BinkpAnswerer answerer(config_, c_, helper_.TempDir(), 0);
+  const auto s = answerer.snapshot();
+  ASSERT_EQ(2, ssize(s->networks.networks()));
+  EXPECT_EQ(s, answerer.snapshot());
+
+  // fido_callout.json did not exist when the snapshot was loaded.
+  helper_.CreateTempFile(FilePath("net", FIDO_CALLOUT_JSON).string(), "{}");
+  EXPECT_NE(s, answerer.snapshot());
+}
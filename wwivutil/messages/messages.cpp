@@ -27,15 +27,19 @@
 #include "sdk/config.h"
 #include "sdk/msgapi/message_api_wwiv.h"
 #include "sdk/msgapi/msgapi.h"
+#include "sdk/msgapi/type2_pack.h"
 #include "sdk/names.h"
 #include "sdk/net/networks.h"
 #include "wwivutil/util.h"
+#include <atomic>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 using std::clog;
@@ -257,6 +261,8 @@ public:
 
   bool AddSubCommands() override {
     add_argument(BooleanCommandLineArgument{"backup", "make a backup of the subs", true});
+    add_argument(BooleanCommandLineArgument{"all", "pack all of the type-2 message areas", false});
+    add_argument({"jobs", "Number of areas to pack at once with --all. (0 = one per CPU)", "0"});
     add_argument({"delete_overflow",
                   "Strategy for deleting excess messages when adding new ones. (none|one|all)",
                   "none"});
@@ -265,8 +271,8 @@ public:
 
   [[nodiscard]] std::string GetUsage() const override {
     std::ostringstream ss;
-    ss << "Usage:   pack <base sub filename>" << endl;
-    ss << "Example: post general" << endl;
+    ss << "Usage:   pack [--all] <base sub filename>" << endl;
+    ss << "Example: pack general" << endl;
     return ss.str();
   }
 
@@ -277,7 +283,87 @@ public:
     return sb && db;
   }
 
-   int Execute() override {
+  static bool pack(const Config& config, const string& basename, bool make_backup) {
+    if (make_backup && !backup(config, basename)) {
+      LOG(ERROR) << "Unable to backup message area: '" << basename << "'.";
+      return false;
+    }
+
+    const auto orig_sub_fn = FilePath(config.datadir(), StrCat(basename, ".sub"));
+    const auto orig_dat_fn = FilePath(config.msgsdir(), StrCat(basename, ".dat"));
+    const auto new_sub_fn = FilePath(config.datadir(), StrCat(basename, ".new.sub"));
+    const auto new_dat_fn = FilePath(config.msgsdir(), StrCat(basename, ".new.dat"));
+    const auto stats = pack_type2_area(orig_sub_fn, orig_dat_fn, new_sub_fn, new_dat_fn);
+    if (!stats) {
+      LOG(ERROR) << "Unable to pack message area: '" << basename << "'.";
+      File::Remove(new_sub_fn);
+      File::Remove(new_dat_fn);
+      return false;
+    }
+
+    // Copy "new" versions back to sub and dat
+    File::Remove(orig_sub_fn);
+    if (!File::Rename(new_sub_fn, orig_sub_fn)) {
+      LOG(ERROR) << "Unable to move sub: " << new_sub_fn;
+      return false;
+    }
+    File::Remove(orig_dat_fn);
+    if (!File::Rename(new_dat_fn, orig_dat_fn)) {
+      LOG(ERROR) << "Unable to move dat: " << new_dat_fn;
+      return false;
+    }
+    LOG(INFO) << "Packed '" << basename << "': " << stats->messages << " messages; "
+              << stats->dropped << " unreadable messages dropped.";
+    return true;
+  }
+
+  int PackAll() {
+    const auto& cfg = *config()->config();
+    Subs subs(cfg.datadir(), config()->networks().networks(), cfg.max_backups());
+    if (!subs.Load()) {
+      LOG(ERROR) << "Unable to open subs. ";
+      return 1;
+    }
+    std::set<std::string> seen;
+    std::vector<std::string> names;
+    for (const auto& x : subs.subs()) {
+      if (x.storage_type == 2 && seen.insert(ToStringLowerCase(x.filename)).second &&
+          File::Exists(FilePath(cfg.datadir(), StrCat(x.filename, ".sub")))) {
+        names.push_back(x.filename);
+      }
+    }
+
+    auto jobs = iarg("jobs");
+    if (jobs <= 0) {
+      jobs = std::max<int>(1, std::thread::hardware_concurrency());
+    }
+    jobs = std::min<int>(jobs, stl::size_int(names));
+    // Each area is independent, so the workers just take the next one.
+    std::atomic<int> next{0};
+    std::atomic<int> failed{0};
+    const auto make_backup = barg("backup");
+    std::vector<std::thread> workers;
+    for (auto i = 0; i < jobs; i++) {
+      workers.emplace_back([&] {
+        for (auto n = next++; n < stl::ssize(names); n = next++) {
+          if (!pack(cfg, names[n], make_backup)) {
+            ++failed;
+          }
+        }
+      });
+    }
+    for (auto& w : workers) {
+      w.join();
+    }
+    cout << "Packed " << (stl::ssize(names) - failed) << " of " << names.size()
+         << " message areas." << endl;
+    return failed == 0 ? 0 : 1;
+  }
+
+  int Execute() override {
+    if (barg("all")) {
+      return PackAll();
+    }
     if (remaining().empty()) {
       clog << "Missing sub basename." << endl;
       cout << GetUsage() << GetHelp();
@@ -300,52 +386,7 @@ public:
       }
     }
 
-    if (barg("backup")) {
-      backup(*config()->config(), basename);
-    }
-
-    auto newsub = sub();
-    newsub.filename = StrCat(basename, ".new");
-    {
-      unique_ptr<MessageArea> area(api().Open(sub(), -1));
-      if (!api().Create(newsub, -1)) {
-        clog << "Unable to create new area: " << newsub.filename;
-        return 1;
-      }
-      unique_ptr<MessageArea> newarea(api().Open(newsub, -1));
-      const auto total = area->number_of_messages();
-      for (auto i = 1; i <= total; i++) {
-        auto message(area->ReadMessage(i));
-        if (!message) {
-          LOG(ERROR) << "Unable to load message #" << i;
-          continue;
-        }
-        if (!newarea->AddMessage(*message, {})) {
-          LOG(ERROR) << "Error adding message: " << message->header().title();
-        } else {
-          cout << "[" << i << "]";
-        }
-      }
-    }
-
-    // Copy "new" versions back to sub and dat
-    const auto orig_sub_fn = FilePath(config()->config()->datadir(), StrCat(basename, ".sub"));
-    const auto new_sub_fn =
-        FilePath(config()->config()->datadir(), StrCat(newsub.filename, ".sub"));
-    File::Remove(orig_sub_fn);
-    if (!File::Rename(new_sub_fn, orig_sub_fn)) {
-      clog << "Unable to move sub";
-    }
-    const auto orig_dat_fn =
-        FilePath(config()->config()->msgsdir(), StrCat(newsub.filename, ".dat"));
-    const auto new_dat_fn =
-        FilePath(config()->config()->msgsdir(), StrCat(newsub.filename, ".dat"));
-    File::Remove(orig_dat_fn);
-    if (!File::Rename(new_dat_fn, orig_dat_fn)) {
-      clog << "Unable to move dat";
-    }
-
-    return 0;
+    return pack(*config()->config(), basename, barg("backup")) ? 0 : 1;
   }
 };
 